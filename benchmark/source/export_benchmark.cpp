@@ -0,0 +1,50 @@
+#include "fixtures.h"
+#include "network_synthesizer.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+
+namespace {
+    // Synthesizer holding the MST of the corpus of `n` documents, computed once per size
+    const Network_Synthesizer& synthesizerWithMST(int n) {
+        static std::map<int, std::unique_ptr<Network_Synthesizer>> cache;
+        auto& entry = cache[n];
+        if (!entry) {
+            entry = std::make_unique<Network_Synthesizer>(statements(n), BENCHMARK_TOPICS);
+            entry->findMSTFusedPrim();
+        }
+        return *entry;
+    }
+}
+
+// The MST is found with fused Prim, which is quadratic, so sizes stop at 20k
+static void BM_ExportCSV(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    const Network_Synthesizer& synthesizer = synthesizerWithMST(n);
+    std::filesystem::create_directories("./temp");
+
+    for (auto _ : state) {
+        synthesizer.exportMSTWithNodeData("./temp/bench_edges.csv", "./temp/bench_nodes.csv", statements(n));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size("./temp/bench_edges.csv") +
+                                                                      std::filesystem::file_size("./temp/bench_nodes.csv")));
+    std::filesystem::remove("./temp/bench_edges.csv");
+    std::filesystem::remove("./temp/bench_nodes.csv");
+}
+BENCHMARK(BM_ExportCSV)->Arg(1000)->Arg(5000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+static void BM_ExportGraphML(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    const Network_Synthesizer& synthesizer = synthesizerWithMST(n);
+    std::filesystem::create_directories("./temp");
+
+    for (auto _ : state) {
+        synthesizer.exportMSTToGraphMLWithNodeData("./temp/bench_mst.graphml", statements(n));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size("./temp/bench_mst.graphml")));
+    std::filesystem::remove("./temp/bench_mst.graphml");
+}
+BENCHMARK(BM_ExportGraphML)->Arg(1000)->Arg(5000)->Arg(20000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#ifndef BENCHMARK_FIXTURES_H
+#define BENCHMARK_FIXTURES_H
+
+#include "synthetic_corpus.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <streambuf>
+
+// Topics used by every benchmark, as in the standalone pipeline
+constexpr int BENCHMARK_TOPICS = 60;
+
+// Words per topic used for perplexity, as in Topic_generator::perplexityPypelyne
+constexpr size_t BENCHMARK_WORDS = 200;
+
+/**
+ * @brief Corpus of `numDocuments` documents with the benchmark seed, generated once per size.
+ */
+inline const Synthetic_Corpus& corpus(int numDocuments) {
+    static std::map<int, std::unique_ptr<Synthetic_Corpus>> cache;
+    auto& entry = cache[numDocuments];
+    if (!entry) {
+        Synthetic_Config config;
+        config.numDocuments = numDocuments;
+        config.numTopics = BENCHMARK_TOPICS;
+        entry = std::make_unique<Synthetic_Corpus>(config);
+    }
+    return *entry;
+}
+
+/**
+ * @brief Statements table of the corpus of `numDocuments` documents, generated once per size.
+ */
+inline const Statements& statements(int numDocuments) {
+    static std::map<int, std::unique_ptr<Statements>> cache;
+    auto& entry = cache[numDocuments];
+    if (!entry) {
+        entry = std::make_unique<Statements>();
+        corpus(numDocuments).fillStatements(*entry);
+    }
+    return *entry;
+}
+
+/**
+ * @brief Silences the progress messages of the library while in scope.
+ */
+class Quiet_Output {
+public:
+    Quiet_Output() : previous(std::cout.rdbuf(&sink)) {
+    }
+
+    ~Quiet_Output() {
+        std::cout.rdbuf(previous);
+    }
+
+private:
+    struct Null_Buffer : std::streambuf {
+        int overflow(int c) override {
+            return c;
+        }
+    };
+
+    Null_Buffer sink;
+    std::streambuf* previous;
+};
+
+#endif // BENCHMARK_FIXTURES_H
@@ -0,0 +1,168 @@
+#include "fixtures.h"
+#include "force_layout.h"
+#include "network_synthesizer.h"
+#include "permutation_test.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace {
+    // Upper triangle of cosine distances, built through the public kernel
+    std::vector<double> similarityTriangle(int n) {
+        Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+        synthesizer.calculateDocumentModulus();
+        std::vector<double> triangle;
+        triangle.reserve(static_cast<size_t>(n) * (n - 1) / 2);
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                triangle.push_back(synthesizer.calculateCosineSimilarity(i, j));
+            }
+        }
+        return triangle;
+    }
+}
+
+// Edge extraction and sort; the edge list takes 24 bytes per pair, so sizes stop at 5k
+static void BM_BuildFromSimilarityMatrix(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    const std::vector<double> triangle = similarityTriangle(n);
+
+    for (auto _ : state) {
+        Network network;
+        network.buildFromSimilarityMatrix(triangle, n);
+        benchmark::DoNotOptimize(network.getEdges().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(triangle.size()));
+}
+BENCHMARK(BM_BuildFromSimilarityMatrix)->Arg(1000)->Arg(2000)->Arg(5000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// n - 1 random unions interleaved with 2n finds
+static void BM_UnionFind(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> node(0, n - 1);
+    std::vector<std::pair<int, int>> pairs(n - 1);
+    for (auto& pair : pairs) {
+        pair = {node(rng), node(rng)};
+    }
+
+    for (auto _ : state) {
+        UF_DS uf(n);
+        for (const auto& [u, v] : pairs) {
+            if (uf.find(u) != uf.find(v)) {
+                uf.unite(u, v);
+            }
+        }
+        benchmark::DoNotOptimize(uf.find(0));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pairs.size()));
+}
+BENCHMARK(BM_UnionFind)->RangeMultiplier(10)->Range(1000, 100000);
+
+// Kruskal over a prebuilt, sorted edge list
+static void BM_FindMST(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+        synthesizer.calculateSimilarity();
+        synthesizer.buildNetwork();
+        state.ResumeTiming();
+
+        synthesizer.findMST();
+        benchmark::DoNotOptimize(synthesizer.getMST().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n) * (n - 1) / 2);
+}
+BENCHMARK(BM_FindMST)->Arg(1000)->Arg(2000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+// TMFG from the unit-row query index, without a similarity matrix
+static void BM_FindTMFG(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    synthesizer.buildQueryIndex();
+
+    for (auto _ : state) {
+        const std::vector<Edge> graph = synthesizer.findTMFG();
+        benchmark::DoNotOptimize(graph.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_FindTMFG)->Arg(1000)->Arg(5000)->Arg(20000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// PMFG over a prebuilt, sorted edge list; one planarity test per candidate, so sizes stay small
+static void BM_FindPMFG(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    synthesizer.calculateSimilarity();
+    synthesizer.buildNetwork();
+
+    for (auto _ : state) {
+        const std::vector<Edge> graph = synthesizer.findPMFG();
+        benchmark::DoNotOptimize(graph.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_FindPMFG)->Arg(250)->Arg(500)->Arg(1000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ForceAtlas2 over the MST with a fixed budget of 100 iterations
+static void BM_ForceLayout(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    synthesizer.calculateDocumentModulus();
+    synthesizer.findMSTFusedPrim();
+    Force_Layout layout(n, synthesizer.getMST());
+    Layout_Config config;
+    config.iterations = 100;
+
+    for (auto _ : state) {
+        layout.run(config);
+        benchmark::DoNotOptimize(layout.getX().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n) * config.iterations);
+}
+BENCHMARK(BM_ForceLayout)->Arg(1000)->Arg(10000)->Arg(50000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// All-pair distance summaries, overall and by verdict pair, streamed without a matrix
+static void BM_DistanceStatistics(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    std::vector<int> labels(n);
+    for (int i = 0; i < n; ++i) {
+        labels[i] = i % 6;
+    }
+    const std::vector<std::string> names = {"true", "mostly-true", "half-true", "mostly-false", "false", "pants-fire"};
+
+    for (auto _ : state) {
+        const Distance_Statistics statistics = synthesizer.computeDistanceStatistics(labels, names);
+        benchmark::DoNotOptimize(statistics.all.getMean());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n) * (n - 1) / 2);
+}
+BENCHMARK(BM_DistanceStatistics)->Arg(1000)->Arg(5000)->Arg(20000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Verdict clustering on a random tree against 100 label permutations
+static void BM_PermutationTest(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937_64 rng(42);
+    std::vector<Edge> tree;
+    std::vector<uint8_t> labels(n);
+    for (int v = 1; v < n; ++v) {
+        tree.emplace_back(static_cast<int>(rng() % v), v, 0.5, v - 1);
+        labels[v] = static_cast<uint8_t>(rng() % 6);
+    }
+    const Permutation_Test test(n, tree, labels, {"true", "mostly-true", "half-true", "mostly-false", "false", "pants-fire"});
+    constexpr int permutations = 100;
+
+    for (auto _ : state) {
+        const auto statistics = test.run(permutations, 1);
+        benchmark::DoNotOptimize(statistics.front().pValue);
+    }
+    state.SetItemsProcessed(state.iterations() * permutations);
+}
+BENCHMARK(BM_PermutationTest)->Arg(10000)->Arg(100000)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,46 @@
+#include "fixtures.h"
+#include "perplexity_utils.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+
+// Composition file parsing; files are written to ./temp/bench_<n>_composition.txt
+static void BM_ParseDocTopicProb(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const std::string profile = "bench_" + std::to_string(n);
+    const std::string filename = "./temp/" + profile + "_composition.txt";
+    std::filesystem::create_directories("./temp");
+    if (!corpus(n).writeComposition(filename)) {
+        state.SkipWithError("Could not write the composition file");
+        return;
+    }
+
+    for (auto _ : state) {
+        int numDocs = 0;
+        double* docTopicProbs = parseDocTopicProb(profile, BENCHMARK_TOPICS, numDocs);
+        benchmark::DoNotOptimize(docTopicProbs);
+        delete[] docTopicProbs;
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(filename)));
+    std::filesystem::remove(filename);
+}
+BENCHMARK(BM_ParseDocTopicProb)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_CalculateDocumentProbabilities(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::vector<double> docTopicProbs;
+    docTopicProbs.reserve(static_cast<size_t>(n) * BENCHMARK_TOPICS);
+    for (const auto& row : corpus(n).getDocuments()) {
+        docTopicProbs.insert(docTopicProbs.end(), row.begin(), row.end());
+    }
+    std::vector<double> wordTopicProbs = corpus(n).getWordTopicProbabilities(BENCHMARK_WORDS);
+
+    for (auto _ : state) {
+        double* docProbs = calculateDocumentProbabilities(docTopicProbs.data(), n, BENCHMARK_TOPICS, wordTopicProbs.data(),
+                                                          BENCHMARK_WORDS);
+        benchmark::DoNotOptimize(docProbs);
+        delete[] docProbs;
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_CalculateDocumentProbabilities)->RangeMultiplier(10)->Range(1000, 100000)->UseRealTime()->Unit(benchmark::kMillisecond);
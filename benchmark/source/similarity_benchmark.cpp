@@ -0,0 +1,59 @@
+#include "fixtures.h"
+#include "network_synthesizer.h"
+#include <benchmark/benchmark.h>
+
+// One cosine distance per iteration over scattered document pairs
+static void BM_CosineSimilarity(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    synthesizer.calculateDocumentModulus();
+
+    int i = 0;
+    for (auto _ : state) {
+        const int j = static_cast<int>((static_cast<int64_t>(i) * 7919 + 1) % n);
+        benchmark::DoNotOptimize(synthesizer.calculateCosineSimilarity(i, j));
+        i = (i + 1) % n;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CosineSimilarity)->RangeMultiplier(10)->Range(1000, 100000);
+
+// Full upper triangle; 100k documents would need 40 GB, so dense sizes stop at 10k
+static void BM_CalculateSimilarity(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+
+    for (auto _ : state) {
+        synthesizer.calculateSimilarity();
+    }
+    const int64_t pairs = static_cast<int64_t>(n) * (n - 1) / 2;
+    state.SetItemsProcessed(state.iterations() * pairs);
+    state.SetBytesProcessed(state.iterations() * pairs * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_CalculateSimilarity)->Arg(1000)->Arg(2000)->Arg(5000)->Arg(10000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Exact top-10 query over the whole corpus, alone and in batches sharing one scan
+static void BM_FindNearestDocuments(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int batchSize = static_cast<int>(state.range(1));
+    Quiet_Output quiet;
+    Network_Synthesizer synthesizer(corpus(n).getDocuments(), BENCHMARK_TOPICS);
+    synthesizer.buildQueryIndex();
+
+    std::vector<Similarity_Query> batch(batchSize);
+    int next = 0;
+    for (auto _ : state) {
+        for (auto& query : batch) {
+            query.document = next;
+            next = (next + 7919) % n;
+        }
+        benchmark::DoNotOptimize(synthesizer.findNearestDocuments(batch, 10));
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_FindNearestDocuments)
+    ->ArgsProduct({{10000, 100000}, {1, 16}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,118 @@
+#ifndef DENDROGRAM_H
+#define DENDROGRAM_H
+
+#include "edge.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief One merge of the single-linkage hierarchy, as a row of a SciPy linkage matrix.
+ *
+ * Clusters 0 to n - 1 are the documents; the cluster formed by merge i is n + i.
+ */
+struct Linkage_Row {
+    int first;       ///< Smaller ID of the two merged clusters.
+    int second;      ///< Larger ID of the two merged clusters.
+    double distance; ///< Cosine distance at which they merge.
+    int size;        ///< Documents in the merged cluster.
+};
+
+/**
+ * @brief Flat clustering request: a distance threshold or a number of clusters.
+ */
+struct Cluster_Cut {
+    bool byCount = false; ///< Cut to `clusters` clusters instead of at `distance`.
+    double distance = 0.0; ///< Merges at or below this distance are kept.
+    int clusters = 1;      ///< Target number of clusters.
+};
+
+/**
+ * @class Dendrogram
+ * @brief Single-linkage hierarchy of the documents, derived from their minimum spanning tree.
+ *
+ * Single linkage merges the two closest clusters at each step, and the closest pair of
+ * clusters is always joined by an MST edge. Replaying the MST edges in increasing weight through
+ * a union-find therefore yields the full hierarchy in O(n log n), without any distance matrix.
+ * A flat cut keeps a prefix of the merges and is answered in O(n).
+ */
+class Dendrogram {
+public:
+    /**
+     * @brief Builds the hierarchy.
+     * @param numNodes Number of documents.
+     * @param mst Edges of the minimum spanning tree (or forest), in any order.
+     */
+    Dendrogram(int numNodes, const std::vector<Edge>& mst);
+
+    /**
+     * @brief Gets the merges in increasing distance; n - 1 rows for a spanning tree, fewer for
+     *        a forest.
+     */
+    const std::vector<Linkage_Row>& getLinkage() const;
+
+    /**
+     * @brief Gets the number of documents.
+     */
+    int getNumNodes() const;
+
+    /**
+     * @brief Flat clusters keeping the merges at or below a distance (SciPy `fcluster` with
+     *        criterion "distance").
+     * @param threshold Largest merge distance kept.
+     * @return Cluster of each document, numbered from 0 in order of their smallest document.
+     */
+    std::vector<int> cutAtDistance(double threshold) const;
+
+    /**
+     * @brief Flat clusters from the last merges undone until `numClusters` remain, or as close
+     *        as a forest allows (SciPy `fcluster` with criterion "maxclust").
+     * @param numClusters Target number of clusters.
+     * @return Cluster of each document, numbered as in cutAtDistance().
+     */
+    std::vector<int> cutToClusters(int numClusters) const;
+
+    /**
+     * @brief Flat clusters for a cut request.
+     */
+    std::vector<int> cut(const Cluster_Cut& request) const;
+
+    /**
+     * @brief Writes the linkage matrix as a float64 NumPy `.npy` file of shape (n - 1, 4), ready
+     *        for `scipy.cluster.hierarchy`.
+     *
+     * Clusters of a forest that are never merged are joined at an infinite distance, since
+     * SciPy expects a single root.
+     *
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeLinkage(const std::string& filename) const;
+
+    /**
+     * @brief Writes flat clusters as `node_id,cluster` rows, the format read by `--communities`.
+     * @param filename Output file.
+     * @param labels Cluster of each document.
+     * @return True on success.
+     */
+    static bool writeClusters(const std::string& filename, const std::vector<int>& labels);
+
+    /**
+     * @brief Parses a cut: "distance:<threshold>" or "clusters:<count>".
+     * @param text Text to parse.
+     * @param request [Output] Parsed cut.
+     * @return True if the text was recognised.
+     */
+    static bool parseCut(const std::string& text, Cluster_Cut& request);
+
+private:
+    int numNodes;                              ///< Number of documents.
+    std::vector<Linkage_Row> linkage;          ///< Merges in increasing distance.
+    std::vector<std::pair<int, int>> mergedEdges; ///< MST edge behind each merge.
+
+    /**
+     * @brief Flat clusters after the first `numMerges` merges.
+     */
+    std::vector<int> labelsAfter(size_t numMerges) const;
+};
+
+#endif // DENDROGRAM_H
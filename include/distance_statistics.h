@@ -0,0 +1,164 @@
+#ifndef DISTANCE_STATISTICS_H
+#define DISTANCE_STATISTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Kll_Sketch
+ * @brief Mergeable quantile sketch of Karnin, Lang and Liberty (KLL).
+ *
+ * Items enter a stack of compactors; a full compactor sorts itself and promotes every other
+ * item, chosen by a random offset, to the next level, where it counts twice as much. Level
+ * capacities shrink by 2/3 going down from the top, so the sketch keeps O(k log(n / k))
+ * items and ranks are off by about 1.7 / k of the count. Two sketches merge by concatenating
+ * their levels and compacting.
+ */
+class Kll_Sketch {
+public:
+    /**
+     * @brief Creates an empty sketch.
+     * @param k Capacity of the top compactor; larger is more accurate.
+     * @param seed Seed of the compaction offsets.
+     */
+    explicit Kll_Sketch(int k = 200, uint64_t seed = 1);
+
+    /**
+     * @brief Adds one value.
+     */
+    void add(double value);
+
+    /**
+     * @brief Adds every value of another sketch.
+     */
+    void merge(const Kll_Sketch& other);
+
+    /**
+     * @brief Number of values added.
+     */
+    uint64_t getCount() const;
+
+    /**
+     * @brief Approximate quantile.
+     * @param q Rank in [0, 1].
+     * @return The value at rank q, NaN if the sketch is empty.
+     */
+    double quantile(double q) const;
+
+private:
+    int k;                                   ///< Capacity of the top compactor.
+    uint64_t count = 0;                      ///< Values added.
+    uint64_t state;                          ///< Xorshift state of the compaction offsets.
+    size_t size = 0;                         ///< Items held over all levels.
+    size_t limit = 0;                        ///< Sum of the level capacities; reaching it triggers a compaction.
+    std::vector<std::vector<double>> levels; ///< Compactors; an item of level h weighs 2^h.
+
+    size_t capacity(size_t level) const;
+    void addLevel();
+    void compress();
+};
+
+/**
+ * @class Distance_Summary
+ * @brief Streaming summary of distances: count, mean, variance, range, a fixed-bin histogram
+ *        over [0, 1] and a KLL sketch. Memory does not depend on the number of values.
+ */
+class Distance_Summary {
+public:
+    /**
+     * @brief Creates an empty summary.
+     * @param bins Bins of the histogram; values outside [0, 1] go to the end bins.
+     */
+    explicit Distance_Summary(int bins = 100);
+
+    /**
+     * @brief Adds one distance.
+     */
+    void add(double distance) {
+        ++count;
+        const double delta = distance - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (distance - mean);
+        minimum = distance < minimum ? distance : minimum;
+        maximum = distance > maximum ? distance : maximum;
+        const double scaled = distance * static_cast<double>(histogram.size());
+        const size_t bin = scaled <= 0 ? 0 : static_cast<size_t>(scaled);
+        ++histogram[bin < histogram.size() ? bin : histogram.size() - 1];
+        sketch.add(distance);
+    }
+
+    /**
+     * @brief Adds every distance of another summary with the same bins (Chan's parallel update).
+     */
+    void merge(const Distance_Summary& other);
+
+    /**
+     * @brief Number of distances.
+     */
+    uint64_t getCount() const;
+
+    /**
+     * @brief Mean distance, NaN if empty.
+     */
+    double getMean() const;
+
+    /**
+     * @brief Population variance of the distances, NaN if empty.
+     */
+    double getVariance() const;
+
+    /**
+     * @brief Smallest distance, NaN if empty.
+     */
+    double getMin() const;
+
+    /**
+     * @brief Largest distance, NaN if empty.
+     */
+    double getMax() const;
+
+    /**
+     * @brief Counts of the equal-width bins over [0, 1].
+     */
+    const std::vector<uint64_t>& getHistogram() const;
+
+    /**
+     * @brief Approximate quantile from the sketch.
+     */
+    double quantile(double q) const;
+
+private:
+    uint64_t count = 0;             ///< Distances added.
+    double mean = 0.0;              ///< Running mean.
+    double m2 = 0.0;                ///< Sum of squared deviations from the mean.
+    double minimum;                 ///< Smallest distance.
+    double maximum;                 ///< Largest distance.
+    std::vector<uint64_t> histogram; ///< Fixed bins over [0, 1].
+    Kll_Sketch sketch;              ///< Quantile sketch.
+};
+
+/**
+ * @brief All-pair distance statistics, overall and by pair of labels.
+ */
+struct Distance_Statistics {
+    Distance_Summary all;                 ///< Every pair.
+    std::vector<std::string> labelNames;  ///< Name of each label.
+    std::vector<Distance_Summary> byPair; ///< Pairs of labels (a, b), a <= b, in order of pairIndex().
+
+    /**
+     * @brief Index of the unordered label pair (a, b) in `byPair`.
+     */
+    static size_t pairIndex(int a, int b, int numLabels);
+
+    /**
+     * @brief Writes the statistics as JSON: count, mean, variance, min, max, quantiles and
+     *        histogram, overall and for each label pair named "a|b".
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeJson(const std::string& filename) const;
+};
+
+#endif // DISTANCE_STATISTICS_H
@@ -59,4 +59,15 @@ public:
     int getId() const;
 };
 
+/**
+ * @brief Orders edges by weight, breaking ties by node pair.
+ *
+ * A strict total order on edges makes the MST unique, so every MST strategy produces the same tree.
+ *
+ * @param a First edge.
+ * @param b Second edge.
+ * @return True if `a` sorts before `b`.
+ */
+bool compareByWeight(const Edge& a, const Edge& b);
+
 #endif // EDGE_H
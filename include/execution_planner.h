@@ -0,0 +1,134 @@
+#ifndef EXECUTION_PLANNER_H
+#define EXECUTION_PLANNER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @enum Strategy
+ * @brief Ways of turning the document-topic matrix into a Minimum Spanning Tree.
+ */
+enum class Strategy {
+    DENSE_MATRIX, ///< Full upper-triangular matrix plus a sorted edge list, then Kruskal.
+    FUSED_PRIM,   ///< Prim's algorithm computing distances on the fly; exact MST in O(n) memory.
+    KNN_GRAPH,    ///< k nearest neighbours per document, then Kruskal on the sparse graph (approximate).
+    OUT_OF_CORE   ///< Sorted edge runs spilled to disk and merged while running Kruskal (exact).
+};
+
+/**
+ * @brief Resource estimate of one strategy for a given problem size.
+ */
+struct Strategy_Estimate {
+    Strategy strategy;        ///< Strategy being estimated.
+    size_t memoryBytes = 0;   ///< Estimated peak resident memory.
+    size_t diskBytes = 0;     ///< Estimated scratch disk usage.
+    double seconds = 0.0;     ///< Rough wall time on the configured number of cores.
+    bool exact = true;        ///< Whether the strategy yields the exact MST.
+    bool keepsEdgeList = false; ///< Whether a sorted edge list is available afterwards.
+    bool fits = false;        ///< Whether the estimate fits the memory and disk budgets.
+};
+
+/**
+ * @brief User-facing knobs of the planner. Zero values are resolved from the machine.
+ */
+struct Planner_Config {
+    size_t memoryBudgetBytes = 0;   ///< RAM budget; 0 uses 80% of the physical memory.
+    size_t diskBudgetBytes = 0;     ///< Scratch disk budget; 0 uses the free space of the scratch directory.
+    unsigned int cores = 0;         ///< Cores available; 0 uses std::thread::hardware_concurrency().
+    int knnNeighbours = 16;         ///< Neighbours kept per document by the kNN strategy.
+    size_t outOfCoreBlockBytes = size_t(256) << 20; ///< Size of one in-memory sorted run.
+    std::string scratchDirectory = "./temp"; ///< Where out-of-core runs are written.
+    bool requireEdgeList = false;   ///< Later stages need the sorted edge stream, not only the MST.
+    bool allowApproximate = false;  ///< The kNN graph may be chosen when exact strategies do not fit.
+    bool forceStrategy = false;     ///< Skip the selection and use `forced`.
+    Strategy forced = Strategy::DENSE_MATRIX; ///< Strategy used when `forceStrategy` is set.
+};
+
+/**
+ * @brief Outcome of planning: the chosen strategy and the estimates it was chosen from.
+ */
+struct Execution_Plan {
+    Strategy strategy = Strategy::DENSE_MATRIX; ///< Strategy to execute.
+    Planner_Config config;                      ///< Configuration with machine defaults resolved.
+    size_t numDocuments = 0;                    ///< Problem size the plan was made for.
+    int numTopics = 0;                          ///< Topic dimension the plan was made for.
+    std::vector<Strategy_Estimate> estimates;   ///< Estimates for every strategy.
+    std::string reason;                         ///< Human readable justification.
+};
+
+/**
+ * @class Execution_Planner
+ * @brief Estimates the memory, disk and time of each MST strategy and picks one within budget.
+ *
+ * Preference order: the dense matrix whenever it fits, since the similarity matrix and sorted
+ * edge list are reused by other analyses. Otherwise fused Prim when only the MST is needed, or,
+ * when the edge stream is required, the kNN graph (if approximation is allowed) or the
+ * out-of-core runs.
+ */
+class Execution_Planner {
+public:
+    /**
+     * @brief Constructs a planner, resolving zero-valued budgets from the machine.
+     * @param config Planner configuration.
+     */
+    explicit Execution_Planner(const Planner_Config& config);
+
+    /**
+     * @brief Plans the network stage for a problem size. Allocates nothing proportional to it.
+     * @param numDocuments Number of documents.
+     * @param numTopics Number of topics per document.
+     * @return The chosen plan with all estimates.
+     */
+    Execution_Plan plan(size_t numDocuments, int numTopics) const;
+
+    /**
+     * @brief Estimates the resources of one strategy.
+     * @param strategy Strategy to estimate.
+     * @param numDocuments Number of documents.
+     * @param numTopics Number of topics per document.
+     * @return The estimate; `fits` is evaluated against the configured budgets.
+     */
+    Strategy_Estimate estimate(Strategy strategy, size_t numDocuments, int numTopics) const;
+
+    /**
+     * @brief Prints the plan, all estimates and the decision to the console.
+     * @param plan Plan to print.
+     */
+    static void logPlan(const Execution_Plan& plan);
+
+    /**
+     * @brief Returns the physical memory of the machine in bytes (0 if unknown).
+     */
+    static size_t physicalMemory();
+
+    /**
+     * @brief Returns the printable name of a strategy.
+     * @param strategy Strategy to name.
+     */
+    static std::string strategyName(Strategy strategy);
+
+    /**
+     * @brief Parses a strategy name ("dense", "prim", "knn", "ooc").
+     * @param name Name to parse.
+     * @param strategy [Output] Parsed strategy.
+     * @return True if the name was recognised.
+     */
+    static bool parseStrategy(const std::string& name, Strategy& strategy);
+
+    /**
+     * @brief Formats a byte count with a binary unit suffix.
+     * @param bytes Byte count.
+     */
+    static std::string formatBytes(size_t bytes);
+
+    /**
+     * @brief Returns the configuration with machine defaults resolved.
+     */
+    const Planner_Config& getConfig() const;
+
+private:
+    Planner_Config config; ///< Resolved configuration.
+};
+
+#endif // EXECUTION_PLANNER_H
@@ -0,0 +1,98 @@
+#ifndef FORCE_LAYOUT_H
+#define FORCE_LAYOUT_H
+
+#include "edge.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Parameters of the ForceAtlas2 layout, named and defaulted as in Gephi.
+ */
+struct Layout_Config {
+    int iterations = 300;          ///< Fixed iteration budget.
+    double scalingRatio = 2.0;     ///< Strength of the repulsion (and gravity).
+    double gravity = 1.0;          ///< Pull towards the origin, keeping components together.
+    bool strongGravity = false;    ///< Gravity grows with the distance to the origin.
+    bool linLog = false;           ///< Logarithmic attraction, for tighter clusters.
+    double edgeWeightInfluence = 1.0; ///< Exponent of the edge similarity in the attraction.
+    double jitterTolerance = 1.0;  ///< Swinging tolerated before the speed is reduced.
+    double theta = 1.2;            ///< Barnes-Hut accuracy: a cell is approximated when distance * theta > size.
+    uint64_t seed = 1;             ///< Seed of the initial positions.
+};
+
+/**
+ * @class Force_Layout
+ * @brief ForceAtlas2 layout (Jacomy et al., 2014) of a sparse graph in two dimensions.
+ *
+ * Nodes repel each other in proportion to their masses (degree + 1) and edges pull their ends
+ * together in proportion to the similarity, 1 - weight. Repulsion is approximated with a
+ * Barnes-Hut quadtree rebuilt every iteration, O(n log n) instead of O(n^2). Forces are
+ * accumulated per node on the pool, each node summing its own repulsion, attraction and
+ * gravity, so no atomics are needed and the result does not depend on the number of threads.
+ * The adaptive speed of ForceAtlas2 balances swinging against convergence.
+ */
+class Force_Layout {
+public:
+    /**
+     * @brief Prepares the layout of a graph.
+     * @param numNodes Number of nodes.
+     * @param edges Edges with cosine distances as weights.
+     * @param pool Thread pool accumulating the forces.
+     */
+    Force_Layout(int numNodes, const std::vector<Edge>& edges, Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Places the nodes at seeded random positions and runs the iterations.
+     * @param config Force parameters and iteration budget.
+     */
+    void run(const Layout_Config& config);
+
+    /**
+     * @brief Gets the x coordinate of every node.
+     */
+    const std::vector<double>& getX() const;
+
+    /**
+     * @brief Gets the y coordinate of every node.
+     */
+    const std::vector<double>& getY() const;
+
+private:
+    /**
+     * @brief A square cell of the quadtree.
+     */
+    struct Cell {
+        double centerX, centerY; ///< Centre of mass.
+        double mass;             ///< Total mass.
+        double size;             ///< Side length.
+        int firstChild;          ///< Index of the first child, -1 for a leaf.
+        int numChildren;         ///< Non-empty children, stored contiguously.
+        int begin, end;          ///< Nodes of a leaf, as a range of `indices`.
+    };
+
+    int numNodes;                          ///< Number of nodes.
+    Thread_Pool& pool;                     ///< Pool accumulating the forces.
+    std::vector<size_t> offsets;           ///< Adjacency offsets (CSR), one per node plus one.
+    std::vector<int> neighbours;           ///< Neighbour of each adjacency slot.
+    std::vector<double> similarities;      ///< Similarity of each adjacency slot.
+    std::vector<double> mass;              ///< Degree + 1 of each node.
+    std::vector<double> x, y;              ///< Positions.
+    std::vector<double> forceX, forceY;    ///< Forces of the current iteration.
+    std::vector<double> oldForceX, oldForceY; ///< Forces of the previous iteration.
+    std::vector<Cell> cells;               ///< Quadtree of the current iteration; cell 0 is the root.
+    std::vector<int> indices;              ///< Nodes ordered by leaf.
+
+    /**
+     * @brief Builds the subtree of a cell over indices [begin, end).
+     */
+    void buildCell(int cell, int begin, int end, double minX, double minY, double size, int depth);
+
+    /**
+     * @brief Adds the Barnes-Hut repulsion on a node to its force.
+     */
+    void repel(int node, double coefficient, double theta);
+};
+
+#endif // FORCE_LAYOUT_H
@@ -0,0 +1,107 @@
+#ifndef GRAPH_WRITER_H
+#define GRAPH_WRITER_H
+
+#include "edge.h"
+#include "statements.h"
+#include "thread_pool.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief A numeric node attribute written as an extra column, GraphML key or binary column.
+ */
+struct Node_Attribute {
+    std::string name;           ///< Column name, also used as GraphML key id.
+    std::vector<double> values; ///< One value per node; nodes past the end are written as 0.
+};
+
+/**
+ * @class Graph_Writer
+ * @brief Writes graphs and their node metadata to CSV and GraphML files.
+ *
+ * Rows are formatted with fmt into large reusable buffers, one per chunk of rows. The chunks
+ * of the next wave are formatted on the pool while the current wave is written, and every
+ * wave is written in order, so the output does not depend on the number of threads. Text
+ * fields are XML-escaped in GraphML.
+ */
+class Graph_Writer {
+public:
+    /**
+     * @brief Creates a writer.
+     * @param pool Thread pool formatting the chunks.
+     */
+    explicit Graph_Writer(Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Writes edges as `source,target,weight` rows.
+     * @param filename Output file.
+     * @param edges Edges to write, in order.
+     * @return True on success.
+     */
+    bool writeEdgeCsv(const std::string& filename, const std::vector<Edge>& edges) const;
+
+    /**
+     * @brief Writes the verdict of nodes 0 to numNodes - 1 as `node_id,verdict` rows, followed
+     *        by one column per attribute.
+     * @param filename Output file.
+     * @param numNodes Number of nodes.
+     * @param statements Node metadata.
+     * @param attributes Extra numeric columns.
+     * @return True on success.
+     */
+    bool writeNodeCsv(const std::string& filename, int numNodes, const Statements& statements,
+                      const std::vector<Node_Attribute>& attributes = {}) const;
+
+    /**
+     * @brief Writes the nodes touched by the edges, with their metadata, and the edges to GraphML.
+     *
+     * Edge weights are written as the similarity scaled to [0, 100], `(1 - weight) * 100`.
+     *
+     * @param filename Output file.
+     * @param numNodes Number of nodes the edges may refer to.
+     * @param edges Edges to write, in order.
+     * @param statements Node metadata.
+     * @param attributes Extra numeric node attributes, written as `double` keys.
+     * @return True on success.
+     */
+    bool writeGraphML(const std::string& filename, int numNodes, const std::vector<Edge>& edges,
+                      const Statements& statements, const std::vector<Node_Attribute>& attributes = {}) const;
+
+    /**
+     * @brief Writes a graph as typed, 64-byte aligned columns that can be memory-mapped.
+     *
+     * Layout (little-endian), documented in documentation/pages/binary_graph.dox:
+     * - a 64-byte header: magic "FCTGRAPH", version, column count, node count, edge count;
+     * - a directory of 64-byte entries: column name, element type, data offset, element count;
+     * - the column data. Edges: `edge.source`, `edge.target` (int32), `edge.weight` (float64).
+     *   Nodes: `node.verdict` (uint8), `node.community`, `node.date` (int32, yyyymmdd), and the
+     *   dictionary codes `node.originator`, `node.source`, `node.factchecker` (int32), whose
+     *   strings are stored in `<name>.offsets` (int64) and `<name>.data` (uint8) columns.
+     *   Attributes follow as `node.<name>` (float64) columns.
+     *
+     * @param filename Output file.
+     * @param numNodes Number of nodes.
+     * @param edges Edges to write, in order.
+     * @param statements Node metadata.
+     * @param communities Community of each node, or empty for -1 everywhere.
+     * @param attributes Extra numeric node columns.
+     * @return True on success.
+     */
+    bool writeBinary(const std::string& filename, int numNodes, const std::vector<Edge>& edges,
+                     const Statements& statements, const std::vector<int>& communities,
+                     const std::vector<Node_Attribute>& attributes = {}) const;
+
+    /**
+     * @brief Reads community assignments from a CSV file of `node_id,community` rows.
+     * @param filename Input file; a non-numeric first line is taken as a header.
+     * @param numNodes Number of nodes.
+     * @param communities [Output] Community of each node, -1 if unassigned.
+     * @return True on success.
+     */
+    static bool readCommunities(const std::string& filename, int numNodes, std::vector<int>& communities);
+
+private:
+    Thread_Pool& pool; ///< Pool formatting the chunks.
+};
+
+#endif // GRAPH_WRITER_H
@@ -0,0 +1,97 @@
+#ifndef GROUP_NETWORK_H
+#define GROUP_NETWORK_H
+
+#include "graph_writer.h"
+#include "statements.h"
+#include "thread_pool.h"
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Statement field whose values become the nodes of a group network.
+ */
+enum class Group_Key {
+    ORIGINATOR, ///< Politicians, outlets and other originators.
+    SOURCE,     ///< Where the statement was made.
+    FACTCHECKER ///< Who checked the statement.
+};
+
+/**
+ * @brief Aggregates of the statements sharing a key value.
+ */
+struct Statement_Group {
+    std::string name;                 ///< Key value shared by the statements.
+    int statements = 0;               ///< Number of statements.
+    double weight = 0.0;              ///< Total weight of the statements with topics (words).
+    std::vector<double> topics;       ///< Weighted mean topic proportions.
+    std::array<int, 6> verdicts = {}; ///< Statements per verdict, indexed by Verdict.
+    int latestDate = 0;               ///< Latest statement date as yyyymmdd, 0 if none is valid.
+};
+
+/**
+ * @class Group_Network
+ * @brief Groups the document-topic matrix by originator, source or factchecker, so that the
+ *        similarity and MST stages run on one node per group instead of one per statement.
+ *
+ * The key is dictionary-encoded and the statements are bucketed by group with a counting
+ * sort; the aggregates are then computed in one parallel pass over the groups. Each statement
+ * is weighted by its number of words: topic proportions are estimated per token, so the
+ * weighted mean is the topic mix of all the text of the group.
+ */
+class Group_Network {
+public:
+    /**
+     * @brief Aggregates the statements.
+     * @param statements Statements with their topics.
+     * @param numTopics Number of topics.
+     * @param key Field to group by.
+     * @param pool Thread pool running the aggregation.
+     */
+    Group_Network(const Statements& statements, int numTopics, Group_Key key,
+                  Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Gets the groups, in order of their first statement.
+     */
+    const std::vector<Statement_Group>& getGroups() const;
+
+    /**
+     * @brief Gets the mean topic proportions of every group, one row per group.
+     */
+    std::vector<std::vector<double>> getTopicMatrix() const;
+
+    /**
+     * @brief Builds one statement per group for the graph exports.
+     *
+     * The grouped field and the comment hold the group name, the verdict is the most common
+     * one (ties to the truer verdict) and the date is the latest of the group.
+     */
+    Statements toStatements() const;
+
+    /**
+     * @brief Gets the aggregates as node attributes: `statements`, `verdict_<name>` counts and
+     *        `topic_<k>` mean proportions.
+     */
+    std::vector<Node_Attribute> getAttributes() const;
+
+    /**
+     * @brief Gets the name of a key: "originator", "source" or "factchecker".
+     */
+    static const char* keyName(Group_Key key);
+
+    /**
+     * @brief Parses a key name.
+     * @param text Text to parse.
+     * @param key [Output] Parsed key.
+     * @return True if the text was recognised.
+     */
+    static bool parseKey(const std::string& text, Group_Key& key);
+
+private:
+    int numTopics;                       ///< Number of topics.
+    Group_Key key;                       ///< Field grouped by.
+    std::vector<Statement_Group> groups; ///< Aggregates of each group.
+};
+
+#endif // GROUP_NETWORK_H
@@ -0,0 +1,178 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Measurements of one execution of a pipeline stage.
+ */
+struct Stage_Record {
+    std::string name;                       ///< Stage name (e.g. "similarity").
+    int64_t startMicros = 0;                ///< Start, relative to enable().
+    int64_t durationMicros = 0;             ///< Wall time.
+    uint32_t thread = 0;                    ///< Small id of the thread that ran the stage.
+    uint64_t bytes = 0;                     ///< Bytes read or written by the stage.
+    uint64_t items = 0;                     ///< Items processed by the stage (documents, pairs, edges...).
+    size_t rssStartBytes = 0;               ///< Resident memory when the stage started.
+    size_t rssEndBytes = 0;                 ///< Resident memory when the stage ended.
+    std::atomic<size_t> peakRssBytes{0};    ///< Highest resident memory sampled while the stage ran.
+    std::map<std::string, double> counters; ///< Stage-specific counters.
+};
+
+/**
+ * @class Instrumentation
+ * @brief Process-wide registry of stage timings, counters, throughput and memory.
+ *
+ * Disabled by default, in which case Scoped_Timer does nothing. Once enabled, a sampler thread
+ * reads the resident set size periodically and raises the peak of every stage running at that
+ * moment, so stages that overlap are still attributed their peak.
+ */
+class Instrumentation {
+public:
+    /**
+     * @brief Retrieves the registry.
+     */
+    static Instrumentation& instance();
+
+    /**
+     * @brief Starts recording and the memory sampler.
+     * @param samplingIntervalMs Period of resident memory sampling in milliseconds.
+     */
+    void enable(int samplingIntervalMs = 5);
+
+    /**
+     * @brief Whether stages are being recorded.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Opens a stage record (used by Scoped_Timer).
+     * @param name Stage name.
+     * @return The open record, or nullptr when disabled.
+     */
+    std::shared_ptr<Stage_Record> beginStage(const std::string& name);
+
+    /**
+     * @brief Closes a stage record (used by Scoped_Timer).
+     * @param record Record returned by beginStage().
+     */
+    void endStage(const std::shared_ptr<Stage_Record>& record);
+
+    /**
+     * @brief Adds to a run-wide counter.
+     * @param name Counter name.
+     * @param value Amount to add.
+     */
+    void addCounter(const std::string& name, double value);
+
+    /**
+     * @brief Writes every stage, a per-stage summary and the counters as JSON.
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeReport(const std::string& filename) const;
+
+    /**
+     * @brief Writes the stages as a Chrome trace (chrome://tracing, Perfetto).
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeChromeTrace(const std::string& filename) const;
+
+    /**
+     * @brief Current resident set size of the process in bytes (0 if unknown).
+     */
+    static size_t currentRss();
+
+    /**
+     * @brief Peak resident set size of the process in bytes (0 if unknown).
+     */
+    static size_t processPeakRss();
+
+    ~Instrumentation();
+
+private:
+    Instrumentation() = default;
+
+    /**
+     * @brief Microseconds since enable().
+     */
+    int64_t now() const;
+
+    /**
+     * @brief Returns a small stable id for the calling thread.
+     */
+    uint32_t threadId();
+
+    /**
+     * @brief Body of the memory sampler thread.
+     */
+    void sampleLoop(int intervalMs);
+
+    std::atomic<bool> enabled{false};                      ///< Recording switch.
+    std::chrono::steady_clock::time_point origin;           ///< Time of enable().
+    mutable std::mutex mutex;                               ///< Guards the members below.
+    std::vector<std::shared_ptr<Stage_Record>> finished;    ///< Closed stages.
+    std::vector<std::shared_ptr<Stage_Record>> active;      ///< Open stages.
+    std::map<std::string, double> counters;                 ///< Run-wide counters.
+    std::map<std::thread::id, uint32_t> threadIds;          ///< Small ids of threads seen so far.
+    std::vector<std::pair<int64_t, size_t>> rssSamples;     ///< (time, RSS) samples for the trace.
+    std::thread sampler;                                    ///< Memory sampler.
+    std::condition_variable stopSampler;                    ///< Wakes the sampler on shutdown.
+    bool stopping = false;                                  ///< Set by the destructor.
+};
+
+/**
+ * @class Scoped_Timer
+ * @brief Records the stage enclosing its lifetime.
+ */
+class Scoped_Timer {
+public:
+    /**
+     * @brief Opens the stage.
+     * @param name Stage name.
+     */
+    explicit Scoped_Timer(const std::string& name);
+
+    /**
+     * @brief Closes the stage.
+     */
+    ~Scoped_Timer();
+
+    Scoped_Timer(const Scoped_Timer&) = delete;
+    Scoped_Timer& operator=(const Scoped_Timer&) = delete;
+
+    /**
+     * @brief Adds to the bytes processed by the stage.
+     * @param bytes Byte count.
+     */
+    void addBytes(uint64_t bytes);
+
+    /**
+     * @brief Adds to the items processed by the stage.
+     * @param items Item count.
+     */
+    void addItems(uint64_t items);
+
+    /**
+     * @brief Adds to a stage-specific counter.
+     * @param name Counter name.
+     * @param value Amount to add.
+     */
+    void addCounter(const std::string& name, double value);
+
+private:
+    std::shared_ptr<Stage_Record> record; ///< Open record, nullptr when disabled.
+};
+
+#endif // INSTRUMENTATION_H
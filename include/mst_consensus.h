@@ -0,0 +1,147 @@
+#ifndef MST_CONSENSUS_H
+#define MST_CONSENSUS_H
+
+#include "edge.h"
+#include "execution_planner.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Where the replicas of a consensus come from.
+ */
+enum class Replica_Kind {
+    TOPIC_BOOTSTRAP, ///< Topic columns resampled with replacement from the fitted model.
+    LDA_SEEDS        ///< Topic models retrained with Mallet under different random seeds.
+};
+
+/**
+ * @brief Options of a consensus run.
+ */
+struct Consensus_Config {
+    Replica_Kind kind = Replica_Kind::TOPIC_BOOTSTRAP; ///< Source of the replicas.
+    int replicas = 100;                                ///< Number of replicas.
+    uint64_t seed = 1;                                 ///< Seed of the first replica; replica r uses seed + r.
+};
+
+/**
+ * @brief An edge of the consensus graph.
+ */
+struct Consensus_Edge {
+    int first;         ///< Smaller document.
+    int second;        ///< Larger document.
+    int count;         ///< Replicas whose MST holds the edge.
+    double support;    ///< Fraction of the replicas whose MST holds the edge.
+    double meanWeight; ///< Mean cosine distance over those replicas.
+};
+
+/**
+ * @class Mst_Consensus
+ * @brief Accumulates how often each document pair is an MST edge across replicas.
+ *
+ * Replicas are built and solved concurrently. Each worker asks the source for a replica
+ * matrix, computes its MST with the fastest exact engine that fits its share of the memory
+ * budget, and adds the tree to a hash map keyed by node pair. The map is split into shards,
+ * each behind its own mutex, so workers rarely contend. The number of concurrent workers is
+ * the largest one for which every worker's replica and engine fit the budget together.
+ */
+class Mst_Consensus {
+public:
+    /**
+     * @brief Fills the topic proportions of one replica, one row per document.
+     *
+     * Called concurrently for different replicas. Returns false on failure.
+     */
+    using Replica_Source = std::function<bool(int replica, std::vector<std::vector<double>>& documents)>;
+
+    /**
+     * @brief Creates an empty consensus.
+     * @param numDocuments Number of documents of every replica.
+     * @param numTopics Number of topics of every replica.
+     * @param pool Thread pool running the replicas and their MSTs.
+     */
+    Mst_Consensus(int numDocuments, int numTopics, Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Builds and solves the replicas and adds their trees.
+     * @param replicas Number of replicas.
+     * @param planner Memory budget and cores shared by all replicas.
+     * @param source Builds the matrix of a replica.
+     * @return False if a replica failed or no engine fits the budget.
+     */
+    bool run(int replicas, const Planner_Config& planner, const Replica_Source& source);
+
+    /**
+     * @brief Adds the MST of one replica. Safe to call concurrently.
+     * @param tree Edges of the tree.
+     */
+    void addTree(const std::vector<Edge>& tree);
+
+    /**
+     * @brief Gets the number of trees added.
+     */
+    int getNumTrees() const;
+
+    /**
+     * @brief Gets every edge seen, by decreasing support, then increasing mean weight.
+     */
+    std::vector<Consensus_Edge> getEdges() const;
+
+    /**
+     * @brief Writes the consensus graph as `source,target,support,count,mean_weight` rows.
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeCsv(const std::string& filename) const;
+
+    /**
+     * @brief Resamples the topic columns with replacement, as the phylogenetic bootstrap
+     *        resamples characters.
+     * @param documents Topic proportions of each document.
+     * @param seed Seed of the draw.
+     * @return The replica: column j of every row is the original column drawn j-th.
+     */
+    static std::vector<std::vector<double>> bootstrapTopics(const std::vector<std::vector<double>>& documents,
+                                                            uint64_t seed);
+
+    /**
+     * @brief Parses a consensus: "<bootstrap|lda>:<replicas>".
+     * @param text Text to parse.
+     * @param config [Output] Parsed options; the seed is left unchanged.
+     * @return True if the text was recognised.
+     */
+    static bool parseConfig(const std::string& text, Consensus_Config& config);
+
+private:
+    /**
+     * @brief Occurrences of one node pair.
+     */
+    struct Edge_Tally {
+        int count = 0;          ///< Trees holding the pair.
+        double weightSum = 0.0; ///< Sum of its weights in those trees.
+    };
+
+    /**
+     * @brief One shard of the concurrent map.
+     */
+    struct Shard {
+        std::mutex mutex;                                 ///< Guards `tallies`.
+        std::unordered_map<uint64_t, Edge_Tally> tallies; ///< Tallies keyed by (first << 32) | second.
+    };
+
+    static constexpr int shardBits = 6; ///< 64 shards.
+
+    int numDocuments;                 ///< Documents of every replica.
+    int numTopics;                    ///< Topics of every replica.
+    Thread_Pool& pool;                ///< Pool running the replicas.
+    std::unique_ptr<Shard[]> shards;  ///< Shards of the edge map.
+    std::atomic<int> numTrees{0};     ///< Trees added.
+};
+
+#endif // MST_CONSENSUS_H
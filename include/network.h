@@ -4,6 +4,37 @@
 #include <vector>
 #include <string>
 #include "edge.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Connectivity of a network keeping only the edges at or below a distance threshold.
+ */
+struct Percolation_Point {
+    double threshold;  ///< Largest edge weight kept.
+    int components;    ///< Connected components, counting singletons.
+    int giantSize;     ///< Nodes in the largest component.
+    int singletons;    ///< Nodes without any kept edge.
+};
+
+/**
+ * @brief Undirected graph in compressed sparse row form: the neighbours of node v are
+ *        `neighbours[offsets[v]]` to `neighbours[offsets[v + 1] - 1]`, in increasing order.
+ */
+struct Sparse_Graph {
+    std::vector<size_t> offsets;    ///< Start of each node's neighbours, plus the end.
+    std::vector<int> neighbours;    ///< Neighbour IDs; every edge appears once per endpoint.
+    std::vector<double> weights;    ///< Weight of each neighbour entry.
+
+    /**
+     * @brief Number of nodes.
+     */
+    int getNumNodes() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size() - 1); }
+
+    /**
+     * @brief Number of undirected edges.
+     */
+    size_t getNumEdges() const { return neighbours.size() / 2; }
+};
 
 /**
  * @brief Represents a network of nodes connected by edges.
@@ -28,8 +59,10 @@ public:
      * @brief Builds the network from a similarity matrix.
      * @param upperTriangle 1D array representing the upper triangular part of the similarity matrix.
      * @param numNodes Number of nodes in the network.
+     * @param pool Thread pool used to extract and sort the edges.
      */
-    void buildFromSimilarityMatrix(const std::vector<double>& upperTriangle, int numNodes);
+    void buildFromSimilarityMatrix(const std::vector<double>& upperTriangle, int numNodes,
+                                   Thread_Pool& pool = Thread_Pool::defaultPool());
 
     /**
      * @brief Retrieves all edges in the network.
@@ -37,6 +70,30 @@ public:
      */
     const std::vector<Edge>& getEdges() const;
 
+    /**
+     * @brief Replays edges in increasing weight through a union-find once, recording the
+     *        connectivity at every threshold.
+     *
+     * Components below a threshold only depend on the minimum spanning forest, so passing the
+     * MST instead of the full edge list gives the same points in O(n).
+     *
+     * @param numNodes Number of nodes.
+     * @param edges Edges, ideally already sorted by compareByWeight() (a sorted copy is made otherwise).
+     * @param thresholds Thresholds to report, in any order.
+     * @return One point per threshold, in the order given.
+     */
+    static std::vector<Percolation_Point> sweepPercolation(int numNodes, const std::vector<Edge>& edges,
+                                                           const std::vector<double>& thresholds);
+
+    /**
+     * @brief Converts an edge list to a symmetric CSR graph.
+     * @param numNodes Number of nodes.
+     * @param edges Edges; for sorted neighbour lists, with node1 < node2 and ordered by first then
+     *        second node.
+     * @return The graph.
+     */
+    static Sparse_Graph toSparseGraph(int numNodes, const std::vector<Edge>& edges);
+
     /**
      * @brief Prints the details of all edges in the network to the console.
      */
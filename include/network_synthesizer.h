@@ -5,9 +5,69 @@
 #include "network.h"
 #include "uf_ds.h"
 #include "statements.h"
+#include "execution_planner.h"
+#include "shard_coordinator.h"
+#include "thread_pool.h"
+#include "graph_writer.h"
+#include "distance_statistics.h"
 #include <vector>
 #include <string>
 
+/**
+ * @brief A document returned by a nearest-neighbour query.
+ */
+struct Similar_Document {
+    int document;    ///< Document index.
+    double distance; ///< Cosine distance to the query.
+};
+
+/**
+ * @brief Restricts a nearest-neighbour query to statements with the given metadata.
+ *
+ * Criteria left empty match every statement; filled ones must all match.
+ */
+struct Query_Filter {
+    std::vector<std::string> verdicts;    ///< Allowed verdicts ("true", "half-true", ...).
+    std::vector<std::string> originators; ///< Allowed originators.
+    std::string dateFrom;                 ///< Earliest statement date, "mm/dd/yyyy", inclusive.
+    std::string dateTo;                   ///< Latest statement date, "mm/dd/yyyy", inclusive.
+
+    /**
+     * @brief Whether the filter has no criteria.
+     */
+    bool isEmpty() const {
+        return verdicts.empty() && originators.empty() && dateFrom.empty() && dateTo.empty();
+    }
+};
+
+/**
+ * @brief One query of a batch: a document of the network or an arbitrary topic vector.
+ */
+struct Similarity_Query {
+    int document = -1;          ///< Query document, left out of its results; -1 to query `topics`.
+    std::vector<double> topics; ///< Topic proportions of the query when `document` is -1.
+};
+
+/**
+ * @brief Edge set of a graph export.
+ */
+enum class Graph_Kind {
+    MST,       ///< The minimum spanning tree.
+    KNN,       ///< Each document joined to its k nearest neighbours.
+    THRESHOLD, ///< Every pair within a cosine distance.
+    TMFG,      ///< Triangulated maximally filtered graph.
+    PMFG       ///< Planar maximally filtered graph.
+};
+
+/**
+ * @brief Selects the edges of a graph export.
+ */
+struct Graph_Export_Config {
+    Graph_Kind kind = Graph_Kind::MST; ///< Edge set.
+    int knnNeighbours = 16;            ///< Neighbours per document for Graph_Kind::KNN.
+    double maxDistance = 0.2;          ///< Largest cosine distance kept for Graph_Kind::THRESHOLD.
+};
+
 /**
  * @brief Synthesizes a network from document-topic data and computes the Minimum Spanning Tree (MST).
  */
@@ -17,8 +77,112 @@ public:
      * @brief Constructor for Network_Synthesizer.
      * @param statements Reference to the Statements object containing document-topic data.
      * @param numTopics Number of topics in the dataset.
+     * @param pool Thread pool shared with the other pipeline stages.
+     */
+    explicit Network_Synthesizer(const Statements& statements, int numTopics,
+                                 Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Constructor from a raw document-topic matrix.
+     * @param documents Topic proportions of each document (one row per document).
+     * @param numTopics Number of topics in the dataset.
+     * @param pool Thread pool shared with the other pipeline stages.
+     */
+    Network_Synthesizer(std::vector<std::vector<double>> documents, int numTopics,
+                        Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Constructor from a row-major document-topic matrix, which is moved in without copying.
+     * @param matrix numDocuments x numTopics proportions, row-major; resized to that if it differs.
+     * @param numDocuments Number of documents (rows).
+     * @param numTopics Number of topics in the dataset (columns).
+     * @param pool Thread pool shared with the other pipeline stages.
      */
-    explicit Network_Synthesizer(const Statements& statements, int numTopics);
+    Network_Synthesizer(std::vector<double> matrix, int numDocuments, int numTopics,
+                        Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Estimates every MST strategy for this problem size and picks one within budget.
+     *
+     * Logs the estimates and the decision. Nothing proportional to the number of pairs is
+     * allocated until the plan is executed.
+     *
+     * @param config Memory budget, cores and requirements of the caller.
+     * @return The chosen plan.
+     */
+    Execution_Plan planExecution(const Planner_Config& config) const;
+
+    /**
+     * @brief Runs the similarity and MST stages with the strategy chosen by the planner.
+     * @param plan Plan returned by planExecution().
+     */
+    void execute(const Execution_Plan& plan);
+
+    /**
+     * @brief Calculates the modulus (norm) of each document's topic vector.
+     */
+    void calculateDocumentModulus();
+
+    /**
+     * @brief Calculates the cosine similarity between two documents.
+     *
+     * Requires the moduli from calculateDocumentModulus().
+     *
+     * @param doc1 Index of the first document.
+     * @param doc2 Index of the second document.
+     * @return Cosine similarity value between the two documents.
+     */
+    double calculateCosineSimilarity(int doc1, int doc2) const;
+
+    /**
+     * @brief Builds the query index: unit-length document rows in one contiguous matrix.
+     *
+     * Must be called before findNearestDocuments(), and again after appendDocuments().
+     * Takes another n x numTopics doubles on top of the documents.
+     */
+    void buildQueryIndex();
+
+    /**
+     * @brief Builds the query index together with the metadata columns used by Query_Filter.
+     * @param statements Statements the documents were read from.
+     */
+    void buildQueryIndex(const Statements& statements);
+
+    /**
+     * @brief Finds the k documents closest to a document.
+     * @param document Index of the query document, which is left out of the results.
+     * @param k Number of documents to return.
+     * @param filter Metadata the returned documents must match.
+     * @return Up to k documents, closest first (ties by index).
+     */
+    std::vector<Similar_Document> findNearestDocuments(int document, int k, const Query_Filter& filter = Query_Filter()) const;
+
+    /**
+     * @brief Finds the k documents closest to a topic vector.
+     * @param topics Topic proportions of the query (numTopics values).
+     * @param k Number of documents to return.
+     * @param filter Metadata the returned documents must match.
+     * @return Up to k documents, closest first (ties by index).
+     */
+    std::vector<Similar_Document> findNearestDocuments(const std::vector<double>& topics, int k,
+                                                       const Query_Filter& filter = Query_Filter()) const;
+
+    /**
+     * @brief Finds the k documents closest to each query of a batch in a single pass.
+     *
+     * The matrix is scanned in cache-sized blocks on the pool. Each row of a block is scored
+     * against every query while it is in cache, so a batch costs about as much memory traffic
+     * as a single query. Rows rejected by the filter are skipped before scoring, and every
+     * chunk keeps a bounded heap per query. Exhaustive, so the results are exact. Safe to call
+     * concurrently.
+     *
+     * @param queries Query documents or topic vectors.
+     * @param k Number of documents to return per query.
+     * @param filter Metadata the returned documents must match.
+     * @return Results of each query in order; empty for a malformed query.
+     */
+    std::vector<std::vector<Similar_Document>> findNearestDocuments(const std::vector<Similarity_Query>& queries, int k,
+                                                                    const Query_Filter& filter = Query_Filter()) const;
 
     /**
      * @brief Calculates the similarity matrix for all document pairs.
@@ -35,6 +199,193 @@ public:
      */
     void findMST();
 
+    /**
+     * @brief Finds the MST with Prim's algorithm, computing distances on the fly.
+     *
+     * Needs no similarity matrix or edge list: memory is O(n) on top of the documents.
+     */
+    void findMSTFusedPrim();
+
+    /**
+     * @brief Builds a sparse network keeping the k nearest neighbours of each document.
+     *
+     * Follow with findMST() to obtain a minimum spanning forest of the kNN graph.
+     *
+     * @param k Number of neighbours per document.
+     */
+    void buildKnnNetwork(int k);
+
+    /**
+     * @brief Builds the Triangulated Maximally Filtered Graph (TMFG) of the documents.
+     *
+     * Starts from the tetrahedron of the four documents most similar to all others and
+     * repeatedly inserts the outside document into the triangular face it is closest to (lowest
+     * sum of cosine distances to the three corners), until every document is in. The result is
+     * a planar triangulation with 3n - 6 edges, an approximation of the PMFG.
+     *
+     * The best document of each face is kept in a lazily updated gain table, and faces are
+     * scored against all outside documents with the query index kernel in parallel chunks, so
+     * no similarity matrix is needed: memory is O(n) on top of the query index, time O(n^2 K).
+     * Builds the query index if it is missing.
+     *
+     * @return Edges sorted by compareByWeight(), with IDs in that order; every pair below four documents.
+     */
+    std::vector<Edge> findTMFG();
+
+    /**
+     * @brief Builds the Planar Maximally Filtered Graph (PMFG) of the documents.
+     *
+     * Walks the sorted edge list like Kruskal, keeping each edge if the graph stays planar,
+     * until 3n - 6 edges are kept. Edges between components are kept without a test, Euler's
+     * bound rejects candidates in components that are already full, and the left-right test
+     * of Planarity_Tester runs on the candidate's component only, for batches of candidates in
+     * parallel. Uses the edge list of the dense or kNN strategy, computing the dense one if it
+     * is missing (O(n^2) memory); with a kNN edge list the result is restricted to those edges.
+     * The dense list is built whatever the Execution_Planner memory budget, and its estimated
+     * size is logged.
+     *
+     * @return Edges sorted by compareByWeight(), with IDs in that order.
+     */
+    std::vector<Edge> findPMFG();
+
+    /**
+     * @brief Connectivity of the network at each distance threshold, from one union-find pass.
+     *
+     * Replays the MST, which yields the same components as the whole edge list at every
+     * threshold, so no edges need to be kept. Requires an MST.
+     *
+     * @param thresholds Distances to report, in any order.
+     * @return One point per threshold, in the order given.
+     */
+    std::vector<Percolation_Point> sweepThresholds(const std::vector<double>& thresholds) const;
+
+    /**
+     * @brief Builds the epsilon-graph, joining every pair within a cosine distance, as CSR.
+     *
+     * Pairs are computed on the fly in parallel and only kept edges are stored, so memory
+     * is proportional to the result.
+     *
+     * @param maxDistance Largest distance kept.
+     * @return The graph, with sorted neighbour lists.
+     */
+    Sparse_Graph buildEpsilonGraph(double maxDistance);
+
+    /**
+     * @brief Streams every pair's cosine distance into summaries, without storing the matrix.
+     *
+     * Rows are split into 64 chunks holding about the same number of pairs; each chunk fills
+     * its own summaries on the pool and the chunks are merged in order, so the result does not
+     * depend on the number of threads. Distances are computed on the fly from the topic rows,
+     * so memory does not grow with the number of pairs.
+     *
+     * @param labels Label of each document (its verdict, say); -1 counts only in the overall summary.
+     * @param labelNames Name of each label.
+     * @param bins Histogram bins over [0, 1].
+     * @return The overall summary and one per unordered pair of labels.
+     */
+    Distance_Statistics computeDistanceStatistics(const std::vector<int>& labels, const std::vector<std::string>& labelNames,
+                                                  int bins = 100) const;
+
+    /**
+     * @brief Computes the edges of a graph: the MST, kNN, threshold, TMFG or PMFG graph.
+     * @param config Edge set.
+     * @return Edges of the graph; the MST and edge list are not changed.
+     */
+    std::vector<Edge> findGraph(const Graph_Export_Config& config);
+
+    /**
+     * @brief Finds the MST by spilling sorted edge runs to disk and merging them through Kruskal.
+     *
+     * The merged, fully sorted edge stream is kept in `<directory>/edges_sorted.bin` as
+     * records of {double weight, int32 node1, int32 node2}.
+     *
+     * @param blockBytes Memory used for one sorted run.
+     * @param directory Scratch directory for the runs.
+     */
+    void findMSTOutOfCore(size_t blockBytes, const std::string& directory);
+
+    /**
+     * @brief Finds the MST with worker processes, each handling tiles of the triangle.
+     * @param config Worker count, shared directory and launch command.
+     * @return True if every worker succeeded.
+     */
+    bool findMSTSharded(const Shard_Config& config);
+
+    /**
+     * @brief Computes the minimum spanning forest of one tile of the triangle.
+     *
+     * The tile holds the pairs (i, j), i < j, with i in [rowBegin, rowEnd) and j in
+     * [columnBegin, columnEnd). Runs Prim over the tile's documents with distances computed on
+     * the fly, so memory is O(rows + columns) however many pairs the tile holds.
+     *
+     * @param rowBegin First row of the tile.
+     * @param rowEnd One past the last row of the tile.
+     * @param columnBegin First column of the tile.
+     * @param columnEnd One past the last column of the tile.
+     * @return Forest edges sorted by compareByWeight().
+     */
+    std::vector<Edge> findTileSpanningForest(int rowBegin, int rowEnd, int columnBegin, int columnEnd);
+
+    /**
+     * @brief Appends documents and updates the MST incrementally.
+     *
+     * Only the distances between each new document and the existing ones are computed (O(kn)).
+     * Each new document is inserted into the tree by a single post-order pass that keeps, for every
+     * cycle closed by a new edge, all but the heaviest edge. The union-find is extended in place.
+     * The similarity matrix and edge list no longer cover every document and are cleared.
+     *
+     * @param newDocuments Topic proportions of the new documents.
+     */
+    void appendDocuments(const std::vector<std::vector<double>>& newDocuments);
+
+    /**
+     * @brief Appends the statements whose IDs are beyond the current document count.
+     * @param statements Statements collection that has grown since construction.
+     */
+    void appendStatements(const Statements& statements);
+
+    /**
+     * @brief Retrieves the number of documents.
+     */
+    int getNumDocuments() const;
+
+    /**
+     * @brief Retrieves the number of topics.
+     */
+    int getNumTopics() const;
+
+    /**
+     * @brief Retrieves the document-topic matrix.
+     * @return numDocuments x numTopics proportions, row-major; moves when documents are appended.
+     */
+    const std::vector<double>& getDocumentMatrix() const;
+
+    /**
+     * @brief Retrieves the similarity matrix from calculateSimilarity().
+     * @return Cosine distances of the pairs i < j, row by row, or nothing if it was not computed.
+     */
+    const std::vector<double>& getUpperTriangle() const;
+
+    /**
+     * @brief Retrieves the edges of the MST.
+     * @return A reference to the MST edges, sorted by weight.
+     */
+    const std::vector<Edge>& getMST() const;
+
+    /**
+     * @brief Saves the MST as binary records of {double weight, int32 node1, int32 node2}.
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool saveMST(const std::string& filename) const;
+
+    /**
+     * @brief Replaces the MST with one saved by saveMST() for the same documents.
+     * @param filename Input file.
+     * @return True on success; false if the file is unreadable or does not match the documents.
+     */
+    bool loadMST(const std::string& filename);
+
     /**
      * @brief Exports the MST and node data to CSV files.
      * @param edgeFilename Filename for the MST edge CSV file.
@@ -50,6 +401,57 @@ public:
      */
     void exportMSTToGraphMLWithNodeData(const std::string& filename, const Statements& statements) const;
 
+    /**
+     * @brief Exports a graph with node metadata in the columnar binary format of Graph_Writer::writeBinary().
+     *
+     * Graphs other than the MST are computed on the fly by findGraph().
+     *
+     * @param filename Output file.
+     * @param statements Node metadata.
+     * @param config Edge set to export.
+     * @param communities Community of each document, or empty.
+     * @return True on success.
+     */
+    bool exportBinaryGraph(const std::string& filename, const Statements& statements,
+                           const Graph_Export_Config& config = Graph_Export_Config(),
+                           const std::vector<int>& communities = {});
+
+    /**
+     * @brief Exports edges that were already computed, such as a filtered graph, in the columnar
+     *        binary format.
+     * @param filename Output file.
+     * @param statements Node metadata.
+     * @param edges Edges to export.
+     * @param communities Community of each document, or empty.
+     * @return True on success.
+     */
+    bool exportBinaryGraph(const std::string& filename, const Statements& statements, const std::vector<Edge>& edges,
+                           const std::vector<int>& communities = {}) const;
+
+    /**
+     * @brief Attaches a numeric attribute to every document, written by the node exports.
+     *
+     * Attributes describe the current MST and are dropped when it changes (appendDocuments(),
+     * loadMST()).
+     *
+     * @param name Attribute name; replaces an attribute of the same name.
+     * @param values One value per document.
+     */
+    void setNodeAttribute(const std::string& name, std::vector<double> values);
+
+    /**
+     * @brief Gets the node attributes, in the order they were first set.
+     */
+    const std::vector<Node_Attribute>& getNodeAttributes() const;
+
+    /**
+     * @brief Parses an edge set: "mst", "knn:<k>", "threshold:<distance>", "tmfg" or "pmfg".
+     * @param text Text to parse.
+     * @param config [Output] Parsed edge set.
+     * @return True if the text was recognised.
+     */
+    static bool parseGraphExport(const std::string& text, Graph_Export_Config& config);
+
     /**
      * @brief Prints the similarity matrix (for debugging purposes).
      */
@@ -66,8 +468,10 @@ private:
     std::vector<double> upperTriangle;       ///< Upper triangular similarity matrix.
     std::vector<Edge> edges;                 ///< List of edges in the network.
     std::vector<Edge> mst;                   ///< Edges in the Minimum Spanning Tree (MST).
-    double mstWeight;                        ///< Total weight of the MST.
+    double mstWeight = 0.0;                  ///< Total weight of the MST.
     UF_DS uf;                                ///< Union-Find data structure for MST computation.
+    Thread_Pool& pool;                       ///< Thread pool running the parallel stages.
+    std::vector<Node_Attribute> nodeAttributes; ///< Extra columns of the node exports.
 
     /**
      * @brief Reads document-topic data from the Statements object.
@@ -76,20 +480,38 @@ private:
     void readDocumentTopics(const Statements& statements);
 
     /**
-     * @brief Calculates the modulus (norm) of each document's topic vector.
+     * @brief Finds the k nearest neighbours of each document, requiring the moduli.
+     * @return Distinct edges sorted by compareByWeight(), with IDs in that order.
      */
-    void calculateDocumentModulus();
+    std::vector<Edge> findKnnEdges(int k) const;
 
     /**
-     * @brief Calculates the cosine similarity between two documents.
-     * @param doc1 Index of the first document.
-     * @param doc2 Index of the second document.
-     * @return Cosine similarity value between the two documents.
+     * @brief Finds every pair within a cosine distance, requiring the moduli.
+     * @return Edges ordered by first then second document.
      */
-    double calculateCosineSimilarity(int doc1, int doc2) const;
+    std::vector<Edge> findThresholdEdges(double maxDistance) const;
+
+    /**
+     * @brief Inserts the last document into the MST (vertex insertion into a minimum spanning forest).
+     */
+    void insertLastDocumentIntoMST();
 
-    std::vector<std::vector<double>> documents; ///< Matrix of topic proportions for each document.
+    /**
+     * @brief Topic proportions of a document, numTopics values.
+     */
+    const double* documentRow(size_t document) const {
+        return documents.data() + document * static_cast<size_t>(numTopics);
+    }
+
+    std::vector<double> documents;              ///< Topic proportions, row-major: numDocuments x numTopics.
     std::vector<double> modulus;                ///< Modulus (norm) for each document's topic vector.
+
+    std::vector<double> normalized;             ///< Unit-length document rows, row-major (query index).
+    std::vector<int> verdictCodes;              ///< Verdict of each document, as an index into `verdictNames`.
+    std::vector<std::string> verdictNames;      ///< Distinct verdicts.
+    std::vector<int> originatorCodes;           ///< Originator of each document, as an index into `originatorNames`.
+    std::vector<std::string> originatorNames;   ///< Distinct originators.
+    std::vector<int> dateKeys;                  ///< Date of each document as yyyymmdd.
 };
 
 #endif // NETWORK_SYNTHESIZER_H
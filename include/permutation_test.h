@@ -0,0 +1,91 @@
+#ifndef PERMUTATION_TEST_H
+#define PERMUTATION_TEST_H
+
+#include "edge.h"
+#include "network.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Observed value of a statistic against its permutation null distribution.
+ */
+struct Permutation_Statistic {
+    std::string name;  ///< Statistic, e.g. "same_label_fraction".
+    double observed;   ///< Value under the real labels.
+    double nullMean;   ///< Mean over the permutations.
+    double nullStdDev; ///< Standard deviation over the permutations.
+    double zScore;     ///< (observed - nullMean) / nullStdDev, NaN if the null is constant.
+    double pValue;     ///< One-sided: (1 + permutations at least as large) / (1 + permutations).
+};
+
+/**
+ * @class Permutation_Test
+ * @brief Tests whether labels (verdicts) cluster along the edges of a graph by shuffling them.
+ *
+ * The statistics are the fraction of edges joining equal labels, the modularity of the
+ * partition by label and the number of edges inside each label; all are large when equal
+ * labels are adjacent. Edges are held as two int32 arrays and labels as one byte per node,
+ * so a permutation costs one shuffle and one pass over the edges and nodes. Permutations run
+ * in parallel, each drawing from its own counter-based random stream keyed by its index, so
+ * results do not depend on the number of threads.
+ */
+class Permutation_Test {
+public:
+    /**
+     * @brief Prepares a test on an edge list, such as the MST.
+     * @param numNodes Number of nodes.
+     * @param edges Undirected edges; self-loops and out-of-range nodes are ignored.
+     * @param labels Label of each node; values from labelNames.size() on mark unlabelled nodes,
+     *        which keep their place and count in no label.
+     * @param labelNames Name of each label, at most 255.
+     * @param pool Thread pool running the permutations.
+     */
+    Permutation_Test(int numNodes, const std::vector<Edge>& edges, std::vector<uint8_t> labels,
+                     std::vector<std::string> labelNames, Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Prepares a test on a sparse graph, such as an epsilon-graph.
+     */
+    Permutation_Test(const Sparse_Graph& graph, std::vector<uint8_t> labels, std::vector<std::string> labelNames,
+                     Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Computes the statistics under the real labels and under random permutations.
+     * @param permutations Number of permutations.
+     * @param seed Seed of the random streams.
+     * @return "same_label_fraction", "modularity" and "same_label_edges_<label>" for each label.
+     */
+    std::vector<Permutation_Statistic> run(int permutations, uint64_t seed) const;
+
+    /**
+     * @brief Writes `statistic,observed,null_mean,null_sd,z_score,p_value` rows.
+     * @param filename Output file.
+     * @param statistics Results of run().
+     * @return True on success.
+     */
+    static bool writeCsv(const std::string& filename, const std::vector<Permutation_Statistic>& statistics);
+
+private:
+    int numNodes;                          ///< Number of nodes.
+    std::vector<int32_t> sources;          ///< First node of each edge.
+    std::vector<int32_t> targets;          ///< Second node of each edge.
+    std::vector<uint32_t> degrees;         ///< Degree of each node.
+    std::vector<uint8_t> labels;           ///< Real label of each node.
+    std::vector<int32_t> labelled;         ///< Labelled nodes, whose labels are shuffled; empty if all are.
+    std::vector<std::string> labelNames;   ///< Name of each label.
+    Thread_Pool& pool;                     ///< Pool running the permutations.
+
+    /**
+     * @brief Fills one value per statistic for the given labels.
+     */
+    void evaluate(const uint8_t* nodeLabels, double* values) const;
+
+    /**
+     * @brief Builds the degree and labelled-node arrays once the edges are set.
+     */
+    void prepare();
+};
+
+#endif // PERMUTATION_TEST_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <tinyxml2.h>
+#include "thread_pool.h"
 
 /**
  * @brief Calculates the total number of words (tokens) in the corpus from the diagnostics file.
@@ -36,9 +37,11 @@ double* parseDiagnosticsForWordTopicProbs(const std::string& diagnosticsFile, in
  * @param numTopics Number of topics in the model.
  * @param wordTopicProbs Word-topic probabilities array.
  * @param numWords Number of words per topic.
+ * @param pool Thread pool the documents are spread over.
  * @return Array of document probabilities (size: numDocs).
  */
-double* calculateDocumentProbabilities(double* docTopicProbs, int numDocs, int numTopics, double* wordTopicProbs, size_t numWords);
+double* calculateDocumentProbabilities(double* docTopicProbs, int numDocs, int numTopics, double* wordTopicProbs, size_t numWords,
+                                       Thread_Pool& pool = Thread_Pool::defaultPool());
 
 /**
  * @brief Calculates the perplexity of the corpus.
@@ -0,0 +1,236 @@
+#ifndef PIPELINE_RUNNER_H
+#define PIPELINE_RUNNER_H
+
+#include "dendrogram.h"
+#include "execution_planner.h"
+#include "force_layout.h"
+#include "group_network.h"
+#include "mst_consensus.h"
+#include "network_synthesizer.h"
+#include "permutation_test.h"
+#include "shard_coordinator.h"
+#include "stage_cache.h"
+#include "stage_graph.h"
+#include "statements.h"
+#include "temporal_network.h"
+#include "thread_pool.h"
+#include "topic_generator.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Inputs and options of a full pipeline run.
+ */
+struct Pipeline_Config {
+    std::string input = "input/politifact_factcheck_data_cleaned.json"; ///< Statements JSON.
+    std::string profile = "profile1";       ///< Prefix of the Mallet files in ./temp.
+    Lda_Config lda;                         ///< Topic model parameters.
+    bool skipMallet = false;                ///< Use existing composition and diagnostics files.
+    std::string topicBackend = "mallet";    ///< Topic backend: "mallet" or "stub" (synthetic model, no Mallet needed).
+    double trainingTimeout = 0.0;           ///< Deadline of each backend process in seconds; 0 for none.
+    int chains = 1;                         ///< Training chains run concurrently; the one with the best log-likelihood is kept.
+    size_t perplexityWords = 200;           ///< Words per topic used for perplexity.
+    Planner_Config planner;                 ///< MST strategy selection.
+    int shards = 0;                         ///< Worker processes for the MST (0 = in-process).
+    Shard_Config shardConfig;               ///< Sharded MST options.
+    bool verifyShards = false;              ///< Check the sharded MST against fused Prim.
+    std::string cacheDirectory = "./temp/cache"; ///< Stage manifests and cached MSTs.
+    bool useCache = true;                   ///< Skip stages whose inputs have not changed.
+    std::string binaryGraph;                ///< Columnar binary graph output, or empty.
+    Graph_Export_Config binaryGraphEdges;   ///< Edge set of the binary graph.
+    std::string communitiesFile;            ///< `node_id,community` CSV for the binary graph, or empty.
+    bool buildFilteredGraph = false;        ///< Export a planar filtered graph next to the MST.
+    Graph_Kind filteredGraph = Graph_Kind::TMFG; ///< Graph_Kind::TMFG or Graph_Kind::PMFG.
+    bool computeLayout = false;             ///< Add ForceAtlas2 `x` and `y` node attributes to the exports.
+    Layout_Config layout;                   ///< Iterations and forces of the layout.
+    std::vector<double> percolationThresholds; ///< Thresholds of ./temp/percolation.csv; empty for 101 steps up to the heaviest MST edge.
+    int permutations = 0;                   ///< Label permutations of ./temp/permutation_tests.csv; 0 skips the test.
+    uint64_t permutationSeed = 1;           ///< Seed of the label permutations.
+    bool computeDistanceStatistics = false; ///< Write all-pair distance summaries to ./temp/distance_stats.json.
+    int distanceBins = 100;                 ///< Histogram bins of the distance summaries.
+    bool cutDendrogram = false;             ///< Write flat single-linkage clusters to ./temp/clusters.csv.
+    Cluster_Cut clusterCut;                 ///< Cut of the single-linkage dendrogram.
+    bool buildConsensus = false;            ///< Also build the MST consensus of replicas.
+    Consensus_Config consensus;             ///< Replicas of the consensus.
+    bool buildGroupNetwork = false;         ///< Also build the network of statement groups.
+    Group_Key groupKey = Group_Key::ORIGINATOR; ///< Field grouped by for the group network.
+    bool buildTemporal = false;             ///< Write an MST series over sliding date windows.
+    Temporal_Config temporal;               ///< Date windows of the series.
+};
+
+/**
+ * @class Pipeline_Runner
+ * @brief Runs import, topic modelling, perplexity, topic assignment, MST and exports, skipping
+ *        stages whose fingerprinted inputs and parameters are unchanged since the last run.
+ *
+ * Cached stages and their fingerprints:
+ * - mallet_import: input file hash, backend -> `<profile>.mallet`
+ * - lda_training: mallet_import fingerprint, K, alpha, beta, iterations, optimisation, seed, chains ->
+ *   composition, diagnostics and word-topic files
+ * - perplexity: composition and diagnostics hashes, K, words -> `means_data.csv`
+ * - mst: composition hash, K, metric and strategy family -> `<cache>/<profile>_mst.bin`
+ *
+ * Import and topic assignment are always rerun since they only fill memory, and so are the
+ * exports, which are cheap. The binary graph export runs only when an output is configured.
+ *
+ * The stages form a DAG run by Stage_Graph on the shared pool. Statements are streamed from
+ * the JSON import into the Mallet corpus file as they are parsed. Perplexity overlaps topic
+ * assignment, the MST and the exports, and the two exports overlap each other.
+ */
+class Pipeline_Runner {
+public:
+    /**
+     * @brief Creates a runner.
+     * @param config Inputs and options.
+     * @param pool Thread pool shared by every stage.
+     */
+    Pipeline_Runner(const Pipeline_Config& config, Thread_Pool& pool);
+
+    /**
+     * @brief Runs the pipeline.
+     * @return 0 on success, 1 on failure.
+     */
+    int run();
+
+    /**
+     * @brief Retrieves the statements of the last run, with their topics.
+     */
+    const Statements& getStatements() const;
+
+    /**
+     * @brief Retrieves the synthesizer holding the MST of the last run.
+     * @return Null if the run did not reach the MST stage.
+     */
+    const Network_Synthesizer* getNetworkSynthesizer() const;
+
+    /**
+     * @copydoc getNetworkSynthesizer() const
+     */
+    Network_Synthesizer* getNetworkSynthesizer();
+
+private:
+    Pipeline_Config config;   ///< Inputs and options.
+    Thread_Pool& pool;        ///< Shared thread pool.
+    Stage_Cache cache;        ///< Stage manifests.
+    Statements statements;    ///< Imported statements and their topics.
+    std::unique_ptr<Network_Synthesizer> networkSynthesizer; ///< Document matrix and MST.
+    Planner_Config stagePlanner; ///< config.planner resolved, with the budgets split across the overlapping MST stages.
+    std::vector<Edge> filteredGraph; ///< Edges of the filtered graph of the last run, reused by the binary export.
+
+    /**
+     * @brief Runs or reuses the Mallet import, writing the corpus file from the streamed statements.
+     * @param corpus Statement texts streamed by the import stage.
+     * @param imported Set by the import stage before it closes the channel, if it succeeded.
+     * @param importKey Fingerprint of the input.
+     * @param topicGenerator Generator running Mallet.
+     * @return False if the import or Mallet failed.
+     */
+    bool runMalletImport(Stage_Channel<std::string>& corpus, const std::atomic<bool>& imported,
+                         const Fingerprint& importKey, Topic_generator& topicGenerator);
+
+    /**
+     * @brief Runs or reuses the LDA training.
+     * @return False if Mallet failed.
+     */
+    bool runTraining(Topic_generator& topicGenerator, const Fingerprint& importKey);
+
+    /**
+     * @brief Trains the configured number of chains concurrently under consecutive seeds and
+     *        copies the files of the chain with the highest final log-likelihood to the profile.
+     * @return False if no chain succeeded.
+     */
+    bool trainChains(Topic_generator& topicGenerator);
+
+    /**
+     * @brief Runs or reuses the perplexity stage.
+     */
+    void runPerplexity(Topic_generator& topicGenerator, const std::string& compositionHash);
+
+    /**
+     * @brief Runs or reuses the MST stage.
+     * @return False if the MST could not be computed.
+     */
+    bool runMST(Network_Synthesizer& networkSynthesizer, const Statements& statements, const std::string& compositionHash);
+
+    /**
+     * @brief Computes the tree metrics of the MST, attaches them as node attributes and writes
+     *        ./temp/tree_metrics.json.
+     */
+    void runTreeAnalytics(Network_Synthesizer& networkSynthesizer, const Statements& statements);
+
+    /**
+     * @brief Lays out the MST with ForceAtlas2 and attaches the positions as `x` and `y` node
+     *        attributes.
+     */
+    void runLayout(Network_Synthesizer& networkSynthesizer);
+
+    /**
+     * @brief Derives the single-linkage dendrogram from the MST, writes ./temp/linkage.npy and,
+     *        if configured, the flat clusters.
+     * @return False if a file could not be written.
+     */
+    bool runDendrogram(const Network_Synthesizer& networkSynthesizer, const Statements& statements);
+
+    /**
+     * @brief Writes the component count, giant component and singletons at each threshold to
+     *        ./temp/percolation.csv.
+     * @return False if the file could not be written.
+     */
+    bool runPercolation(const Network_Synthesizer& networkSynthesizer);
+
+    /**
+     * @brief Tests whether verdicts cluster along the MST against label permutations and writes
+     *        ./temp/permutation_tests.csv.
+     * @return False if the file could not be written.
+     */
+    bool runPermutationTest(const Network_Synthesizer& networkSynthesizer, const Statements& statements);
+
+    /**
+     * @brief Streams every pair's distance into summaries, overall and by verdict pair, and
+     *        writes them to ./temp/distance_stats.json.
+     * @return False if the file could not be written.
+     */
+    bool runDistanceStatistics(const Network_Synthesizer& networkSynthesizer, const Statements& statements);
+
+    /**
+     * @brief Computes the MSTs of the configured replicas and writes their consensus, with the
+     *        support of every edge, to ./temp/consensus_edges.csv.
+     * @return False if a replica failed or the file could not be written.
+     */
+    bool runConsensus(Topic_generator& topicGenerator, const Statements& statements);
+
+    /**
+     * @brief Groups the statements by the configured key, computes the MST of the groups and
+     *        writes ./temp/<key>_mst_edges.csv, ./temp/<key>_node_data.csv and
+     *        ./temp/<key>_mst_with_data.graphml with the group aggregates as node attributes.
+     * @return False if there are too few groups.
+     */
+    bool runGroupNetwork(const Statements& statements);
+
+    /**
+     * @brief Builds an MST per date window and writes ./temp/temporal_windows.csv and
+     *        ./temp/temporal_mst_edges.csv.
+     * @return False if a file could not be written.
+     */
+    bool runTemporal(const Statements& statements);
+
+    /**
+     * @brief Builds the configured filtered graph, keeps it for the binary export and writes
+     *        ./temp/<tmfg|pmfg>_edges.csv and ./temp/<tmfg|pmfg>_with_data.graphml.
+     * @return False if a file could not be written.
+     */
+    bool runFilteredGraph(Network_Synthesizer& networkSynthesizer, const Statements& statements);
+
+    /**
+     * @brief Path of a file of the profile in ./temp.
+     */
+    std::string profileFile(const std::string& suffix) const;
+
+    /**
+     * @brief Cache key of a stage, per profile.
+     */
+    std::string stageName(const std::string& stage) const;
+};
+
+#endif // PIPELINE_RUNNER_H
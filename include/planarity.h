@@ -0,0 +1,66 @@
+#ifndef PLANARITY_H
+#define PLANARITY_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Planarity_Tester
+ * @brief Left-right planarity test (de Fraysseix and Rosenstiehl, as formulated by Brandes).
+ *
+ * Runs in O(n + m): a DFS orients the graph and computes lowpoints, and a second DFS checks
+ * that the back edges can be split between the two sides of the tree edges. Both traversals
+ * are iterative. Only answers whether the graph is planar; no embedding is built. A tester
+ * keeps its buffers between calls, so one instance per thread avoids reallocations.
+ */
+class Planarity_Tester {
+public:
+    /**
+     * @brief Tests whether a simple undirected graph is planar.
+     * @param numNodes Number of nodes.
+     * @param edges Edges as pairs of nodes in [0, numNodes), without loops or duplicates.
+     * @return True if the graph is planar.
+     */
+    bool isPlanar(int numNodes, const std::vector<std::pair<int, int>>& edges);
+
+private:
+    /**
+     * @brief Interval of return edges, from `low` up to `high`; -1 when empty.
+     */
+    struct Interval {
+        int low = -1;
+        int high = -1;
+        bool empty() const { return low < 0 && high < 0; }
+    };
+
+    /**
+     * @brief Return edges that must lie on the left and right side respectively.
+     */
+    struct Conflict_Pair {
+        Interval left;
+        Interval right;
+    };
+
+    std::vector<int> offsets, adjacency;    ///< Undirected adjacency (CSR) as edge IDs.
+    std::vector<int> source, target;        ///< Edge endpoints, oriented by the first DFS.
+    std::vector<char> oriented;             ///< Whether each edge has been oriented.
+    std::vector<int> height, parentEdge;    ///< DFS height and tree edge into each node.
+    std::vector<int> lowpt, lowpt2, nestingDepth; ///< Lowpoints and nesting order of each edge.
+    std::vector<int> outOffsets, outEdges;  ///< Oriented edges leaving each node, by nesting depth.
+    std::vector<int> ref, lowptEdge;        ///< Interval chains and lowest return edge.
+    std::vector<size_t> stackBottom;        ///< Conflict stack size when each edge was entered.
+    std::vector<int> next;                  ///< Next adjacency slot of each node on the DFS stack.
+    std::vector<char> returning;            ///< Whether a node is resuming after a tree edge.
+    std::vector<int> dfs;                   ///< DFS stack.
+    std::vector<Conflict_Pair> conflicts;   ///< Conflict pair stack.
+
+    void orient(int root);
+    bool test(int root);
+    bool addConstraints(int ei, int e);
+    void removeBackEdges(int e);
+    bool conflicting(const Interval& interval, int edge) const;
+    int lowest(const Conflict_Pair& pair) const;
+};
+
+#endif // PLANARITY_H
@@ -0,0 +1,94 @@
+#ifndef SHARD_COORDINATOR_H
+#define SHARD_COORDINATOR_H
+
+#include "edge.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Settings of a sharded (multi-process) MST computation.
+ */
+struct Shard_Config {
+    int workers = 4;       ///< Number of worker processes.
+    int blocks = 0;        ///< Row blocks of the triangle; 0 picks enough tiles to balance the workers.
+    std::string directory = "./temp/shards"; ///< Shared directory for the document matrix, manifest and forests.
+    std::string executable; ///< Path of the Factify binary that runs the workers.
+
+    /**
+     * @brief Command used to start one worker. Placeholders: {exe}, {dir}, {worker}.
+     *
+     * Empty runs the worker locally. Prefix with e.g. `ssh node{worker}` to spread workers across
+     * nodes that share the directory.
+     */
+    std::string launchCommand;
+};
+
+/**
+ * @class Shard_Coordinator
+ * @brief Splits the all-pairs stage into tiles handled by independent worker processes.
+ *
+ * The document×document triangle is cut into row blocks; tile (a, b) with a <= b holds the pairs
+ * between blocks a and b. Each worker computes the minimum spanning forest of its tiles and
+ * writes it to the shared directory. The coordinator merges the forests with a UF_DS-based
+ * Kruskal. An edge dropped inside a tile is the heaviest edge of a cycle there, so it cannot be in
+ * the global MST, and the merged tree equals the single-process one.
+ *
+ * Protocol, all inside the shared directory:
+ * - `documents.bin`: int64 rows, int32 columns, then rows×columns doubles (row-major).
+ * - `manifest.txt`: `blocks <B>` then one `worker <w> <a>,<b> ...` line per worker.
+ * - `forest_<w>.bin`: int64 count, then {double weight, int32 node1, int32 node2} records,
+ *   renamed into place only once complete.
+ * Workers report progress on stdout, which the coordinator reads through a pipe.
+ */
+class Shard_Coordinator {
+public:
+    /**
+     * @brief Constructs a coordinator.
+     * @param config Shard settings.
+     */
+    explicit Shard_Coordinator(const Shard_Config& config);
+
+    /**
+     * @brief Runs the workers and merges their forests.
+     * @param documents Document-topic matrix, row-major.
+     * @param numDocuments Number of documents (rows).
+     * @param numTopics Number of topics per document (columns).
+     * @param mst [Output] Edges of the merged MST, sorted by compareByWeight().
+     * @return True if every worker succeeded.
+     */
+    bool run(const std::vector<double>& documents, int numDocuments, int numTopics, std::vector<Edge>& mst) const;
+
+    /**
+     * @brief Entry point of a worker process.
+     * @param directory Shared directory written by the coordinator.
+     * @param workerId Index of this worker in the manifest.
+     * @return Process exit code (0 on success).
+     */
+    static int runWorker(const std::string& directory, int workerId);
+
+    /**
+     * @brief Returns the row range [begin, end) of a block.
+     * @param block Block index.
+     * @param blocks Number of blocks.
+     * @param numDocuments Number of documents.
+     */
+    static std::pair<int, int> blockRange(int block, int blocks, int numDocuments);
+
+private:
+    Shard_Config config; ///< Shard settings.
+
+    /**
+     * @brief Writes the document matrix and the tile assignment.
+     * @return True on success.
+     */
+    bool writeInputs(const std::vector<double>& documents, int numDocuments, int numTopics, int blocks) const;
+
+    /**
+     * @brief Launches one worker and relays its progress lines.
+     * @return True if the worker exited successfully.
+     */
+    bool launchWorker(int workerId) const;
+};
+
+#endif // SHARD_COORDINATOR_H
@@ -0,0 +1,118 @@
+#ifndef SIMILARITY_SERVER_H
+#define SIMILARITY_SERVER_H
+
+#include "network_synthesizer.h"
+#include "statements.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Similarity_Server
+ * @brief Answers similarity, MST-neighbourhood and community queries over a Unix domain socket.
+ *
+ * The statements, the document-topic matrix and the MST are loaded once by the caller and kept
+ * in memory. Clients send one JSON request per line and receive one JSON response per line:
+ *
+ * - `{"op": "similar", "document": 12, "k": 10}`, or with `"topics": [...]` instead of a document, or
+ *   `"documents": [...]` for one result list per document; an optional `"filter"` holds `"verdicts"`,
+ *   `"originators"`, `"from"` and `"to"` (mm/dd/yyyy)
+ * - `{"op": "neighbourhood", "document": 12, "depth": 2, "limit": 100}`
+ * - `{"op": "community", "document": 12, "limit": 100}`
+ * - `{"op": "statement", "document": 12}`
+ * - `{"op": "info"}`, `{"op": "load_communities", "file": "..."}`, `{"op": "shutdown"}`
+ * - `{"batch": [request, ...]}`, answered with `{"results": [response, ...]}`
+ *
+ * An optional `"id"` is echoed back. Errors are answered with `{"error": "..."}`.
+ *
+ * Each connection is served by its own thread, and the requests of a batch run on the pool.
+ * Queries take a shared lock, so they run concurrently; only reloading the communities takes
+ * it exclusively.
+ */
+class Similarity_Server {
+public:
+    /**
+     * @brief Creates a server over loaded data.
+     * @param statements Statements with their topics; must outlive the server.
+     * @param networkSynthesizer Synthesizer holding the documents and the MST; must outlive the server.
+     * @param pool Thread pool running the queries.
+     */
+    Similarity_Server(const Statements& statements, Network_Synthesizer& networkSynthesizer, Thread_Pool& pool);
+
+    /**
+     * @brief Loads community assignments from a CSV file of `node_id,community` rows.
+     * @param filename Input file; a non-numeric first line is taken as a header.
+     * @return True on success; the previous assignments are kept on failure.
+     */
+    bool loadCommunities(const std::string& filename);
+
+    /**
+     * @brief Answers one request line.
+     * @param line JSON request, or a batch of requests.
+     * @return JSON response, without the trailing newline.
+     */
+    std::string handleRequest(const std::string& line);
+
+    /**
+     * @brief Listens on a Unix domain socket until a shutdown request or stop().
+     * @param socketPath Path of the socket; an existing file there is replaced.
+     * @return True if the server ran; false if the socket could not be opened.
+     */
+    bool serve(const std::string& socketPath);
+
+    /**
+     * @brief Makes serve() return after closing every connection.
+     */
+    void stop();
+
+private:
+    const Statements& statements;            ///< Statements and their metadata.
+    Network_Synthesizer& networkSynthesizer; ///< Documents and MST.
+    Thread_Pool& pool;                       ///< Pool running the batched queries.
+
+    std::vector<int> offsets;                ///< MST adjacency offsets (CSR), one per document plus one.
+    std::vector<int> neighbours;             ///< MST adjacency targets.
+    std::vector<double> weights;             ///< MST adjacency weights.
+
+    std::vector<int> community;              ///< Community of each document, -1 if unassigned.
+    std::vector<std::vector<int>> members;   ///< Documents of each community.
+    std::string communitiesFile;             ///< File the communities came from.
+    mutable std::shared_mutex dataMutex;     ///< Shared by queries, exclusive for reloads.
+
+    std::atomic<bool> running{false};        ///< Cleared to stop serving.
+    int listener = -1;                       ///< Listening socket.
+    std::mutex connectionsMutex;             ///< Guards `clients`.
+    std::condition_variable disconnected;    ///< Signalled when a connection closes.
+    std::vector<int> clients;                ///< Open client sockets, one thread each.
+
+    /**
+     * @brief Serves one client until it disconnects.
+     * @param client Client socket.
+     */
+    void serveClient(int client);
+
+    /**
+     * @brief A node reached by a neighbourhood query.
+     */
+    struct Tree_Node {
+        int document;  ///< Node.
+        int parent;    ///< Node it was reached from, -1 for the start node.
+        int hops;      ///< Edges from the start node.
+        double weight; ///< Weight of the edge to the parent.
+    };
+
+    /**
+     * @brief Finds the MST nodes within `depth` edges of a document, breadth first.
+     * @param document Start node.
+     * @param depth Maximum number of edges.
+     * @param limit Maximum number of nodes returned.
+     * @return Nodes in breadth-first order, starting with the document itself.
+     */
+    std::vector<Tree_Node> findNeighbourhood(int document, int depth, int limit) const;
+};
+
+#endif // SIMILARITY_SERVER_H
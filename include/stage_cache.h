@@ -0,0 +1,116 @@
+#ifndef STAGE_CACHE_H
+#define STAGE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Fingerprint
+ * @brief Hash of everything a pipeline stage's outputs depend on.
+ *
+ * Parameters are added as named values; the names and values are kept so that a stale
+ * manifest can report what changed.
+ */
+class Fingerprint {
+public:
+    /**
+     * @brief Adds a parameter.
+     * @param name Parameter name.
+     * @param value Parameter value.
+     * @return This fingerprint, for chaining.
+     */
+    Fingerprint& add(const std::string& name, const std::string& value);
+
+    /**
+     * @brief Adds a numeric parameter.
+     * @param name Parameter name.
+     * @param value Parameter value.
+     * @return This fingerprint, for chaining.
+     */
+    Fingerprint& add(const std::string& name, double value);
+
+    /**
+     * @brief Retrieves the hash of the parameters as 16 hex digits.
+     */
+    std::string value() const;
+
+    /**
+     * @brief Retrieves the parameters in insertion order.
+     */
+    const std::vector<std::pair<std::string, std::string>>& getParameters() const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> parameters; ///< Named inputs of the stage.
+};
+
+/**
+ * @class Stage_Cache
+ * @brief Manifests of stage outputs, used to skip stages whose inputs have not changed.
+ *
+ * Each stage has a manifest `<directory>/<stage>.manifest` listing its fingerprint and the size
+ * and content hash of every output file. A stage is reusable when the fingerprint matches and
+ * every output is still on disk unchanged.
+ */
+class Stage_Cache {
+public:
+    /**
+     * @brief Opens the cache.
+     * @param directory Directory holding the manifests.
+     * @param enabled When false, nothing is ever reused (manifests are still written).
+     */
+    explicit Stage_Cache(const std::string& directory = "./temp/cache", bool enabled = true);
+
+    /**
+     * @brief Whether a stage's outputs are up to date.
+     * @param stage Stage name.
+     * @param fingerprint Fingerprint of the stage's current inputs.
+     * @return True if the stage can be skipped.
+     */
+    bool isValid(const std::string& stage, const Fingerprint& fingerprint) const;
+
+    /**
+     * @brief Writes the manifest of a stage that just ran.
+     * @param stage Stage name.
+     * @param fingerprint Fingerprint of the stage's inputs.
+     * @param outputs Files produced by the stage.
+     * @return True on success.
+     */
+    bool record(const std::string& stage, const Fingerprint& fingerprint, const std::vector<std::string>& outputs) const;
+
+    /**
+     * @brief Removes a stage's manifest, e.g. when the stage failed.
+     * @param stage Stage name.
+     */
+    void invalidate(const std::string& stage) const;
+
+    /**
+     * @brief Retrieves the directory holding the manifests.
+     */
+    const std::string& getDirectory() const;
+
+    /**
+     * @brief Hashes the contents of a file (64-bit FNV-1a) as 16 hex digits.
+     * @param filename File to hash.
+     * @return The hash, or an empty string if the file cannot be read.
+     */
+    static std::string hashFile(const std::string& filename);
+
+    /**
+     * @brief Hashes a string (64-bit FNV-1a) as 16 hex digits.
+     * @param data Bytes to hash.
+     */
+    static std::string hashString(const std::string& data);
+
+private:
+    std::string directory; ///< Manifest directory.
+    bool enabled;          ///< Whether stages may be skipped.
+
+    /**
+     * @brief Path of a stage's manifest.
+     */
+    std::string manifestPath(const std::string& stage) const;
+};
+
+#endif // STAGE_CACHE_H
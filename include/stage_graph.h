@@ -0,0 +1,150 @@
+#ifndef STAGE_GRAPH_H
+#define STAGE_GRAPH_H
+
+#include "thread_pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Stage_Graph
+ * @brief Runs pipeline stages as a DAG on the shared thread pool.
+ *
+ * A stage is scheduled as soon as all of its dependencies have succeeded, so independent stages
+ * overlap. A stage that fails (returns false or throws) is reported, and every stage depending
+ * on it, directly or not, is skipped. Stages may use the pool's parallel loops themselves.
+ */
+class Stage_Graph {
+public:
+    using Stage_Function = std::function<bool()>; ///< Stage body; returns false on failure.
+
+    /**
+     * @brief Adds a stage.
+     * @param name Stage name, used in messages.
+     * @param body Stage body.
+     * @param dependencies Stages that must succeed first (IDs returned by addStage()).
+     * @return ID of the new stage.
+     */
+    int addStage(const std::string& name, Stage_Function body, const std::vector<int>& dependencies = {});
+
+    /**
+     * @brief Runs every stage and waits for them.
+     * @param pool Pool the stages run on.
+     * @return True if every stage succeeded.
+     */
+    bool run(Thread_Pool& pool);
+
+private:
+    enum class State { PENDING, SUCCEEDED, FAILED, SKIPPED };
+
+    struct Stage {
+        std::string name;                ///< Stage name.
+        Stage_Function body;             ///< Stage body.
+        std::vector<int> dependents;     ///< Stages waiting on this one.
+        size_t numDependencies = 0;      ///< Number of dependencies.
+        size_t remaining = 0;            ///< Dependencies not finished yet.
+        bool blocked = false;            ///< A dependency failed or was skipped.
+        State state = State::PENDING;    ///< Outcome.
+    };
+
+    std::vector<Stage> stages; ///< Stages in insertion order.
+    std::mutex mutex;          ///< Guards the scheduling fields of `stages`.
+
+    /**
+     * @brief Runs stage `id` and releases its dependents.
+     */
+    void runStage(int id, Task_Group& group);
+
+    /**
+     * @brief Records the outcome of stage `id` and schedules or skips its dependents.
+     */
+    void finishStage(int id, State state, Task_Group& group);
+};
+
+/**
+ * @class Stage_Channel
+ * @brief Unbounded queue streaming items from a producer stage to a consumer stage.
+ *
+ * A consumer running on a pool worker executes pending pool tasks while it waits, so it can
+ * never starve a producer queued on the same pool.
+ */
+template <typename T>
+class Stage_Channel {
+public:
+    /**
+     * @brief Queues an item; dropped if the consumer called discard().
+     * @param item Item to send.
+     */
+    void push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (discarding) {
+                return;
+            }
+            items.push_back(std::move(item));
+        }
+        ready.notify_one();
+    }
+
+    /**
+     * @brief Signals that no more items will be pushed.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+    /**
+     * @brief Drops the queued items and every later push.
+     */
+    void discard() {
+        std::lock_guard<std::mutex> lock(mutex);
+        discarding = true;
+        items.clear();
+    }
+
+    /**
+     * @brief Takes the next item, waiting for one if necessary.
+     * @param pool Pool whose pending tasks are run while waiting on a worker.
+     * @param item [Output] Next item.
+     * @return False once the channel is closed and empty.
+     */
+    bool pop(Thread_Pool& pool, T& item) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!pool.isWorkerThread()) {
+                    ready.wait(lock, [this]() { return !items.empty() || closed; });
+                }
+                if (!items.empty()) {
+                    item = std::move(items.front());
+                    items.pop_front();
+                    return true;
+                }
+                if (closed) {
+                    return false;
+                }
+            }
+            if (!pool.runPendingTask()) {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait_for(lock, std::chrono::milliseconds(1), [this]() { return !items.empty() || closed; });
+            }
+        }
+    }
+
+private:
+    std::deque<T> items;              ///< Queued items.
+    std::mutex mutex;                 ///< Guards the members.
+    std::condition_variable ready;    ///< Signalled on push and close.
+    bool closed = false;              ///< No more pushes.
+    bool discarding = false;          ///< Pushes are dropped.
+};
+
+#endif // STAGE_GRAPH_H
@@ -20,6 +20,13 @@ enum class Verdict {
     PANTS_FIRE      ///< Statement is blatantly false.
 };
 
+/**
+ * @brief Converts a verdict to its PolitiFact name ("true", "mostly-true", ..., "pants-fire").
+ * @param verdict Verdict to convert.
+ * @return The name of the verdict.
+ */
+const char* verdictToString(Verdict verdict);
+
 /**
  * @class Statement
  * @brief Represents a statement with additional metadata including originator, source, and factcheck information.
@@ -31,7 +38,7 @@ public:
      * 
      * @param comment The text of the statement.
      * @param verdict The truthfulness verdict of the statement.
-     * @param date The date of the statement in "mm/dd/yyyy" format.
+     * @param date The date of the statement in "mm/dd/yyyy" format, or empty if unknown (left zeroed).
      * @param originator The originator of the statement.
      * @param source The source of the statement (e.g., news, speech).
      * @param factchecker The name of the factchecker.
@@ -43,7 +50,7 @@ public:
      * @brief Retrieves the comment of the statement.
      * @return The comment as a string.
      */
-    std::string getComment() const;
+    const std::string& getComment() const;
 
     /**
      * @brief Retrieves the verdict of the statement.
@@ -61,25 +68,25 @@ public:
      * @brief Retrieves the originator of the statement.
      * @return The originator as a string.
      */
-    std::string getOriginator() const;
+    const std::string& getOriginator() const;
 
     /**
      * @brief Retrieves the source of the statement.
      * @return The source as a string.
      */
-    std::string getSource() const;
+    const std::string& getSource() const;
 
     /**
      * @brief Retrieves the name of the factchecker.
      * @return The factchecker name as a string.
      */
-    std::string getFactchecker() const;
+    const std::string& getFactchecker() const;
 
     /**
      * @brief Retrieves the fact-checking date of the statement.
      * @return The fact-checking date as a string.
      */
-    std::string getFactcheckDate() const;
+    const std::string& getFactcheckDate() const;
 
 private:
     std::string comment;       ///< The text of the statement.
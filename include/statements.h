@@ -35,6 +35,14 @@ public:
      */
     void addTopics(int id, const std::vector<double>& topics);
 
+    /**
+     * @brief Looks up a statement by ID, without copying its fields.
+     * 
+     * @param id Identifier of the statement.
+     * @return The statement, or nullptr if the ID is unknown. Stays valid while the collection exists.
+     */
+    const Statement* findStatement(int id) const;
+
     /**
      * @brief Retrieves the comment of a statement by ID.
      * 
@@ -67,6 +75,14 @@ public:
      */
     std::string getOriginator(int id) const;
 
+    /**
+     * @brief Retrieves the date of a statement by ID.
+     * 
+     * @param id Identifier of the statement.
+     * @return The date, or a zeroed `std::tm` if the ID is unknown.
+     */
+    std::tm getDate(int id) const;
+
     /**
      * @brief Retrieves the source of a statement by ID.
      * 
@@ -0,0 +1,121 @@
+#ifndef SYNTHETIC_CORPUS_H
+#define SYNTHETIC_CORPUS_H
+
+#include "statements.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shape of a synthetic corpus.
+ */
+struct Synthetic_Config {
+    int numDocuments = 1000;   ///< Number of statements.
+    int numTopics = 60;        ///< Number of topics.
+    int vocabularySize = 5000; ///< Number of distinct words.
+    int wordsPerDocument = 20; ///< Words in each generated statement.
+    double alpha = 0.1;        ///< Dirichlet concentration of the document-topic proportions.
+    double beta = 0.05;        ///< Dirichlet concentration of the topic-word distributions.
+    uint64_t seed = 42;        ///< Seed; equal seeds give identical corpora.
+};
+
+/**
+ * @class Synthetic_Corpus
+ * @brief Seeded LDA-shaped corpus for benchmarks and scale tests.
+ *
+ * Document-topic proportions are drawn from Dirichlet(alpha) and topic-word distributions from
+ * Dirichlet(beta). Every document has its own random stream derived from the seed and its index,
+ * so document i is the same whatever the corpus size and generation runs in parallel.
+ */
+class Synthetic_Corpus {
+public:
+    /**
+     * @brief Generates the corpus.
+     * @param config Corpus shape and seed.
+     * @param pool Thread pool the documents are generated on.
+     */
+    explicit Synthetic_Corpus(const Synthetic_Config& config, Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Retrieves the configuration.
+     */
+    const Synthetic_Config& getConfig() const;
+
+    /**
+     * @brief Retrieves the topic proportions of every document (one row per document).
+     */
+    const std::vector<std::vector<double>>& getDocuments() const;
+
+    /**
+     * @brief Retrieves P(w|t) of the most probable words of each topic, in decreasing order.
+     * @param numWords Words per topic.
+     * @return Array of size numTopics * numWords, laid out as calculateDocumentProbabilities() expects.
+     */
+    std::vector<double> getWordTopicProbabilities(size_t numWords) const;
+
+    /**
+     * @brief Fills a Statements table with generated text, metadata and the topic proportions.
+     * @param statements Table to fill; IDs start at 0.
+     */
+    void fillStatements(Statements& statements) const;
+
+    /**
+     * @brief Writes the statements as PolitiFact-shaped JSON, as read by Topic_generator::importStoreData().
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool writeJson(const std::string& filename) const;
+
+    /**
+     * @brief Writes the document-topic proportions as a Mallet composition file.
+     * @param filename Output file (e.g. "./temp/profile1_composition.txt").
+     * @return True on success.
+     */
+    bool writeComposition(const std::string& filename) const;
+
+    /**
+     * @brief Writes a Mallet-style diagnostics file with per-topic metrics and top words.
+     * @param filename Output file (e.g. "./temp/profile1_diagnostics.xml").
+     * @param numWords Words listed per topic.
+     * @return True on success.
+     */
+    bool writeDiagnostics(const std::string& filename, size_t numWords) const;
+
+private:
+    /**
+     * @brief Text and metadata of one generated statement.
+     */
+    struct Record {
+        std::string comment;
+        std::string verdict;
+        std::string date;
+        std::string originator;
+        std::string source;
+        std::string factchecker;
+        std::string factcheckDate;
+    };
+
+    /**
+     * @brief Generates the text and metadata of every statement.
+     */
+    std::vector<Record> generateRecords() const;
+
+    Synthetic_Config config;                     ///< Corpus shape and seed.
+    std::vector<std::vector<double>> documents;  ///< Document-topic proportions.
+    std::vector<std::vector<int>> topicWords;    ///< Word ids of each topic by decreasing probability.
+    std::vector<std::vector<double>> topicProbs; ///< Probabilities matching `topicWords`.
+    Thread_Pool& pool;                           ///< Pool used by the generators.
+
+    /**
+     * @brief Seed of the random stream of item `index` in stream `stream`.
+     */
+    uint64_t streamSeed(uint64_t stream, uint64_t index) const;
+
+    /**
+     * @brief Spelling of word `id` of the vocabulary.
+     */
+    static std::string word(int id);
+};
+
+#endif // SYNTHETIC_CORPUS_H
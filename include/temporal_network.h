@@ -0,0 +1,134 @@
+#ifndef TEMPORAL_NETWORK_H
+#define TEMPORAL_NETWORK_H
+
+#include "edge.h"
+#include "statements.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Calendar unit of the window width and stride.
+ */
+enum class Time_Unit {
+    DAY,  ///< Calendar days.
+    MONTH ///< Calendar months.
+};
+
+/**
+ * @brief Sliding windows over the statement dates.
+ */
+struct Temporal_Config {
+    Time_Unit unit = Time_Unit::MONTH;  ///< Unit of `width` and `stride`.
+    int width = 1;                      ///< Units covered by each window.
+    int stride = 1;                     ///< Units between the starts of consecutive windows.
+    size_t memoryBudgetBytes = size_t(1) << 30; ///< Memory for the cached distances of all runs.
+};
+
+/**
+ * @brief MST and summary metrics of one window.
+ */
+struct Temporal_Window {
+    std::string start;               ///< First day of the window, yyyy-mm-dd.
+    std::string end;                 ///< Day after the window, yyyy-mm-dd.
+    std::vector<int> documents;      ///< Documents dated within the window, by date.
+    int newDocuments = 0;            ///< Documents that were not in the previous window.
+    std::vector<Edge> mst;           ///< MST over the documents, sorted by compareByWeight().
+    double mstWeight = 0.0;          ///< Total weight of the MST.
+    double maxEdge = 0.0;            ///< Heaviest MST edge.
+    double diameter = 0.0;           ///< Longest path of the MST.
+    double verdictAssortativity = 0.0; ///< Verdict assortativity along the MST, NaN if undefined.
+};
+
+/**
+ * @class Temporal_Network
+ * @brief Builds an MST per sliding window of statement dates.
+ *
+ * Documents are sorted by date, so every window is a contiguous range of that order and
+ * consecutive windows only add documents at the end and drop them at the start. Windows are
+ * split into runs of consecutive windows processed in parallel. Each run keeps the distances
+ * of its current window in a ring-indexed matrix, so a window only computes the distances of
+ * the documents it adds, and its MST is found by dense Prim over the cached distances. Windows
+ * whose matrix does not fit the memory budget compute their distances on the fly instead.
+ */
+class Temporal_Network {
+public:
+    /**
+     * @brief Reads the topics and dates of the statements.
+     *
+     * Statements without a valid date are left out of every window.
+     *
+     * @param statements Statements with their topics.
+     * @param numTopics Number of topics.
+     * @param pool Thread pool running the windows.
+     */
+    Temporal_Network(const Statements& statements, int numTopics, Thread_Pool& pool = Thread_Pool::defaultPool());
+
+    /**
+     * @brief Computes the windows, from the one holding the earliest statement to the one
+     *        holding the latest. Empty windows are kept, so the series is regular.
+     * @param config Window width, stride and memory budget.
+     * @return Windows in time order.
+     */
+    std::vector<Temporal_Window> run(const Temporal_Config& config);
+
+    /**
+     * @brief Distances computed by the last run().
+     */
+    size_t getComputedPairs() const;
+
+    /**
+     * @brief Distances of the last run() taken from the previous window instead of computed.
+     */
+    size_t getReusedPairs() const;
+
+    /**
+     * @brief Writes one row of metrics per window: window, start, end, documents, new_documents,
+     *        mst_weight, mean_edge, max_edge, diameter, verdict_assortativity.
+     * @param filename Output file.
+     * @param windows Windows returned by run().
+     * @return True on success.
+     */
+    static bool writeSeries(const std::string& filename, const std::vector<Temporal_Window>& windows);
+
+    /**
+     * @brief Writes the MST edges of every window as `window,source,target,weight` rows.
+     * @param filename Output file.
+     * @param windows Windows returned by run().
+     * @return True on success.
+     */
+    static bool writeEdges(const std::string& filename, const std::vector<Temporal_Window>& windows);
+
+    /**
+     * @brief Parses windows: "<day|month>:<width>[:<stride>]"; the stride defaults to one unit.
+     * @param text Text to parse.
+     * @param config [Output] Parsed windows; the memory budget is left unchanged.
+     * @return True if the text was recognised.
+     */
+    static bool parseConfig(const std::string& text, Temporal_Config& config);
+
+private:
+    int numTopics;                 ///< Number of topics.
+    Thread_Pool& pool;             ///< Thread pool running the windows.
+    std::vector<double> rows;      ///< Unit-length topic rows of the dated documents, in date order.
+    std::vector<int> order;        ///< Document of each row.
+    std::vector<int> days;         ///< Date of each row, in days since 1970-01-01.
+    std::vector<int> verdicts;     ///< Verdict of each row.
+    size_t computedPairs = 0;      ///< Distances computed by the last run.
+    size_t reusedPairs = 0;        ///< Distances reused by the last run.
+
+    /**
+     * @brief Cosine distance between two rows.
+     */
+    double distance(size_t a, size_t b) const;
+
+    /**
+     * @brief Fills the MST and metrics of a window covering rows [begin, end).
+     * @param distanceOf Distance between two rows of the window, by local index.
+     */
+    template <typename Distance>
+    void buildWindow(Temporal_Window& window, size_t begin, size_t end, Distance&& distanceOf) const;
+};
+
+#endif // TEMPORAL_NETWORK_H
@@ -0,0 +1,221 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Thread_Pool
+ * @brief Work-stealing task scheduler shared by every stage of the pipeline.
+ *
+ * Each worker owns a deque: it pops its own tasks LIFO and steals from the other workers FIFO.
+ * Exactly `numThreads` workers run tasks, so CPU usage stays predictable when several jobs share
+ * a node. Threads outside the pool that wait for work block instead of executing it. Workers
+ * that wait on nested work keep executing tasks, so nested parallelFor calls cannot deadlock.
+ */
+class Thread_Pool {
+public:
+    using Task = std::function<void()>; ///< Unit of work.
+
+    /**
+     * @brief Starts the workers.
+     * @param numThreads Number of workers; 0 uses std::thread::hardware_concurrency().
+     * @param pinThreads Pin worker i to the i-th CPU the process may run on.
+     */
+    explicit Thread_Pool(unsigned int numThreads = 0, bool pinThreads = false);
+
+    /**
+     * @brief Finishes the queued tasks and joins the workers.
+     */
+    ~Thread_Pool();
+
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+    /**
+     * @brief Retrieves the number of workers.
+     */
+    unsigned int getNumThreads() const;
+
+    /**
+     * @brief Queues a task. Workers push onto their own deque, other threads round-robin.
+     * @param task Task to run.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Runs `body(chunkBegin, chunkEnd)` over [begin, end) split into chunks, and waits.
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param body Callable taking a half-open index range.
+     * @param grain Chunk size; 0 makes about four chunks per worker.
+     */
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, Body&& body, size_t grain = 0);
+
+    /**
+     * @brief Sorts a random-access range: chunks are sorted concurrently, then merged pairwise.
+     * @param first Begin of the range.
+     * @param last End of the range.
+     * @param comp Strict weak ordering.
+     */
+    template <typename Iterator, typename Compare>
+    void parallelSort(Iterator first, Iterator last, Compare comp);
+
+    /**
+     * @brief Executes one queued task on the calling worker (own deque first, then stealing).
+     * @return False if the caller is not a worker of this pool or no task was available.
+     */
+    bool runPendingTask();
+
+    /**
+     * @brief Whether the calling thread is a worker of this pool.
+     */
+    bool isWorkerThread() const;
+
+    /**
+     * @brief Pool used by components that were not handed one explicitly.
+     */
+    static Thread_Pool& defaultPool();
+
+private:
+    struct Worker_Queue {
+        std::mutex mutex;        ///< Guards `tasks`.
+        std::deque<Task> tasks;  ///< Owner pops the back, thieves the front.
+    };
+
+    std::vector<std::unique_ptr<Worker_Queue>> queues; ///< One deque per worker.
+    std::vector<std::thread> threads;                  ///< Workers.
+    std::mutex sleepMutex;                             ///< Guards sleeping and `stopping`.
+    std::condition_variable wakeUp;                    ///< Signalled when tasks arrive or on shutdown.
+    std::atomic<size_t> pendingTasks{0};               ///< Tasks queued and not yet taken.
+    std::atomic<unsigned int> nextQueue{0};            ///< Round-robin target for external submissions.
+    bool stopping = false;                             ///< Set by the destructor.
+
+    /**
+     * @brief Main loop of worker `index`.
+     */
+    void workerLoop(unsigned int index);
+
+    /**
+     * @brief Takes a task from worker `index`'s deque, or steals one.
+     */
+    bool popTask(unsigned int index, Task& task);
+
+    /**
+     * @brief Pins a worker thread to a CPU.
+     */
+    static void pinThread(std::thread& thread, unsigned int index);
+};
+
+/**
+ * @class Task_Group
+ * @brief Set of tasks that can be waited on together.
+ *
+ * wait() rethrows the first exception raised by a task.
+ */
+class Task_Group {
+public:
+    /**
+     * @brief Creates an empty group on a pool.
+     * @param pool Pool executing the tasks.
+     */
+    explicit Task_Group(Thread_Pool& pool);
+
+    /**
+     * @brief Waits for the outstanding tasks.
+     */
+    ~Task_Group();
+
+    Task_Group(const Task_Group&) = delete;
+    Task_Group& operator=(const Task_Group&) = delete;
+
+    /**
+     * @brief Queues a task in the group.
+     * @param task Task to run.
+     */
+    void run(Thread_Pool::Task task);
+
+    /**
+     * @brief Waits until every task of the group has finished.
+     *
+     * Workers of the pool keep executing tasks while they wait; other threads block.
+     */
+    void wait();
+
+private:
+    Thread_Pool& pool;                   ///< Executing pool.
+    std::atomic<size_t> outstanding{0};  ///< Tasks not finished yet.
+    std::mutex mutex;                    ///< Guards `error` and completion signalling.
+    std::condition_variable done;        ///< Signalled when `outstanding` reaches zero.
+    std::exception_ptr error;            ///< First exception raised by a task.
+};
+
+template <typename Body>
+void Thread_Pool::parallelFor(size_t begin, size_t end, Body&& body, size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+        grain = std::max<size_t>(1, count / (4 * static_cast<size_t>(getNumThreads())));
+    }
+    if (count <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    Task_Group group(*this);
+    for (size_t chunk = begin; chunk < end; chunk += grain) {
+        const size_t stop = std::min(end, chunk + grain);
+        group.run([&body, chunk, stop]() { body(chunk, stop); });
+    }
+    group.wait();
+}
+
+template <typename Iterator, typename Compare>
+void Thread_Pool::parallelSort(Iterator first, Iterator last, Compare comp) {
+    const size_t count = static_cast<size_t>(std::distance(first, last));
+    const size_t chunks = std::min<size_t>(getNumThreads(), count / 4096);
+    if (chunks < 2) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t c = 0; c <= chunks; ++c) {
+        bounds[c] = count * c / chunks;
+    }
+    parallelFor(0, chunks, [&](size_t c0, size_t c1) {
+        for (size_t c = c0; c < c1; ++c) {
+            std::sort(first + bounds[c], first + bounds[c + 1], comp);
+        }
+    }, 1);
+
+    // Merge neighbouring sorted runs until one is left
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        parallelFor(0, merges, [&](size_t m0, size_t m1) {
+            for (size_t m = m0; m < m1; ++m) {
+                const size_t lo = 2 * width * m;
+                const size_t mid = std::min(chunks, lo + width);
+                const size_t hi = std::min(chunks, lo + 2 * width);
+                if (mid < hi) {
+                    std::inplace_merge(first + bounds[lo], first + bounds[mid], first + bounds[hi], comp);
+                }
+            }
+        }, 1);
+    }
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,199 @@
+#ifndef TOPIC_BACKEND_H
+#define TOPIC_BACKEND_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parameters of the Mallet LDA training.
+ */
+struct Lda_Config {
+    int numTopics = 60;         ///< Number of topics.
+    double alpha = 50.0;        ///< Sum of the Dirichlet prior over topics (Mallet --alpha).
+    double beta = 0.05;         ///< Dirichlet prior over words (Mallet --beta).
+    int iterations = 1000;      ///< Gibbs sampling iterations.
+    int optimizeInterval = 20;  ///< Iterations between hyperparameter optimisations.
+    int optimizeBurnIn = 50;    ///< Iterations before the first optimisation.
+    int seed = 0;               ///< Mallet --random-seed; 0 lets Mallet seed from the clock.
+};
+
+/**
+ * @brief One training chain: reads ./temp/<input>.mallet and writes ./temp/<output>_composition.txt,
+ *        _diagnostics.xml and _word_topic.txt.
+ */
+struct Training_Job {
+    std::string input;  ///< Profile of the imported corpus.
+    Lda_Config config;  ///< Topics, priors, iterations and seed.
+    std::string output; ///< Prefix of the output files.
+};
+
+/**
+ * @brief Progress of a chain, reported while it trains.
+ */
+struct Training_Progress {
+    int job;              ///< Index of the job in the batch.
+    int iteration;        ///< Iterations done.
+    int iterations;       ///< Iterations planned.
+    double logLikelihood; ///< Log-likelihood per token at this iteration, NaN if not reported.
+};
+
+/**
+ * @brief Outcome of a chain.
+ */
+struct Training_Result {
+    bool ok = false;          ///< The chain finished and succeeded.
+    bool timedOut = false;    ///< The chain was stopped at its deadline.
+    bool cancelled = false;   ///< The chain was stopped by cancel().
+    int exitCode = -1;        ///< Exit code of the process, -1 if it did not exit normally.
+    double logLikelihood = std::numeric_limits<double>::quiet_NaN(); ///< Last log-likelihood per token reported, NaN if none.
+    double seconds = 0.0;     ///< Wall time of the chain.
+    std::string output;       ///< Last lines the process printed, for error reports.
+};
+
+/**
+ * @brief Options shared by every run of a backend.
+ */
+struct Backend_Options {
+    std::chrono::duration<double> timeout{0};                 ///< Deadline of each process; zero for none.
+    std::function<void(const Training_Progress&)> onProgress; ///< Called from the monitoring thread.
+};
+
+/**
+ * @class Topic_Backend
+ * @brief Topic model engine behind Topic_generator: imports a corpus and trains chains.
+ *
+ * Implementations are safe to call from several threads at once, and cancel() stops every
+ * chain in progress.
+ */
+class Topic_Backend {
+public:
+    virtual ~Topic_Backend() = default;
+
+    /**
+     * @brief Name of the backend, as accepted by create().
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Imports a corpus file with one statement per line into ./temp/<output>.mallet.
+     * @return True on success.
+     */
+    virtual bool importCorpus(const std::string& corpusFile, const std::string& output) = 0;
+
+    /**
+     * @brief Trains several chains, up to `concurrency` at a time, and waits for all of them.
+     * @param jobs Chains to train.
+     * @param concurrency Largest number of chains running at once.
+     * @return One result per job, in order.
+     */
+    virtual std::vector<Training_Result> train(const std::vector<Training_Job>& jobs, int concurrency) = 0;
+
+    /**
+     * @brief Trains one chain.
+     */
+    Training_Result train(const Training_Job& job);
+
+    /**
+     * @brief Stops every chain in progress; later runs start normally.
+     */
+    void cancel();
+
+    /**
+     * @brief Sets the deadline and progress callback of later runs.
+     */
+    void setOptions(Backend_Options options);
+
+    /**
+     * @brief Creates a backend by name: "mallet" or "stub".
+     * @return The backend, or nullptr if the name is unknown.
+     */
+    static std::unique_ptr<Topic_Backend> create(const std::string& name);
+
+protected:
+    std::atomic<unsigned> generation{0}; ///< Incremented by cancel(); runs stop when it changes.
+
+    /**
+     * @brief Copy of the options, taken when a run starts.
+     */
+    Backend_Options snapshot() const;
+
+private:
+    mutable std::mutex optionsMutex; ///< Guards `options`.
+    Backend_Options options;         ///< Deadline and progress callback.
+};
+
+/**
+ * @class Mallet_Backend
+ * @brief Runs the Mallet command line tool as child processes.
+ *
+ * Processes are started with posix_spawn, without a shell, and their output is read through
+ * pipes by one monitoring loop per run, which parses Mallet's "<iteration> LL/token: x" lines
+ * into progress reports, keeps the last lines for error messages and stops processes past
+ * their deadline. On Windows the processes run one at a time through the shell instead,
+ * without progress or deadlines.
+ */
+class Mallet_Backend : public Topic_Backend {
+public:
+    /**
+     * @brief Creates the backend.
+     * @param executable Mallet launcher, looked up on the PATH.
+     */
+    explicit Mallet_Backend(std::string executable = "mallet");
+
+    std::string name() const override;
+    bool importCorpus(const std::string& corpusFile, const std::string& output) override;
+    std::vector<Training_Result> train(const std::vector<Training_Job>& jobs, int concurrency) override;
+    using Topic_Backend::train;
+
+    /**
+     * @brief Arguments of the Mallet command that trains a chain.
+     */
+    std::vector<std::string> trainArguments(const Training_Job& job) const;
+
+private:
+    std::string executable; ///< Mallet launcher.
+
+    /**
+     * @brief Runs commands, up to `concurrency` at a time, reporting progress for each.
+     */
+    std::vector<Training_Result> runProcesses(const std::vector<std::vector<std::string>>& commands,
+                                              const std::vector<int>& iterations, int concurrency);
+};
+
+/**
+ * @class Stub_Backend
+ * @brief Backend for tests and demonstrations that needs no Mallet installation.
+ *
+ * Importing records the number of lines of the corpus; training writes a seeded synthetic
+ * model (Synthetic_Corpus) of that many documents in Mallet's file formats, reporting progress
+ * every ten iterations with a made-up, rising log-likelihood.
+ */
+class Stub_Backend : public Topic_Backend {
+public:
+    /**
+     * @brief Creates the backend.
+     * @param iterationDelay Time each iteration takes, to exercise deadlines and cancellation.
+     */
+    explicit Stub_Backend(std::chrono::microseconds iterationDelay = std::chrono::microseconds(0));
+
+    std::string name() const override;
+    bool importCorpus(const std::string& corpusFile, const std::string& output) override;
+    std::vector<Training_Result> train(const std::vector<Training_Job>& jobs, int concurrency) override;
+    using Topic_Backend::train;
+
+private:
+    std::chrono::microseconds iterationDelay; ///< Simulated time per iteration.
+
+    /**
+     * @brief Trains one chain on the calling thread.
+     */
+    Training_Result trainOne(const Training_Job& job, int index, unsigned startGeneration, const Backend_Options& run) const;
+};
+
+#endif // TOPIC_BACKEND_H
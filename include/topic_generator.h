@@ -3,12 +3,18 @@
 
 #include <string>
 #include "statements.h"
+#include "thread_pool.h"
+#include "topic_backend.h"
 #include <cstdlib>
+#include <functional>
 #include <map>
+#include <memory>
 
 /**
  * @class Topic_generator
  * @brief Generates and assigns topics to statements using Mallet and perplexity calculations.
+ *
+ * Corpus import and training go through a Topic_Backend, Mallet_Backend by default.
  */
 class Topic_generator {
 public:
@@ -18,12 +24,22 @@ public:
      */
     Topic_generator();
 
+    /**
+     * @brief Constructor for Topic_generator sharing the pipeline's thread pool.
+     * @param pool Thread pool used by the perplexity calculations.
+     */
+    explicit Topic_generator(Thread_Pool& pool);
+
     /**
      * @brief Imports and stores data from a JSON file into a `Statements` object.
      * 
      * @param statements Reference to the `Statements` object where data will be stored.
+     * @param filename PolitiFact-shaped JSON file to import.
+     * @param onStatement Called with the ID and text of each statement as soon as it is stored.
      */
-    void importStoreData(Statements& statements);
+    void importStoreData(Statements& statements,
+                         const std::string& filename = "input/politifact_factcheck_data_cleaned.json",
+                         const std::function<void(int, const std::string&)>& onStatement = nullptr);
 
     /**
      * @brief Cleans the input data (placeholder function).
@@ -44,8 +60,18 @@ public:
      * 
      * @param statements Reference to the `Statements` object containing statement data.
      * @param output Name of the output file for the Mallet profile.
+     * @return True if Mallet succeeded.
      */
-    void buildMalletProfile(Statements& statements, const std::string& output);
+    bool buildMalletProfile(Statements& statements, const std::string& output);
+
+    /**
+     * @brief Imports a corpus file with one statement per line into a Mallet profile.
+     * 
+     * @param corpusFile Text file with one statement per line.
+     * @param output Name of the output file for the Mallet profile.
+     * @return True if Mallet succeeded.
+     */
+    bool importMalletCorpus(const std::string& corpusFile, const std::string& output);
 
     /**
      * @brief Generates topics using the Mallet tool.
@@ -53,8 +79,40 @@ public:
      * @param input Name of the Mallet input file.
      * @param numTopics Number of topics to generate.
      * @param output Name of the output file prefix for topic data.
+     * @return True if Mallet succeeded.
+     */
+    bool generateTopics(const std::string& input, int numTopics, const std::string& output);
+
+    /**
+     * @brief Generates topics using the Mallet tool with explicit training parameters.
+     * 
+     * @param input Name of the Mallet input file.
+     * @param config Number of topics, priors and iteration counts.
+     * @param output Name of the output file prefix for topic data.
+     * @return True if Mallet succeeded.
+     */
+    bool generateTopics(const std::string& input, const Lda_Config& config, const std::string& output);
+
+    /**
+     * @brief Trains several chains concurrently, such as the same model under different seeds.
+     * 
+     * @param jobs Input profile, parameters and output prefix of each chain.
+     * @param concurrency Largest number of chains training at once.
+     * @return One result per chain, with its final log-likelihood per token.
+     */
+    std::vector<Training_Result> generateTopicChains(const std::vector<Training_Job>& jobs, int concurrency);
+
+    /**
+     * @brief Replaces the topic backend.
+     * 
+     * @param backend Backend used by later imports and trainings.
+     */
+    void setBackend(std::unique_ptr<Topic_Backend> backend);
+
+    /**
+     * @brief Retrieves the topic backend, e.g. to set its options or cancel its chains.
      */
-    void generateTopics(const std::string& input, int numTopics, const std::string& output);
+    Topic_Backend& getBackend();
 
     /**
      * @brief Assigns topic distributions to statements based on Mallet output.
@@ -69,12 +127,15 @@ public:
      * @brief Calculates perplexity and exports metrics for the topic model.
      * 
      * @param numTopics Number of topics in the model.
+     * @param profile Name of the profile holding the composition and diagnostics files.
      */
-    void perplexityPypelyne(int numTopics);
+    void perplexityPypelyne(int numTopics, const std::string& profile = "profile1");
 
 private:
     std::string malletFile; ///< Path to the Mallet file.
     std::string rawData;    ///< Raw data path.
+    Thread_Pool& pool;      ///< Thread pool shared with the other pipeline stages.
+    std::unique_ptr<Topic_Backend> backend; ///< Engine importing corpora and training chains.
 };
 
 #endif // TOPIC_GENERATOR_H
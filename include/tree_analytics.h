@@ -0,0 +1,116 @@
+#ifndef TREE_ANALYTICS_H
+#define TREE_ANALYTICS_H
+
+#include "edge.h"
+#include "statements.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class Tree_Analytics
+ * @brief Linear-time structural metrics of a minimum spanning forest.
+ *
+ * The forest is stored as CSR adjacency and walked with iterative DFS, so deep trees cannot
+ * overflow the stack. Since every pair of nodes of a tree is joined by exactly one path, the
+ * metrics follow from subtree sizes and a few traversals instead of all-pairs shortest paths.
+ * Distances are sums of edge weights (cosine distances); each tree of a forest is handled as
+ * its own graph.
+ */
+class Tree_Analytics {
+public:
+    /**
+     * @brief Builds the adjacency and DFS order of a forest.
+     * @param numNodes Number of nodes; nodes without edges are isolated.
+     * @param edges Edges of the forest (no cycles).
+     */
+    Tree_Analytics(int numNodes, const std::vector<Edge>& edges);
+
+    /**
+     * @brief Degree of every node.
+     */
+    std::vector<double> degrees() const;
+
+    /**
+     * @brief Betweenness centrality: number of node pairs whose path passes through each node.
+     *
+     * For a node whose removal splits its tree of N nodes into branches of sizes s_b, this is
+     * ((N - 1)^2 - sum s_b^2) / 2, the unnormalised undirected count.
+     */
+    std::vector<double> betweenness() const;
+
+    /**
+     * @brief Closeness centrality: (N - 1) divided by the sum of distances to the other N - 1
+     *        nodes of the tree, 0 for isolated nodes.
+     *
+     * The distance sum of the root comes from subtree sizes. Moving the root to a child at
+     * distance w then changes it by w * (N - 2 * size(child)).
+     */
+    std::vector<double> closeness() const;
+
+    /**
+     * @brief Eccentricity: distance to the farthest node of the same tree.
+     *
+     * In a tree the farthest node from any node is one of the two ends of a diameter, so three
+     * traversals give every eccentricity.
+     */
+    std::vector<double> eccentricity() const;
+
+    /**
+     * @brief Longest path of the forest.
+     * @param first [Output] One end of the path.
+     * @param second [Output] Other end of the path.
+     * @return Length of the path.
+     */
+    double diameter(int& first, int& second) const;
+
+    /**
+     * @brief Number of nodes of each degree, indexed by degree.
+     */
+    std::vector<size_t> degreeHistogram() const;
+
+    /**
+     * @brief Number of trees, counting isolated nodes.
+     */
+    int getNumComponents() const;
+
+    /**
+     * @brief Newman's assortativity coefficient of a categorical node label along the edges.
+     *
+     * 1 when edges only join equal labels, 0 when labels are mixed as by chance. Edges touching
+     * a node labelled -1 are ignored.
+     *
+     * @param labels Category of each node, or -1.
+     * @return The coefficient, NaN if every edge joins the same category.
+     */
+    double assortativity(const std::vector<int>& labels) const;
+
+    /**
+     * @brief Writes the diameter, component count, degree histogram and verdict and originator
+     *        assortativity to a JSON file.
+     * @param filename Output file.
+     * @param statements Node metadata.
+     * @return True on success.
+     */
+    bool writeSummary(const std::string& filename, const Statements& statements) const;
+
+private:
+    int numNodes;                  ///< Number of nodes.
+    std::vector<int> offsets;      ///< Adjacency offsets (CSR), one per node plus one.
+    std::vector<int> neighbours;   ///< Adjacency targets.
+    std::vector<double> weights;   ///< Adjacency weights.
+    std::vector<int> order;        ///< Nodes in DFS preorder, tree by tree.
+    std::vector<int> parent;       ///< DFS parent, -1 for roots.
+    std::vector<double> parentWeight; ///< Weight of the edge to the parent.
+    std::vector<int> root;         ///< Root of the tree of each node.
+    std::vector<int> subtreeSize;  ///< Nodes in the DFS subtree of each node.
+
+    /**
+     * @brief Distances from a node to every node of its tree.
+     * @param source Start node.
+     * @param distance [Output] Distances, written for the nodes of the tree only.
+     * @return The farthest node (smallest index on ties).
+     */
+    int distancesFrom(int source, std::vector<double>& distance) const;
+};
+
+#endif // TREE_ANALYTICS_H
@@ -2,6 +2,7 @@
 #define UF_DS_H
 
 #include "edge.h"
+#include <vector>
 
 /**
  * @class UF_DS
@@ -41,9 +42,23 @@ public:
      */
     void unite(int u, int v);
 
+    /**
+     * @brief Appends singleton sets for new elements, keeping the existing sets intact.
+     * 
+     * @param count The number of elements to add.
+     */
+    void extend(int count);
+
+    /**
+     * @brief Retrieves the number of elements.
+     * 
+     * @return int The number of elements in the Union-Find data structure.
+     */
+    int getSize() const;
+
 private:
-    int* parent; ///< Array to store the parent of each element.
-    int* rank; ///< Array to store the rank of each element's tree.
+    std::vector<int> parent; ///< Array to store the parent of each element.
+    std::vector<int> rank; ///< Array to store the rank of each element's tree.
     int size; ///< The number of elements in the Union-Find data structure.
 };
 
@@ -19,6 +19,14 @@ def load_graph_networkx(edge_file):
     return G
 
 
+def load_graph_edges(edges):
+    """Builds the graph from an edge array of the factify module, e.g. factify.Network.mst."""
+    G = nx.Graph()
+    G.add_weighted_edges_from(zip(edges['source'].tolist(), edges['target'].tolist(),
+                                  (1.0 - edges['weight']).tolist()))
+    return G
+
+
 def convert_nx_to_igraph(G):
     """Converts a NetworkX graph to an iGraph graph."""
     ig_graph = ig.Graph()
@@ -0,0 +1,145 @@
+"""Scale test of the standalone pipeline on synthetic corpora.
+
+For every size, a PolitiFact-shaped corpus with matching Mallet composition and diagnostics
+files is generated with `Factify --generate`. The pipeline then runs on it with `--skip-mallet`
+and `--metrics-json`. Wall time and peak resident memory of every stage are compared with the
+stored baselines. The script exits with status 1 when a value exceeds its baseline by more
+than the tolerance.
+
+    python pyfiles/scale_harness.py --factify build/standalone/Factify
+    python pyfiles/scale_harness.py --factify build/standalone/Factify --sizes 10000 --update-baselines
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+
+DEFAULT_BASELINES = os.path.join(os.path.dirname(os.path.abspath(__file__)), "scale_baselines.json")
+
+
+def run(command, cwd, log_file):
+    """Runs a command in `cwd`, appending its output to `log_file`; exits on failure."""
+    with open(log_file, "a") as log:
+        log.write("$ " + " ".join(command) + "\n")
+        log.flush()
+        completed = subprocess.run(command, cwd=cwd, stdout=log, stderr=subprocess.STDOUT)
+    if completed.returncode != 0:
+        sys.exit(f"Command failed with exit code {completed.returncode}: {' '.join(command)} (see {log_file})")
+
+
+def measure(factify, size, args):
+    """Generates a corpus of `size` statements, runs the pipeline on it and returns its metrics."""
+    work_dir = os.path.abspath(os.path.join(args.work_dir, str(size)))
+    os.makedirs(os.path.join(work_dir, "temp"), exist_ok=True)
+    log_file = os.path.join(work_dir, "harness.log")
+    open(log_file, "w").close()
+
+    common = ["--input", "input/synthetic.json", "--topics", str(args.topics)]
+    run([factify, "--generate", str(size), "--vocabulary", str(args.vocabulary), "--seed", str(args.seed)] + common,
+        work_dir, log_file)
+
+    start = time.perf_counter()
+    run([factify, "--skip-mallet", "--metrics-json", "metrics.json", "--trace", "trace.json"] + common + args.extra,
+        work_dir, log_file)
+    elapsed = time.perf_counter() - start
+
+    with open(os.path.join(work_dir, "metrics.json")) as f:
+        report = json.load(f)
+    return {
+        "wall_seconds": elapsed,
+        "peak_rss_bytes": report["peak_rss_bytes"],
+        "stages": {
+            name: {"seconds": stage["seconds"], "peak_rss_bytes": stage["peak_rss_bytes"]}
+            for name, stage in report["summary"].items()
+        },
+    }
+
+
+def compare(label, value, baseline, tolerance, floor):
+    """Returns a failure message if `value` exceeds `baseline` by more than the tolerance."""
+    limit = baseline * (1.0 + tolerance)
+    if value > limit and value - baseline > floor:
+        return f"{label}: {value:.4g} exceeds baseline {baseline:.4g} (limit {limit:.4g})"
+    return None
+
+
+def check(size, measured, baseline, args):
+    """Lists the regressions of one size."""
+    failures = []
+    checks = [("wall_seconds", args.tolerance, args.min_seconds),
+              ("peak_rss_bytes", args.memory_tolerance, args.min_bytes)]
+    for key, tolerance, floor in checks:
+        failure = compare(f"[{size}] total {key}", measured[key], baseline[key], tolerance, floor)
+        if failure:
+            failures.append(failure)
+
+    for name, stage in measured["stages"].items():
+        reference = baseline["stages"].get(name)
+        if reference is None:
+            print(f"[{size}] stage {name} has no baseline")
+            continue
+        for key, tolerance, floor in [("seconds", args.tolerance, args.min_seconds),
+                                      ("peak_rss_bytes", args.memory_tolerance, args.min_bytes)]:
+            failure = compare(f"[{size}] {name} {key}", stage[key], reference[key], tolerance, floor)
+            if failure:
+                failures.append(failure)
+    return failures
+
+
+def print_table(size, measured):
+    print(f"\n{size} statements: {measured['wall_seconds']:.2f} s, peak {measured['peak_rss_bytes'] / 2**20:.1f} MiB")
+    print(f"  {'stage':<24}{'seconds':>10}{'peak MiB':>12}")
+    for name, stage in sorted(measured["stages"].items(), key=lambda item: -item[1]["seconds"]):
+        print(f"  {name:<24}{stage['seconds']:>10.3f}{stage['peak_rss_bytes'] / 2**20:>12.1f}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Scale test of the Factify pipeline on synthetic corpora.")
+    parser.add_argument("--factify", required=True, help="Path to the Factify executable")
+    parser.add_argument("--sizes", type=int, nargs="+", default=[10000, 50000, 200000], help="Statement counts")
+    parser.add_argument("--topics", type=int, default=60, help="Number of topics")
+    parser.add_argument("--vocabulary", type=int, default=5000, help="Vocabulary size")
+    parser.add_argument("--seed", type=int, default=42, help="Corpus seed")
+    parser.add_argument("--work-dir", default="scale_runs", help="Directory for the corpora and reports")
+    parser.add_argument("--baselines", default=DEFAULT_BASELINES, help="Baseline file")
+    parser.add_argument("--update-baselines", action="store_true", help="Store the measurements as the new baselines")
+    parser.add_argument("--tolerance", type=float, default=0.25, help="Allowed relative slowdown")
+    parser.add_argument("--memory-tolerance", type=float, default=0.10, help="Allowed relative memory growth")
+    parser.add_argument("--min-seconds", type=float, default=0.05, help="Ignore slowdowns smaller than this")
+    parser.add_argument("--min-bytes", type=int, default=16 * 2**20, help="Ignore memory growth smaller than this")
+    parser.add_argument("extra", nargs=argparse.REMAINDER, help="Extra Factify options, after --")
+    args = parser.parse_args()
+    args.extra = [option for option in args.extra if option != "--"]
+
+    factify = os.path.abspath(args.factify)
+    baselines = {}
+    if os.path.exists(args.baselines):
+        with open(args.baselines) as f:
+            baselines = json.load(f)
+
+    failures = []
+    for size in args.sizes:
+        measured = measure(factify, size, args)
+        print_table(size, measured)
+        if args.update_baselines:
+            baselines[str(size)] = measured
+        elif str(size) in baselines:
+            failures += check(size, measured, baselines[str(size)], args)
+        else:
+            print(f"[{size}] no baseline; run with --update-baselines to record one")
+
+    if args.update_baselines:
+        with open(args.baselines, "w") as f:
+            json.dump(baselines, f, indent=2, sort_keys=True)
+        print(f"\nBaselines written to {args.baselines}")
+
+    if failures:
+        print("\nRegressions:")
+        for failure in failures:
+            print("  " + failure)
+        sys.exit(1)
+    print("\nNo regressions.")
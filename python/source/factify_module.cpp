@@ -0,0 +1,293 @@
+#include "execution_planner.h"
+#include "network.h"
+#include "network_synthesizer.h"
+#include "pipeline_runner.h"
+#include "statements.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace py = pybind11;
+
+namespace {
+
+// Read-only array over memory owned by `owner`, which the array keeps alive as its base
+template <typename T>
+py::array view(const T* data, std::vector<py::ssize_t> shape, py::handle owner) {
+    py::array array(py::dtype::of<T>(), std::move(shape), data, owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Edges are viewed in place, so the dtype spells out the layout of Edge
+py::dtype edgeDtype() {
+    static_assert(std::is_standard_layout<Edge>::value && std::is_trivially_copyable<Edge>::value &&
+                      sizeof(int) == 4 && sizeof(Edge) == 24,
+                  "Edge must be laid out as {int32 node1, int32 node2, float64 weight, int32 id}");
+    py::list names, formats, offsets;
+    for (const char* name : {"source", "target", "weight", "id"}) {
+        names.append(name);
+    }
+    for (const char* format : {"i4", "i4", "f8", "i4"}) {
+        formats.append(format);
+    }
+    for (int offset : {0, 4, 8, 16}) {
+        offsets.append(offset);
+    }
+    return py::dtype(names, formats, offsets, sizeof(Edge));
+}
+
+py::array edgeView(const std::vector<Edge>& edges, py::handle owner) {
+    py::array array(edgeDtype(), {static_cast<py::ssize_t>(edges.size())}, edges.data(), owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Each undirected edge of a CSR graph once, with u < v, as an owned edge array
+py::array sparseEdges(const Sparse_Graph& graph) {
+    py::array array(edgeDtype(), {static_cast<py::ssize_t>(graph.getNumEdges())});
+    Edge* out = static_cast<Edge*>(array.mutable_data());
+    {
+        py::gil_scoped_release release;
+        int id = 0;
+        for (int u = 0; u < graph.getNumNodes(); ++u) {
+            for (size_t s = graph.offsets[u]; s < graph.offsets[u + 1]; ++s) {
+                if (graph.neighbours[s] > u && static_cast<size_t>(id) < graph.getNumEdges()) {
+                    new (out + id) Edge(u, graph.neighbours[s], graph.weights[s], id);
+                    ++id;
+                }
+            }
+        }
+    }
+    return array;
+}
+
+Strategy parseStrategy(const std::string& name) {
+    Strategy strategy;
+    if (!Execution_Planner::parseStrategy(name, strategy)) {
+        throw py::value_error("Unknown strategy: " + name);
+    }
+    return strategy;
+}
+
+}
+
+PYBIND11_MODULE(factify, m) {
+    m.doc() = "Factify's statements, topic model and networks as NumPy arrays, without CSV files.";
+
+    PYBIND11_NUMPY_DTYPE(Similar_Document, document, distance);
+    PYBIND11_NUMPY_DTYPE_EX(Percolation_Point, threshold, "threshold", components, "components", giantSize, "giant_size",
+                            singletons, "singletons");
+
+    m.def("verdict_names", []() {
+        std::vector<std::string> names;
+        for (Verdict verdict : {Verdict::TRUE, Verdict::MOSTLY_TRUE, Verdict::HALF_TRUE, Verdict::MOSTLY_FALSE,
+                                Verdict::FALSE, Verdict::PANTS_FIRE}) {
+            names.emplace_back(verdictToString(verdict));
+        }
+        return names;
+    }, "Names of the verdict codes used by Statements.table().");
+
+    py::class_<Lda_Config>(m, "LdaConfig")
+        .def(py::init<>())
+        .def_readwrite("num_topics", &Lda_Config::numTopics)
+        .def_readwrite("alpha", &Lda_Config::alpha)
+        .def_readwrite("beta", &Lda_Config::beta)
+        .def_readwrite("iterations", &Lda_Config::iterations)
+        .def_readwrite("optimize_interval", &Lda_Config::optimizeInterval)
+        .def_readwrite("optimize_burn_in", &Lda_Config::optimizeBurnIn)
+        .def_readwrite("seed", &Lda_Config::seed);
+
+    py::class_<Pipeline_Config>(m, "PipelineConfig")
+        .def(py::init<>())
+        .def_readwrite("input", &Pipeline_Config::input)
+        .def_readwrite("profile", &Pipeline_Config::profile)
+        .def_readwrite("lda", &Pipeline_Config::lda)
+        .def_readwrite("skip_mallet", &Pipeline_Config::skipMallet)
+        .def_readwrite("topic_backend", &Pipeline_Config::topicBackend)
+        .def_readwrite("training_timeout", &Pipeline_Config::trainingTimeout)
+        .def_readwrite("chains", &Pipeline_Config::chains)
+        .def_readwrite("use_cache", &Pipeline_Config::useCache)
+        .def_readwrite("cache_directory", &Pipeline_Config::cacheDirectory)
+        .def_readwrite("shards", &Pipeline_Config::shards)
+        .def_readwrite("compute_layout", &Pipeline_Config::computeLayout)
+        .def_readwrite("permutations", &Pipeline_Config::permutations)
+        .def_readwrite("permutation_seed", &Pipeline_Config::permutationSeed)
+        .def_readwrite("compute_distance_statistics", &Pipeline_Config::computeDistanceStatistics)
+        .def_readwrite("distance_bins", &Pipeline_Config::distanceBins)
+        .def_property("strategy", [](const Pipeline_Config& config) {
+            return config.planner.forceStrategy ? Execution_Planner::strategyName(config.planner.forced) : std::string("auto");
+        }, [](Pipeline_Config& config, const std::string& name) {
+            config.planner.forceStrategy = name != "auto";
+            if (config.planner.forceStrategy) {
+                config.planner.forced = parseStrategy(name);
+            }
+        }, "MST strategy: \"auto\" or a strategy name of the planner.");
+
+    py::class_<Statements>(m, "Statements")
+        .def("__len__", &Statements::getSize)
+        .def("table", [](const Statements& self) {
+            const py::ssize_t n = self.getSize();
+            py::array_t<uint8_t> verdicts(n);
+            py::array_t<int32_t> dates(n);
+            auto verdict = verdicts.mutable_unchecked<1>();
+            auto date = dates.mutable_unchecked<1>();
+            py::list comments, originators, sources, factcheckers, factcheckDates;
+            for (py::ssize_t i = 0; i < n; ++i) {
+                const Statement* statement = self.findStatement(static_cast<int>(i));
+                if (!statement) {
+                    verdict(i) = std::numeric_limits<uint8_t>::max();
+                    date(i) = 0;
+                    for (py::list* column : {&comments, &originators, &sources, &factcheckers, &factcheckDates}) {
+                        column->append(py::none());
+                    }
+                    continue;
+                }
+                const std::tm when = statement->getDate();
+                verdict(i) = static_cast<uint8_t>(statement->getVerdict());
+                date(i) = (when.tm_year + 1900) * 10000 + (when.tm_mon + 1) * 100 + when.tm_mday;
+                comments.append(statement->getComment());
+                originators.append(statement->getOriginator());
+                sources.append(statement->getSource());
+                factcheckers.append(statement->getFactchecker());
+                factcheckDates.append(statement->getFactcheckDate());
+            }
+            py::dict table;
+            table["verdict"] = verdicts;
+            table["date"] = dates;
+            table["comment"] = comments;
+            table["originator"] = originators;
+            table["source"] = sources;
+            table["factchecker"] = factcheckers;
+            table["factcheck_date"] = factcheckDates;
+            return table;
+        }, "Columns of the statements by ID: verdict codes (see verdict_names(), 255 if missing), dates as "
+           "yyyymmdd integers, and lists of comments, originators, sources, factcheckers and factcheck dates. "
+           "Accepted by pandas.DataFrame.")
+        .def("topics", [](const Statements& self) {
+            const int n = self.getSize();
+            size_t numTopics = 0;
+            for (int i = 0; i < n; ++i) {
+                numTopics = std::max(numTopics, self.getTopics(i).size());
+            }
+            py::array_t<double> topics({static_cast<py::ssize_t>(n), static_cast<py::ssize_t>(numTopics)});
+            double* out = topics.mutable_data();
+            std::fill(out, out + topics.size(), 0.0);
+            for (int i = 0; i < n; ++i) {
+                const std::vector<double> row = self.getTopics(i);
+                std::copy(row.begin(), row.end(), out + static_cast<size_t>(i) * numTopics);
+            }
+            return topics;
+        }, "Copy of the topic proportions assigned to the statements; Network.documents is the same matrix without copying.");
+
+    py::class_<Sparse_Graph>(m, "SparseGraph")
+        .def_property_readonly("num_nodes", &Sparse_Graph::getNumNodes)
+        .def_property_readonly("num_edges", &Sparse_Graph::getNumEdges)
+        .def_property_readonly("offsets", [](py::object self) {
+            const auto& graph = self.cast<const Sparse_Graph&>();
+            return view(graph.offsets.data(), {static_cast<py::ssize_t>(graph.offsets.size())}, self);
+        }, "CSR row offsets (view).")
+        .def_property_readonly("neighbours", [](py::object self) {
+            const auto& graph = self.cast<const Sparse_Graph&>();
+            return view(graph.neighbours.data(), {static_cast<py::ssize_t>(graph.neighbours.size())}, self);
+        }, "CSR neighbour IDs (view); scipy.sparse.csr_matrix((weights, neighbours, offsets)) wraps them.")
+        .def_property_readonly("weights", [](py::object self) {
+            const auto& graph = self.cast<const Sparse_Graph&>();
+            return view(graph.weights.data(), {static_cast<py::ssize_t>(graph.weights.size())}, self);
+        }, "CSR weights (view).")
+        .def("edges", &sparseEdges, "Each edge once as a (source, target, weight, id) structured array.");
+
+    py::class_<Network_Synthesizer>(m, "Network")
+        .def(py::init([](py::array_t<double, py::array::c_style | py::array::forcecast> documents) {
+            if (documents.ndim() != 2) {
+                throw py::value_error("documents must be a 2-D documents x topics array");
+            }
+            const py::ssize_t rows = documents.shape(0), columns = documents.shape(1);
+            std::vector<double> matrix(documents.data(), documents.data() + documents.size());
+            return std::make_unique<Network_Synthesizer>(std::move(matrix), static_cast<int>(rows), static_cast<int>(columns));
+        }), py::arg("documents"), "Copies a documents x topics matrix into a new network.")
+        .def_property_readonly("num_documents", &Network_Synthesizer::getNumDocuments)
+        .def_property_readonly("num_topics", &Network_Synthesizer::getNumTopics)
+        .def_property_readonly("documents", [](py::object self) {
+            const auto& network = self.cast<const Network_Synthesizer&>();
+            return view(network.getDocumentMatrix().data(),
+                        {network.getNumDocuments(), network.getNumTopics()}, self);
+        }, "Document-topic matrix (read-only view).")
+        .def_property_readonly("upper_triangle", [](py::object self) {
+            const auto& triangle = self.cast<const Network_Synthesizer&>().getUpperTriangle();
+            return view(triangle.data(), {static_cast<py::ssize_t>(triangle.size())}, self);
+        }, "Cosine distances of the pairs i < j, row by row (read-only view); empty until calculate_similarity() "
+           "or the dense strategy has run, and invalid after the next call.")
+        .def_property_readonly("mst", [](py::object self) {
+            return edgeView(self.cast<const Network_Synthesizer&>().getMST(), self);
+        }, "MST edges as a (source, target, weight, id) structured array (read-only view), invalid after the next find_mst().")
+        .def("find_mst", [](Network_Synthesizer& self, const std::string& strategy, size_t memoryBudget) {
+            Planner_Config config;
+            config.memoryBudgetBytes = memoryBudget;
+            config.forceStrategy = strategy != "auto";
+            if (config.forceStrategy) {
+                config.forced = parseStrategy(strategy);
+            }
+            py::gil_scoped_release release;
+            self.execute(self.planExecution(config));
+        }, py::arg("strategy") = "auto", py::arg("memory_budget") = 0,
+           "Plans and computes the MST; \"auto\" lets the planner choose within the memory budget (0 for 80% of RAM).")
+        .def("calculate_similarity", &Network_Synthesizer::calculateSimilarity, py::call_guard<py::gil_scoped_release>())
+        .def("build_query_index", py::overload_cast<>(&Network_Synthesizer::buildQueryIndex),
+             py::call_guard<py::gil_scoped_release>())
+        .def("nearest", [](const Network_Synthesizer& self,
+                           py::array_t<int, py::array::c_style | py::array::forcecast> documents, int k) {
+            std::vector<Similarity_Query> queries(static_cast<size_t>(documents.size()));
+            for (size_t q = 0; q < queries.size(); ++q) {
+                queries[q].document = documents.data()[q];
+            }
+            k = std::max(0, std::min(k, self.getNumDocuments()));
+            std::vector<std::vector<Similar_Document>> results;
+            {
+                py::gil_scoped_release release;
+                results = self.findNearestDocuments(queries, k);
+            }
+            py::array_t<Similar_Document> out({static_cast<py::ssize_t>(queries.size()), static_cast<py::ssize_t>(k)});
+            Similar_Document* row = out.mutable_data();
+            for (const auto& result : results) {
+                for (int j = 0; j < k; ++j) {
+                    row[j] = static_cast<size_t>(j) < result.size()
+                                 ? result[j]
+                                 : Similar_Document{-1, std::numeric_limits<double>::quiet_NaN()};
+                }
+                row += k;
+            }
+            return out;
+        }, py::arg("documents"), py::arg("k"),
+           "The k nearest documents of each query document as a (queries, k) array of (document, distance), "
+           "padded with -1; needs build_query_index().")
+        .def("build_epsilon_graph", &Network_Synthesizer::buildEpsilonGraph, py::arg("max_distance"),
+             py::call_guard<py::gil_scoped_release>(), "Every pair within a cosine distance, as a SparseGraph.")
+        .def("percolation", [](const Network_Synthesizer& self, const std::vector<double>& thresholds) {
+            std::vector<Percolation_Point> points;
+            {
+                py::gil_scoped_release release;
+                points = self.sweepThresholds(thresholds);
+            }
+            py::array_t<Percolation_Point> out(static_cast<py::ssize_t>(points.size()));
+            std::copy(points.begin(), points.end(), out.mutable_data());
+            return out;
+        }, py::arg("thresholds"), "Components, giant component and singletons at each threshold; needs the MST.");
+
+    py::class_<Pipeline_Runner>(m, "PipelineRunner")
+        .def(py::init([](const Pipeline_Config& config) {
+            return std::make_unique<Pipeline_Runner>(config, Thread_Pool::defaultPool());
+        }), py::arg("config"))
+        .def("run", &Pipeline_Runner::run, py::call_guard<py::gil_scoped_release>(),
+             "Runs the pipeline stages; returns 0 on success.")
+        .def_property_readonly("statements", &Pipeline_Runner::getStatements, py::return_value_policy::reference_internal)
+        .def_property_readonly("network", py::overload_cast<>(&Pipeline_Runner::getNetworkSynthesizer),
+                               py::return_value_policy::reference_internal,
+                               "Network of the last run, or None; replaced by the next run.");
+}
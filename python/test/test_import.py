@@ -0,0 +1,46 @@
+"""Imports the factify module and calls it on a small random corpus.
+
+Run by ctest with the module's directory on PYTHONPATH; also runs under pytest.
+"""
+
+import numpy as np
+
+import factify
+
+
+def make_documents(num_documents=50, num_topics=6, seed=3):
+    rng = np.random.default_rng(seed)
+    documents = rng.random((num_documents, num_topics)) ** 4 + 1e-3
+    return documents / documents.sum(axis=1, keepdims=True)
+
+
+def test_verdict_names():
+    assert factify.verdict_names() == ["true", "mostly-true", "half-true", "mostly-false", "false", "pants-fire"]
+
+
+def test_network():
+    documents = make_documents()
+    network = factify.Network(documents)
+    assert network.num_documents == 50 and network.num_topics == 6
+    assert np.array_equal(network.documents, documents)
+    assert not network.documents.flags.writeable
+
+    network.find_mst("dense")
+    dense = np.sort(network.mst["weight"])
+    network.find_mst("prim")
+    mst = network.mst
+    assert mst.shape == (49,)
+    assert set(mst.dtype.names) == {"source", "target", "weight", "id"}
+    assert np.allclose(np.sort(mst["weight"]), dense)
+
+    points = network.percolation([0.0, 1.0])
+    assert points["components"].tolist() == [50, 1]
+
+    graph = network.build_epsilon_graph(2.0)
+    assert graph.num_edges == 50 * 49 // 2
+    assert graph.offsets[-1] == 2 * graph.num_edges
+
+
+if __name__ == "__main__":
+    test_verdict_names()
+    test_network()
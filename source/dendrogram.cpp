@@ -0,0 +1,174 @@
+#include "dendrogram.h"
+#include "uf_ds.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <fmt/format.h>
+
+Dendrogram::Dendrogram(int numNodes, const std::vector<Edge>& mst) : numNodes(std::max(0, numNodes)) {
+    std::vector<Edge> sorted(mst);
+    std::sort(sorted.begin(), sorted.end(), compareByWeight);
+
+    // Cluster ID currently held by each union-find root, and its size
+    UF_DS uf(this->numNodes);
+    std::vector<int> cluster(this->numNodes), size(this->numNodes, 1);
+    for (int v = 0; v < this->numNodes; ++v) {
+        cluster[v] = v;
+    }
+    linkage.reserve(sorted.size());
+    mergedEdges.reserve(sorted.size());
+    for (const auto& edge : sorted) {
+        const int a = uf.find(edge.getNode1());
+        const int b = uf.find(edge.getNode2());
+        if (a == b) {
+            continue;
+        }
+        const int merged = size[a] + size[b];
+        linkage.push_back({std::min(cluster[a], cluster[b]), std::max(cluster[a], cluster[b]), edge.getWeight(), merged});
+        mergedEdges.emplace_back(edge.getNode1(), edge.getNode2());
+        uf.unite(a, b);
+        const int root = uf.find(a);
+        cluster[root] = this->numNodes + static_cast<int>(linkage.size()) - 1;
+        size[root] = merged;
+    }
+}
+
+const std::vector<Linkage_Row>& Dendrogram::getLinkage() const {
+    return linkage;
+}
+
+int Dendrogram::getNumNodes() const {
+    return numNodes;
+}
+
+std::vector<int> Dendrogram::labelsAfter(size_t numMerges) const {
+    UF_DS uf(numNodes);
+    for (size_t i = 0; i < numMerges; ++i) {
+        uf.unite(mergedEdges[i].first, mergedEdges[i].second);
+    }
+    std::vector<int> labels(numNodes), rootLabel(numNodes, -1);
+    int next = 0;
+    for (int v = 0; v < numNodes; ++v) {
+        int& label = rootLabel[uf.find(v)];
+        if (label < 0) {
+            label = next++;
+        }
+        labels[v] = label;
+    }
+    return labels;
+}
+
+std::vector<int> Dendrogram::cutAtDistance(double threshold) const {
+    const auto end = std::upper_bound(linkage.begin(), linkage.end(), threshold,
+                                      [](double value, const Linkage_Row& row) { return value < row.distance; });
+    return labelsAfter(static_cast<size_t>(end - linkage.begin()));
+}
+
+std::vector<int> Dendrogram::cutToClusters(int numClusters) const {
+    const long long merges = static_cast<long long>(numNodes) - std::max(1, numClusters);
+    return labelsAfter(static_cast<size_t>(std::clamp<long long>(merges, 0, static_cast<long long>(linkage.size()))));
+}
+
+std::vector<int> Dendrogram::cut(const Cluster_Cut& request) const {
+    return request.byCount ? cutToClusters(request.clusters) : cutAtDistance(request.distance);
+}
+
+bool Dendrogram::writeLinkage(const std::string& filename) const {
+    std::vector<double> matrix;
+    const size_t rows = numNodes > 0 ? static_cast<size_t>(numNodes) - 1 : 0;
+    matrix.reserve(rows * 4);
+    for (const auto& row : linkage) {
+        matrix.insert(matrix.end(), {double(row.first), double(row.second), row.distance, double(row.size)});
+    }
+
+    // Roots of a forest, joined in order of their smallest document
+    if (linkage.size() < rows) {
+        std::vector<int> labels = labelsAfter(linkage.size());
+        std::vector<int> cluster, size;
+        for (int v = 0; v < numNodes; ++v) {
+            if (labels[v] == static_cast<int>(cluster.size())) {
+                cluster.push_back(v);
+                size.push_back(0);
+            }
+            ++size[labels[v]];
+        }
+        // The final ID of each root cluster: the last merge that formed it
+        for (size_t i = 0; i < linkage.size(); ++i) {
+            cluster[labels[mergedEdges[i].first]] = numNodes + static_cast<int>(i);
+        }
+        int current = cluster[0], total = size[0];
+        for (size_t c = 1; c < cluster.size(); ++c) {
+            total += size[c];
+            const double merged = static_cast<double>(numNodes) + static_cast<double>(matrix.size() / 4);
+            matrix.insert(matrix.end(), {double(std::min(current, cluster[c])), double(std::max(current, cluster[c])),
+                                         std::numeric_limits<double>::infinity(), double(total)});
+            current = static_cast<int>(merged);
+        }
+    }
+
+    // NPY 1.0: magic, header length, then a Python dict literal padded to a 64-byte boundary
+    std::string header = fmt::format("{{'descr': '<f8', 'fortran_order': False, 'shape': ({}, 4), }}", rows);
+    const size_t unpadded = 10 + header.size() + 1;
+    header.append((64 - unpadded % 64) % 64, ' ');
+    header.push_back('\n');
+    const uint16_t headerLength = static_cast<uint16_t>(header.size());
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    char prefix[10] = {'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0};
+    std::memcpy(prefix + 8, &headerLength, sizeof(headerLength));
+    file.write(prefix, sizeof(prefix));
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(matrix.data()), static_cast<std::streamsize>(matrix.size() * sizeof(double)));
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Error: Could not write file " << filename << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Dendrogram::writeClusters(const std::string& filename, const std::vector<int>& labels) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "node_id,cluster\n");
+    for (size_t v = 0; v < labels.size(); ++v) {
+        fmt::format_to(std::back_inserter(buffer), "{},{}\n", v, labels[v]);
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+bool Dendrogram::parseCut(const std::string& text, Cluster_Cut& request) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    const std::string kind = text.substr(0, colon);
+    const std::string value = text.substr(colon + 1);
+    try {
+        if (kind == "distance") {
+            request.byCount = false;
+            request.distance = std::stod(value);
+        } else if (kind == "clusters") {
+            request.byCount = true;
+            request.clusters = std::stoi(value);
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
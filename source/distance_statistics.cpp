@@ -0,0 +1,202 @@
+#include "distance_statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <nlohmann/json.hpp>
+#include <fmt/format.h>
+
+using json = nlohmann::json;
+
+Kll_Sketch::Kll_Sketch(int k, uint64_t seed)
+    : k(std::max(8, k)), state(seed * 0x9E3779B97F4A7C15ull | 1) {
+    addLevel();
+}
+
+size_t Kll_Sketch::capacity(size_t level) const {
+    const double depth = static_cast<double>(levels.size() - 1 - level);
+    return std::max<size_t>(8, static_cast<size_t>(std::ceil(k * std::pow(2.0 / 3.0, depth))));
+}
+
+void Kll_Sketch::addLevel() {
+    levels.emplace_back();
+    limit = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+        limit += capacity(h);
+    }
+}
+
+void Kll_Sketch::add(double value) {
+    levels.front().push_back(value);
+    ++size;
+    ++count;
+    if (size >= limit) {
+        compress();
+    }
+}
+
+void Kll_Sketch::compress() {
+    for (size_t h = 0; h < levels.size(); ++h) {
+        if (levels[h].size() < capacity(h)) {
+            continue;
+        }
+        if (h + 1 == levels.size()) {
+            addLevel();
+        }
+        auto& level = levels[h];
+        std::sort(level.begin(), level.end());
+
+        // An odd item stays behind; of the rest, every other one moves up with double weight
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const size_t keep = level.size() % 2;
+        for (size_t i = keep + (state & 1); i < level.size(); i += 2) {
+            levels[h + 1].push_back(level[i]);
+        }
+        size -= (level.size() - keep) / 2;
+        level.resize(keep);
+        return;
+    }
+}
+
+void Kll_Sketch::merge(const Kll_Sketch& other) {
+    while (levels.size() < other.levels.size()) {
+        addLevel();
+    }
+    for (size_t h = 0; h < other.levels.size(); ++h) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    size += other.size;
+    count += other.count;
+    while (size >= limit) {
+        compress();
+    }
+}
+
+uint64_t Kll_Sketch::getCount() const {
+    return count;
+}
+
+double Kll_Sketch::quantile(double q) const {
+    if (count == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    std::vector<std::pair<double, uint64_t>> items;
+    items.reserve(size);
+    for (size_t h = 0; h < levels.size(); ++h) {
+        for (double value : levels[h]) {
+            items.emplace_back(value, uint64_t(1) << h);
+        }
+    }
+    std::sort(items.begin(), items.end());
+    const double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(count);
+    uint64_t rank = 0;
+    for (const auto& [value, weight] : items) {
+        rank += weight;
+        if (static_cast<double>(rank) >= target) {
+            return value;
+        }
+    }
+    return items.back().first;
+}
+
+Distance_Summary::Distance_Summary(int bins)
+    : minimum(std::numeric_limits<double>::infinity()), maximum(-std::numeric_limits<double>::infinity()),
+      histogram(static_cast<size_t>(std::max(1, bins)), 0) {
+}
+
+void Distance_Summary::merge(const Distance_Summary& other) {
+    if (other.count == 0) {
+        return;
+    }
+    const double total = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+    mean += delta * static_cast<double>(other.count) / total;
+    count += other.count;
+    minimum = std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+    for (size_t b = 0; b < histogram.size() && b < other.histogram.size(); ++b) {
+        histogram[b] += other.histogram[b];
+    }
+    sketch.merge(other.sketch);
+}
+
+uint64_t Distance_Summary::getCount() const {
+    return count;
+}
+
+double Distance_Summary::getMean() const {
+    return count > 0 ? mean : std::numeric_limits<double>::quiet_NaN();
+}
+
+double Distance_Summary::getVariance() const {
+    return count > 0 ? m2 / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double Distance_Summary::getMin() const {
+    return count > 0 ? minimum : std::numeric_limits<double>::quiet_NaN();
+}
+
+double Distance_Summary::getMax() const {
+    return count > 0 ? maximum : std::numeric_limits<double>::quiet_NaN();
+}
+
+const std::vector<uint64_t>& Distance_Summary::getHistogram() const {
+    return histogram;
+}
+
+double Distance_Summary::quantile(double q) const {
+    return sketch.quantile(q);
+}
+
+size_t Distance_Statistics::pairIndex(int a, int b, int numLabels) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return static_cast<size_t>(a) * numLabels - static_cast<size_t>(a) * (a - 1) / 2 + (b - a);
+}
+
+bool Distance_Statistics::writeJson(const std::string& filename) const {
+    auto number = [](double value) { return std::isnan(value) ? json(nullptr) : json(value); };
+    auto summarize = [&](const Distance_Summary& summary) {
+        json quantiles = json::object();
+        for (double q : {0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99}) {
+            quantiles[fmt::format("{:g}", q)] = number(summary.quantile(q));
+        }
+        return json{
+            {"count", summary.getCount()},
+            {"mean", number(summary.getMean())},
+            {"variance", number(summary.getVariance())},
+            {"min", number(summary.getMin())},
+            {"max", number(summary.getMax())},
+            {"quantiles", quantiles},
+            {"histogram", summary.getHistogram()},
+        };
+    };
+
+    json pairs = json::object();
+    const int numLabels = static_cast<int>(labelNames.size());
+    for (int a = 0; a < numLabels; ++a) {
+        for (int b = a; b < numLabels; ++b) {
+            const size_t index = pairIndex(a, b, numLabels);
+            if (index < byPair.size()) {
+                pairs[labelNames[a] + "|" + labelNames[b]] = summarize(byPair[index]);
+            }
+        }
+    }
+    json report = summarize(all);
+    report["histogram_range"] = {0.0, 1.0};
+    report["by_label_pair"] = pairs;
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    out << report.dump(2) << "\n";
+    return static_cast<bool>(out);
+}
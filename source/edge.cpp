@@ -50,3 +50,19 @@ double Edge::getWeight() const {
 int Edge::getId() const {
     return id;
 }
+
+
+/**
+ * @brief Orders edges by weight, then by first and second node.
+ *
+ * @return bool True if `a` sorts before `b`.
+ */
+bool compareByWeight(const Edge& a, const Edge& b) {
+    if (a.getWeight() != b.getWeight()) {
+        return a.getWeight() < b.getWeight();
+    }
+    if (a.getNode1() != b.getNode1()) {
+        return a.getNode1() < b.getNode1();
+    }
+    return a.getNode2() < b.getNode2();
+}
@@ -0,0 +1,211 @@
+#include "execution_planner.h"
+#include "edge.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // Throughput assumptions used for the time column; only the ratios between strategies matter.
+    constexpr double kMultiplyAddsPerSecondPerCore = 1.0e9;
+    constexpr double kSortComparisonsPerSecond = 1.0e8;
+    constexpr double kDiskBytesPerSecond = 200.0 * 1024 * 1024;
+
+    // Bytes of one spilled edge record (weight + two 32-bit endpoints).
+    constexpr size_t kRunRecordBytes = sizeof(double) + 2 * sizeof(int);
+    // Read buffer kept per run while merging.
+    constexpr size_t kRunReadBufferBytes = size_t(1) << 20;
+}
+
+Execution_Planner::Execution_Planner(const Planner_Config& config) : config(config) {
+    if (this->config.cores == 0) {
+        this->config.cores = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->config.memoryBudgetBytes == 0) {
+        this->config.memoryBudgetBytes = static_cast<size_t>(physicalMemory() * 0.8);
+    }
+    if (this->config.diskBudgetBytes == 0) {
+        std::error_code ec;
+        auto space = std::filesystem::space(this->config.scratchDirectory, ec);
+        this->config.diskBudgetBytes = ec ? 0 : static_cast<size_t>(space.available);
+    }
+    if (this->config.knnNeighbours < 1) {
+        this->config.knnNeighbours = 1;
+    }
+}
+
+Strategy_Estimate Execution_Planner::estimate(Strategy strategy, size_t numDocuments, int numTopics) const {
+    const double n = static_cast<double>(numDocuments);
+    const double pairs = n * (n - 1) / 2;
+    const double cores = static_cast<double>(config.cores);
+    const size_t pairCount = numDocuments < 2 ? 0 : numDocuments * (numDocuments - 1) / 2;
+
+    // Every strategy holds the row-major document-topic matrix, the moduli and the MST
+    const size_t base = numDocuments * (numTopics * sizeof(double) + sizeof(double))
+                        + numDocuments * sizeof(Edge);
+    const double kernelSeconds = pairs * numTopics / (kMultiplyAddsPerSecondPerCore * cores);
+
+    Strategy_Estimate e;
+    e.strategy = strategy;
+
+    switch (strategy) {
+        case Strategy::DENSE_MATRIX:
+            // Triangle, per-thread edge buffers and the synthesizer's copy of the sorted list
+            e.memoryBytes = base + pairCount * (sizeof(double) + 2 * sizeof(Edge));
+            e.seconds = kernelSeconds + pairs * std::log2(std::max(2.0, pairs)) / kSortComparisonsPerSecond;
+            e.keepsEdgeList = true;
+            break;
+        case Strategy::FUSED_PRIM: {
+            // Best edge into the tree and an index in the list of remaining documents per
+            // document, and the closest document of each scanned chunk
+            const size_t numChunks = numDocuments >= 4096 ? 4 * static_cast<size_t>(config.cores) : 1;
+            e.memoryBytes = base + numDocuments * (sizeof(Edge) + sizeof(int)) + numChunks * sizeof(int);
+            e.seconds = kernelSeconds + n * n / (kMultiplyAddsPerSecondPerCore * cores);
+            break;
+        }
+        case Strategy::KNN_GRAPH: {
+            const size_t k = std::min(numDocuments, static_cast<size_t>(config.knnNeighbours));
+            // Candidate lists per document, then the deduplicated, sorted edge list
+            e.memoryBytes = base + 2 * numDocuments * k * sizeof(Edge) + numDocuments * 2 * sizeof(int);
+            e.seconds = 2 * kernelSeconds + n * k * std::log2(std::max(2.0, n * k)) / kSortComparisonsPerSecond;
+            e.exact = false;
+            e.keepsEdgeList = true;
+            break;
+        }
+        case Strategy::OUT_OF_CORE: {
+            const size_t runBytes = std::max(kRunRecordBytes, config.outOfCoreBlockBytes);
+            const size_t runs = (pairCount * kRunRecordBytes + runBytes - 1) / runBytes;
+            e.memoryBytes = base + runBytes + runs * kRunReadBufferBytes + numDocuments * 2 * sizeof(int);
+            // Runs plus the merged, sorted edge stream
+            e.diskBytes = 2 * pairCount * kRunRecordBytes;
+            e.seconds = kernelSeconds + pairs * std::log2(std::max(2.0, pairs)) / kSortComparisonsPerSecond
+                        + 2.0 * e.diskBytes / kDiskBytesPerSecond;
+            e.keepsEdgeList = true;
+            break;
+        }
+    }
+
+    e.fits = e.memoryBytes <= config.memoryBudgetBytes && e.diskBytes <= config.diskBudgetBytes;
+    return e;
+}
+
+Execution_Plan Execution_Planner::plan(size_t numDocuments, int numTopics) const {
+    Execution_Plan plan;
+    plan.config = config;
+    plan.numDocuments = numDocuments;
+    plan.numTopics = numTopics;
+
+    for (Strategy s : {Strategy::DENSE_MATRIX, Strategy::FUSED_PRIM, Strategy::KNN_GRAPH, Strategy::OUT_OF_CORE}) {
+        plan.estimates.push_back(estimate(s, numDocuments, numTopics));
+    }
+    auto fits = [&plan](Strategy s) { return plan.estimates[static_cast<size_t>(s)].fits; };
+
+    if (config.forceStrategy) {
+        plan.strategy = config.forced;
+        plan.reason = "forced by configuration";
+    } else if (fits(Strategy::DENSE_MATRIX)) {
+        plan.strategy = Strategy::DENSE_MATRIX;
+        plan.reason = "dense matrix fits the memory budget";
+    } else if (!config.requireEdgeList && fits(Strategy::FUSED_PRIM)) {
+        plan.strategy = Strategy::FUSED_PRIM;
+        plan.reason = "dense matrix exceeds the budget; only the MST is required";
+    } else if (config.requireEdgeList && config.allowApproximate && fits(Strategy::KNN_GRAPH)) {
+        plan.strategy = Strategy::KNN_GRAPH;
+        plan.reason = "dense matrix exceeds the budget; approximate sparse edge list accepted";
+    } else if (fits(Strategy::OUT_OF_CORE)) {
+        plan.strategy = Strategy::OUT_OF_CORE;
+        plan.reason = "dense matrix exceeds the budget; sorted edge stream kept on disk";
+    } else {
+        // Nothing fits: fall back to the smallest footprint and let the caller see the warning
+        plan.strategy = Strategy::FUSED_PRIM;
+        plan.reason = "no strategy fits the budgets; using the smallest footprint";
+    }
+
+    return plan;
+}
+
+void Execution_Planner::logPlan(const Execution_Plan& plan) {
+    std::cout << "Execution plan for " << plan.numDocuments << " documents x " << plan.numTopics << " topics"
+              << " (memory budget " << formatBytes(plan.config.memoryBudgetBytes)
+              << ", disk budget " << formatBytes(plan.config.diskBudgetBytes)
+              << ", " << plan.config.cores << " cores):\n";
+
+    for (const auto& e : plan.estimates) {
+        std::ostringstream seconds;
+        seconds << std::fixed << std::setprecision(1) << e.seconds;
+        std::cout << "  " << (e.strategy == plan.strategy ? "* " : "  ")
+                  << std::left << std::setw(13) << strategyName(e.strategy) << std::right
+                  << " memory " << std::setw(10) << formatBytes(e.memoryBytes)
+                  << "  disk " << std::setw(10) << formatBytes(e.diskBytes)
+                  << "  ~" << seconds.str() << " s"
+                  << (e.exact ? "" : "  approximate")
+                  << (e.fits ? "" : "  exceeds budget") << "\n";
+    }
+
+    std::cout << "Selected " << strategyName(plan.strategy) << ": " << plan.reason << "\n";
+}
+
+size_t Execution_Planner::physicalMemory() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        return static_cast<size_t>(status.ullTotalPhys);
+    }
+    return 0;
+#else
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(pages) * static_cast<size_t>(pageSize);
+#endif
+}
+
+std::string Execution_Planner::strategyName(Strategy strategy) {
+    switch (strategy) {
+        case Strategy::DENSE_MATRIX: return "dense";
+        case Strategy::FUSED_PRIM: return "prim";
+        case Strategy::KNN_GRAPH: return "knn";
+        case Strategy::OUT_OF_CORE: return "ooc";
+    }
+    return "unknown";
+}
+
+bool Execution_Planner::parseStrategy(const std::string& name, Strategy& strategy) {
+    for (Strategy s : {Strategy::DENSE_MATRIX, Strategy::FUSED_PRIM, Strategy::KNN_GRAPH, Strategy::OUT_OF_CORE}) {
+        if (name == strategyName(s)) {
+            strategy = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string Execution_Planner::formatBytes(size_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB", "PiB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 5) {
+        value /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+
+const Planner_Config& Execution_Planner::getConfig() const {
+    return config;
+}
@@ -0,0 +1,246 @@
+#include "force_layout.h"
+#include "instrumentation.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Coincident nodes stop splitting here and interact directly
+constexpr int kMaxDepth = 24;
+
+}
+
+Force_Layout::Force_Layout(int numNodes, const std::vector<Edge>& edges, Thread_Pool& pool)
+    : numNodes(std::max(0, numNodes)), pool(pool) {
+    const size_t n = static_cast<size_t>(this->numNodes);
+    auto valid = [&](const Edge& edge) {
+        return edge.getNode1() != edge.getNode2() && edge.getNode1() >= 0 && edge.getNode2() >= 0 &&
+               edge.getNode1() < this->numNodes && edge.getNode2() < this->numNodes;
+    };
+    offsets.assign(n + 1, 0);
+    for (const auto& edge : edges) {
+        if (valid(edge)) {
+            ++offsets[edge.getNode1() + 1];
+            ++offsets[edge.getNode2() + 1];
+        }
+    }
+    for (size_t v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    neighbours.resize(offsets[n]);
+    similarities.resize(offsets[n]);
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto& edge : edges) {
+        if (!valid(edge)) {
+            continue;
+        }
+        const double similarity = std::max(0.0, 1.0 - edge.getWeight());
+        neighbours[fill[edge.getNode1()]] = edge.getNode2();
+        similarities[fill[edge.getNode1()]++] = similarity;
+        neighbours[fill[edge.getNode2()]] = edge.getNode1();
+        similarities[fill[edge.getNode2()]++] = similarity;
+    }
+    mass.resize(n);
+    for (size_t v = 0; v < n; ++v) {
+        mass[v] = static_cast<double>(offsets[v + 1] - offsets[v]) + 1.0;
+    }
+}
+
+void Force_Layout::buildCell(int cell, int begin, int end, double minX, double minY, double size, int depth) {
+    double total = 0.0, sumX = 0.0, sumY = 0.0;
+    for (int k = begin; k < end; ++k) {
+        const int v = indices[k];
+        total += mass[v];
+        sumX += mass[v] * x[v];
+        sumY += mass[v] * y[v];
+    }
+    cells[cell] = {sumX / total, sumY / total, total, size, -1, 0, begin, end};
+    if (end - begin <= 1 || depth >= kMaxDepth) {
+        return;
+    }
+
+    // Split the range into the four quadrants: lower half first, then left before right
+    const double half = size / 2;
+    const double midX = minX + half, midY = minY + half;
+    auto* first = indices.data() + begin;
+    auto* last = indices.data() + end;
+    auto* upper = std::partition(first, last, [&](int v) { return y[v] < midY; });
+    auto* lowerRight = std::partition(first, upper, [&](int v) { return x[v] < midX; });
+    auto* upperRight = std::partition(upper, last, [&](int v) { return x[v] < midX; });
+    const std::array<int, 5> bounds = {begin, static_cast<int>(lowerRight - indices.data()), static_cast<int>(upper - indices.data()),
+                                       static_cast<int>(upperRight - indices.data()), end};
+
+    const int firstChild = static_cast<int>(cells.size());
+    int numChildren = 0;
+    for (int q = 0; q < 4; ++q) {
+        numChildren += bounds[q] < bounds[q + 1];
+    }
+    cells[cell].firstChild = firstChild;
+    cells[cell].numChildren = numChildren;
+    cells.resize(cells.size() + numChildren);
+    int child = firstChild;
+    for (int q = 0; q < 4; ++q) {
+        if (bounds[q] < bounds[q + 1]) {
+            buildCell(child++, bounds[q], bounds[q + 1], (q & 1) ? midX : minX, (q & 2) ? midY : minY, half, depth + 1);
+        }
+    }
+}
+
+void Force_Layout::repel(int node, double coefficient, double theta) {
+    double fx = 0.0, fy = 0.0;
+    const double px = x[node], py = y[node], m = mass[node];
+    std::array<int, 4 * kMaxDepth + 4> stack;
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = cells[stack[--top]];
+        if (cell.firstChild < 0) {
+            for (int k = cell.begin; k < cell.end; ++k) {
+                const int other = indices[k];
+                const double dx = px - x[other], dy = py - y[other];
+                const double d2 = dx * dx + dy * dy;
+                if (other != node && d2 > 0) {
+                    const double factor = coefficient * m * mass[other] / d2;
+                    fx += dx * factor;
+                    fy += dy * factor;
+                }
+            }
+            continue;
+        }
+        const double dx = px - cell.centerX, dy = py - cell.centerY;
+        const double d2 = dx * dx + dy * dy;
+        if (d2 > 0 && std::sqrt(d2) * theta > cell.size) {
+            const double factor = coefficient * m * cell.mass / d2;
+            fx += dx * factor;
+            fy += dy * factor;
+        } else {
+            for (int c = 0; c < cell.numChildren; ++c) {
+                stack[top++] = cell.firstChild + c;
+            }
+        }
+    }
+    forceX[node] += fx;
+    forceY[node] += fy;
+}
+
+void Force_Layout::run(const Layout_Config& config) {
+    Scoped_Timer timer("force_layout");
+    const size_t n = static_cast<size_t>(numNodes);
+    std::mt19937_64 rng(config.seed);
+    const double extent = 10.0 * std::sqrt(static_cast<double>(std::max<size_t>(1, n)));
+    std::uniform_real_distribution<double> place(-extent, extent);
+    x.resize(n);
+    y.resize(n);
+    for (size_t v = 0; v < n; ++v) {
+        x[v] = place(rng);
+        y[v] = place(rng);
+    }
+    forceX.assign(n, 0.0);
+    forceY.assign(n, 0.0);
+    oldForceX.assign(n, 0.0);
+    oldForceY.assign(n, 0.0);
+    indices.resize(n);
+    if (n < 2) {
+        return;
+    }
+
+    std::vector<double> weights(similarities.size());
+    for (size_t s = 0; s < similarities.size(); ++s) {
+        weights[s] = config.edgeWeightInfluence == 0.0 ? 1.0 : std::pow(similarities[s], config.edgeWeightInfluence);
+    }
+    std::vector<double> swinging(n), traction(n);
+    double speed = 1.0, speedEfficiency = 1.0;
+    const size_t grain = std::max<size_t>(64, n / (8 * static_cast<size_t>(pool.getNumThreads())));
+
+    for (int iteration = 0; iteration < config.iterations; ++iteration) {
+        std::swap(forceX, oldForceX);
+        std::swap(forceY, oldForceY);
+
+        // Quadtree over the bounding square
+        const auto [minX, maxX] = std::minmax_element(x.begin(), x.end());
+        const auto [minY, maxY] = std::minmax_element(y.begin(), y.end());
+        const double size = std::max({*maxX - *minX, *maxY - *minY, 1e-9}) * (1 + 1e-9);
+        std::iota(indices.begin(), indices.end(), 0);
+        cells.assign(1, Cell());
+        buildCell(0, 0, static_cast<int>(n), *minX, *minY, size, 0);
+
+        // Each node sums its own forces
+        pool.parallelFor(0, n, [&](size_t start, size_t end) {
+            for (size_t v = start; v < end; ++v) {
+                forceX[v] = 0.0;
+                forceY[v] = 0.0;
+                repel(static_cast<int>(v), config.scalingRatio, config.theta);
+
+                const double distance = std::sqrt(x[v] * x[v] + y[v] * y[v]);
+                if (distance > 0) {
+                    const double pull = config.scalingRatio * mass[v] * config.gravity / (config.strongGravity ? 1.0 : distance);
+                    forceX[v] -= x[v] * pull;
+                    forceY[v] -= y[v] * pull;
+                }
+
+                for (size_t s = offsets[v]; s < offsets[v + 1]; ++s) {
+                    const int other = neighbours[s];
+                    const double dx = x[v] - x[other], dy = y[v] - y[other];
+                    double factor = -weights[s];
+                    if (config.linLog) {
+                        const double d = std::sqrt(dx * dx + dy * dy);
+                        factor = d > 0 ? factor * std::log1p(d) / d : 0.0;
+                    }
+                    forceX[v] += dx * factor;
+                    forceY[v] += dy * factor;
+                }
+
+                const double sx = oldForceX[v] - forceX[v], sy = oldForceY[v] - forceY[v];
+                const double tx = oldForceX[v] + forceX[v], ty = oldForceY[v] + forceY[v];
+                swinging[v] = mass[v] * std::sqrt(sx * sx + sy * sy);
+                traction[v] = mass[v] * 0.5 * std::sqrt(tx * tx + ty * ty);
+            }
+        }, grain);
+
+        // Adaptive speed (as in Gephi's ForceAtlas2), summed in node order
+        const double totalSwinging = std::accumulate(swinging.begin(), swinging.end(), 0.0);
+        const double totalTraction = std::accumulate(traction.begin(), traction.end(), 0.0);
+        const double estimatedJitter = 0.05 * std::sqrt(static_cast<double>(n));
+        const double minJitter = std::sqrt(estimatedJitter), maxJitter = 10.0;
+        double jitter = config.jitterTolerance *
+            std::max(minJitter, std::min(maxJitter, estimatedJitter * totalTraction / (static_cast<double>(n) * n)));
+        constexpr double minSpeedEfficiency = 0.05;
+        if (totalTraction > 0 && totalSwinging / totalTraction > 2.0) {
+            if (speedEfficiency > minSpeedEfficiency) {
+                speedEfficiency *= 0.5;
+            }
+            jitter = std::max(jitter, config.jitterTolerance);
+        }
+        if (totalSwinging > 0) {
+            const double targetSpeed = jitter * speedEfficiency * totalTraction / totalSwinging;
+            if (totalSwinging > jitter * totalTraction) {
+                if (speedEfficiency > minSpeedEfficiency) {
+                    speedEfficiency *= 0.7;
+                }
+            } else if (speed < 1000) {
+                speedEfficiency *= 1.3;
+            }
+            speed += std::min(targetSpeed - speed, 0.5 * speed);
+        }
+
+        pool.parallelFor(0, n, [&](size_t start, size_t end) {
+            for (size_t v = start; v < end; ++v) {
+                const double factor = speed / (1.0 + std::sqrt(speed * swinging[v]));
+                x[v] += forceX[v] * factor;
+                y[v] += forceY[v] * factor;
+            }
+        }, grain);
+    }
+    timer.addItems(n * static_cast<size_t>(std::max(0, config.iterations)));
+}
+
+const std::vector<double>& Force_Layout::getX() const {
+    return x;
+}
+
+const std::vector<double>& Force_Layout::getY() const {
+    return y;
+}
@@ -0,0 +1,408 @@
+#include "graph_writer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <fmt/format.h>
+
+namespace {
+    constexpr size_t CHUNK_ROWS = 8192; ///< Rows formatted into one buffer.
+
+    constexpr char BINARY_MAGIC[8] = {'F', 'C', 'T', 'G', 'R', 'A', 'P', 'H'};
+    constexpr uint32_t BINARY_VERSION = 1;
+    constexpr uint64_t BINARY_ALIGNMENT = 64; ///< Size of the header and directory entries, and column alignment.
+    constexpr size_t BINARY_NAME_SIZE = 40;   ///< Column name field, NUL-padded.
+
+    /**
+     * @brief Element types of the binary columns.
+     */
+    enum Column_Type : uint8_t { INT32 = 1, FLOAT64 = 2, UINT8 = 3, INT64 = 4 };
+
+    /**
+     * @brief A column to write: name, type and contiguous elements.
+     */
+    struct Column {
+        std::string name;
+        Column_Type type;
+        const void* data;
+        uint64_t count;
+        size_t elementSize;
+    };
+
+    template <typename T>
+    Column makeColumn(const std::string& name, Column_Type type, const std::vector<T>& values) {
+        return {name, type, values.data(), values.size(), sizeof(T)};
+    }
+
+    /**
+     * @brief Dictionary encoding of strings: codes in order of first appearance.
+     */
+    struct String_Dictionary {
+        std::unordered_map<std::string_view, int32_t> ids; ///< Views into the statements.
+        std::vector<int64_t> offsets{0};                   ///< Start of each string in `data`, plus the end.
+        std::vector<uint8_t> data;                         ///< Concatenated UTF-8 strings.
+
+        int32_t encode(const std::string& value) {
+            auto [it, inserted] = ids.emplace(value, static_cast<int32_t>(offsets.size() - 1));
+            if (inserted) {
+                data.insert(data.end(), value.begin(), value.end());
+                offsets.push_back(static_cast<int64_t>(data.size()));
+            }
+            return it->second;
+        }
+    };
+
+    /**
+     * @brief Appends text with the five XML special characters escaped.
+     */
+    void appendEscaped(fmt::memory_buffer& buffer, std::string_view text) {
+        size_t start = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            std::string_view entity;
+            switch (text[i]) {
+                case '&': entity = "&amp;"; break;
+                case '<': entity = "&lt;"; break;
+                case '>': entity = "&gt;"; break;
+                case '"': entity = "&quot;"; break;
+                case '\'': entity = "&apos;"; break;
+                default: continue;
+            }
+            buffer.append(text.data() + start, text.data() + i);
+            buffer.append(entity.data(), entity.data() + entity.size());
+            start = i + 1;
+        }
+        buffer.append(text.data() + start, text.data() + text.size());
+    }
+
+    /**
+     * @brief Formats rows [0, count) in chunks on the pool and writes them in order.
+     *
+     * Two sets of buffers alternate: the pool formats the next wave of chunks into one while
+     * the calling thread writes the other.
+     *
+     * @param file Output stream.
+     * @param pool Pool formatting the chunks.
+     * @param count Number of rows.
+     * @param formatRow Appends row `i` to a buffer: formatRow(buffer, i).
+     * @return True if every write succeeded.
+     */
+    template <typename Format_Row>
+    bool writeRows(std::ofstream& file, Thread_Pool& pool, size_t count, const Format_Row& formatRow) {
+        const size_t numChunks = (count + CHUNK_ROWS - 1) / CHUNK_ROWS;
+        const size_t waveChunks = 2 * static_cast<size_t>(pool.getNumThreads());
+        const size_t numWaves = (numChunks + waveChunks - 1) / waveChunks;
+        std::vector<fmt::memory_buffer> buffers[2];
+        buffers[0].resize(waveChunks);
+        buffers[1].resize(waveChunks);
+
+        auto formatWave = [&](size_t wave, Task_Group& group) {
+            auto& set = buffers[wave % 2];
+            for (size_t slot = 0; slot < waveChunks; ++slot) {
+                const size_t chunk = wave * waveChunks + slot;
+                if (chunk >= numChunks) {
+                    break;
+                }
+                group.run([&formatRow, &set, slot, chunk, count]() {
+                    auto& buffer = set[slot];
+                    buffer.clear();
+                    const size_t end = std::min(count, (chunk + 1) * CHUNK_ROWS);
+                    for (size_t row = chunk * CHUNK_ROWS; row < end; ++row) {
+                        formatRow(buffer, row);
+                    }
+                });
+            }
+        };
+
+        if (numWaves > 0) {
+            Task_Group group(pool);
+            formatWave(0, group);
+            group.wait();
+        }
+        for (size_t wave = 0; wave < numWaves; ++wave) {
+            Task_Group group(pool);
+            if (wave + 1 < numWaves) {
+                formatWave(wave + 1, group);
+            }
+            const auto& set = buffers[wave % 2];
+            for (size_t slot = 0; slot < waveChunks && wave * waveChunks + slot < numChunks; ++slot) {
+                file.write(set[slot].data(), static_cast<std::streamsize>(set[slot].size()));
+            }
+            group.wait();
+        }
+        return static_cast<bool>(file);
+    }
+
+    double attributeValue(const Node_Attribute& attribute, size_t node) {
+        return node < attribute.values.size() ? attribute.values[node] : 0.0;
+    }
+
+    bool openOutput(std::ofstream& file, const std::string& filename) {
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool finishOutput(std::ofstream& file, const std::string& filename) {
+        file.close();
+        if (file.fail()) {
+            std::cerr << "Error: Could not write file " << filename << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+Graph_Writer::Graph_Writer(Thread_Pool& pool) : pool(pool) {
+}
+
+bool Graph_Writer::writeEdgeCsv(const std::string& filename, const std::vector<Edge>& edges) const {
+    std::ofstream file;
+    if (!openOutput(file, filename)) {
+        return false;
+    }
+    file << "source,target,weight\n";
+    writeRows(file, pool, edges.size(), [&edges](fmt::memory_buffer& buffer, size_t i) {
+        const Edge& edge = edges[i];
+        fmt::format_to(std::back_inserter(buffer), "{},{},{:g}\n", edge.getNode1(), edge.getNode2(), edge.getWeight());
+    });
+    return finishOutput(file, filename);
+}
+
+bool Graph_Writer::writeNodeCsv(const std::string& filename, int numNodes, const Statements& statements,
+                                const std::vector<Node_Attribute>& attributes) const {
+    std::ofstream file;
+    if (!openOutput(file, filename)) {
+        return false;
+    }
+    file << "node_id,verdict";
+    for (const auto& attribute : attributes) {
+        file << ',' << attribute.name;
+    }
+    file << '\n';
+    writeRows(file, pool, static_cast<size_t>(std::max(0, numNodes)), [&](fmt::memory_buffer& buffer, size_t i) {
+        const Statement* statement = statements.findStatement(static_cast<int>(i));
+        auto out = std::back_inserter(buffer);
+        fmt::format_to(out, "{},{}", i, statement ? verdictToString(statement->getVerdict()) : "unknown");
+        for (const auto& attribute : attributes) {
+            fmt::format_to(out, ",{:g}", attributeValue(attribute, i));
+        }
+        buffer.push_back('\n');
+    });
+    return finishOutput(file, filename);
+}
+
+bool Graph_Writer::writeGraphML(const std::string& filename, int numNodes, const std::vector<Edge>& edges,
+                                const Statements& statements, const std::vector<Node_Attribute>& attributes) const {
+    std::ofstream file;
+    if (!openOutput(file, filename)) {
+        return false;
+    }
+
+    file << R"(<?xml version="1.0" encoding="UTF-8"?>)" << '\n';
+    file << R"(<graphml xmlns="http://graphml.graphdrawing.org/xmlns")" << '\n';
+    file << R"(    xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance")" << '\n';
+    file << R"(    xsi:schemaLocation="http://graphml.graphdrawing.org/xmlns )" << '\n';
+    file << R"(     http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd">)" << '\n';
+    file << R"(<graph id="G" edgedefault="undirected">)" << '\n';
+    file << R"(<key id="verdict" for="node" attr.name="verdict" attr.type="string"/>)" << '\n';
+    file << R"(<key id="originator" for="node" attr.name="statement_originator" attr.type="string"/>)" << '\n';
+    file << R"(<key id="source" for="node" attr.name="statement_source" attr.type="string"/>)" << '\n';
+    file << R"(<key id="factchecker" for="node" attr.name="factchecker" attr.type="string"/>)" << '\n';
+    file << R"(<key id="factcheck_date" for="node" attr.name="factcheck_date" attr.type="string"/>)" << '\n';
+    for (const auto& attribute : attributes) {
+        file << R"(<key id=")" << attribute.name << R"(" for="node" attr.name=")" << attribute.name << R"(" attr.type="double"/>)" << '\n';
+    }
+    file << R"(<key id="weight" for="edge" attr.name="weight" attr.type="double"/>)" << '\n';
+    file << R"(<key id="label" for="edge" attr.name="label" attr.type="string"/>)" << '\n';
+
+    // Nodes touched by an edge, in increasing order
+    std::vector<char> touched(static_cast<size_t>(std::max(0, numNodes)), 0);
+    for (const auto& edge : edges) {
+        touched[edge.getNode1()] = 1;
+        touched[edge.getNode2()] = 1;
+    }
+    std::vector<int> nodes;
+    for (size_t node = 0; node < touched.size(); ++node) {
+        if (touched[node]) {
+            nodes.push_back(static_cast<int>(node));
+        }
+    }
+
+    static const std::string empty;
+    writeRows(file, pool, nodes.size(), [&](fmt::memory_buffer& buffer, size_t i) {
+        const int node = nodes[i];
+        const Statement* statement = statements.findStatement(node);
+        auto out = std::back_inserter(buffer);
+        fmt::format_to(out, "  <node id=\"{}\">\n    <data key=\"verdict\">{}</data>\n    <data key=\"originator\">", node,
+                       statement ? verdictToString(statement->getVerdict()) : "unknown");
+        appendEscaped(buffer, statement ? statement->getOriginator() : empty);
+        fmt::format_to(out, "</data>\n    <data key=\"source\">");
+        appendEscaped(buffer, statement ? statement->getSource() : empty);
+        fmt::format_to(out, "</data>\n    <data key=\"factchecker\">");
+        appendEscaped(buffer, statement ? statement->getFactchecker() : empty);
+        fmt::format_to(out, "</data>\n    <data key=\"factcheck_date\">");
+        appendEscaped(buffer, statement ? statement->getFactcheckDate() : empty);
+        fmt::format_to(out, "</data>\n");
+        for (const auto& attribute : attributes) {
+            fmt::format_to(out, "    <data key=\"{}\">{:g}</data>\n", attribute.name, attributeValue(attribute, node));
+        }
+        fmt::format_to(out, "  </node>\n");
+    });
+
+    writeRows(file, pool, edges.size(), [&edges](fmt::memory_buffer& buffer, size_t i) {
+        const Edge& edge = edges[i];
+        const double scaledWeight = (1.0 - edge.getWeight()) * 100; // Scale weight for better visualization
+        fmt::format_to(std::back_inserter(buffer),
+                       "  <edge id=\"e{}\" source=\"{}\" target=\"{}\">\n    <data key=\"weight\">{:g}</data>\n"
+                       "    <data key=\"label\">{:g}</data>\n  </edge>\n",
+                       i, edge.getNode1(), edge.getNode2(), scaledWeight, scaledWeight);
+    });
+
+    file << "</graph>" << '\n';
+    file << "</graphml>" << '\n';
+    return finishOutput(file, filename);
+}
+
+bool Graph_Writer::writeBinary(const std::string& filename, int numNodes, const std::vector<Edge>& edges,
+                               const Statements& statements, const std::vector<int>& communities,
+                               const std::vector<Node_Attribute>& attributes) const {
+    numNodes = std::max(0, numNodes);
+    const size_t m = edges.size();
+    std::vector<int32_t> sources(m), targets(m);
+    std::vector<double> weights(m);
+    pool.parallelFor(0, m, [&](size_t start, size_t end) {
+        for (size_t e = start; e < end; ++e) {
+            sources[e] = edges[e].getNode1();
+            targets[e] = edges[e].getNode2();
+            weights[e] = edges[e].getWeight();
+        }
+    });
+
+    // Verdicts keep their enum order; 255 marks a missing statement
+    std::vector<uint8_t> verdicts(numNodes, 255);
+    std::vector<int32_t> community(numNodes, -1), dates(numNodes, 0);
+    std::vector<int32_t> originators(numNodes, -1), sourceCodes(numNodes, -1), factcheckers(numNodes, -1);
+    String_Dictionary originatorNames, sourceNames, factcheckerNames;
+    for (int i = 0; i < numNodes; ++i) {
+        if (i < static_cast<int>(communities.size())) {
+            community[i] = communities[i];
+        }
+        const Statement* statement = statements.findStatement(i);
+        if (!statement) {
+            continue;
+        }
+        verdicts[i] = static_cast<uint8_t>(statement->getVerdict());
+        const std::tm date = statement->getDate();
+        dates[i] = date.tm_year == 0 && date.tm_mday == 0 ? 0 : (date.tm_year + 1900) * 10000 + (date.tm_mon + 1) * 100 + date.tm_mday;
+        originators[i] = originatorNames.encode(statement->getOriginator());
+        sourceCodes[i] = sourceNames.encode(statement->getSource());
+        factcheckers[i] = factcheckerNames.encode(statement->getFactchecker());
+    }
+
+    std::vector<std::vector<double>> attributeColumns;
+    attributeColumns.reserve(attributes.size());
+    for (const auto& attribute : attributes) {
+        auto& values = attributeColumns.emplace_back(numNodes, 0.0);
+        std::copy_n(attribute.values.begin(), std::min(values.size(), attribute.values.size()), values.begin());
+    }
+
+    std::vector<Column> columns = {
+        makeColumn("edge.source", INT32, sources),
+        makeColumn("edge.target", INT32, targets),
+        makeColumn("edge.weight", FLOAT64, weights),
+        makeColumn("node.verdict", UINT8, verdicts),
+        makeColumn("node.community", INT32, community),
+        makeColumn("node.date", INT32, dates),
+        makeColumn("node.originator", INT32, originators),
+        makeColumn("node.originator.offsets", INT64, originatorNames.offsets),
+        makeColumn("node.originator.data", UINT8, originatorNames.data),
+        makeColumn("node.source", INT32, sourceCodes),
+        makeColumn("node.source.offsets", INT64, sourceNames.offsets),
+        makeColumn("node.source.data", UINT8, sourceNames.data),
+        makeColumn("node.factchecker", INT32, factcheckers),
+        makeColumn("node.factchecker.offsets", INT64, factcheckerNames.offsets),
+        makeColumn("node.factchecker.data", UINT8, factcheckerNames.data),
+    };
+    for (size_t a = 0; a < attributes.size(); ++a) {
+        columns.push_back(makeColumn("node." + attributes[a].name, FLOAT64, attributeColumns[a]));
+    }
+
+    std::ofstream file;
+    if (!openOutput(file, filename)) {
+        return false;
+    }
+    auto align = [](uint64_t offset) {
+        return (offset + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+    };
+
+    char header[BINARY_ALIGNMENT] = {};
+    const uint32_t numColumns = static_cast<uint32_t>(columns.size());
+    const uint64_t nodeCount = static_cast<uint64_t>(numNodes);
+    const uint64_t edgeCount = m;
+    std::memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    std::memcpy(header + 8, &BINARY_VERSION, sizeof(uint32_t));
+    std::memcpy(header + 12, &numColumns, sizeof(uint32_t));
+    std::memcpy(header + 16, &nodeCount, sizeof(uint64_t));
+    std::memcpy(header + 24, &edgeCount, sizeof(uint64_t));
+    file.write(header, sizeof(header));
+
+    uint64_t offset = BINARY_ALIGNMENT * (1 + columns.size());
+    for (const auto& column : columns) {
+        char entry[BINARY_ALIGNMENT] = {};
+        std::memcpy(entry, column.name.data(), std::min(column.name.size(), BINARY_NAME_SIZE - 1));
+        entry[BINARY_NAME_SIZE] = static_cast<char>(column.type);
+        std::memcpy(entry + 48, &offset, sizeof(uint64_t));
+        std::memcpy(entry + 56, &column.count, sizeof(uint64_t));
+        file.write(entry, sizeof(entry));
+        offset = align(offset + column.count * column.elementSize);
+    }
+
+    const char padding[BINARY_ALIGNMENT] = {};
+    for (const auto& column : columns) {
+        const uint64_t bytes = column.count * column.elementSize;
+        file.write(static_cast<const char*>(column.data), static_cast<std::streamsize>(bytes));
+        file.write(padding, static_cast<std::streamsize>(align(bytes) - bytes));
+    }
+    return finishOutput(file, filename);
+}
+
+bool Graph_Writer::readCommunities(const std::string& filename, int numNodes, std::vector<int>& communities) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<int> assignment(std::max(0, numNodes), -1);
+    std::string line;
+    bool first = true;
+    while (std::getline(file, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        int node = 0, community = 0;
+        if (!(fields >> node >> community)) {
+            if (first || line.find_first_not_of(" \r") == std::string::npos) {
+                first = false;
+                continue;
+            }
+            std::cerr << "Error: Malformed community line in " << filename << ": " << line << std::endl;
+            return false;
+        }
+        first = false;
+        if (node < 0 || node >= numNodes || community < 0) {
+            std::cerr << "Error: Community assignment " << node << " -> " << community << " out of range in " << filename << std::endl;
+            return false;
+        }
+        assignment[node] = community;
+    }
+    communities.swap(assignment);
+    return true;
+}
@@ -0,0 +1,177 @@
+#include "group_network.h"
+#include "instrumentation.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <unordered_map>
+#include <fmt/format.h>
+
+namespace {
+
+// Statements are weighted by their number of words, at least one
+double countWords(const std::string& text) {
+    int words = 0;
+    bool inWord = false;
+    for (unsigned char c : text) {
+        const bool space = std::isspace(c) != 0;
+        words += !space && !inWord;
+        inWord = !space;
+    }
+    return std::max(1, words);
+}
+
+}
+
+Group_Network::Group_Network(const Statements& statements, int numTopics, Group_Key key, Thread_Pool& pool)
+    : numTopics(numTopics), key(key) {
+    Scoped_Timer timer("group_aggregation");
+    const int n = statements.getSize();
+
+    // Dictionary-encode the key, then bucket the statements by group (counting sort)
+    std::unordered_map<std::string, int> ids;
+    std::vector<int> groupOf(std::max(0, n), -1);
+    for (int i = 0; i < n; ++i) {
+        const Statement* statement = statements.findStatement(i);
+        if (!statement) {
+            continue;
+        }
+        const std::string& name = key == Group_Key::ORIGINATOR ? statement->getOriginator()
+                                : key == Group_Key::SOURCE     ? statement->getSource()
+                                                               : statement->getFactchecker();
+        auto [it, inserted] = ids.emplace(name, static_cast<int>(groups.size()));
+        if (inserted) {
+            groups.emplace_back();
+            groups.back().name = name;
+        }
+        groupOf[i] = it->second;
+    }
+    const size_t numGroups = groups.size();
+    std::vector<size_t> offsets(numGroups + 1, 0);
+    for (int group : groupOf) {
+        if (group >= 0) {
+            ++offsets[group + 1];
+        }
+    }
+    for (size_t g = 0; g < numGroups; ++g) {
+        offsets[g + 1] += offsets[g];
+    }
+    std::vector<int> members(offsets[numGroups]);
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        if (groupOf[i] >= 0) {
+            members[fill[groupOf[i]]++] = i;
+        }
+    }
+
+    // One pass over the groups; each sums its own statements, so no partial sums are merged
+    const size_t rowSize = static_cast<size_t>(std::max(0, numTopics));
+    pool.parallelFor(0, numGroups, [&](size_t start, size_t end) {
+        for (size_t g = start; g < end; ++g) {
+            Statement_Group& group = groups[g];
+            group.topics.assign(rowSize, 0.0);
+            for (size_t m = offsets[g]; m < offsets[g + 1]; ++m) {
+                const Statement* statement = statements.findStatement(members[m]);
+                ++group.statements;
+                ++group.verdicts[static_cast<size_t>(statement->getVerdict())];
+                const std::tm date = statement->getDate();
+                if (date.tm_mday != 0) {
+                    group.latestDate = std::max(group.latestDate,
+                                                (date.tm_year + 1900) * 10000 + (date.tm_mon + 1) * 100 + date.tm_mday);
+                }
+                const std::vector<double> topics = statements.getTopics(members[m]);
+                if (topics.size() != rowSize) {
+                    continue;
+                }
+                const double weight = countWords(statement->getComment());
+                for (size_t t = 0; t < rowSize; ++t) {
+                    group.topics[t] += weight * topics[t];
+                }
+                group.weight += weight;
+            }
+            if (group.weight > 0) {
+                for (double& value : group.topics) {
+                    value /= group.weight;
+                }
+            }
+        }
+    }, std::max<size_t>(1, numGroups / (16 * static_cast<size_t>(pool.getNumThreads()))));
+
+    timer.addItems(static_cast<size_t>(std::max(0, n)));
+    std::cout << n << " statements grouped into " << numGroups << " " << keyName(key) << " groups\n";
+}
+
+const std::vector<Statement_Group>& Group_Network::getGroups() const {
+    return groups;
+}
+
+std::vector<std::vector<double>> Group_Network::getTopicMatrix() const {
+    std::vector<std::vector<double>> matrix;
+    matrix.reserve(groups.size());
+    for (const auto& group : groups) {
+        matrix.push_back(group.topics);
+    }
+    return matrix;
+}
+
+Statements Group_Network::toStatements() const {
+    Statements nodes;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const Statement_Group& group = groups[g];
+        const size_t verdict = static_cast<size_t>(
+            std::max_element(group.verdicts.begin(), group.verdicts.end()) - group.verdicts.begin());
+        const std::string date = group.latestDate == 0 ? std::string()
+            : fmt::format("{:02}/{:02}/{:04}", group.latestDate / 100 % 100, group.latestDate % 100, group.latestDate / 10000);
+        const std::string none;
+        nodes.addStatement(static_cast<int>(g), group.name, verdictToString(static_cast<Verdict>(verdict)), date,
+                           key == Group_Key::ORIGINATOR ? group.name : none,
+                           key == Group_Key::SOURCE ? group.name : none,
+                           key == Group_Key::FACTCHECKER ? group.name : none, none);
+        nodes.addTopics(static_cast<int>(g), group.topics);
+    }
+    return nodes;
+}
+
+std::vector<Node_Attribute> Group_Network::getAttributes() const {
+    std::vector<Node_Attribute> attributes;
+    attributes.push_back({"statements", {}});
+    for (size_t v = 0; v < 6; ++v) {
+        std::string name = std::string("verdict_") + verdictToString(static_cast<Verdict>(v));
+        std::replace(name.begin(), name.end(), '-', '_');
+        attributes.push_back({name, {}});
+    }
+    for (int t = 0; t < numTopics; ++t) {
+        attributes.push_back({fmt::format("topic_{}", t), {}});
+    }
+    for (auto& attribute : attributes) {
+        attribute.values.reserve(groups.size());
+    }
+    for (const auto& group : groups) {
+        attributes[0].values.push_back(group.statements);
+        for (size_t v = 0; v < 6; ++v) {
+            attributes[1 + v].values.push_back(group.verdicts[v]);
+        }
+        for (size_t t = 0; t < group.topics.size(); ++t) {
+            attributes[7 + t].values.push_back(group.topics[t]);
+        }
+    }
+    return attributes;
+}
+
+const char* Group_Network::keyName(Group_Key key) {
+    switch (key) {
+        case Group_Key::ORIGINATOR: return "originator";
+        case Group_Key::SOURCE: return "source";
+        case Group_Key::FACTCHECKER: return "factchecker";
+        default: return "unknown";
+    }
+}
+
+bool Group_Network::parseKey(const std::string& text, Group_Key& key) {
+    for (Group_Key candidate : {Group_Key::ORIGINATOR, Group_Key::SOURCE, Group_Key::FACTCHECKER}) {
+        if (text == keyName(candidate)) {
+            key = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,270 @@
+#include "instrumentation.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+    // Raises an atomic to at least `value`
+    void raiseTo(std::atomic<size_t>& target, size_t value) {
+        size_t current = target.load();
+        while (value > current && !target.compare_exchange_weak(current, value)) {
+        }
+    }
+}
+
+Instrumentation& Instrumentation::instance() {
+    static Instrumentation registry;
+    return registry;
+}
+
+Instrumentation::~Instrumentation() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stopSampler.notify_all();
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+}
+
+void Instrumentation::enable(int samplingIntervalMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (enabled) {
+        return;
+    }
+    origin = std::chrono::steady_clock::now();
+    enabled = true;
+    if (samplingIntervalMs > 0) {
+        sampler = std::thread(&Instrumentation::sampleLoop, this, samplingIntervalMs);
+    }
+}
+
+bool Instrumentation::isEnabled() const {
+    return enabled;
+}
+
+int64_t Instrumentation::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+uint32_t Instrumentation::threadId() {
+    auto it = threadIds.find(std::this_thread::get_id());
+    if (it != threadIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(threadIds.size());
+    threadIds.emplace(std::this_thread::get_id(), id);
+    return id;
+}
+
+std::shared_ptr<Stage_Record> Instrumentation::beginStage(const std::string& name) {
+    if (!enabled) {
+        return nullptr;
+    }
+    auto record = std::make_shared<Stage_Record>();
+    record->name = name;
+    record->rssStartBytes = currentRss();
+    record->peakRssBytes = record->rssStartBytes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    record->thread = threadId();
+    record->startMicros = now();
+    active.push_back(record);
+    return record;
+}
+
+void Instrumentation::endStage(const std::shared_ptr<Stage_Record>& record) {
+    if (!record) {
+        return;
+    }
+    record->rssEndBytes = currentRss();
+    raiseTo(record->peakRssBytes, record->rssEndBytes);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    record->durationMicros = now() - record->startMicros;
+    active.erase(std::remove(active.begin(), active.end(), record), active.end());
+    finished.push_back(record);
+}
+
+void Instrumentation::addCounter(const std::string& name, double value) {
+    if (!enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    counters[name] += value;
+}
+
+void Instrumentation::sampleLoop(int intervalMs) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        lock.unlock();
+        const size_t rss = currentRss();
+        lock.lock();
+
+        for (const auto& record : active) {
+            raiseTo(record->peakRssBytes, rss);
+        }
+        // Keep the trace's memory track at a bounded resolution
+        if (rssSamples.empty() || rssSamples.back().second != rss || now() - rssSamples.back().first > 100000) {
+            rssSamples.emplace_back(now(), rss);
+        }
+        stopSampler.wait_for(lock, std::chrono::milliseconds(intervalMs));
+    }
+}
+
+bool Instrumentation::writeReport(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    json stages = json::array();
+    json summary = json::object();
+    for (const auto& record : finished) {
+        const double seconds = record->durationMicros / 1e6;
+        json stage = {
+            {"name", record->name},
+            {"start_seconds", record->startMicros / 1e6},
+            {"seconds", seconds},
+            {"thread", record->thread},
+            {"bytes", record->bytes},
+            {"items", record->items},
+            {"bytes_per_second", seconds > 0 ? record->bytes / seconds : 0.0},
+            {"items_per_second", seconds > 0 ? record->items / seconds : 0.0},
+            {"rss_start_bytes", record->rssStartBytes},
+            {"rss_end_bytes", record->rssEndBytes},
+            {"peak_rss_bytes", record->peakRssBytes.load()},
+            {"counters", record->counters},
+        };
+        stages.push_back(stage);
+
+        json& total = summary[record->name];
+        if (total.is_null()) {
+            total = {{"calls", 0}, {"seconds", 0.0}, {"bytes", 0}, {"items", 0}, {"peak_rss_bytes", 0}};
+        }
+        total["calls"] = total["calls"].get<int>() + 1;
+        total["seconds"] = total["seconds"].get<double>() + seconds;
+        total["bytes"] = total["bytes"].get<uint64_t>() + record->bytes;
+        total["items"] = total["items"].get<uint64_t>() + record->items;
+        total["peak_rss_bytes"] = std::max(total["peak_rss_bytes"].get<size_t>(), record->peakRssBytes.load());
+    }
+
+    json report = {
+        {"wall_seconds", now() / 1e6},
+        {"peak_rss_bytes", processPeakRss()},
+        {"stages", stages},
+        {"summary", summary},
+        {"counters", counters},
+    };
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    out << report.dump(2) << "\n";
+    std::cout << "Instrumentation report written to " << filename << std::endl;
+    return true;
+}
+
+bool Instrumentation::writeChromeTrace(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    json events = json::array();
+    for (const auto& record : finished) {
+        json args = {{"bytes", record->bytes}, {"items", record->items}, {"peak_rss_bytes", record->peakRssBytes.load()}};
+        for (const auto& [name, value] : record->counters) {
+            args[name] = value;
+        }
+        events.push_back({{"name", record->name}, {"cat", "stage"}, {"ph", "X"}, {"ts", record->startMicros},
+                          {"dur", record->durationMicros}, {"pid", 1}, {"tid", record->thread}, {"args", args}});
+    }
+    for (const auto& [time, rss] : rssSamples) {
+        events.push_back({{"name", "rss"}, {"ph", "C"}, {"ts", time}, {"pid", 1}, {"args", {{"bytes", rss}}}});
+    }
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    out << json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump() << "\n";
+    std::cout << "Chrome trace written to " << filename << std::endl;
+    return true;
+}
+
+size_t Instrumentation::currentRss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+#else
+    return processPeakRss();
+#endif
+}
+
+size_t Instrumentation::processPeakRss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// --- Scoped_Timer ---
+
+Scoped_Timer::Scoped_Timer(const std::string& name) : record(Instrumentation::instance().beginStage(name)) {
+}
+
+Scoped_Timer::~Scoped_Timer() {
+    Instrumentation::instance().endStage(record);
+}
+
+void Scoped_Timer::addBytes(uint64_t bytes) {
+    if (record) {
+        record->bytes += bytes;
+    }
+}
+
+void Scoped_Timer::addItems(uint64_t items) {
+    if (record) {
+        record->items += items;
+    }
+}
+
+void Scoped_Timer::addCounter(const std::string& name, double value) {
+    if (record) {
+        record->counters[name] += value;
+    }
+}
@@ -0,0 +1,177 @@
+#include "mst_consensus.h"
+#include "instrumentation.h"
+#include "network_synthesizer.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <fmt/format.h>
+
+Mst_Consensus::Mst_Consensus(int numDocuments, int numTopics, Thread_Pool& pool)
+    : numDocuments(numDocuments), numTopics(numTopics), pool(pool), shards(new Shard[size_t(1) << shardBits]) {
+}
+
+bool Mst_Consensus::run(int replicas, const Planner_Config& planner, const Replica_Source& source) {
+    Scoped_Timer timer("mst_consensus");
+    if (replicas < 1) {
+        return true;
+    }
+
+    // Largest number of concurrent replicas whose fastest exact engine fits its share of the budget
+    const Planner_Config resolved = Execution_Planner(planner).plan(static_cast<size_t>(numDocuments), numTopics).config;
+    const size_t n = static_cast<size_t>(std::max(0, numDocuments));
+    auto choose = [&](int workers, Execution_Plan& plan) {
+        Planner_Config share = resolved;
+        share.memoryBudgetBytes = resolved.memoryBudgetBytes / static_cast<size_t>(workers);
+        share.cores = std::max(1u, resolved.cores / static_cast<unsigned int>(workers));
+        const Execution_Planner sharePlanner(share);
+        bool found = false;
+        // Out-of-core runs share one scratch directory, and kNN is approximate
+        for (Strategy strategy : {Strategy::DENSE_MATRIX, Strategy::FUSED_PRIM}) {
+            const Strategy_Estimate estimate = sharePlanner.estimate(strategy, n, numTopics);
+            if (estimate.fits && (!found || estimate.seconds < plan.estimates.front().seconds)) {
+                plan.strategy = strategy;
+                plan.config = share;
+                plan.estimates = {estimate};
+                found = true;
+            }
+        }
+        return found;
+    };
+    Execution_Plan plan;
+    int workers = std::min<int>(replicas, static_cast<int>(std::max(1u, resolved.cores)));
+    while (workers > 1 && !choose(workers, plan)) {
+        --workers;
+    }
+    const bool found = workers > 1 || choose(1, plan);
+    if (!found) {
+        std::cerr << "Error: No MST engine fits the memory budget for the consensus replicas." << std::endl;
+        return false;
+    }
+    std::cout << "Consensus: " << replicas << " replicas, " << workers << " at a time with "
+              << Execution_Planner::strategyName(plan.strategy) << " (about "
+              << Execution_Planner::formatBytes(plan.estimates.front().memoryBytes) << " each)\n";
+
+    // Workers pull replicas until none are left or one fails
+    std::atomic<int> next{0};
+    std::atomic<bool> ok{true};
+    Task_Group group(pool);
+    for (int worker = 0; worker < workers; ++worker) {
+        group.run([&]() {
+            for (int replica = next++; replica < replicas && ok; replica = next++) {
+                std::vector<std::vector<double>> documents;
+                if (!source(replica, documents) || static_cast<int>(documents.size()) != numDocuments) {
+                    std::cerr << "Error: Consensus replica " << replica << " could not be built." << std::endl;
+                    ok = false;
+                    return;
+                }
+                Network_Synthesizer synthesizer(std::move(documents), numTopics, pool);
+                synthesizer.execute(plan);
+                addTree(synthesizer.getMST());
+            }
+        });
+    }
+    group.wait();
+    timer.addItems(static_cast<size_t>(getNumTrees()));
+    return ok;
+}
+
+void Mst_Consensus::addTree(const std::vector<Edge>& tree) {
+    for (const auto& edge : tree) {
+        const uint64_t first = static_cast<uint32_t>(std::min(edge.getNode1(), edge.getNode2()));
+        const uint64_t second = static_cast<uint32_t>(std::max(edge.getNode1(), edge.getNode2()));
+        const uint64_t key = first << 32 | second;
+        Shard& shard = shards[(key * 0x9E3779B97F4A7C15ull) >> (64 - shardBits)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Edge_Tally& tally = shard.tallies[key];
+        ++tally.count;
+        tally.weightSum += edge.getWeight();
+    }
+    ++numTrees;
+}
+
+int Mst_Consensus::getNumTrees() const {
+    return numTrees;
+}
+
+std::vector<Consensus_Edge> Mst_Consensus::getEdges() const {
+    std::vector<Consensus_Edge> result;
+    const double trees = std::max(1, getNumTrees());
+    for (size_t s = 0; s < (size_t(1) << shardBits); ++s) {
+        std::lock_guard<std::mutex> lock(shards[s].mutex);
+        for (const auto& [key, tally] : shards[s].tallies) {
+            result.push_back({static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFFu), tally.count,
+                              tally.count / trees, tally.weightSum / tally.count});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Consensus_Edge& a, const Consensus_Edge& b) {
+        if (a.count != b.count) {
+            return a.count > b.count;
+        }
+        if (a.meanWeight != b.meanWeight) {
+            return a.meanWeight < b.meanWeight;
+        }
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+    return result;
+}
+
+bool Mst_Consensus::writeCsv(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "source,target,support,count,mean_weight\n");
+    for (const auto& edge : getEdges()) {
+        fmt::format_to(std::back_inserter(buffer), "{},{},{},{},{}\n", edge.first, edge.second, edge.support,
+                       edge.count, edge.meanWeight);
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+std::vector<std::vector<double>> Mst_Consensus::bootstrapTopics(const std::vector<std::vector<double>>& documents,
+                                                                uint64_t seed) {
+    const size_t numTopics = documents.empty() ? 0 : documents.front().size();
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> draw(0, numTopics > 0 ? numTopics - 1 : 0);
+    std::vector<size_t> columns(numTopics);
+    for (auto& column : columns) {
+        column = draw(rng);
+    }
+    std::vector<std::vector<double>> replica(documents.size(), std::vector<double>(numTopics));
+    for (size_t i = 0; i < documents.size(); ++i) {
+        for (size_t t = 0; t < numTopics; ++t) {
+            replica[i][t] = columns[t] < documents[i].size() ? documents[i][columns[t]] : 0.0;
+        }
+    }
+    return replica;
+}
+
+bool Mst_Consensus::parseConfig(const std::string& text, Consensus_Config& config) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    const std::string kind = text.substr(0, colon);
+    try {
+        const int replicas = std::stoi(text.substr(colon + 1));
+        if (replicas < 1) {
+            return false;
+        }
+        if (kind == "bootstrap") {
+            config.kind = Replica_Kind::TOPIC_BOOTSTRAP;
+        } else if (kind == "lda") {
+            config.kind = Replica_Kind::LDA_SEEDS;
+        } else {
+            return false;
+        }
+        config.replicas = replicas;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
@@ -1,76 +1,119 @@
 #include "network.h"
+#include "instrumentation.h"
+#include "uf_ds.h"
 #include <iostream>
 #include <algorithm>
-#include <thread>
-#include <mutex>
 
 void Network::addEdge(int source, int target, double weight, int id) {
     edges.emplace_back(source, target, weight, id);
 }
 
-void Network::buildFromSimilarityMatrix(const std::vector<double>& upperTriangle, int numNodes) {
+void Network::buildFromSimilarityMatrix(const std::vector<double>& upperTriangle, int numNodes, Thread_Pool& pool) {
     edges.clear(); // Clear any existing edges
-    std::mutex edgeMutex; // Mutex to protect shared resources
 
-    // Determine the number of threads to use
-    const size_t numThreads = std::thread::hardware_concurrency();
-    if (numThreads == 0) {
-        throw std::runtime_error("No available threads for multithreading!");
-    }
+    const size_t n = static_cast<size_t>(numNodes);
+    const size_t numEdges = n < 2 ? 0 : n * (n - 1) / 2;
 
     // Lambda function for calculating the index in the 1D upper triangular matrix
-    auto index = [&](size_t i, size_t j) -> size_t {
-        return (i * (2 * static_cast<size_t>(numNodes) - i - 1)) / 2 + (j - i - 1);
+    auto index = [n](size_t i, size_t j) -> size_t {
+        return (i * (2 * n - i - 1)) / 2 + (j - i - 1);
     };
 
-    // Function to process a range of rows
-    auto processRange = [&](size_t start, size_t end, std::vector<Edge>& threadEdges) {
-        for (size_t i = start; i < end; ++i) {
-            for (size_t j = i + 1; j < static_cast<size_t>(numNodes); ++j) {
-                double weight = upperTriangle[index(i, j)];
-                if (weight > 0.0) {
-                    threadEdges.emplace_back(static_cast<int>(i), static_cast<int>(j), weight, 0);
+    {
+        Scoped_Timer timer("edge_extraction");
+        timer.addItems(numEdges);
+        timer.addBytes(numEdges * sizeof(Edge));
+        edges.resize(numEdges);
+
+        // Every pair becomes an edge, so edge (i, j) takes the slot of its matrix entry and
+        // rows can be filled concurrently without any merging. Rows shrink with i, so they are
+        // handed out in small chunks for the workers to balance by stealing.
+        pool.parallelFor(0, n, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; ++i) {
+                for (size_t j = i + 1; j < n; ++j) {
+                    size_t id = index(i, j);
+                    edges[id] = Edge(static_cast<int>(i), static_cast<int>(j), upperTriangle[id], static_cast<int>(id));
                 }
             }
-        }
-    };
+        }, std::max<size_t>(1, n / (16 * pool.getNumThreads())));
+    }
 
-    // Divide the work among threads
-    std::vector<std::thread> threads;
-    std::vector<std::vector<Edge>> threadResults(numThreads); // Store results from each thread
-    size_t rowsPerThread = numNodes / numThreads;
+    // Sort edges by weight (ties broken by node pair so the MST is reproducible)
+    Scoped_Timer timer("edge_sort");
+    timer.addItems(numEdges);
+    pool.parallelSort(edges.begin(), edges.end(), compareByWeight);
+}
 
-    for (size_t t = 0; t < numThreads; ++t) {
-        size_t start = t * rowsPerThread;
-        size_t end = (t == numThreads - 1) ? static_cast<size_t>(numNodes) : start + rowsPerThread;
 
-        threads.emplace_back(processRange, start, end, std::ref(threadResults[t]));
-    }
+const std::vector<Edge>& Network::getEdges() const {
+    return edges;
+}
 
-    // Join all threads
-    for (auto& thread : threads) {
-        thread.join();
+std::vector<Percolation_Point> Network::sweepPercolation(int numNodes, const std::vector<Edge>& edges,
+                                                        const std::vector<double>& thresholds) {
+    numNodes = std::max(0, numNodes);
+    std::vector<Edge> sortedCopy;
+    const std::vector<Edge>* sorted = &edges;
+    if (!std::is_sorted(edges.begin(), edges.end(), compareByWeight)) {
+        sortedCopy = edges;
+        std::sort(sortedCopy.begin(), sortedCopy.end(), compareByWeight);
+        sorted = &sortedCopy;
     }
 
-    // Combine results from all threads
-    for (const auto& threadEdges : threadResults) {
-        edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
+    // Thresholds are visited in increasing order while the edges are replayed
+    std::vector<size_t> order(thresholds.size());
+    for (size_t t = 0; t < order.size(); ++t) {
+        order[t] = t;
     }
+    std::sort(order.begin(), order.end(), [&thresholds](size_t a, size_t b) { return thresholds[a] < thresholds[b]; });
 
-    // Assign unique IDs to edges
-    for (size_t id = 0; id < edges.size(); ++id) {
-        edges[id] = Edge(edges[id].getNode1(), edges[id].getNode2(), edges[id].getWeight(), static_cast<int>(id));
+    UF_DS uf(numNodes);
+    std::vector<int> size(numNodes, 1);
+    int components = numNodes, singletons = numNodes, giantSize = numNodes > 0 ? 1 : 0;
+    std::vector<Percolation_Point> points(thresholds.size());
+    size_t next = 0;
+    for (size_t t : order) {
+        for (; next < sorted->size() && (*sorted)[next].getWeight() <= thresholds[t]; ++next) {
+            const int a = uf.find((*sorted)[next].getNode1());
+            const int b = uf.find((*sorted)[next].getNode2());
+            if (a == b) {
+                continue;
+            }
+            singletons -= (size[a] == 1) + (size[b] == 1);
+            uf.unite(a, b);
+            const int root = uf.find(a);
+            size[root] = size[a] + size[b];
+            giantSize = std::max(giantSize, size[root]);
+            --components;
+        }
+        points[t] = {thresholds[t], components, giantSize, singletons};
     }
-
-    // Sort edges by weight
-    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
-        return a.getWeight() < b.getWeight();
-    });
+    return points;
 }
 
-
-const std::vector<Edge>& Network::getEdges() const {
-    return edges;
+Sparse_Graph Network::toSparseGraph(int numNodes, const std::vector<Edge>& edges) {
+    Sparse_Graph graph;
+    const size_t n = static_cast<size_t>(std::max(0, numNodes));
+    graph.offsets.assign(n + 1, 0);
+    for (const auto& edge : edges) {
+        ++graph.offsets[edge.getNode1() + 1];
+        ++graph.offsets[edge.getNode2() + 1];
+    }
+    for (size_t v = 0; v < n; ++v) {
+        graph.offsets[v + 1] += graph.offsets[v];
+    }
+    graph.neighbours.resize(graph.offsets[n]);
+    graph.weights.resize(graph.offsets[n]);
+    std::vector<size_t> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto& edge : edges) {
+        const int a = edge.getNode1();
+        const int b = edge.getNode2();
+        graph.neighbours[fill[a]] = b;
+        graph.weights[fill[a]++] = edge.getWeight();
+        graph.neighbours[fill[b]] = a;
+        graph.weights[fill[b]++] = edge.getWeight();
+    }
+    return graph;
 }
 
 void Network::printNetwork() const {
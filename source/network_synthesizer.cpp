@@ -1,83 +1,444 @@
 #include "network_synthesizer.h"
+#include "instrumentation.h"
+#include "planarity.h"
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <chrono>
-#include <set>
+#include <filesystem>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <cstdint>
+#include <unordered_map>
 
 // --- Constructor ---
-Network_Synthesizer::Network_Synthesizer(const Statements& statements, int numTopics)
-    : numTopics(numTopics), numDocuments(statements.getSize()), uf(statements.getSize()) {
-    // Resize data structures
-    documents.resize(numDocuments, std::vector<double>(numTopics, 0.0));
+Network_Synthesizer::Network_Synthesizer(const Statements& statements, int numTopics, Thread_Pool& pool)
+    : numDocuments(statements.getSize()), numTopics(numTopics), uf(statements.getSize()), pool(pool) {
+    // Resize data structures; the similarity matrix is only allocated by calculateSimilarity()
+    documents.assign(static_cast<size_t>(numDocuments) * std::max(0, numTopics), 0.0);
     modulus.resize(numDocuments, 0.0);
 
-    // Initialize upperTriangle with the size of the upper triangular matrix
-    size_t matrixSize = numDocuments * (numDocuments - 1) / 2;
-    upperTriangle.resize(matrixSize, 0.0);
-
     // Populate the document-topic matrix
     readDocumentTopics(statements);
 }
 
+Network_Synthesizer::Network_Synthesizer(std::vector<std::vector<double>> documents, int numTopics, Thread_Pool& pool)
+    : numDocuments(static_cast<int>(documents.size())), numTopics(numTopics), uf(static_cast<int>(documents.size())),
+      pool(pool) {
+    // Rows are padded or cut to numTopics, like appendDocuments()
+    const size_t rowSize = static_cast<size_t>(std::max(0, numTopics));
+    this->documents.assign(static_cast<size_t>(numDocuments) * rowSize, 0.0);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        std::copy_n(documents[i].begin(), std::min(rowSize, documents[i].size()), this->documents.begin() + i * rowSize);
+    }
+    modulus.resize(numDocuments, 0.0);
+}
+
+Network_Synthesizer::Network_Synthesizer(std::vector<double> matrix, int numDocuments, int numTopics, Thread_Pool& pool)
+    : numDocuments(std::max(0, numDocuments)), numTopics(numTopics), uf(std::max(0, numDocuments)), pool(pool),
+      documents(std::move(matrix)) {
+    documents.resize(static_cast<size_t>(this->numDocuments) * std::max(0, numTopics), 0.0);
+    modulus.resize(this->numDocuments, 0.0);
+}
 
 // --- Private Methods ---
 
+namespace {
+    // Size of a file just written, for the export throughput
+    uint64_t fileSize(const std::string& filename) {
+        std::error_code error;
+        const uintmax_t size = std::filesystem::file_size(filename, error);
+        return error ? 0 : static_cast<uint64_t>(size);
+    }
+
+    // Dot product of two rows; four independent accumulators let the compiler vectorise it
+    double rowDot(const double* a, const double* b, size_t size) {
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        size_t t = 0;
+        for (; t + 4 <= size; t += 4) {
+            s0 += a[t] * b[t];
+            s1 += a[t + 1] * b[t + 1];
+            s2 += a[t + 2] * b[t + 2];
+            s3 += a[t + 3] * b[t + 3];
+        }
+        for (; t < size; ++t) {
+            s0 += a[t] * b[t];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+}
+
 // Reads document topics from the Statements class and fills the `documents` matrix
 void Network_Synthesizer::readDocumentTopics(const Statements& statements) {
+    const size_t rowSize = static_cast<size_t>(std::max(0, numTopics));
     for (int i = 0; i < numDocuments; ++i) {
-        documents[i] = statements.getTopics(i);
+        const std::vector<double> topics = statements.getTopics(i);
+        std::copy_n(topics.begin(), std::min(rowSize, topics.size()), documents.begin() + i * rowSize);
     }
 }
 
 // Calculates the modulus (norm) of each document's topic vector
 void Network_Synthesizer::calculateDocumentModulus() {
     std::cout << "Calculating document moduli...\n";
-    for (int i = 0; i < numDocuments; ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < numTopics; ++j) {
-            sum += documents[i][j] * documents[i][j];
+    pool.parallelFor(0, static_cast<size_t>(numDocuments), [this](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            const double* row = documentRow(i);
+            double sum = 0.0;
+            for (int j = 0; j < numTopics; ++j) {
+                sum += row[j] * row[j];
+            }
+            modulus[i] = std::sqrt(sum);
         }
-        modulus[i] = std::sqrt(sum);
-    }
+    });
     std::cout << "Document moduli calculated successfully.\n";
 }
 
 // Calculates the cosine similarity between two documents
 double Network_Synthesizer::calculateCosineSimilarity(int doc1, int doc2) const {
+    const double* row1 = documentRow(doc1);
+    const double* row2 = documentRow(doc2);
     double dotProduct = 0.0;
     for (int k = 0; k < numTopics; ++k) {
-        dotProduct += documents[doc1][k] * documents[doc2][k];
+        dotProduct += row1[k] * row2[k];
     }
     double cosineSimilarity = (modulus[doc1] > 0 && modulus[doc2] > 0) ? dotProduct / (modulus[doc1] * modulus[doc2]) : 0.0;
     return 1.0 - cosineSimilarity; // Invert the similarity to represent stronger relations with lower values
 }
 
+void Network_Synthesizer::buildQueryIndex() {
+    Scoped_Timer timer("query_index");
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    normalized.assign(static_cast<size_t>(numDocuments) * rowSize, 0.0);
+    pool.parallelFor(0, static_cast<size_t>(numDocuments), [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            const double* row = documentRow(i);
+            double sum = 0.0;
+            for (size_t t = 0; t < rowSize; ++t) {
+                sum += row[t] * row[t];
+            }
+            if (sum > 0) {
+                const double scale = 1.0 / std::sqrt(sum);
+                for (size_t t = 0; t < rowSize; ++t) {
+                    normalized[i * rowSize + t] = row[t] * scale;
+                }
+            }
+        }
+    });
+    verdictCodes.clear();
+    verdictNames.clear();
+    originatorCodes.clear();
+    originatorNames.clear();
+    dateKeys.clear();
+    timer.addItems(numDocuments);
+    timer.addBytes(normalized.size() * sizeof(double));
+}
+
+void Network_Synthesizer::buildQueryIndex(const Statements& statements) {
+    buildQueryIndex();
+
+    // Verdicts and originators are dictionary-encoded so that filters compare integers
+    auto encode = [](const std::string& value, std::unordered_map<std::string, int>& ids, std::vector<std::string>& names) {
+        auto [it, inserted] = ids.emplace(value, static_cast<int>(names.size()));
+        if (inserted) {
+            names.push_back(value);
+        }
+        return it->second;
+    };
+    std::unordered_map<std::string, int> verdictIds, originatorIds;
+    verdictCodes.resize(numDocuments);
+    originatorCodes.resize(numDocuments);
+    dateKeys.resize(numDocuments);
+    for (int i = 0; i < numDocuments; ++i) {
+        verdictCodes[i] = encode(statements.getVerdict(i), verdictIds, verdictNames);
+        originatorCodes[i] = encode(statements.getOriginator(i), originatorIds, originatorNames);
+        const std::tm date = statements.getDate(i);
+        dateKeys[i] = (date.tm_year + 1900) * 10000 + (date.tm_mon + 1) * 100 + date.tm_mday;
+    }
+}
+
+std::vector<Similar_Document> Network_Synthesizer::findNearestDocuments(int document, int k, const Query_Filter& filter) const {
+    Similarity_Query query;
+    query.document = document;
+    return findNearestDocuments(std::vector<Similarity_Query>{query}, k, filter).front();
+}
+
+std::vector<Similar_Document> Network_Synthesizer::findNearestDocuments(const std::vector<double>& topics, int k,
+                                                                        const Query_Filter& filter) const {
+    Similarity_Query query;
+    query.topics = topics;
+    return findNearestDocuments(std::vector<Similarity_Query>{query}, k, filter).front();
+}
+
+std::vector<std::vector<Similar_Document>> Network_Synthesizer::findNearestDocuments(
+    const std::vector<Similarity_Query>& queries, int k, const Query_Filter& filter) const {
+    std::vector<std::vector<Similar_Document>> results(queries.size());
+    const size_t n = static_cast<size_t>(numDocuments);
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    if (normalized.size() != n * rowSize) {
+        std::cerr << "Error: The query index is missing; call buildQueryIndex() first." << std::endl;
+        return results;
+    }
+    if (!filter.isEmpty() && verdictCodes.size() != n) {
+        std::cerr << "Error: Query filters need the statements passed to buildQueryIndex()." << std::endl;
+        return results;
+    }
+    k = std::max(0, std::min(k, numDocuments));
+    if (k == 0 || queries.empty()) {
+        return results;
+    }
+
+    // Unit-length query rows; a malformed query keeps a zero row and gets no results
+    const size_t numQueries = queries.size();
+    std::vector<double> queryRows(numQueries * rowSize, 0.0);
+    std::vector<int> exclude(numQueries, -1);
+    std::vector<char> valid(numQueries, 0);
+    for (size_t q = 0; q < numQueries; ++q) {
+        const auto& query = queries[q];
+        if (query.document >= 0 && query.document < numDocuments) {
+            std::copy_n(normalized.begin() + query.document * rowSize, rowSize, queryRows.begin() + q * rowSize);
+            exclude[q] = query.document;
+            valid[q] = 1;
+        } else if (query.document < 0 && query.topics.size() == rowSize) {
+            double sum = 0.0;
+            for (double value : query.topics) {
+                sum += value * value;
+            }
+            const double scale = sum > 0 ? 1.0 / std::sqrt(sum) : 0.0;
+            for (size_t t = 0; t < rowSize; ++t) {
+                queryRows[q * rowSize + t] = query.topics[t] * scale;
+            }
+            valid[q] = 1;
+        }
+    }
+
+    // Filters are resolved to allowed codes once, then checked per row before any scoring
+    auto parseDate = [](const std::string& text, int fallback) {
+        if (text.empty()) {
+            return fallback;
+        }
+        std::tm date = {};
+        std::istringstream stream(text);
+        stream >> std::get_time(&date, "%m/%d/%Y");
+        return stream.fail() ? fallback : (date.tm_year + 1900) * 10000 + (date.tm_mon + 1) * 100 + date.tm_mday;
+    };
+    auto allowed = [](const std::vector<std::string>& wanted, const std::vector<std::string>& names) {
+        std::vector<char> mask(names.size(), wanted.empty());
+        for (size_t code = 0; code < names.size(); ++code) {
+            mask[code] = mask[code] || std::find(wanted.begin(), wanted.end(), names[code]) != wanted.end();
+        }
+        return mask;
+    };
+    const bool filtered = !filter.isEmpty();
+    const std::vector<char> verdictAllowed = allowed(filter.verdicts, verdictNames);
+    const std::vector<char> originatorAllowed = allowed(filter.originators, originatorNames);
+    const int dateFrom = parseDate(filter.dateFrom, std::numeric_limits<int>::min());
+    const int dateTo = parseDate(filter.dateTo, std::numeric_limits<int>::max());
+
+    auto closer = [](const Similar_Document& a, const Similar_Document& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.document < b.document);
+    };
+
+    // Blocks of about 64 KiB of rows stay in cache while every query is scored against them
+    const size_t blockRows = std::max<size_t>(16, (size_t(64) << 10) / (rowSize * sizeof(double) + 1));
+    const size_t numBlocks = (n + blockRows - 1) / blockRows;
+    const size_t grain = std::max<size_t>(1, numBlocks / (4 * static_cast<size_t>(pool.getNumThreads())));
+    std::vector<std::vector<std::vector<Similar_Document>>> partial((numBlocks + grain - 1) / grain);
+
+    pool.parallelFor(0, numBlocks, [&](size_t b0, size_t b1) {
+        auto& heaps = partial[b0 / grain];
+        heaps.assign(numQueries, {});
+        for (auto& heap : heaps) {
+            heap.reserve(static_cast<size_t>(k) + 1);
+        }
+        const size_t end = std::min(n, b1 * blockRows);
+        for (size_t j = b0 * blockRows; j < end; ++j) {
+            if (filtered && (!verdictAllowed[verdictCodes[j]] || !originatorAllowed[originatorCodes[j]] ||
+                             dateKeys[j] < dateFrom || dateKeys[j] > dateTo)) {
+                continue;
+            }
+            const double* row = normalized.data() + j * rowSize;
+            for (size_t q = 0; q < numQueries; ++q) {
+                if (!valid[q] || exclude[q] == static_cast<int>(j)) {
+                    continue;
+                }
+                const double* query = queryRows.data() + q * rowSize;
+                const Similar_Document candidate{static_cast<int>(j), 1.0 - rowDot(row, query, rowSize)};
+
+                auto& heap = heaps[q];
+                if (static_cast<int>(heap.size()) < k) {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                } else if (closer(candidate, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), closer);
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                }
+            }
+        }
+    }, grain);
+
+    for (size_t q = 0; q < numQueries; ++q) {
+        auto& nearest = results[q];
+        for (const auto& heaps : partial) {
+            nearest.insert(nearest.end(), heaps[q].begin(), heaps[q].end());
+        }
+        const size_t keep = std::min(nearest.size(), static_cast<size_t>(k));
+        std::partial_sort(nearest.begin(), nearest.begin() + keep, nearest.end(), closer);
+        nearest.resize(keep);
+    }
+    return results;
+}
+
+// Inserts document numDocuments - 1 into the minimum spanning forest of the others
+void Network_Synthesizer::insertLastDocumentIntoMST() {
+    const int z = numDocuments - 1;
+
+    // The k x n part of the work: distances from the new document to every existing one
+    std::vector<double> toNew(z);
+    pool.parallelFor(0, static_cast<size_t>(z), [&](size_t start, size_t end) {
+        for (size_t u = start; u < end; ++u) {
+            toNew[u] = calculateCosineSimilarity(static_cast<int>(u), z);
+        }
+    });
+
+    // Adjacency of the current forest (CSR)
+    std::vector<int> offsets(z + 1, 0);
+    for (const auto& edge : mst) {
+        ++offsets[edge.getNode1() + 1];
+        ++offsets[edge.getNode2() + 1];
+    }
+    for (int v = 0; v < z; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<int> neighbours(offsets[z]);
+    std::vector<int> treeEdge(offsets[z]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t e = 0; e < mst.size(); ++e) {
+        int a = mst[e].getNode1();
+        int b = mst[e].getNode2();
+        neighbours[fill[a]] = b;
+        treeEdge[fill[a]++] = static_cast<int>(e);
+        neighbours[fill[b]] = a;
+        treeEdge[fill[b]++] = static_cast<int>(e);
+    }
+
+    // Post-order pass. pending[u] is the heaviest edge on the path from u's subtree to z:
+    // the only edge there that a later cycle can still remove. Every other edge is final.
+    std::vector<Edge> pending(z);
+    std::vector<Edge> updated;
+    updated.reserve(mst.size() + 1);
+    std::vector<int> parent(z, -1);
+    std::vector<char> visited(z, 0);
+    std::vector<std::pair<int, int>> stack; // (vertex, next adjacency slot)
+
+    for (int root = 0; root < z; ++root) {
+        if (visited[root]) {
+            continue;
+        }
+        visited[root] = 1;
+        stack.emplace_back(root, offsets[root]);
+
+        while (!stack.empty()) {
+            auto& [u, slot] = stack.back();
+            if (slot < offsets[u + 1]) {
+                int child = neighbours[slot++];
+                if (!visited[child]) {
+                    visited[child] = 1;
+                    parent[child] = u;
+                    stack.emplace_back(child, offsets[child]);
+                }
+                continue;
+            }
+
+            // All children of u are done: close the cycle z-u-child-...-z for each of them
+            Edge path(u, z, toNew[u], 0);
+            for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+                int child = neighbours[k];
+                if (parent[child] != u) {
+                    continue;
+                }
+                const Edge& down = mst[treeEdge[k]];
+                const Edge& up = pending[child];
+                bool downHeavier = compareByWeight(up, down);
+                const Edge& heavy = downHeavier ? down : up;
+                updated.push_back(downHeavier ? up : down);
+                if (compareByWeight(heavy, path)) {
+                    path = heavy;
+                }
+            }
+            pending[u] = path;
+
+            int finished = u;
+            stack.pop_back();
+            if (parent[finished] < 0) {
+                updated.push_back(pending[finished]);
+            }
+        }
+    }
+
+    mst.swap(updated);
+}
+
 // --- Public Methods ---
 
+Execution_Plan Network_Synthesizer::planExecution(const Planner_Config& config) const {
+    Execution_Planner planner(config);
+    Execution_Plan plan = planner.plan(static_cast<size_t>(numDocuments), numTopics);
+    Execution_Planner::logPlan(plan);
+    return plan;
+}
+
+void Network_Synthesizer::execute(const Execution_Plan& plan) {
+    switch (plan.strategy) {
+        case Strategy::DENSE_MATRIX:
+            calculateSimilarity();
+            buildNetwork();
+            findMST();
+            break;
+        case Strategy::FUSED_PRIM:
+            findMSTFusedPrim();
+            break;
+        case Strategy::KNN_GRAPH:
+            buildKnnNetwork(plan.config.knnNeighbours);
+            findMST();
+            break;
+        case Strategy::OUT_OF_CORE:
+            findMSTOutOfCore(plan.config.outOfCoreBlockBytes, plan.config.scratchDirectory);
+            break;
+    }
+}
+
 // Calculates the similarity matrix for all document pairs
 void Network_Synthesizer::calculateSimilarity() {
     std::cout << "Calculating similarity matrix...\n";
     calculateDocumentModulus();
+    Scoped_Timer timer("similarity");
 
-    // Resize upperTriangle to fit the required size
-    size_t matrixSize = numDocuments * (numDocuments - 1) / 2; // Upper triangular size
-    upperTriangle.resize(matrixSize, 0.0);
+    // Resize upperTriangle to fit the required size (computed in size_t: n^2 overflows int past ~46k documents)
+    const size_t n = static_cast<size_t>(numDocuments);
+    size_t matrixSize = n < 2 ? 0 : n * (n - 1) / 2; // Upper triangular size
+    upperTriangle.assign(matrixSize, 0.0);
+    timer.addItems(matrixSize);
+    timer.addBytes(matrixSize * sizeof(double));
 
     // Lambda function for indexing the upper triangular matrix
-    auto index = [this](int i, int j) {
-        return (i * (2 * numDocuments - i - 1)) / 2 + (j - i - 1);
+    auto index = [n](size_t i, size_t j) {
+        return (i * (2 * n - i - 1)) / 2 + (j - i - 1);
     };
 
-    // Populate the upper triangular matrix
-    for (int i = 0; i < numDocuments; ++i) {
-        for (int j = i + 1; j < numDocuments; ++j) {
-            double similarity = calculateCosineSimilarity(i, j);
-            upperTriangle[index(i, j)] = similarity;
+    // Populate the upper triangular matrix; rows shrink with i, so they go out in small chunks
+    pool.parallelFor(0, n, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                upperTriangle[index(i, j)] = calculateCosineSimilarity(static_cast<int>(i), static_cast<int>(j));
+            }
         }
-    }
+    }, std::max<size_t>(1, n / (16 * pool.getNumThreads())));
 
     std::cout << "Upper triangular similarity matrix calculated successfully.\n";
 }
@@ -87,10 +448,7 @@ void Network_Synthesizer::buildNetwork() {
     std::cout << "Building network...\n";
     Network network; // Create a Network object
 
-    auto start = std::chrono::high_resolution_clock::now();
-    network.buildFromSimilarityMatrix(upperTriangle, numDocuments);
-    auto end = std::chrono::high_resolution_clock::now();
-    std::cout << "Time taken: " << std::chrono::duration<double>(end - start).count() << " seconds\n";
+    network.buildFromSimilarityMatrix(upperTriangle, numDocuments, pool);
 
     edges = network.getEdges(); // Store the edges in the synthesizer for further processing
     std::cout << "Network successfully built with " << edges.size() << " edges.\n";
@@ -98,8 +456,11 @@ void Network_Synthesizer::buildNetwork() {
 
 void Network_Synthesizer::findMST() {
     std::cout << "Finding minimum spanning tree...\n";
+    Scoped_Timer timer("mst");
+    timer.addItems(edges.size());
     mst.clear(); // Clear any existing MST
     mstWeight = 0.0; // Reset MST weight
+    uf = UF_DS(numDocuments); // Forget the components of any earlier build
 
     // Process edges sorted by weight
     for (const auto& edge : edges) {
@@ -117,114 +478,1027 @@ void Network_Synthesizer::findMST() {
     std::cout << "MST successfully calculated. Total weight: " << mstWeight << "\n";
 }
 
-void Network_Synthesizer::exportMSTWithNodeData(const std::string& edgeFilename, const std::string& nodeFilename, const Statements& statements) const {
-    // Export MST edges
-    std::ofstream edgeFile(edgeFilename);
-    if (!edgeFile.is_open()) {
-        std::cerr << "Error: Could not open file " << edgeFilename << " for writing." << std::endl;
+void Network_Synthesizer::findMSTFusedPrim() {
+    std::cout << "Finding minimum spanning tree (fused Prim)...\n";
+    calculateDocumentModulus();
+    Scoped_Timer timer("mst_fused_prim");
+    timer.addItems(numDocuments < 2 ? 0 : static_cast<uint64_t>(numDocuments) * (numDocuments - 1) / 2);
+    mst.clear();
+    mstWeight = 0.0;
+    uf = UF_DS(numDocuments);
+    if (numDocuments == 0) {
         return;
     }
 
-    edgeFile << "source,target,weight\n"; // Header for edges CSV
+    // Cheapest known edge connecting each document to the tree, compared with compareByWeight()
+    // so ties resolve exactly as in Kruskal
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<Edge> best(numDocuments, Edge(0, 0, infinity, 0));
+
+    // Documents not yet in the tree; each step scans them in parallel chunks, every chunk
+    // reporting its closest candidate
+    std::vector<int> remaining(numDocuments - 1);
+    for (int v = 1; v < numDocuments; ++v) {
+        remaining[v - 1] = v;
+    }
+    const size_t numChunks = numDocuments >= 4096 ? 4 * static_cast<size_t>(pool.getNumThreads()) : 1;
+    std::vector<int> chunkNext(numChunks);
+
+    int current = 0;
+    while (!remaining.empty()) {
+        const size_t count = remaining.size();
+        pool.parallelFor(0, numChunks, [&](size_t c0, size_t c1) {
+            for (size_t c = c0; c < c1; ++c) {
+                int next = -1;
+                for (size_t r = count * c / numChunks; r < count * (c + 1) / numChunks; ++r) {
+                    const int v = remaining[r];
+                    Edge candidate(std::min(current, v), std::max(current, v), calculateCosineSimilarity(current, v), 0);
+                    if (compareByWeight(candidate, best[v])) {
+                        best[v] = candidate;
+                    }
+                    if (next < 0 || compareByWeight(best[v], best[next])) {
+                        next = v;
+                    }
+                }
+                chunkNext[c] = next;
+            }
+        }, 1);
+
+        int next = -1;
+        for (int candidate : chunkNext) {
+            if (candidate >= 0 && (next < 0 || compareByWeight(best[candidate], best[next]))) {
+                next = candidate;
+            }
+        }
+
+        const Edge& edge = best[next];
+        mst.emplace_back(edge.getNode1(), edge.getNode2(), edge.getWeight(), static_cast<int>(mst.size()));
+        uf.unite(edge.getNode1(), edge.getNode2());
+        mstWeight += edge.getWeight();
+
+        auto position = std::find(remaining.begin(), remaining.end(), next);
+        *position = remaining.back();
+        remaining.pop_back();
+        current = next;
+    }
+
+    // Keep the same edge order as Kruskal
+    std::sort(mst.begin(), mst.end(), compareByWeight);
+    std::cout << "MST successfully calculated. Total weight: " << mstWeight << "\n";
+}
+
+void Network_Synthesizer::buildKnnNetwork(int k) {
+    std::cout << "Building " << k << "-nearest-neighbour network...\n";
+    calculateDocumentModulus();
+    Scoped_Timer timer("knn_graph");
+    timer.addCounter("k", k);
+    edges = findKnnEdges(k);
+    timer.addItems(edges.size());
+    std::cout << "kNN network successfully built with " << edges.size() << " edges.\n";
+}
+
+std::vector<Edge> Network_Synthesizer::findKnnEdges(int k) const {
+    k = std::max(0, std::min(k, numDocuments - 1));
+
+    // Each row keeps its k closest neighbours in a max-heap, written to its own slots
+    std::vector<Edge> neighbours(static_cast<size_t>(numDocuments) * k);
+    pool.parallelFor(0, static_cast<size_t>(numDocuments), [&](size_t start, size_t end) {
+        std::vector<Edge> heap;
+        heap.reserve(static_cast<size_t>(k) + 1);
+        for (size_t row = start; row < end && k > 0; ++row) {
+            const int i = static_cast<int>(row);
+            heap.clear();
+            for (int j = 0; j < numDocuments; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                Edge candidate(std::min(i, j), std::max(i, j), calculateCosineSimilarity(i, j), 0);
+                if (static_cast<int>(heap.size()) < k) {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end(), compareByWeight);
+                } else if (compareByWeight(candidate, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), compareByWeight);
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end(), compareByWeight);
+                }
+            }
+            std::copy(heap.begin(), heap.end(), neighbours.begin() + row * k);
+        }
+    });
+
+    // Mutual neighbours appear twice
+    pool.parallelSort(neighbours.begin(), neighbours.end(), compareByWeight);
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end(), [](const Edge& a, const Edge& b) {
+        return a.getNode1() == b.getNode1() && a.getNode2() == b.getNode2();
+    }), neighbours.end());
+
+    for (size_t id = 0; id < neighbours.size(); ++id) {
+        neighbours[id] = Edge(neighbours[id].getNode1(), neighbours[id].getNode2(), neighbours[id].getWeight(), static_cast<int>(id));
+    }
+    return neighbours;
+}
+
+std::vector<Edge> Network_Synthesizer::findThresholdEdges(double maxDistance) const {
+    // Rows shrink with i, so they go out in small chunks, each collecting its own edges
+    const size_t n = static_cast<size_t>(numDocuments);
+    const size_t grain = std::max<size_t>(1, n / (16 * pool.getNumThreads()));
+    std::vector<std::vector<Edge>> chunks((n + grain - 1) / grain);
+    pool.parallelFor(0, n, [&](size_t start, size_t end) {
+        auto& found = chunks[start / grain];
+        for (size_t i = start; i < end; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                const double distance = calculateCosineSimilarity(static_cast<int>(i), static_cast<int>(j));
+                if (distance <= maxDistance) {
+                    found.emplace_back(static_cast<int>(i), static_cast<int>(j), distance, 0);
+                }
+            }
+        }
+    }, grain);
+
+    std::vector<Edge> result;
+    for (const auto& found : chunks) {
+        for (const auto& edge : found) {
+            result.emplace_back(edge.getNode1(), edge.getNode2(), edge.getWeight(), static_cast<int>(result.size()));
+        }
+    }
+    return result;
+}
+
+std::vector<Edge> Network_Synthesizer::findTMFG() {
+    std::cout << "Building triangulated maximally filtered graph...\n";
+    calculateDocumentModulus();
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    if (normalized.size() != static_cast<size_t>(numDocuments) * rowSize) {
+        buildQueryIndex();
+    }
+    Scoped_Timer timer("tmfg");
+    timer.addItems(numDocuments);
+
+    const int n = numDocuments;
+    std::vector<Edge> graph;
+    auto addEdge = [&](int a, int b) {
+        graph.emplace_back(std::min(a, b), std::max(a, b), calculateCosineSimilarity(a, b), 0);
+    };
+    auto finish = [&]() {
+        std::sort(graph.begin(), graph.end(), compareByWeight);
+        for (size_t id = 0; id < graph.size(); ++id) {
+            graph[id] = Edge(graph[id].getNode1(), graph[id].getNode2(), graph[id].getWeight(), static_cast<int>(id));
+        }
+        std::cout << "TMFG built with " << graph.size() << " edges.\n";
+        return graph;
+    };
+    if (n < 4) {
+        for (int a = 0; a < n; ++a) {
+            for (int b = a + 1; b < n; ++b) {
+                addEdge(a, b);
+            }
+        }
+        return finish();
+    }
+    auto row = [&](int v) { return normalized.data() + static_cast<size_t>(v) * rowSize; };
+
+    // Seed tetrahedron: the four documents with the largest total similarity to all others,
+    // which for unit rows is the dot product with the sum of the rows
+    std::vector<double> rowSum(rowSize, 0.0);
+    for (int v = 0; v < n; ++v) {
+        for (size_t t = 0; t < rowSize; ++t) {
+            rowSum[t] += row(v)[t];
+        }
+    }
+    std::vector<double> strength(n);
+    pool.parallelFor(0, static_cast<size_t>(n), [&](size_t start, size_t end) {
+        for (size_t v = start; v < end; ++v) {
+            strength[v] = rowDot(row(static_cast<int>(v)), rowSum.data(), rowSize);
+        }
+    });
+    std::vector<int> seeds(n);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::partial_sort(seeds.begin(), seeds.begin() + 4, seeds.end(), [&](int a, int b) {
+        return strength[a] > strength[b] || (strength[a] == strength[b] && a < b);
+    });
+    seeds.resize(4);
+    for (int a = 0; a < 4; ++a) {
+        for (int b = a + 1; b < 4; ++b) {
+            addEdge(seeds[a], seeds[b]);
+        }
+    }
+
+    struct Face {
+        int a, b, c;
+    };
+    std::vector<Face> faces = {{seeds[0], seeds[1], seeds[2]}, {seeds[0], seeds[1], seeds[3]},
+                               {seeds[0], seeds[2], seeds[3]}, {seeds[1], seeds[2], seeds[3]}};
+    std::vector<char> alive(faces.size(), 1);
+
+    // Documents still outside the graph, with their position for O(1) removal
+    std::vector<int> remaining, position(n, -1);
+    for (int v = 0; v < n; ++v) {
+        if (std::find(seeds.begin(), seeds.end(), v) == seeds.end()) {
+            position[v] = static_cast<int>(remaining.size());
+            remaining.push_back(v);
+        }
+    }
+
+    // Gain table: the best insertion of each face, lowest total distance to its three corners
+    // first (ties by document, then face). Entries go stale when their document is inserted
+    // elsewhere; since a face's best cost can only grow, a stale entry is rescored when it
+    // reaches the top instead of eagerly.
+    struct Candidate {
+        double cost;
+        int document;
+        int face;
+    };
+    auto later = [](const Candidate& x, const Candidate& y) {
+        if (x.cost != y.cost) {
+            return x.cost > y.cost;
+        }
+        return x.document != y.document ? x.document > y.document : x.face > y.face;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(later)> gains(later);
+
+    // Scores faces against every remaining document in one parallel pass: each document is
+    // compared once with each distinct corner, and every chunk keeps its best per face
+    const double infinity = std::numeric_limits<double>::infinity();
+    auto scoreFaces = [&](const std::vector<int>& faceIds) {
+        std::vector<int> corners;
+        std::vector<std::array<size_t, 3>> slots;
+        for (int id : faceIds) {
+            std::array<size_t, 3> slot{};
+            const int vertices[3] = {faces[id].a, faces[id].b, faces[id].c};
+            for (int k = 0; k < 3; ++k) {
+                auto it = std::find(corners.begin(), corners.end(), vertices[k]);
+                slot[k] = static_cast<size_t>(it - corners.begin());
+                if (it == corners.end()) {
+                    corners.push_back(vertices[k]);
+                }
+            }
+            slots.push_back(slot);
+        }
+
+        const size_t count = remaining.size();
+        const size_t numChunks = count >= 4096 ? 4 * static_cast<size_t>(pool.getNumThreads()) : 1;
+        std::vector<Candidate> best(numChunks * faceIds.size(), Candidate{infinity, -1, -1});
+        pool.parallelFor(0, numChunks, [&](size_t c0, size_t c1) {
+            std::vector<double> distance(corners.size());
+            for (size_t c = c0; c < c1; ++c) {
+                Candidate* chunkBest = best.data() + c * faceIds.size();
+                for (size_t r = count * c / numChunks; r < count * (c + 1) / numChunks; ++r) {
+                    const int u = remaining[r];
+                    for (size_t k = 0; k < corners.size(); ++k) {
+                        distance[k] = 1.0 - rowDot(row(u), row(corners[k]), rowSize);
+                    }
+                    for (size_t f = 0; f < faceIds.size(); ++f) {
+                        const double cost = distance[slots[f][0]] + distance[slots[f][1]] + distance[slots[f][2]];
+                        Candidate& current = chunkBest[f];
+                        if (cost < current.cost || (cost == current.cost && u < current.document)) {
+                            current = {cost, u, faceIds[f]};
+                        }
+                    }
+                }
+            }
+        }, 1);
+
+        for (size_t f = 0; f < faceIds.size(); ++f) {
+            Candidate winner{infinity, -1, faceIds[f]};
+            for (size_t c = 0; c < numChunks; ++c) {
+                const Candidate& candidate = best[c * faceIds.size() + f];
+                if (candidate.document >= 0 && (winner.document < 0 || later(winner, candidate))) {
+                    winner = candidate;
+                }
+            }
+            if (winner.document >= 0) {
+                gains.push(winner);
+            }
+        }
+    };
+
+    scoreFaces({0, 1, 2, 3});
+    while (!remaining.empty()) {
+        const Candidate top = gains.top();
+        gains.pop();
+        if (!alive[top.face]) {
+            continue;
+        }
+        if (position[top.document] < 0) {
+            scoreFaces({top.face});
+            continue;
+        }
+
+        // Insert the document inside the face, splitting it into three
+        const int v = top.document;
+        const Face face = faces[top.face];
+        alive[top.face] = 0;
+        addEdge(v, face.a);
+        addEdge(v, face.b);
+        addEdge(v, face.c);
+        const int last = remaining.back();
+        remaining[position[v]] = last;
+        position[last] = position[v];
+        remaining.pop_back();
+        position[v] = -1;
+
+        const int first = static_cast<int>(faces.size());
+        faces.push_back({face.a, face.b, v});
+        faces.push_back({face.a, face.c, v});
+        faces.push_back({face.b, face.c, v});
+        alive.resize(faces.size(), 1);
+        if (!remaining.empty()) {
+            scoreFaces({first, first + 1, first + 2});
+        }
+    }
+    timer.addCounter("faces", static_cast<double>(faces.size()));
+    return finish();
+}
+
+std::vector<Edge> Network_Synthesizer::findPMFG() {
+    std::cout << "Building planar maximally filtered graph...\n";
+    if (edges.empty() && numDocuments > 1) {
+        // The walk needs every pair in weight order, so no cheaper strategy can stand in
+        Planner_Config sizing;
+        sizing.memoryBudgetBytes = 1;
+        sizing.diskBudgetBytes = 1;
+        const size_t bytes = Execution_Planner(sizing).estimate(Strategy::DENSE_MATRIX, numDocuments, numTopics).memoryBytes;
+        std::cout << "PMFG builds the full edge list (~" << Execution_Planner::formatBytes(bytes)
+                  << ") regardless of the memory budget.\n";
+        calculateSimilarity();
+        buildNetwork();
+    }
+    Scoped_Timer timer("pmfg");
+
+    const int n = numDocuments;
+    const size_t target = n >= 3 ? 3 * static_cast<size_t>(n) - 6 : static_cast<size_t>(std::max(0, n)) * std::max(0, n - 1) / 2;
+    std::vector<Edge> graph;
+
+    // Planarity only has to be checked within the component the candidate closes a cycle in;
+    // edges joining two components are always accepted
+    UF_DS components(n);
+    std::vector<std::vector<int>> componentNodes(n);
+    std::vector<std::vector<std::pair<int, int>>> componentEdges(n);
+    for (int v = 0; v < n; ++v) {
+        componentNodes[v].push_back(v);
+    }
+    auto accept = [&](const Edge& edge) {
+        graph.emplace_back(edge.getNode1(), edge.getNode2(), edge.getWeight(), static_cast<int>(graph.size()));
+        int a = components.find(edge.getNode1());
+        int b = components.find(edge.getNode2());
+        if (a != b) {
+            components.unite(a, b);
+            const int root = components.find(a);
+            const int other = root == a ? b : a;
+            // Smaller lists are appended to larger ones
+            if (componentNodes[root].size() < componentNodes[other].size()) {
+                componentNodes[root].swap(componentNodes[other]);
+                componentEdges[root].swap(componentEdges[other]);
+            }
+            componentNodes[root].insert(componentNodes[root].end(), componentNodes[other].begin(), componentNodes[other].end());
+            componentEdges[root].insert(componentEdges[root].end(), componentEdges[other].begin(), componentEdges[other].end());
+            std::vector<int>().swap(componentNodes[other]);
+            std::vector<std::pair<int, int>>().swap(componentEdges[other]);
+            a = root;
+        }
+        componentEdges[a].emplace_back(edge.getNode1(), edge.getNode2());
+    };
+
+    // Candidates within a component are tested speculatively in parallel batches against the
+    // current graph. A graph stays non-planar when edges are added, so every rejection in a
+    // batch is final, and so is the first acceptance; the candidates after it are retested.
+    const size_t batchSize = 2 * static_cast<size_t>(pool.getNumThreads());
+    std::vector<Planarity_Tester> testers(batchSize);
+    std::vector<std::vector<int>> localIds(batchSize);
+    std::vector<std::vector<std::pair<int, int>>> localEdges(batchSize);
+    std::vector<size_t> batch;
+    std::vector<int> batchRoot;
+    std::vector<char> planar(batchSize), rejected(edges.size(), 0);
+    size_t tested = 0;
+
+    size_t i = 0;
+    while (i < edges.size() && graph.size() < target) {
+        batch.clear();
+        batchRoot.clear();
+        while (i < edges.size() && batch.size() < batchSize && graph.size() < target) {
+            const Edge& edge = edges[i];
+            const int a = components.find(edge.getNode1());
+            const int b = components.find(edge.getNode2());
+            if (rejected[i] || edge.getNode1() == edge.getNode2()) {
+                ++i;
+            } else if (a != b) {
+                if (!batch.empty()) {
+                    break;
+                }
+                accept(edge);
+                ++i;
+            } else if (componentNodes[a].size() >= 3 && componentEdges[a].size() + 1 > 3 * componentNodes[a].size() - 6) {
+                rejected[i++] = 1; // Too many edges for a planar component (Euler)
+            } else {
+                batch.push_back(i++);
+                batchRoot.push_back(a);
+            }
+        }
+        if (batch.empty()) {
+            continue;
+        }
+
+        pool.parallelFor(0, batch.size(), [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; ++b) {
+                const auto& nodes = componentNodes[batchRoot[b]];
+                auto& local = localIds[b];
+                local.resize(n);
+                for (size_t k = 0; k < nodes.size(); ++k) {
+                    local[nodes[k]] = static_cast<int>(k);
+                }
+                auto& candidate = localEdges[b];
+                candidate.clear();
+                for (const auto& [u, v] : componentEdges[batchRoot[b]]) {
+                    candidate.emplace_back(local[u], local[v]);
+                }
+                const Edge& edge = edges[batch[b]];
+                candidate.emplace_back(local[edge.getNode1()], local[edge.getNode2()]);
+                planar[b] = testers[b].isPlanar(static_cast<int>(nodes.size()), candidate);
+            }
+        }, 1);
+        tested += batch.size();
+
+        size_t first = batch.size();
+        for (size_t b = 0; b < batch.size(); ++b) {
+            if (!planar[b]) {
+                rejected[batch[b]] = 1;
+            } else if (first == batch.size()) {
+                first = b;
+            }
+        }
+        if (first < batch.size()) {
+            accept(edges[batch[first]]);
+            i = batch[first] + 1;
+        }
+    }
+
+    timer.addItems(i);
+    timer.addCounter("planarity_tests", static_cast<double>(tested));
+    std::cout << "PMFG built with " << graph.size() << " edges after " << tested << " planarity tests.\n";
+    return graph;
+}
+
+std::vector<Percolation_Point> Network_Synthesizer::sweepThresholds(const std::vector<double>& thresholds) const {
+    Scoped_Timer timer("percolation_sweep");
+    timer.addItems(mst.size());
+    return Network::sweepPercolation(numDocuments, mst, thresholds);
+}
+
+Sparse_Graph Network_Synthesizer::buildEpsilonGraph(double maxDistance) {
+    calculateDocumentModulus();
+    Scoped_Timer timer("epsilon_graph");
+    const std::vector<Edge> kept = findThresholdEdges(maxDistance);
+    timer.addItems(kept.size());
+    return Network::toSparseGraph(numDocuments, kept);
+}
+
+Distance_Statistics Network_Synthesizer::computeDistanceStatistics(const std::vector<int>& labels,
+                                                                   const std::vector<std::string>& labelNames, int bins) const {
+    Scoped_Timer timer("distance_statistics");
+    const size_t n = static_cast<size_t>(numDocuments);
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    const int numLabels = static_cast<int>(labelNames.size());
+    const size_t numPairs = static_cast<size_t>(numLabels) * (numLabels + 1) / 2;
+    const size_t totalPairs = n < 2 ? 0 : n * (n - 1) / 2;
+    timer.addItems(totalPairs);
+
+    // Summary index of each ordered label pair; -1 for unlabelled documents
+    std::vector<int> pairTable(static_cast<size_t>(numLabels) * numLabels);
+    for (int a = 0; a < numLabels; ++a) {
+        for (int b = 0; b < numLabels; ++b) {
+            pairTable[a * numLabels + b] = static_cast<int>(Distance_Statistics::pairIndex(a, b, numLabels));
+        }
+    }
+    std::vector<int> codes(n, -1);
+    for (size_t i = 0; i < n && i < labels.size(); ++i) {
+        codes[i] = labels[i] >= 0 && labels[i] < numLabels ? labels[i] : -1;
+    }
+
+    // Same kernel as calculateCosineSimilarity(), with the norms inverted once
+    std::vector<double> inverse(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        const double* row = documentRow(i);
+        double sum = 0.0;
+        for (size_t t = 0; t < rowSize; ++t) {
+            sum += row[t] * row[t];
+        }
+        inverse[i] = sum > 0 ? 1.0 / std::sqrt(sum) : 0.0;
+    }
+
+    // Chunk c starts at the first row preceded by at least c / kChunks of the pairs
+    constexpr size_t kChunks = 64;
+    constexpr size_t kTile = 256;
+    std::vector<size_t> rowBounds(kChunks + 1, n);
+    for (size_t c = 0, i = 0; c < kChunks; ++c) {
+        while (i < n && i * (2 * n - i - 1) / 2 < totalPairs * c / kChunks) {
+            ++i;
+        }
+        rowBounds[c] = i;
+    }
+
+    // Each pair goes to exactly one summary: its label pair's, or `unlabelled`
+    struct Chunk {
+        Distance_Summary unlabelled;
+        std::vector<Distance_Summary> byPair;
+    };
+    std::vector<Chunk> chunks(kChunks, Chunk{Distance_Summary(bins), std::vector<Distance_Summary>(numPairs, Distance_Summary(bins))});
+    pool.parallelFor(0, kChunks, [&](size_t c0, size_t c1) {
+        for (size_t c = c0; c < c1; ++c) {
+            Chunk& chunk = chunks[c];
+            const size_t rowBegin = rowBounds[c], rowEnd = rowBounds[c + 1];
+            // Columns go in tiles so that a tile's rows stay in cache across the chunk's rows
+            for (size_t tile = rowBegin + 1; tile < n; tile += kTile) {
+                const size_t tileEnd = std::min(n, tile + kTile);
+                for (size_t i = rowBegin; i < rowEnd && i + 1 < tileEnd; ++i) {
+                    const double* row = documentRow(i);
+                    const int* pairRow = codes[i] >= 0 ? pairTable.data() + static_cast<size_t>(codes[i]) * numLabels : nullptr;
+                    for (size_t j = std::max(i + 1, tile); j < tileEnd; ++j) {
+                        const double* other = documentRow(j);
+                        double dot = 0.0;
+                        for (size_t t = 0; t < rowSize; ++t) {
+                            dot += row[t] * other[t];
+                        }
+                        const double distance = inverse[i] > 0 && inverse[j] > 0 ? 1.0 - dot * inverse[i] * inverse[j] : 1.0;
+                        if (pairRow && codes[j] >= 0) {
+                            chunk.byPair[pairRow[codes[j]]].add(distance);
+                        } else {
+                            chunk.unlabelled.add(distance);
+                        }
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    Distance_Statistics statistics{Distance_Summary(bins), labelNames, std::vector<Distance_Summary>(numPairs, Distance_Summary(bins))};
+    for (const auto& chunk : chunks) {
+        statistics.all.merge(chunk.unlabelled);
+        for (size_t p = 0; p < numPairs; ++p) {
+            statistics.byPair[p].merge(chunk.byPair[p]);
+        }
+    }
+    for (const auto& summary : statistics.byPair) {
+        statistics.all.merge(summary);
+    }
+    return statistics;
+}
+
+std::vector<Edge> Network_Synthesizer::findGraph(const Graph_Export_Config& config) {
+    switch (config.kind) {
+        case Graph_Kind::KNN:
+            calculateDocumentModulus();
+            return findKnnEdges(config.knnNeighbours);
+        case Graph_Kind::THRESHOLD:
+            calculateDocumentModulus();
+            return findThresholdEdges(config.maxDistance);
+        case Graph_Kind::TMFG:
+            return findTMFG();
+        case Graph_Kind::PMFG:
+            return findPMFG();
+        case Graph_Kind::MST:
+            break;
+    }
+    return mst;
+}
+
+void Network_Synthesizer::findMSTOutOfCore(size_t blockBytes, const std::string& directory) {
+    std::cout << "Finding minimum spanning tree (out-of-core)...\n";
+    calculateDocumentModulus();
+    Scoped_Timer timer("mst_out_of_core");
+    mst.clear();
+    mstWeight = 0.0;
+    uf = UF_DS(numDocuments);
+
+    // On-disk edge record
+    struct RunRecord {
+        double weight;
+        std::int32_t node1;
+        std::int32_t node2;
+    };
+    auto recordLess = [](const RunRecord& a, const RunRecord& b) {
+        return compareByWeight(Edge(a.node1, a.node2, a.weight, 0), Edge(b.node1, b.node2, b.weight, 0));
+    };
+
+    // Phase 1: sorted runs of at most blockBytes each
+    const size_t recordsPerRun = std::max<size_t>(1, blockBytes / sizeof(RunRecord));
+    std::vector<std::string> runFiles;
+    std::vector<RunRecord> buffer;
+
+    auto flushRun = [&]() {
+        if (buffer.empty()) {
+            return true;
+        }
+        pool.parallelSort(buffer.begin(), buffer.end(), recordLess);
+        std::string runFile = directory + "/ooc_run_" + std::to_string(runFiles.size()) + ".bin";
+        std::ofstream out(runFile, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open file " << runFile << " for writing." << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(RunRecord));
+        runFiles.push_back(runFile);
+        buffer.clear();
+        return true;
+    };
+
+    // Whole rows go into a run; their pairs are computed concurrently at precomputed offsets
+    bool ok = true;
+    std::vector<size_t> rowOffsets;
+    for (int row = 0; row < numDocuments && ok;) {
+        int rowEnd = row;
+        size_t count = 0;
+        rowOffsets.assign(1, 0);
+        while (rowEnd < numDocuments && (count == 0 || count + (numDocuments - rowEnd - 1) <= recordsPerRun)) {
+            count += numDocuments - rowEnd - 1;
+            rowOffsets.push_back(count);
+            ++rowEnd;
+        }
+
+        buffer.resize(count);
+        pool.parallelFor(static_cast<size_t>(row), static_cast<size_t>(rowEnd), [&](size_t start, size_t end) {
+            for (size_t r = start; r < end; ++r) {
+                const int i = static_cast<int>(r);
+                size_t slot = rowOffsets[r - row];
+                for (int j = i + 1; j < numDocuments; ++j) {
+                    buffer[slot++] = {calculateCosineSimilarity(i, j), i, j};
+                }
+            }
+        });
+        ok = flushRun();
+        row = rowEnd;
+    }
+    ok = ok && flushRun();
+    buffer.shrink_to_fit();
+    timer.addCounter("runs", static_cast<double>(runFiles.size()));
+    std::cout << "Spilled " << runFiles.size() << " sorted runs to " << directory << ".\n";
+
+    // Phase 2: k-way merge into a single sorted stream, running Kruskal on the way
+    const size_t recordsPerRead = std::max<size_t>(1, (size_t(1) << 20) / sizeof(RunRecord));
+    struct RunReader {
+        std::ifstream in;
+        std::vector<RunRecord> records;
+        size_t position = 0;
+
+        bool refill(size_t count) {
+            records.resize(count);
+            in.read(reinterpret_cast<char*>(records.data()), count * sizeof(RunRecord));
+            records.resize(static_cast<size_t>(in.gcount()) / sizeof(RunRecord));
+            position = 0;
+            return !records.empty();
+        }
+    };
+
+    std::vector<RunReader> readers(ok ? runFiles.size() : 0);
+    using HeapEntry = std::pair<RunRecord, size_t>;
+    auto heapGreater = [&recordLess](const HeapEntry& a, const HeapEntry& b) { return recordLess(b.first, a.first); };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(heapGreater)> heap(heapGreater);
+
+    for (size_t r = 0; r < readers.size(); ++r) {
+        readers[r].in.open(runFiles[r], std::ios::binary);
+        if (readers[r].refill(recordsPerRead)) {
+            heap.push({readers[r].records[0], r});
+        }
+    }
+
+    const std::string sortedFile = directory + "/edges_sorted.bin";
+    std::ofstream sortedOut(sortedFile, std::ios::binary);
+    if (ok && !sortedOut.is_open()) {
+        std::cerr << "Error: Could not open file " << sortedFile << " for writing." << std::endl;
+    }
+
+    std::vector<RunRecord> outBuffer;
+    outBuffer.reserve(recordsPerRead);
+    while (!heap.empty()) {
+        auto [record, r] = heap.top();
+        heap.pop();
+
+        outBuffer.push_back(record);
+        if (outBuffer.size() == recordsPerRead) {
+            sortedOut.write(reinterpret_cast<const char*>(outBuffer.data()), outBuffer.size() * sizeof(RunRecord));
+            outBuffer.clear();
+        }
+
+        if (uf.find(record.node1) != uf.find(record.node2)) {
+            mst.emplace_back(record.node1, record.node2, record.weight, static_cast<int>(mst.size()));
+            uf.unite(record.node1, record.node2);
+            mstWeight += record.weight;
+        }
+
+        RunReader& reader = readers[r];
+        if (++reader.position < reader.records.size() || reader.refill(recordsPerRead)) {
+            heap.push({reader.records[reader.position], r});
+        }
+    }
+    sortedOut.write(reinterpret_cast<const char*>(outBuffer.data()), outBuffer.size() * sizeof(RunRecord));
+    timer.addBytes(static_cast<uint64_t>(sortedOut.tellp()));
+    sortedOut.close();
+
+    readers.clear();
+    for (const auto& runFile : runFiles) {
+        std::remove(runFile.c_str());
+    }
+
+    if (ok) {
+        std::cout << "Sorted edge stream written to " << sortedFile << "\n";
+    }
+    std::cout << "MST successfully calculated. Total weight: " << mstWeight << "\n";
+}
+
+bool Network_Synthesizer::findMSTSharded(const Shard_Config& config) {
+    std::cout << "Finding minimum spanning tree (sharded)...\n";
+    Scoped_Timer timer("mst_sharded");
+    timer.addCounter("workers", config.workers);
+    mst.clear();
+    mstWeight = 0.0;
+    uf = UF_DS(numDocuments);
+
+    Shard_Coordinator coordinator(config);
+    if (!coordinator.run(documents, numDocuments, numTopics, mst)) {
+        std::cerr << "Error: Sharded MST computation failed." << std::endl;
+        mst.clear();
+        return false;
+    }
+
     for (const auto& edge : mst) {
-        edgeFile << edge.getNode1() << "," << edge.getNode2() << "," << edge.getWeight() << "\n";
+        uf.unite(edge.getNode1(), edge.getNode2());
+        mstWeight += edge.getWeight();
     }
-    edgeFile.close();
-    std::cout << "MST edges exported to " << edgeFilename << std::endl;
+    std::cout << "MST successfully calculated. Total weight: " << mstWeight << "\n";
+    return true;
+}
 
-    // Export node data
-    std::ofstream nodeFile(nodeFilename);
-    if (!nodeFile.is_open()) {
-        std::cerr << "Error: Could not open file " << nodeFilename << " for writing." << std::endl;
-        return;
+std::vector<Edge> Network_Synthesizer::findTileSpanningForest(int rowBegin, int rowEnd, int columnBegin, int columnEnd) {
+    calculateDocumentModulus();
+
+    // Prim over the documents of the tile, with an edge wherever a pair falls inside it: the
+    // complete graph of a diagonal tile, the bipartite one otherwise. Only O(rows + columns)
+    // memory, where listing and sorting the pairs took 24 bytes each
+    std::vector<int> nodes;
+    for (int v = rowBegin; v < rowEnd; ++v) {
+        nodes.push_back(v);
+    }
+    for (int v = columnBegin; v < columnEnd; ++v) {
+        if (v < rowBegin || v >= rowEnd) {
+            nodes.push_back(v);
+        }
     }
+    auto inTile = [&](int u, int v) {
+        const int i = std::min(u, v), j = std::max(u, v);
+        return i != j && i >= rowBegin && i < rowEnd && j >= columnBegin && j < columnEnd;
+    };
 
-    nodeFile << "node_id,verdict\n"; // Header for nodes CSV
-    for (int i = 0; i < numDocuments; ++i) {
-        std::string verdict = statements.getVerdict(i); // Retrieve the verdict for this node
-        nodeFile << i << "," << verdict << "\n";
+    const double infinity = std::numeric_limits<double>::infinity();
+    const Edge none(0, 0, infinity, 0);
+    std::vector<Edge> best(nodes.size(), none);
+    std::vector<int> remaining(nodes.size());
+    for (size_t r = 0; r < nodes.size(); ++r) {
+        remaining[r] = static_cast<int>(r);
     }
-    nodeFile.close();
-    std::cout << "Node data exported to " << nodeFilename << std::endl;
+    std::vector<Edge> forest;
+    int current = -1;
+    while (!remaining.empty()) {
+        size_t nextPosition = 0;
+        for (size_t r = 0; r < remaining.size(); ++r) {
+            const int v = remaining[r];
+            if (current >= 0 && inTile(nodes[current], nodes[v])) {
+                const int a = std::min(nodes[current], nodes[v]), b = std::max(nodes[current], nodes[v]);
+                const Edge candidate(a, b, calculateCosineSimilarity(a, b), 0);
+                if (compareByWeight(candidate, best[v])) {
+                    best[v] = candidate;
+                }
+            }
+            if (compareByWeight(best[v], best[remaining[nextPosition]])) {
+                nextPosition = r;
+            }
+        }
+        // A node no tree edge reaches starts a new tree of the forest
+        const int next = remaining[nextPosition];
+        if (best[next].getWeight() != infinity) {
+            forest.push_back(best[next]);
+        }
+        remaining[nextPosition] = remaining.back();
+        remaining.pop_back();
+        current = next;
+    }
+    std::sort(forest.begin(), forest.end(), compareByWeight);
+    return forest;
 }
 
-void Network_Synthesizer::exportMSTToGraphMLWithNodeData(const std::string& filename, const Statements& statements) const {
-    // Open the GraphML file for writing
-    std::ofstream outputFile(filename);
-    if (!outputFile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
-        return;
+void Network_Synthesizer::appendDocuments(const std::vector<std::vector<double>>& newDocuments) {
+    std::cout << "Appending " << newDocuments.size() << " documents to the network...\n";
+    calculateDocumentModulus();
+    Scoped_Timer timer("mst_append");
+    timer.addItems(newDocuments.size());
+
+    for (const auto& row : newDocuments) {
+        std::vector<double> topics(row);
+        topics.resize(numTopics, 0.0);
+        double sum = 0.0;
+        for (double p : topics) {
+            sum += p * p;
+        }
+        documents.insert(documents.end(), topics.begin(), topics.end());
+        modulus.push_back(std::sqrt(sum));
+        ++numDocuments;
+        uf.extend(1);
+
+        insertLastDocumentIntoMST();
     }
 
-    // Write the GraphML header
-    outputFile << R"(<?xml version="1.0" encoding="UTF-8"?>)" << '\n';
-    outputFile << R"(<graphml xmlns="http://graphml.graphdrawing.org/xmlns")" << '\n';
-    outputFile << R"(    xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance")" << '\n';
-    outputFile << R"(    xsi:schemaLocation="http://graphml.graphdrawing.org/xmlns )" << '\n';
-    outputFile << R"(     http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd">)" << '\n';
-    outputFile << R"(<graph id="G" edgedefault="undirected">)" << '\n';
-
-    // Add node attributes for metadata
-    outputFile << R"(<key id="verdict" for="node" attr.name="verdict" attr.type="string"/>)" << '\n';
-    outputFile << R"(<key id="originator" for="node" attr.name="statement_originator" attr.type="string"/>)" << '\n';
-    outputFile << R"(<key id="source" for="node" attr.name="statement_source" attr.type="string"/>)" << '\n';
-    outputFile << R"(<key id="factchecker" for="node" attr.name="factchecker" attr.type="string"/>)" << '\n';
-    outputFile << R"(<key id="factcheck_date" for="node" attr.name="factcheck_date" attr.type="string"/>)" << '\n';
-    outputFile << R"(<key id="weight" for="edge" attr.name="weight" attr.type="double"/>)" << '\n';
-    outputFile << R"(<key id="label" for="edge" attr.name="label" attr.type="string"/>)" << '\n';
-
-    // Write nodes
-    std::set<int> nodes;
+    mstWeight = 0.0;
     for (const auto& edge : mst) {
-        nodes.insert(edge.getNode1());
-        nodes.insert(edge.getNode2());
+        uf.unite(edge.getNode1(), edge.getNode2());
+        mstWeight += edge.getWeight();
+    }
+    std::sort(mst.begin(), mst.end(), compareByWeight);
+    for (size_t id = 0; id < mst.size(); ++id) {
+        mst[id] = Edge(mst[id].getNode1(), mst[id].getNode2(), mst[id].getWeight(), static_cast<int>(id));
+    }
+
+    // Built for the previous document set
+    normalized.clear();
+    nodeAttributes.clear();
+    upperTriangle.clear();
+    upperTriangle.shrink_to_fit();
+    edges.clear();
+    edges.shrink_to_fit();
+
+    std::cout << "MST updated to " << numDocuments << " documents. Total weight: " << mstWeight << "\n";
+}
+
+void Network_Synthesizer::appendStatements(const Statements& statements) {
+    std::vector<std::vector<double>> rows;
+    for (int id = numDocuments; id < statements.getSize(); ++id) {
+        rows.push_back(statements.getTopics(id));
     }
+    appendDocuments(rows);
+}
+
+int Network_Synthesizer::getNumDocuments() const {
+    return numDocuments;
+}
+
+int Network_Synthesizer::getNumTopics() const {
+    return numTopics;
+}
+
+const std::vector<double>& Network_Synthesizer::getDocumentMatrix() const {
+    return documents;
+}
+
+const std::vector<double>& Network_Synthesizer::getUpperTriangle() const {
+    return upperTriangle;
+}
 
-    for (const int node : nodes) {
-        std::string verdict = statements.getVerdict(node);
-        std::string originator = statements.getOriginator(node);
-        std::string source = statements.getSource(node);
-        std::string factchecker = statements.getFactchecker(node);
-        std::string factcheckDate = statements.getFactcheckDate(node);
+const std::vector<Edge>& Network_Synthesizer::getMST() const {
+    return mst;
+}
+
+bool Network_Synthesizer::saveMST(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    for (const auto& edge : mst) {
+        const double weight = edge.getWeight();
+        const std::int32_t nodes[2] = {edge.getNode1(), edge.getNode2()};
+        file.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+        file.write(reinterpret_cast<const char*>(nodes), sizeof(nodes));
+    }
+    return file.good();
+}
 
-        outputFile << "  <node id=\"" << node << "\">" << '\n';
-        outputFile << "    <data key=\"verdict\">" << verdict << "</data>" << '\n';
-        outputFile << "    <data key=\"originator\">" << originator << "</data>" << '\n';
-        outputFile << "    <data key=\"source\">" << source << "</data>" << '\n';
-        outputFile << "    <data key=\"factchecker\">" << factchecker << "</data>" << '\n';
-        outputFile << "    <data key=\"factcheck_date\">" << factcheckDate << "</data>" << '\n';
-        outputFile << "  </node>" << '\n';
+bool Network_Synthesizer::loadMST(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << "." << std::endl;
+        return false;
     }
 
-    // Write edges
-    int edgeId = 0;
+    std::vector<Edge> loaded;
+    double weight;
+    std::int32_t nodes[2];
+    while (file.read(reinterpret_cast<char*>(&weight), sizeof(weight)) && file.read(reinterpret_cast<char*>(nodes), sizeof(nodes))) {
+        if (nodes[0] < 0 || nodes[1] < 0 || nodes[0] >= numDocuments || nodes[1] >= numDocuments) {
+            std::cerr << "Error: " << filename << " does not match the documents." << std::endl;
+            return false;
+        }
+        loaded.emplace_back(nodes[0], nodes[1], weight, static_cast<int>(loaded.size()));
+    }
 
+    mst.swap(loaded);
+    nodeAttributes.clear();
+    mstWeight = 0.0;
+    uf = UF_DS(numDocuments);
     for (const auto& edge : mst) {
-        double scaledWeight = (1.0 - edge.getWeight()) * 100; // Scale weight for better visualization
-        outputFile << "  <edge id=\"e" << edgeId++
-                   << "\" source=\"" << edge.getNode1()
-                   << "\" target=\"" << edge.getNode2() << "\">" << '\n';
-        outputFile << "    <data key=\"weight\">" << scaledWeight << "</data>" << '\n';
-        outputFile << "    <data key=\"label\">" << scaledWeight << "</data>" << '\n';
-        outputFile << "  </edge>" << '\n';
+        uf.unite(edge.getNode1(), edge.getNode2());
+        mstWeight += edge.getWeight();
     }
+    std::cout << "MST loaded from " << filename << ". Total weight: " << mstWeight << "\n";
+    return true;
+}
 
-    // Write the GraphML footer
-    outputFile << "</graph>" << '\n';
-    outputFile << "</graphml>" << '\n';
+void Network_Synthesizer::exportMSTWithNodeData(const std::string& edgeFilename, const std::string& nodeFilename, const Statements& statements) const {
+    Scoped_Timer timer("export_csv");
+    Graph_Writer writer(pool);
+
+    // Export MST edges
+    if (!writer.writeEdgeCsv(edgeFilename, mst)) {
+        return;
+    }
+    timer.addBytes(fileSize(edgeFilename));
+    std::cout << "MST edges exported to " << edgeFilename << std::endl;
 
-    outputFile.close();
+    // Export node data
+    if (!writer.writeNodeCsv(nodeFilename, numDocuments, statements, nodeAttributes)) {
+        return;
+    }
+    timer.addBytes(fileSize(nodeFilename));
+    std::cout << "Node data exported to " << nodeFilename << std::endl;
+}
+
+void Network_Synthesizer::exportMSTToGraphMLWithNodeData(const std::string& filename, const Statements& statements) const {
+    Scoped_Timer timer("export_graphml");
+    if (!Graph_Writer(pool).writeGraphML(filename, numDocuments, mst, statements, nodeAttributes)) {
+        return;
+    }
+    timer.addBytes(fileSize(filename));
     std::cout << "MST exported to GraphML successfully with node data to " << filename << std::endl;
 }
 
+bool Network_Synthesizer::exportBinaryGraph(const std::string& filename, const Statements& statements,
+                                            const Graph_Export_Config& config, const std::vector<int>& communities) {
+    if (config.kind == Graph_Kind::MST) {
+        return exportBinaryGraph(filename, statements, mst, communities);
+    }
+    return exportBinaryGraph(filename, statements, findGraph(config), communities);
+}
+
+bool Network_Synthesizer::exportBinaryGraph(const std::string& filename, const Statements& statements,
+                                            const std::vector<Edge>& edges, const std::vector<int>& communities) const {
+    Scoped_Timer timer("export_binary");
+    if (!Graph_Writer(pool).writeBinary(filename, numDocuments, edges, statements, communities, nodeAttributes)) {
+        return false;
+    }
+    timer.addItems(edges.size());
+    timer.addBytes(fileSize(filename));
+    std::cout << "Graph with " << edges.size() << " edges exported to " << filename << std::endl;
+    return true;
+}
 
+void Network_Synthesizer::setNodeAttribute(const std::string& name, std::vector<double> values) {
+    values.resize(numDocuments, 0.0);
+    for (auto& attribute : nodeAttributes) {
+        if (attribute.name == name) {
+            attribute.values = std::move(values);
+            return;
+        }
+    }
+    nodeAttributes.push_back({name, std::move(values)});
+}
+
+const std::vector<Node_Attribute>& Network_Synthesizer::getNodeAttributes() const {
+    return nodeAttributes;
+}
+
+bool Network_Synthesizer::parseGraphExport(const std::string& text, Graph_Export_Config& config) {
+    const size_t colon = text.find(':');
+    const std::string kind = text.substr(0, colon);
+    const std::string value = colon == std::string::npos ? "" : text.substr(colon + 1);
+    try {
+        if (kind == "mst" && value.empty()) {
+            config.kind = Graph_Kind::MST;
+        } else if (kind == "knn") {
+            config.kind = Graph_Kind::KNN;
+            if (!value.empty()) {
+                config.knnNeighbours = std::stoi(value);
+            }
+        } else if (kind == "threshold") {
+            config.kind = Graph_Kind::THRESHOLD;
+            if (!value.empty()) {
+                config.maxDistance = std::stod(value);
+            }
+        } else if (kind == "tmfg" && value.empty()) {
+            config.kind = Graph_Kind::TMFG;
+        } else if (kind == "pmfg" && value.empty()) {
+            config.kind = Graph_Kind::PMFG;
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
 
 // --- Debugging/Utility Methods ---
 
 // Prints the similarity matrix
 void Network_Synthesizer::printSimilarityMatrix() const {
-    auto index = [this](int i, int j) {
-        return (i * (2 * numDocuments - i - 1)) / 2 + (j - i - 1);
+    const size_t n = static_cast<size_t>(numDocuments);
+    auto index = [n](size_t i, size_t j) {
+        return (i * (2 * n - i - 1)) / 2 + (j - i - 1);
     };
 
     std::cout << "Similarity Matrix (upper triangular):\n";
@@ -0,0 +1,220 @@
+#include "permutation_test.h"
+#include "instrumentation.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <fmt/format.h>
+
+namespace {
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Counter-based stream: draw i of stream k is a hash of (k, i), so a permutation's draws
+// do not depend on which thread runs it or what ran before
+class Counter_Stream {
+public:
+    explicit Counter_Stream(uint64_t key) : key(splitmix64(key)) {
+    }
+
+    // Uniform in [0, bound), without modulo bias (Lemire's multiply-shift)
+    uint32_t below(uint32_t bound) {
+        uint64_t product = uint64_t(next()) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = uint64_t(next()) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+private:
+    uint64_t key;
+    uint64_t counter = 0;
+
+    uint32_t next() {
+        return static_cast<uint32_t>(splitmix64(key + ++counter * 0xD1B54A32D192ED03ull) >> 32);
+    }
+};
+
+}
+
+Permutation_Test::Permutation_Test(int numNodes, const std::vector<Edge>& edges, std::vector<uint8_t> labels,
+                                   std::vector<std::string> labelNames, Thread_Pool& pool)
+    : numNodes(std::max(0, numNodes)), labels(std::move(labels)), labelNames(std::move(labelNames)), pool(pool) {
+    for (const auto& edge : edges) {
+        const int u = edge.getNode1(), v = edge.getNode2();
+        if (u != v && u >= 0 && v >= 0 && u < this->numNodes && v < this->numNodes) {
+            sources.push_back(u);
+            targets.push_back(v);
+        }
+    }
+    prepare();
+}
+
+Permutation_Test::Permutation_Test(const Sparse_Graph& graph, std::vector<uint8_t> labels,
+                                   std::vector<std::string> labelNames, Thread_Pool& pool)
+    : numNodes(graph.getNumNodes()), labels(std::move(labels)), labelNames(std::move(labelNames)), pool(pool) {
+    for (int u = 0; u < numNodes; ++u) {
+        for (size_t s = graph.offsets[u]; s < graph.offsets[u + 1]; ++s) {
+            if (graph.neighbours[s] > u) {
+                sources.push_back(u);
+                targets.push_back(graph.neighbours[s]);
+            }
+        }
+    }
+    prepare();
+}
+
+void Permutation_Test::prepare() {
+    const size_t n = static_cast<size_t>(numNodes);
+    const int numLabels = static_cast<int>(std::min<size_t>(labelNames.size(), 255));
+    labelNames.resize(static_cast<size_t>(numLabels));
+    labels.resize(n, static_cast<uint8_t>(numLabels));
+    for (auto& label : labels) {
+        label = std::min<uint8_t>(label, static_cast<uint8_t>(numLabels));
+    }
+    degrees.assign(n, 0);
+    for (size_t e = 0; e < sources.size(); ++e) {
+        ++degrees[sources[e]];
+        ++degrees[targets[e]];
+    }
+    labelled.clear();
+    if (std::count(labels.begin(), labels.end(), static_cast<uint8_t>(numLabels)) > 0) {
+        for (size_t v = 0; v < n; ++v) {
+            if (labels[v] < numLabels) {
+                labelled.push_back(static_cast<int32_t>(v));
+            }
+        }
+    }
+}
+
+void Permutation_Test::evaluate(const uint8_t* nodeLabels, double* values) const {
+    // Four interleaved tables so that consecutive edges of one label do not wait on each other
+    std::array<std::array<uint32_t, 256>, 4> within{};
+    const size_t numEdges = sources.size();
+    const int32_t* first = sources.data();
+    const int32_t* second = targets.data();
+    size_t e = 0;
+    for (; e + 4 <= numEdges; e += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            const uint8_t a = nodeLabels[first[e + lane]], b = nodeLabels[second[e + lane]];
+            within[lane][a] += a == b;
+        }
+    }
+    for (; e < numEdges; ++e) {
+        const uint8_t a = nodeLabels[first[e]], b = nodeLabels[second[e]];
+        within[0][a] += a == b;
+    }
+    std::array<uint64_t, 256> degreeSums{};
+    for (size_t v = 0; v < degrees.size(); ++v) {
+        degreeSums[nodeLabels[v]] += degrees[v];
+    }
+
+    const double m = static_cast<double>(numEdges);
+    double same = 0.0, modularity = 0.0;
+    for (size_t c = 0; c < labelNames.size(); ++c) {
+        const double inside = static_cast<double>(within[0][c] + within[1][c] + within[2][c] + within[3][c]);
+        const double share = static_cast<double>(degreeSums[c]) / (2.0 * m);
+        same += inside;
+        modularity += inside / m - share * share;
+        values[2 + c] = inside;
+    }
+    values[0] = same / m;
+    values[1] = modularity;
+}
+
+std::vector<Permutation_Statistic> Permutation_Test::run(int permutations, uint64_t seed) const {
+    Scoped_Timer timer("permutation_test");
+    const size_t numStatistics = 2 + labelNames.size();
+    std::vector<Permutation_Statistic> result(numStatistics);
+    result[0].name = "same_label_fraction";
+    result[1].name = "modularity";
+    for (size_t c = 0; c < labelNames.size(); ++c) {
+        result[2 + c].name = "same_label_edges_" + labelNames[c];
+    }
+    if (sources.empty()) {
+        for (auto& statistic : result) {
+            statistic.observed = statistic.nullMean = statistic.nullStdDev = statistic.zScore =
+                std::numeric_limits<double>::quiet_NaN();
+            statistic.pValue = 1.0;
+        }
+        return result;
+    }
+
+    std::vector<double> observed(numStatistics);
+    evaluate(labels.data(), observed.data());
+
+    // Null values, one row per permutation
+    const size_t count = static_cast<size_t>(std::max(0, permutations));
+    std::vector<double> null(count * numStatistics);
+    const size_t grain = std::max<size_t>(1, count / (8 * static_cast<size_t>(pool.getNumThreads())));
+    pool.parallelFor(0, count, [&](size_t start, size_t end) {
+        std::vector<uint8_t> shuffled(labels.size());
+        for (size_t p = start; p < end; ++p) {
+            // Fisher-Yates from the real labels, over every node or only the labelled ones
+            std::copy(labels.begin(), labels.end(), shuffled.begin());
+            Counter_Stream stream(seed ^ splitmix64(p));
+            if (labelled.empty()) {
+                for (size_t i = shuffled.size(); i > 1; --i) {
+                    std::swap(shuffled[i - 1], shuffled[stream.below(static_cast<uint32_t>(i))]);
+                }
+            } else {
+                for (size_t i = labelled.size(); i > 1; --i) {
+                    std::swap(shuffled[labelled[i - 1]], shuffled[labelled[stream.below(static_cast<uint32_t>(i))]]);
+                }
+            }
+            evaluate(shuffled.data(), null.data() + p * numStatistics);
+        }
+    }, grain);
+
+    for (size_t s = 0; s < numStatistics; ++s) {
+        double sum = 0.0, squares = 0.0;
+        size_t atLeast = 0;
+        for (size_t p = 0; p < count; ++p) {
+            const double value = null[p * numStatistics + s];
+            sum += value;
+            squares += value * value;
+            atLeast += value >= observed[s];
+        }
+        Permutation_Statistic& statistic = result[s];
+        statistic.observed = observed[s];
+        statistic.nullMean = count > 0 ? sum / count : std::numeric_limits<double>::quiet_NaN();
+        statistic.nullStdDev = count > 0 ? std::sqrt(std::max(0.0, squares / count - statistic.nullMean * statistic.nullMean))
+                                         : std::numeric_limits<double>::quiet_NaN();
+        statistic.zScore = statistic.nullStdDev > 0 ? (statistic.observed - statistic.nullMean) / statistic.nullStdDev
+                                                    : std::numeric_limits<double>::quiet_NaN();
+        statistic.pValue = static_cast<double>(1 + atLeast) / static_cast<double>(1 + count);
+    }
+    timer.addItems(count);
+    return result;
+}
+
+bool Permutation_Test::writeCsv(const std::string& filename, const std::vector<Permutation_Statistic>& statistics) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    fmt::memory_buffer buffer;
+    auto out = std::back_inserter(buffer);
+    auto number = [](double value) { return std::isnan(value) ? std::string() : fmt::format("{}", value); };
+    fmt::format_to(out, "statistic,observed,null_mean,null_sd,z_score,p_value\n");
+    for (const auto& statistic : statistics) {
+        fmt::format_to(out, "{},{},{},{},{},{}\n", statistic.name, number(statistic.observed), number(statistic.nullMean),
+                       number(statistic.nullStdDev), number(statistic.zScore), statistic.pValue);
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
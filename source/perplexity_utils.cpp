@@ -1,16 +1,16 @@
 #include "perplexity_utils.h"
+#include "instrumentation.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cmath>
 #include <cstring> 
-#include <omp.h>
-#include <cmath>
 #include <vector>
 
 using namespace tinyxml2;
 
 int totalNumberOfWords(const std::string& diagnosticsFile) {
+    Scoped_Timer timer("diagnostics_parse");
     XMLDocument doc;
     if (doc.LoadFile(("./temp/" + diagnosticsFile + "_diagnostics.xml").c_str()) != XML_SUCCESS) {
         std::cerr << "Error: Failed to load diagnostics file: " << diagnosticsFile << std::endl;
@@ -34,6 +34,7 @@ int totalNumberOfWords(const std::string& diagnosticsFile) {
 }
 
 double* calculateMeans(const std::string& diagnosticsFile, int numTopics) {
+    Scoped_Timer timer("diagnostics_parse");
     XMLDocument doc;
     if (doc.LoadFile(("./temp/" + diagnosticsFile + "_diagnostics.xml").c_str()) != XML_SUCCESS) {
         std::cerr << "Error: Failed to load diagnostics file: " << diagnosticsFile << std::endl;
@@ -91,6 +92,7 @@ double* calculateMeans(const std::string& diagnosticsFile, int numTopics) {
 
 
 double* parseDocTopicProb(const std::string& profile, int numTopics, int& numDocs) {
+    Scoped_Timer timer("composition_parse");
     std::ifstream file("./temp/" + profile + "_composition.txt", std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Error: Could not open composition file." << std::endl;
@@ -99,6 +101,7 @@ double* parseDocTopicProb(const std::string& profile, int numTopics, int& numDoc
 
     file.seekg(0, std::ios::end);
     std::streampos fileSize = file.tellg();
+    timer.addBytes(static_cast<uint64_t>(fileSize));
     if (fileSize == 0) {
         std::cerr << "Error: Composition file is empty." << std::endl;
         return nullptr;
@@ -144,11 +147,13 @@ double* parseDocTopicProb(const std::string& profile, int numTopics, int& numDoc
             docTopicProbs[docID * numTopics + topicID] = prob;
         }
     }
+    timer.addItems(numDocs);
 
     return docTopicProbs;
 }
 
 double* parseDiagnosticsForWordTopicProbs(const std::string& diagnosticsFile, int numTopics, size_t numWords) {
+    Scoped_Timer timer("diagnostics_parse");
     XMLDocument doc;
     if (doc.LoadFile(("./temp/" + diagnosticsFile + "_diagnostics.xml").c_str()) != XML_SUCCESS) {
         std::cerr << "Error: Failed to load diagnostics file: " << diagnosticsFile << std::endl;
@@ -175,32 +180,36 @@ double* parseDiagnosticsForWordTopicProbs(const std::string& diagnosticsFile, in
     return wordTopicProbs;
 }
 
-double* calculateDocumentProbabilities(double* docTopicProbs, int numDocs, int numTopics, double* wordTopicProbs, size_t numWords) {
+double* calculateDocumentProbabilities(double* docTopicProbs, int numDocs, int numTopics, double* wordTopicProbs, size_t numWords,
+                                       Thread_Pool& pool) {
+    Scoped_Timer timer("document_probabilities");
+    timer.addItems(numDocs);
     double* docProbs = new double[numDocs]();
 
-    #pragma omp parallel for
-    for (int docID = 0; docID < numDocs; ++docID) {
-        double logDocProb = 0.0;
+    pool.parallelFor(0, static_cast<size_t>(numDocs), [=](size_t start, size_t end) {
+        for (size_t docID = start; docID < end; ++docID) {
+            double logDocProb = 0.0;
 
-        for (size_t wordID = 0; wordID < numWords; ++wordID) {
-            double wordProb = 0.0;
+            for (size_t wordID = 0; wordID < numWords; ++wordID) {
+                double wordProb = 0.0;
 
-            double* wordTopicPtr = wordTopicProbs + wordID; // Pointer to P(w|t)
-            double* docTopicPtr = docTopicProbs + docID * numTopics; // Pointer to P(t|d)
+                double* wordTopicPtr = wordTopicProbs + wordID; // Pointer to P(w|t)
+                double* docTopicPtr = docTopicProbs + docID * numTopics; // Pointer to P(t|d)
 
-            for (int topicID = 0; topicID < numTopics; ++topicID) {
-                wordProb += (*wordTopicPtr) * (*docTopicPtr);
-                wordTopicPtr += numWords; // Move to the next topic
-                ++docTopicPtr; // Move to the next topic
-            }
+                for (int topicID = 0; topicID < numTopics; ++topicID) {
+                    wordProb += (*wordTopicPtr) * (*docTopicPtr);
+                    wordTopicPtr += numWords; // Move to the next topic
+                    ++docTopicPtr; // Move to the next topic
+                }
 
-            if (wordProb > 0) {
-                logDocProb += std::log(wordProb);
+                if (wordProb > 0) {
+                    logDocProb += std::log(wordProb);
+                }
             }
-        }
 
-        docProbs[docID] = std::exp(logDocProb);
-    }
+            docProbs[docID] = std::exp(logDocProb);
+        }
+    });
 
     return docProbs;
 }
@@ -0,0 +1,613 @@
+#include "pipeline_runner.h"
+#include "graph_writer.h"
+#include "instrumentation.h"
+#include "perplexity_utils.h"
+#include "tree_analytics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+Pipeline_Runner::Pipeline_Runner(const Pipeline_Config& config, Thread_Pool& pool)
+    : config(config), pool(pool), cache(config.cacheDirectory, config.useCache) {
+}
+
+int Pipeline_Runner::run() {
+    std::filesystem::create_directories("./temp");
+
+    Topic_generator topicGenerator(pool);
+    if (auto backend = Topic_Backend::create(config.topicBackend)) {
+        topicGenerator.setBackend(std::move(backend));
+    }
+    Backend_Options backendOptions;
+    backendOptions.timeout = std::chrono::duration<double>(config.trainingTimeout);
+    backendOptions.onProgress = [](const Training_Progress& progress) {
+        // About ten reports per chain
+        const int step = std::max(10, progress.iterations / 100 * 10);
+        if (progress.iteration % step == 0) {
+            static std::mutex outputMutex;
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << "Chain " << progress.job << ": iteration " << progress.iteration << "/" << progress.iterations;
+            if (!std::isnan(progress.logLikelihood)) {
+                std::cout << ", LL/token " << progress.logLikelihood;
+            }
+            std::cout << "\n";
+        }
+    };
+    topicGenerator.getBackend().setOptions(backendOptions);
+    statements = Statements();
+    networkSynthesizer.reset();
+    filteredGraph.clear();
+
+    // The MST, consensus, group and temporal stages overlap and each sizes its own work, so
+    // they split the memory and disk budgets instead of each assuming all of them
+    const size_t planningStages = 1 + (config.buildConsensus ? 1 : 0) + (config.buildGroupNetwork ? 1 : 0) +
+                                  (config.buildTemporal ? 1 : 0);
+    stagePlanner = Execution_Planner(config.planner).plan(0, 0).config;
+    stagePlanner.memoryBudgetBytes /= planningStages;
+    stagePlanner.diskBudgetBytes /= planningStages;
+    Stage_Channel<std::string> corpus;
+    std::atomic<bool> imported{false};
+    Fingerprint importKey;
+    std::string compositionHash;
+
+    Stage_Graph graph;
+    const int import = graph.addStage("import", [&]() {
+        std::function<void(int, const std::string&)> stream;
+        if (!config.skipMallet) {
+            stream = [&corpus](int, const std::string& comment) { corpus.push(comment); };
+        }
+        topicGenerator.importStoreData(statements, config.input, stream);
+        imported = statements.getSize() > 0;
+        corpus.close();
+        if (!imported) {
+            std::cerr << "Error: No statements imported from " << config.input << "." << std::endl;
+        }
+        return imported.load();
+    });
+
+    std::vector<int> model;
+    if (!config.skipMallet) {
+        const int fingerprint = graph.addStage("input_fingerprint", [&]() {
+            importKey.add("input", Stage_Cache::hashFile(config.input)).add("backend", config.topicBackend);
+            return true;
+        });
+        const int malletImport = graph.addStage("mallet_import", [&]() {
+            return runMalletImport(corpus, imported, importKey, topicGenerator);
+        }, {fingerprint});
+        model.push_back(graph.addStage("lda_training", [&]() {
+            return runTraining(topicGenerator, importKey);
+        }, {malletImport}));
+    }
+
+    const int modelFingerprint = graph.addStage("model_fingerprint", [&]() {
+        compositionHash = Stage_Cache::hashFile(profileFile("_composition.txt"));
+        return !compositionHash.empty();
+    }, model);
+
+    graph.addStage("perplexity", [&]() {
+        runPerplexity(topicGenerator, compositionHash);
+        return true;
+    }, {modelFingerprint});
+
+    const int assignment = graph.addStage("topic_assignment", [&]() {
+        topicGenerator.assignTopics(statements, config.lda.numTopics, config.profile);
+        return true;
+    }, {import, modelFingerprint});
+
+    const int mst = graph.addStage("mst", [&]() {
+        networkSynthesizer = std::make_unique<Network_Synthesizer>(statements, config.lda.numTopics, pool);
+        return runMST(*networkSynthesizer, statements, compositionHash);
+    }, {assignment});
+
+    // Consensus replicas, groups and windows read the topics directly, so they overlap the MST
+    if (config.buildConsensus) {
+        graph.addStage("consensus", [&]() {
+            return runConsensus(topicGenerator, statements);
+        }, {assignment});
+    }
+    if (config.buildGroupNetwork) {
+        graph.addStage("group_network", [&]() {
+            return runGroupNetwork(statements);
+        }, {assignment});
+    }
+    if (config.buildTemporal) {
+        graph.addStage("temporal_windows", [&]() {
+            return runTemporal(statements);
+        }, {assignment});
+    }
+
+    // Exports read the tree metrics as node attributes
+    const int analytics = graph.addStage("tree_analytics", [&]() {
+        runTreeAnalytics(*networkSynthesizer, statements);
+        return true;
+    }, {mst});
+
+    graph.addStage("percolation", [&]() {
+        return runPercolation(*networkSynthesizer);
+    }, {mst});
+
+    if (config.permutations > 0) {
+        graph.addStage("permutation_test", [&]() {
+            return runPermutationTest(*networkSynthesizer, statements);
+        }, {mst});
+    }
+    if (config.computeDistanceStatistics) {
+        graph.addStage("distance_statistics", [&]() {
+            return runDistanceStatistics(*networkSynthesizer, statements);
+        }, {mst});
+    }
+
+    graph.addStage("dendrogram", [&]() {
+        return runDendrogram(*networkSynthesizer, statements);
+    }, {mst});
+
+    // The layout adds its attributes after the tree metrics
+    int attributes = analytics;
+    if (config.computeLayout) {
+        attributes = graph.addStage("layout", [&]() {
+            runLayout(*networkSynthesizer);
+            return true;
+        }, {analytics});
+    }
+
+    graph.addStage("export_graphml", [&]() {
+        networkSynthesizer->exportMSTToGraphMLWithNodeData("./temp/mst_with_data.graphml", statements);
+        return true;
+    }, {attributes});
+    graph.addStage("export_csv", [&]() {
+        networkSynthesizer->exportMSTWithNodeData("./temp/mst_edges.csv", "./temp/node_data.csv", statements);
+        return true;
+    }, {attributes});
+
+    // A binary export of the filtered graph writes the edges that stage built, so it waits for it
+    std::vector<int> binaryInputs = {attributes};
+    if (config.buildFilteredGraph) {
+        binaryInputs.push_back(graph.addStage("filtered_graph", [&]() {
+            return runFilteredGraph(*networkSynthesizer, statements);
+        }, {mst}));
+    }
+
+    if (!config.binaryGraph.empty()) {
+        graph.addStage("export_binary", [&]() {
+            std::vector<int> communities;
+            if (!config.communitiesFile.empty() &&
+                !Graph_Writer::readCommunities(config.communitiesFile, statements.getSize(), communities)) {
+                return false;
+            }
+            if (config.buildFilteredGraph && config.binaryGraphEdges.kind == config.filteredGraph) {
+                return networkSynthesizer->exportBinaryGraph(config.binaryGraph, statements, filteredGraph, communities);
+            }
+            return networkSynthesizer->exportBinaryGraph(config.binaryGraph, statements, config.binaryGraphEdges, communities);
+        }, binaryInputs);
+    }
+
+    return graph.run(pool) ? 0 : 1;
+}
+
+bool Pipeline_Runner::runMalletImport(Stage_Channel<std::string>& corpus, const std::atomic<bool>& imported,
+                                      const Fingerprint& importKey, Topic_generator& topicGenerator) {
+    const std::string malletFile = profileFile(".mallet");
+    if (cache.isValid(stageName("mallet_import"), importKey)) {
+        corpus.discard();
+        std::cout << "Cache: reusing " << malletFile << "\n";
+        return true;
+    }
+
+    // The corpus file is written while the JSON is still being imported
+    const std::string corpusFile = "./temp/statements_only.txt";
+    {
+        Scoped_Timer timer("corpus_write");
+        std::ofstream outFile(corpusFile);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not create temporary input file." << std::endl;
+            corpus.discard();
+            return false;
+        }
+        std::string comment;
+        uint64_t count = 0;
+        while (corpus.pop(pool, comment)) {
+            outFile << comment << '\n';
+            ++count;
+        }
+        timer.addItems(count);
+        timer.addBytes(static_cast<uint64_t>(outFile.tellp()));
+    }
+    if (!imported) {
+        return false;
+    }
+    std::cout << "Statements written to " << corpusFile << std::endl;
+
+    if (!topicGenerator.importMalletCorpus(corpusFile, config.profile)) {
+        cache.invalidate(stageName("mallet_import"));
+        return false;
+    }
+    cache.record(stageName("mallet_import"), importKey, {malletFile});
+    return true;
+}
+
+bool Pipeline_Runner::runTraining(Topic_generator& topicGenerator, const Fingerprint& importKey) {
+    const Lda_Config& lda = config.lda;
+    Fingerprint trainingKey;
+    trainingKey.add("mallet_import", importKey.value())
+        .add("topics", lda.numTopics)
+        .add("alpha", lda.alpha)
+        .add("beta", lda.beta)
+        .add("iterations", lda.iterations)
+        .add("optimize_interval", lda.optimizeInterval)
+        .add("optimize_burn_in", lda.optimizeBurnIn)
+        .add("seed", lda.seed)
+        .add("chains", config.chains);
+
+    if (cache.isValid(stageName("lda_training"), trainingKey)) {
+        std::cout << "Cache: reusing the topic model of profile " << config.profile << "\n";
+        return true;
+    }
+    if (!(config.chains > 1 ? trainChains(topicGenerator) : topicGenerator.generateTopics(config.profile, lda, config.profile))) {
+        cache.invalidate(stageName("lda_training"));
+        return false;
+    }
+    cache.record(stageName("lda_training"), trainingKey,
+                 {profileFile("_composition.txt"), profileFile("_diagnostics.xml"), profileFile("_word_topic.txt")});
+    return true;
+}
+
+bool Pipeline_Runner::trainChains(Topic_generator& topicGenerator) {
+    // Chain c trains under seed + c into its own files; the best one becomes the profile's model
+    std::vector<Training_Job> jobs;
+    for (int c = 0; c < config.chains; ++c) {
+        Lda_Config lda = config.lda;
+        lda.seed = (config.lda.seed != 0 ? config.lda.seed : 1) + c;
+        jobs.push_back({config.profile, lda, config.profile + "_chain" + std::to_string(c)});
+    }
+    const std::vector<Training_Result> results = topicGenerator.generateTopicChains(jobs, config.chains);
+    int best = -1;
+    for (int c = 0; c < config.chains; ++c) {
+        const Training_Result& result = results[c];
+        if (result.ok && (best < 0 || std::isnan(results[best].logLikelihood) ||
+                          (!std::isnan(result.logLikelihood) && result.logLikelihood > results[best].logLikelihood))) {
+            best = c;
+        }
+    }
+    if (best < 0) {
+        std::cerr << "Error: No training chain succeeded." << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    for (const char* suffix : {"_composition.txt", "_diagnostics.xml", "_word_topic.txt"}) {
+        std::filesystem::copy_file("./temp/" + jobs[best].output + suffix, profileFile(suffix),
+                                   std::filesystem::copy_options::overwrite_existing, ec);
+        if (ec) {
+            std::cerr << "Error: Could not copy the model of chain " << best << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Kept chain " << best << " of " << config.chains << " (LL/token " << results[best].logLikelihood << ")\n";
+    return true;
+}
+
+void Pipeline_Runner::runPerplexity(Topic_generator& topicGenerator, const std::string& compositionHash) {
+    Fingerprint key;
+    key.add("composition", compositionHash)
+        .add("diagnostics", Stage_Cache::hashFile(profileFile("_diagnostics.xml")))
+        .add("topics", config.lda.numTopics)
+        .add("words", static_cast<double>(config.perplexityWords));
+
+    const std::string meansFile = "./temp/means_data.csv";
+    if (cache.isValid(stageName("perplexity"), key)) {
+        std::cout << "Cache: reusing " << meansFile << "\n";
+        return;
+    }
+    topicGenerator.perplexityPypelyne(config.lda.numTopics, config.profile);
+    cache.record(stageName("perplexity"), key, {meansFile});
+}
+
+bool Pipeline_Runner::runMST(Network_Synthesizer& networkSynthesizer, const Statements& statements,
+                             const std::string& compositionHash) {
+    // Every exact strategy yields the same MST, so only the kNN approximation changes the result
+    Execution_Plan plan;
+    std::string family = "exact";
+    if (config.shards <= 0) {
+        plan = networkSynthesizer.planExecution(stagePlanner);
+        if (plan.strategy == Strategy::KNN_GRAPH) {
+            family = "knn:" + std::to_string(config.planner.knnNeighbours);
+        }
+    }
+
+    Fingerprint key;
+    key.add("composition", compositionHash)
+        .add("documents", statements.getSize())
+        .add("topics", config.lda.numTopics)
+        .add("metric", "cosine")
+        .add("strategy", family);
+
+    const std::string mstFile = config.cacheDirectory + "/" + config.profile + "_mst.bin";
+    if (cache.isValid(stageName("mst"), key) && networkSynthesizer.loadMST(mstFile)) {
+        std::cout << "Cache: reusing " << mstFile << "\n";
+        return true;
+    }
+
+    if (config.shards > 0) {
+        if (!networkSynthesizer.findMSTSharded(config.shardConfig)) {
+            return false;
+        }
+        if (config.verifyShards) {
+            Network_Synthesizer reference(statements, config.lda.numTopics, pool);
+            reference.findMSTFusedPrim();
+            const auto& a = networkSynthesizer.getMST();
+            const auto& b = reference.getMST();
+            bool same = a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Edge& x, const Edge& y) {
+                return x.getNode1() == y.getNode1() && x.getNode2() == y.getNode2() && x.getWeight() == y.getWeight();
+            });
+            std::cout << "Sharded MST " << (same ? "matches" : "differs from") << " the single-process MST.\n";
+            if (!same) {
+                return false;
+            }
+        }
+    } else {
+        networkSynthesizer.execute(plan);
+    }
+
+    std::filesystem::create_directories(config.cacheDirectory);
+    if (networkSynthesizer.saveMST(mstFile)) {
+        cache.record(stageName("mst"), key, {mstFile});
+    }
+    return true;
+}
+
+void Pipeline_Runner::runTreeAnalytics(Network_Synthesizer& networkSynthesizer, const Statements& statements) {
+    Scoped_Timer timer("tree_analytics");
+    const int numNodes = statements.getSize();
+    timer.addItems(numNodes);
+    Tree_Analytics analytics(numNodes, networkSynthesizer.getMST());
+    networkSynthesizer.setNodeAttribute("degree", analytics.degrees());
+    networkSynthesizer.setNodeAttribute("betweenness", analytics.betweenness());
+    networkSynthesizer.setNodeAttribute("closeness", analytics.closeness());
+    networkSynthesizer.setNodeAttribute("eccentricity", analytics.eccentricity());
+    analytics.writeSummary("./temp/tree_metrics.json", statements);
+}
+
+void Pipeline_Runner::runLayout(Network_Synthesizer& networkSynthesizer) {
+    Force_Layout layout(networkSynthesizer.getNumDocuments(), networkSynthesizer.getMST(), pool);
+    layout.run(config.layout);
+    networkSynthesizer.setNodeAttribute("x", layout.getX());
+    networkSynthesizer.setNodeAttribute("y", layout.getY());
+    std::cout << "ForceAtlas2 layout computed in " << config.layout.iterations << " iterations\n";
+}
+
+bool Pipeline_Runner::runDendrogram(const Network_Synthesizer& networkSynthesizer, const Statements& statements) {
+    Scoped_Timer timer("dendrogram");
+    timer.addItems(networkSynthesizer.getMST().size());
+    Dendrogram dendrogram(statements.getSize(), networkSynthesizer.getMST());
+    if (!dendrogram.writeLinkage("./temp/linkage.npy")) {
+        return false;
+    }
+    std::cout << "Single-linkage dendrogram written to ./temp/linkage.npy\n";
+    if (!config.cutDendrogram) {
+        return true;
+    }
+    const std::vector<int> labels = dendrogram.cut(config.clusterCut);
+    const int numClusters = labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end()) + 1;
+    if (!Dendrogram::writeClusters("./temp/clusters.csv", labels)) {
+        return false;
+    }
+    std::cout << numClusters << " single-linkage clusters written to ./temp/clusters.csv\n";
+    return true;
+}
+
+bool Pipeline_Runner::runPercolation(const Network_Synthesizer& networkSynthesizer) {
+    std::vector<double> thresholds = config.percolationThresholds;
+    if (thresholds.empty()) {
+        const auto& mst = networkSynthesizer.getMST();
+        double heaviest = 0.0;
+        for (const auto& edge : mst) {
+            heaviest = std::max(heaviest, edge.getWeight());
+        }
+        constexpr int steps = 100;
+        for (int step = 0; step <= steps; ++step) {
+            thresholds.push_back(heaviest * step / steps);
+        }
+    }
+    const std::vector<Percolation_Point> points = networkSynthesizer.sweepThresholds(thresholds);
+
+    const std::string filename = "./temp/percolation.csv";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    file << "threshold,components,giant_size,singletons\n";
+    for (const auto& point : points) {
+        file << point.threshold << ',' << point.components << ',' << point.giantSize << ',' << point.singletons << '\n';
+    }
+    std::cout << "Percolation sweep over " << points.size() << " thresholds written to " << filename << "\n";
+    return static_cast<bool>(file);
+}
+
+bool Pipeline_Runner::runPermutationTest(const Network_Synthesizer& networkSynthesizer, const Statements& statements) {
+    constexpr int numVerdicts = static_cast<int>(Verdict::PANTS_FIRE) + 1;
+    std::vector<std::string> names;
+    for (int v = 0; v < numVerdicts; ++v) {
+        names.push_back(verdictToString(static_cast<Verdict>(v)));
+    }
+    std::vector<uint8_t> labels(static_cast<size_t>(networkSynthesizer.getNumDocuments()), numVerdicts);
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const Statement* statement = statements.findStatement(static_cast<int>(i));
+        if (statement) {
+            labels[i] = static_cast<uint8_t>(statement->getVerdict());
+        }
+    }
+    const Permutation_Test test(networkSynthesizer.getNumDocuments(), networkSynthesizer.getMST(), std::move(labels),
+                                std::move(names), pool);
+    const std::vector<Permutation_Statistic> statistics = test.run(config.permutations, config.permutationSeed);
+
+    const std::string filename = "./temp/permutation_tests.csv";
+    if (!Permutation_Test::writeCsv(filename, statistics)) {
+        return false;
+    }
+    std::cout << "Permutation test over " << config.permutations << " permutations written to " << filename
+              << " (same-verdict edges " << statistics[0].observed << ", p = " << statistics[0].pValue << ")\n";
+    return true;
+}
+
+bool Pipeline_Runner::runDistanceStatistics(const Network_Synthesizer& networkSynthesizer, const Statements& statements) {
+    constexpr int numVerdicts = static_cast<int>(Verdict::PANTS_FIRE) + 1;
+    std::vector<std::string> names;
+    for (int v = 0; v < numVerdicts; ++v) {
+        names.push_back(verdictToString(static_cast<Verdict>(v)));
+    }
+    std::vector<int> labels(static_cast<size_t>(networkSynthesizer.getNumDocuments()), -1);
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const Statement* statement = statements.findStatement(static_cast<int>(i));
+        labels[i] = statement ? static_cast<int>(statement->getVerdict()) : -1;
+    }
+    const Distance_Statistics statistics = networkSynthesizer.computeDistanceStatistics(labels, names, config.distanceBins);
+
+    const std::string filename = "./temp/distance_stats.json";
+    if (!statistics.writeJson(filename)) {
+        return false;
+    }
+    std::cout << "Distance statistics over " << statistics.all.getCount() << " pairs written to " << filename
+              << " (median " << statistics.all.quantile(0.5) << ", mean " << statistics.all.getMean() << ")\n";
+    return true;
+}
+
+bool Pipeline_Runner::runConsensus(Topic_generator& topicGenerator, const Statements& statements) {
+    const Consensus_Config& consensusConfig = config.consensus;
+    const int numTopics = config.lda.numTopics;
+    if (consensusConfig.kind == Replica_Kind::LDA_SEEDS && config.skipMallet) {
+        std::cerr << "Error: LDA replicas need Mallet; drop --skip-mallet or use bootstrap replicas." << std::endl;
+        return false;
+    }
+    std::vector<std::vector<double>> documents(statements.getSize());
+    for (int i = 0; i < statements.getSize(); ++i) {
+        documents[i] = statements.getTopics(i);
+        documents[i].resize(numTopics, 0.0);
+    }
+
+    auto bootstrap = [&](int replica, std::vector<std::vector<double>>& rows) {
+        rows = Mst_Consensus::bootstrapTopics(documents, consensusConfig.seed + static_cast<uint64_t>(replica));
+        return true;
+    };
+    // Each LDA replica retrains on the imported corpus with its own seed and output files
+    auto retrain = [&](int replica, std::vector<std::vector<double>>& rows) {
+        Lda_Config lda = config.lda;
+        lda.seed = static_cast<int>(consensusConfig.seed + static_cast<uint64_t>(replica));
+        const std::string output = config.profile + "_replica" + std::to_string(replica);
+        if (!topicGenerator.generateTopics(config.profile, lda, output)) {
+            return false;
+        }
+        int numDocs = 0;
+        std::unique_ptr<double[]> probabilities(parseDocTopicProb(output, numTopics, numDocs));
+        if (!probabilities || numDocs != statements.getSize()) {
+            return false;
+        }
+        rows.assign(numDocs, std::vector<double>(numTopics));
+        for (int i = 0; i < numDocs; ++i) {
+            std::copy_n(probabilities.get() + static_cast<size_t>(i) * numTopics, numTopics, rows[i].begin());
+        }
+        return true;
+    };
+
+    Mst_Consensus consensus(statements.getSize(), numTopics, pool);
+    // Replicas share the consensus stage's part of the budget, as the MST stage overlaps them
+    Planner_Config planner = stagePlanner;
+    planner.requireEdgeList = false;
+    planner.forceStrategy = false;
+    const bool resampled = consensusConfig.kind == Replica_Kind::TOPIC_BOOTSTRAP;
+    if (!consensus.run(consensusConfig.replicas, planner, resampled ? Mst_Consensus::Replica_Source(bootstrap)
+                                                                    : Mst_Consensus::Replica_Source(retrain))) {
+        return false;
+    }
+    const std::string filename = "./temp/consensus_edges.csv";
+    if (!consensus.writeCsv(filename)) {
+        return false;
+    }
+    const std::vector<Consensus_Edge> edges = consensus.getEdges();
+    const size_t majority = static_cast<size_t>(std::count_if(edges.begin(), edges.end(),
+                                                              [](const Consensus_Edge& edge) { return edge.support > 0.5; }));
+    std::cout << "Consensus of " << consensus.getNumTrees() << " MSTs written to " << filename << " ("
+              << edges.size() << " distinct edges, " << majority << " in a majority of the trees)\n";
+    return true;
+}
+
+bool Pipeline_Runner::runGroupNetwork(const Statements& statements) {
+    const Group_Network groups(statements, config.lda.numTopics, config.groupKey, pool);
+    if (groups.getGroups().size() < 2) {
+        std::cerr << "Error: At least two " << Group_Network::keyName(config.groupKey) << " groups are needed." << std::endl;
+        return false;
+    }
+    // The main MST runs concurrently, so out-of-core runs of the groups get their own scratch directory
+    Planner_Config planner = stagePlanner;
+    planner.scratchDirectory += "/group_network";
+    std::error_code error;
+    std::filesystem::create_directories(planner.scratchDirectory, error);
+    Network_Synthesizer groupSynthesizer(groups.getTopicMatrix(), config.lda.numTopics, pool);
+    groupSynthesizer.execute(groupSynthesizer.planExecution(planner));
+    for (auto& attribute : groups.getAttributes()) {
+        groupSynthesizer.setNodeAttribute(attribute.name, std::move(attribute.values));
+    }
+    if (config.computeLayout) {
+        runLayout(groupSynthesizer);
+    }
+
+    const Statements nodes = groups.toStatements();
+    const std::string prefix = std::string("./temp/") + Group_Network::keyName(config.groupKey);
+    groupSynthesizer.exportMSTWithNodeData(prefix + "_mst_edges.csv", prefix + "_node_data.csv", nodes);
+    groupSynthesizer.exportMSTToGraphMLWithNodeData(prefix + "_mst_with_data.graphml", nodes);
+    return true;
+}
+
+bool Pipeline_Runner::runTemporal(const Statements& statements) {
+    Temporal_Network temporalNetwork(statements, config.lda.numTopics, pool);
+    Temporal_Config temporal = config.temporal;
+    temporal.memoryBudgetBytes = std::min(temporal.memoryBudgetBytes, stagePlanner.memoryBudgetBytes);
+    const std::vector<Temporal_Window> windows = temporalNetwork.run(temporal);
+    if (!Temporal_Network::writeSeries("./temp/temporal_windows.csv", windows) ||
+        !Temporal_Network::writeEdges("./temp/temporal_mst_edges.csv", windows)) {
+        return false;
+    }
+    std::cout << "Temporal series written to ./temp/temporal_windows.csv and ./temp/temporal_mst_edges.csv\n";
+    return true;
+}
+
+bool Pipeline_Runner::runFilteredGraph(Network_Synthesizer& networkSynthesizer, const Statements& statements) {
+    Graph_Export_Config graphConfig;
+    graphConfig.kind = config.filteredGraph;
+    filteredGraph = networkSynthesizer.findGraph(graphConfig);
+    const std::vector<Edge>& graph = filteredGraph;
+    const std::string prefix = config.filteredGraph == Graph_Kind::PMFG ? "./temp/pmfg" : "./temp/tmfg";
+
+    Scoped_Timer timer("export_filtered_graph");
+    timer.addItems(graph.size());
+    Graph_Writer writer(pool);
+    if (!writer.writeEdgeCsv(prefix + "_edges.csv", graph) ||
+        !writer.writeGraphML(prefix + "_with_data.graphml", statements.getSize(), graph, statements)) {
+        return false;
+    }
+    std::cout << "Filtered graph exported to " << prefix << "_edges.csv and " << prefix << "_with_data.graphml\n";
+    return true;
+}
+
+const Statements& Pipeline_Runner::getStatements() const {
+    return statements;
+}
+
+const Network_Synthesizer* Pipeline_Runner::getNetworkSynthesizer() const {
+    return networkSynthesizer.get();
+}
+
+Network_Synthesizer* Pipeline_Runner::getNetworkSynthesizer() {
+    return networkSynthesizer.get();
+}
+
+std::string Pipeline_Runner::profileFile(const std::string& suffix) const {
+    return "./temp/" + config.profile + suffix;
+}
+
+std::string Pipeline_Runner::stageName(const std::string& stage) const {
+    return config.profile + "_" + stage;
+}
@@ -0,0 +1,276 @@
+#include "planarity.h"
+#include <algorithm>
+
+bool Planarity_Tester::isPlanar(int numNodes, const std::vector<std::pair<int, int>>& edges) {
+    const size_t n = static_cast<size_t>(std::max(0, numNodes));
+    const size_t m = edges.size();
+    // Euler's formula: a simple planar graph has at most 3n - 6 edges
+    if (n > 2 && m > 3 * n - 6) {
+        return false;
+    }
+
+    offsets.assign(n + 1, 0);
+    for (const auto& [u, v] : edges) {
+        ++offsets[u + 1];
+        ++offsets[v + 1];
+    }
+    for (size_t v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    adjacency.resize(2 * m);
+    next.assign(offsets.begin(), offsets.end() - 1);
+    for (size_t e = 0; e < m; ++e) {
+        adjacency[next[edges[e].first]++] = static_cast<int>(e);
+        adjacency[next[edges[e].second]++] = static_cast<int>(e);
+    }
+
+    source.resize(m);
+    target.resize(m);
+    for (size_t e = 0; e < m; ++e) {
+        source[e] = edges[e].first;
+        target[e] = edges[e].second;
+    }
+    oriented.assign(m, 0);
+    lowpt.assign(m, 0);
+    lowpt2.assign(m, 0);
+    nestingDepth.assign(m, 0);
+    height.assign(n, -1);
+    parentEdge.assign(n, -1);
+    returning.assign(n, 0);
+    std::vector<int> roots;
+    for (size_t v = 0; v < n; ++v) {
+        if (height[v] < 0) {
+            height[v] = 0;
+            roots.push_back(static_cast<int>(v));
+            orient(static_cast<int>(v));
+        }
+    }
+
+    // Outgoing edges of each node by nesting depth (ties in orientation order)
+    outOffsets.assign(n + 1, 0);
+    for (size_t e = 0; e < m; ++e) {
+        ++outOffsets[source[e] + 1];
+    }
+    for (size_t v = 0; v < n; ++v) {
+        outOffsets[v + 1] += outOffsets[v];
+    }
+    outEdges.resize(m);
+    next.assign(outOffsets.begin(), outOffsets.end() - 1);
+    for (size_t e = 0; e < m; ++e) {
+        outEdges[next[source[e]]++] = static_cast<int>(e);
+    }
+    for (size_t v = 0; v < n; ++v) {
+        std::stable_sort(outEdges.begin() + outOffsets[v], outEdges.begin() + outOffsets[v + 1],
+                         [this](int a, int b) { return nestingDepth[a] < nestingDepth[b]; });
+    }
+
+    ref.assign(m, -1);
+    lowptEdge.assign(m, -1);
+    stackBottom.assign(m, 0);
+    returning.assign(n, 0);
+    conflicts.clear();
+    for (int root : roots) {
+        if (!test(root)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Planarity_Tester::orient(int root) {
+    next[root] = offsets[root];
+    dfs.assign(1, root);
+    while (!dfs.empty()) {
+        const int v = dfs.back();
+        const int e = parentEdge[v];
+        bool descended = false;
+        for (; next[v] < offsets[v + 1]; ++next[v]) {
+            const int vw = adjacency[next[v]];
+            if (!returning[v]) {
+                if (oriented[vw]) {
+                    continue;
+                }
+                oriented[vw] = 1;
+                if (source[vw] != v) {
+                    std::swap(source[vw], target[vw]);
+                }
+                const int w = target[vw];
+                lowpt[vw] = lowpt2[vw] = height[v];
+                if (height[w] < 0) { // Tree edge: finish it once w is done
+                    parentEdge[w] = vw;
+                    height[w] = height[v] + 1;
+                    next[w] = offsets[w];
+                    returning[v] = 1;
+                    dfs.push_back(w);
+                    descended = true;
+                    break;
+                }
+                lowpt[vw] = height[w]; // Back edge
+            }
+            returning[v] = 0;
+
+            // Nesting order: by lowpoint, chordal edges after the others
+            nestingDepth[vw] = 2 * lowpt[vw] + (lowpt2[vw] < height[v] ? 1 : 0);
+            if (e >= 0) {
+                if (lowpt[vw] < lowpt[e]) {
+                    lowpt2[e] = std::min(lowpt[e], lowpt2[vw]);
+                    lowpt[e] = lowpt[vw];
+                } else if (lowpt[vw] > lowpt[e]) {
+                    lowpt2[e] = std::min(lowpt2[e], lowpt[vw]);
+                } else {
+                    lowpt2[e] = std::min(lowpt2[e], lowpt2[vw]);
+                }
+            }
+        }
+        if (!descended) {
+            dfs.pop_back();
+        }
+    }
+}
+
+bool Planarity_Tester::test(int root) {
+    next[root] = outOffsets[root];
+    dfs.assign(1, root);
+    while (!dfs.empty()) {
+        const int v = dfs.back();
+        const int e = parentEdge[v];
+        bool descended = false;
+        for (; next[v] < outOffsets[v + 1]; ++next[v]) {
+            const int ei = outEdges[next[v]];
+            if (!returning[v]) {
+                stackBottom[ei] = conflicts.size();
+                const int w = target[ei];
+                if (ei == parentEdge[w]) { // Tree edge: integrate it once w is done
+                    next[w] = outOffsets[w];
+                    returning[v] = 1;
+                    dfs.push_back(w);
+                    descended = true;
+                    break;
+                }
+                lowptEdge[ei] = ei; // Back edge
+                conflicts.push_back({Interval(), Interval{ei, ei}});
+            }
+            returning[v] = 0;
+
+            // Integrate the return edges of ei
+            if (lowpt[ei] < height[v]) {
+                if (next[v] == outOffsets[v]) {
+                    lowptEdge[e] = lowptEdge[ei];
+                } else if (!addConstraints(ei, e)) {
+                    return false;
+                }
+            }
+        }
+        if (!descended) {
+            if (e >= 0) {
+                removeBackEdges(e);
+            }
+            dfs.pop_back();
+        }
+    }
+    return true;
+}
+
+bool Planarity_Tester::addConstraints(int ei, int e) {
+    Conflict_Pair merged;
+
+    // Merge the return edges of ei into the right interval
+    do {
+        Conflict_Pair q = conflicts.back();
+        conflicts.pop_back();
+        if (!q.left.empty()) {
+            std::swap(q.left, q.right);
+        }
+        if (!q.left.empty()) {
+            return false;
+        }
+        if (lowpt[q.right.low] > lowpt[e]) {
+            if (merged.right.empty()) {
+                merged.right = q.right;
+            } else {
+                ref[merged.right.low] = q.right.high;
+            }
+            merged.right.low = q.right.low;
+        } else {
+            ref[q.right.low] = lowptEdge[e];
+        }
+    } while (conflicts.size() != stackBottom[ei]);
+
+    // Merge the conflicting return edges of the earlier siblings into the left interval
+    while (!conflicts.empty() && (conflicting(conflicts.back().left, ei) || conflicting(conflicts.back().right, ei))) {
+        Conflict_Pair q = conflicts.back();
+        conflicts.pop_back();
+        if (conflicting(q.right, ei)) {
+            std::swap(q.left, q.right);
+        }
+        if (conflicting(q.right, ei)) {
+            return false;
+        }
+        if (merged.right.low >= 0) {
+            ref[merged.right.low] = q.right.high;
+        }
+        if (q.right.low >= 0) {
+            merged.right.low = q.right.low;
+        }
+        if (merged.left.empty()) {
+            merged.left = q.left;
+        } else {
+            ref[merged.left.low] = q.left.high;
+        }
+        merged.left.low = q.left.low;
+    }
+
+    if (!merged.left.empty() || !merged.right.empty()) {
+        conflicts.push_back(merged);
+    }
+    return true;
+}
+
+void Planarity_Tester::removeBackEdges(int e) {
+    const int u = source[e];
+
+    // Drop the conflict pairs whose return edges all end at u
+    while (!conflicts.empty() && lowest(conflicts.back()) == height[u]) {
+        conflicts.pop_back();
+    }
+
+    // Trim the back edges ending at u from the topmost remaining pair
+    if (!conflicts.empty()) {
+        Conflict_Pair& p = conflicts.back();
+        while (p.left.high >= 0 && target[p.left.high] == u) {
+            p.left.high = ref[p.left.high];
+        }
+        if (p.left.high < 0 && p.left.low >= 0) {
+            ref[p.left.low] = p.right.low;
+            p.left.low = -1;
+        }
+        while (p.right.high >= 0 && target[p.right.high] == u) {
+            p.right.high = ref[p.right.high];
+        }
+        if (p.right.high < 0 && p.right.low >= 0) {
+            ref[p.right.low] = p.left.low;
+            p.right.low = -1;
+        }
+    }
+
+    // e refers to its highest return edge
+    if (lowpt[e] < height[u] && !conflicts.empty()) {
+        const int highLeft = conflicts.back().left.high;
+        const int highRight = conflicts.back().right.high;
+        ref[e] = highLeft >= 0 && (highRight < 0 || lowpt[highLeft] > lowpt[highRight]) ? highLeft : highRight;
+    }
+}
+
+bool Planarity_Tester::conflicting(const Interval& interval, int edge) const {
+    return !interval.empty() && lowpt[interval.high] > lowpt[edge];
+}
+
+int Planarity_Tester::lowest(const Conflict_Pair& pair) const {
+    if (pair.left.empty()) {
+        return lowpt[pair.right.low];
+    }
+    if (pair.right.empty()) {
+        return lowpt[pair.left.low];
+    }
+    return std::min(lowpt[pair.left.low], lowpt[pair.right.low]);
+}
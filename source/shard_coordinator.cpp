@@ -0,0 +1,300 @@
+#include "shard_coordinator.h"
+#include "network_synthesizer.h"
+#include "uf_ds.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace {
+    // On-disk edge record of a forest file
+    struct ForestRecord {
+        double weight;
+        std::int32_t node1;
+        std::int32_t node2;
+    };
+
+    std::mutex outputMutex; // Serialises relayed worker output
+
+    // Keeps the minimum spanning forest of a set of edges
+    std::vector<Edge> kruskal(std::vector<Edge> edges, int numNodes) {
+        std::sort(edges.begin(), edges.end(), compareByWeight);
+        UF_DS uf(numNodes);
+        std::vector<Edge> forest;
+        for (const auto& edge : edges) {
+            if (uf.find(edge.getNode1()) != uf.find(edge.getNode2())) {
+                uf.unite(edge.getNode1(), edge.getNode2());
+                forest.push_back(edge);
+            }
+        }
+        return forest;
+    }
+
+    std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+        for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size())) {
+            text.replace(pos, from.size(), to);
+        }
+        return text;
+    }
+
+    std::string forestFile(const std::string& directory, int workerId) {
+        return directory + "/forest_" + std::to_string(workerId) + ".bin";
+    }
+}
+
+Shard_Coordinator::Shard_Coordinator(const Shard_Config& config) : config(config) {
+    if (this->config.workers < 1) {
+        this->config.workers = 1;
+    }
+}
+
+std::pair<int, int> Shard_Coordinator::blockRange(int block, int blocks, int numDocuments) {
+    auto bound = [&](int b) {
+        return static_cast<int>(static_cast<long long>(b) * numDocuments / blocks);
+    };
+    return {bound(block), bound(block + 1)};
+}
+
+bool Shard_Coordinator::writeInputs(const std::vector<double>& documents, int numDocuments, int numTopics, int blocks) const {
+    const std::string documentsFile = config.directory + "/documents.bin";
+    std::ofstream docs(documentsFile, std::ios::binary);
+    if (!docs.is_open()) {
+        std::cerr << "Error: Could not open file " << documentsFile << " for writing." << std::endl;
+        return false;
+    }
+    std::int64_t rows = numDocuments;
+    std::int32_t columns = numTopics;
+    docs.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    docs.write(reinterpret_cast<const char*>(&columns), sizeof(columns));
+    docs.write(reinterpret_cast<const char*>(documents.data()),
+               static_cast<std::streamsize>(sizeof(double) * static_cast<size_t>(rows) * static_cast<size_t>(columns)));
+    docs.close();
+
+    // Tiles sorted by pair count, assigned to the least loaded worker
+    const int n = numDocuments;
+    struct Tile {
+        int a, b;
+        double pairs;
+    };
+    std::vector<Tile> tiles;
+    for (int a = 0; a < blocks; ++a) {
+        for (int b = a; b < blocks; ++b) {
+            auto ra = blockRange(a, blocks, n);
+            auto rb = blockRange(b, blocks, n);
+            double rowsA = ra.second - ra.first;
+            double rowsB = rb.second - rb.first;
+            tiles.push_back({a, b, a == b ? rowsA * (rowsA - 1) / 2 : rowsA * rowsB});
+        }
+    }
+    std::stable_sort(tiles.begin(), tiles.end(), [](const Tile& x, const Tile& y) { return x.pairs > y.pairs; });
+
+    std::vector<double> load(config.workers, 0.0);
+    std::vector<std::vector<Tile>> assignment(config.workers);
+    for (const auto& tile : tiles) {
+        size_t w = std::min_element(load.begin(), load.end()) - load.begin();
+        load[w] += tile.pairs;
+        assignment[w].push_back(tile);
+    }
+
+    const std::string manifestFile = config.directory + "/manifest.txt";
+    std::ofstream manifest(manifestFile);
+    if (!manifest.is_open()) {
+        std::cerr << "Error: Could not open file " << manifestFile << " for writing." << std::endl;
+        return false;
+    }
+    manifest << "blocks " << blocks << "\n";
+    for (int w = 0; w < config.workers; ++w) {
+        manifest << "worker " << w;
+        for (const auto& tile : assignment[w]) {
+            manifest << " " << tile.a << "," << tile.b;
+        }
+        manifest << "\n";
+    }
+    return true;
+}
+
+bool Shard_Coordinator::launchWorker(int workerId) const {
+    std::string command = config.launchCommand.empty()
+                              ? "\"{exe}\" --shard-worker \"{dir}\" --shard-id {worker}"
+                              : config.launchCommand;
+    command = replaceAll(command, "{exe}", config.executable);
+    command = replaceAll(command, "{dir}", config.directory);
+    command = replaceAll(command, "{worker}", std::to_string(workerId));
+    command += " 2>&1";
+
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        std::cerr << "Error: Could not launch shard worker " << workerId << std::endl;
+        return false;
+    }
+
+    char line[512];
+    while (std::fgets(line, sizeof(line), pipe)) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << "[shard " << workerId << "] " << line << std::flush;
+    }
+
+    int status = pclose(pipe);
+    if (status != 0) {
+        std::cerr << "Error: Shard worker " << workerId << " failed with status " << status << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Shard_Coordinator::run(const std::vector<double>& documents, int numDocuments, int numTopics, std::vector<Edge>& mst) const {
+    mst.clear();
+    const int n = numDocuments;
+    if (n < 2) {
+        return true;
+    }
+
+    // Enough tiles (B(B+1)/2 of them) for about four per worker
+    int blocks = config.blocks > 0 ? config.blocks
+                                   : static_cast<int>(std::ceil(std::sqrt(8.0 * config.workers)));
+    blocks = std::max(1, std::min(blocks, n));
+
+    std::error_code ec;
+    std::filesystem::create_directories(config.directory, ec);
+    for (int w = 0; w < config.workers; ++w) {
+        std::filesystem::remove(forestFile(config.directory, w), ec);
+    }
+    if (!writeInputs(documents, numDocuments, numTopics, blocks)) {
+        return false;
+    }
+
+    std::cout << "Launching " << config.workers << " shard workers over " << blocks * (blocks + 1) / 2
+              << " tiles...\n";
+    std::vector<char> succeeded(config.workers, 0);
+    std::vector<std::thread> launchers;
+    for (int w = 0; w < config.workers; ++w) {
+        launchers.emplace_back([this, w, &succeeded]() { succeeded[w] = launchWorker(w); });
+    }
+    for (auto& launcher : launchers) {
+        launcher.join();
+    }
+    if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end()) {
+        return false;
+    }
+
+    // Merge the partial forests
+    std::vector<Edge> candidates;
+    for (int w = 0; w < config.workers; ++w) {
+        std::ifstream in(forestFile(config.directory, w), std::ios::binary);
+        std::int64_t count = 0;
+        if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+            std::cerr << "Error: Missing forest of shard worker " << w << std::endl;
+            return false;
+        }
+        std::vector<ForestRecord> records(static_cast<size_t>(count));
+        if (!in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(ForestRecord))) {
+            std::cerr << "Error: Truncated forest of shard worker " << w << std::endl;
+            return false;
+        }
+        for (const auto& record : records) {
+            candidates.emplace_back(record.node1, record.node2, record.weight, 0);
+        }
+    }
+
+    mst = kruskal(std::move(candidates), n);
+    for (size_t id = 0; id < mst.size(); ++id) {
+        mst[id] = Edge(mst[id].getNode1(), mst[id].getNode2(), mst[id].getWeight(), static_cast<int>(id));
+    }
+    std::cout << "Merged shard forests into an MST with " << mst.size() << " edges.\n";
+    return true;
+}
+
+int Shard_Coordinator::runWorker(const std::string& directory, int workerId) {
+    std::ifstream docs(directory + "/documents.bin", std::ios::binary);
+    std::int64_t rows = 0;
+    std::int32_t columns = 0;
+    if (!docs.read(reinterpret_cast<char*>(&rows), sizeof(rows)) || !docs.read(reinterpret_cast<char*>(&columns), sizeof(columns))) {
+        std::cerr << "Error: Could not read " << directory << "/documents.bin" << std::endl;
+        return 1;
+    }
+    if (rows < 0 || columns < 0) {
+        std::cerr << "Error: Invalid document matrix in " << directory << "/documents.bin" << std::endl;
+        return 1;
+    }
+    std::vector<double> documents(static_cast<size_t>(rows) * static_cast<size_t>(columns));
+    docs.read(reinterpret_cast<char*>(documents.data()), static_cast<std::streamsize>(sizeof(double) * documents.size()));
+    if (!docs) {
+        std::cerr << "Error: Truncated document matrix." << std::endl;
+        return 1;
+    }
+
+    std::ifstream manifest(directory + "/manifest.txt");
+    std::string line, keyword;
+    int blocks = 0;
+    std::vector<std::pair<int, int>> tiles;
+    while (std::getline(manifest, line)) {
+        std::istringstream iss(line);
+        iss >> keyword;
+        if (keyword == "blocks") {
+            iss >> blocks;
+        } else if (keyword == "worker") {
+            int id = -1;
+            iss >> id;
+            std::string tile;
+            while (id == workerId && iss >> tile) {
+                size_t comma = tile.find(',');
+                tiles.emplace_back(std::stoi(tile.substr(0, comma)), std::stoi(tile.substr(comma + 1)));
+            }
+        }
+    }
+    if (blocks < 1) {
+        std::cerr << "Error: Invalid shard manifest in " << directory << std::endl;
+        return 1;
+    }
+
+    const int n = static_cast<int>(rows);
+    Network_Synthesizer synthesizer(std::move(documents), n, columns);
+
+    std::vector<Edge> forest;
+    for (const auto& [a, b] : tiles) {
+        auto ra = blockRange(a, blocks, n);
+        auto rb = blockRange(b, blocks, n);
+        std::vector<Edge> tileForest = synthesizer.findTileSpanningForest(ra.first, ra.second, rb.first, rb.second);
+        std::cout << "tile " << a << "," << b << ": " << tileForest.size() << " forest edges" << std::endl;
+
+        // Keep the running forest at most n - 1 edges
+        forest.insert(forest.end(), tileForest.begin(), tileForest.end());
+        forest = kruskal(std::move(forest), n);
+    }
+
+    const std::string finalFile = forestFile(directory, workerId);
+    const std::string partialFile = finalFile + ".part";
+    std::ofstream out(partialFile, std::ios::binary);
+    std::int64_t count = static_cast<std::int64_t>(forest.size());
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& edge : forest) {
+        ForestRecord record{edge.getWeight(), edge.getNode1(), edge.getNode2()};
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Could not write " << partialFile << std::endl;
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(finalFile, ec);
+    std::filesystem::rename(partialFile, finalFile, ec);
+    if (ec) {
+        std::cerr << "Error: Could not publish " << finalFile << ": " << ec.message() << std::endl;
+        return 1;
+    }
+    std::cout << "done: " << forest.size() << " edges" << std::endl;
+    return 0;
+}
@@ -0,0 +1,403 @@
+#include "similarity_server.h"
+#include "graph_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+    constexpr int MAX_RESULTS = 10000; ///< Upper bound on k and on neighbourhood and community sizes.
+
+    json describe(const Statements& statements, int document) {
+        return {{"document", document},
+                {"verdict", statements.getVerdict(document)},
+                {"originator", statements.getOriginator(document)}};
+    }
+
+    Query_Filter parseFilter(const json& request) {
+        Query_Filter filter;
+        if (request.contains("filter")) {
+            const json& criteria = request["filter"];
+            filter.verdicts = criteria.value("verdicts", std::vector<std::string>());
+            filter.originators = criteria.value("originators", std::vector<std::string>());
+            filter.dateFrom = criteria.value("from", "");
+            filter.dateTo = criteria.value("to", "");
+        }
+        return filter;
+    }
+
+    json failure(const std::string& message) {
+        return {{"error", message}};
+    }
+
+#ifndef _WIN32
+    bool sendAll(int socket, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t count = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (count <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        return true;
+    }
+#endif
+}
+
+Similarity_Server::Similarity_Server(const Statements& statements, Network_Synthesizer& networkSynthesizer, Thread_Pool& pool)
+    : statements(statements), networkSynthesizer(networkSynthesizer), pool(pool) {
+    networkSynthesizer.buildQueryIndex(statements);
+
+    // MST adjacency (CSR)
+    const int n = networkSynthesizer.getNumDocuments();
+    const auto& mst = networkSynthesizer.getMST();
+    offsets.assign(n + 1, 0);
+    for (const auto& edge : mst) {
+        ++offsets[edge.getNode1() + 1];
+        ++offsets[edge.getNode2() + 1];
+    }
+    for (int v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    neighbours.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto& edge : mst) {
+        const int a = edge.getNode1();
+        const int b = edge.getNode2();
+        neighbours[fill[a]] = b;
+        weights[fill[a]++] = edge.getWeight();
+        neighbours[fill[b]] = a;
+        weights[fill[b]++] = edge.getWeight();
+    }
+    community.assign(n, -1);
+}
+
+bool Similarity_Server::loadCommunities(const std::string& filename) {
+    std::vector<int> assignment;
+    if (!Graph_Writer::readCommunities(filename, networkSynthesizer.getNumDocuments(), assignment)) {
+        return false;
+    }
+    std::vector<std::vector<int>> groups;
+    for (int node = 0; node < static_cast<int>(assignment.size()); ++node) {
+        if (assignment[node] < 0) {
+            continue;
+        }
+        if (assignment[node] >= static_cast<int>(groups.size())) {
+            groups.resize(assignment[node] + 1);
+        }
+        groups[assignment[node]].push_back(node);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    community.swap(assignment);
+    members.swap(groups);
+    communitiesFile = filename;
+    std::cout << "Communities loaded from " << filename << " (" << members.size() << " communities).\n";
+    return true;
+}
+
+std::vector<Similarity_Server::Tree_Node> Similarity_Server::findNeighbourhood(int document, int depth, int limit) const {
+    std::vector<Tree_Node> nodes;
+    nodes.push_back({document, -1, 0, 0.0});
+
+    // The MST has no cycles, so the parent is the only visited neighbour to skip
+    for (size_t head = 0; head < nodes.size() && static_cast<int>(nodes.size()) < limit; ++head) {
+        const Tree_Node node = nodes[head];
+        if (node.hops >= depth) {
+            break;
+        }
+        for (int slot = offsets[node.document]; slot < offsets[node.document + 1]; ++slot) {
+            if (neighbours[slot] == node.parent) {
+                continue;
+            }
+            if (static_cast<int>(nodes.size()) >= limit) {
+                break;
+            }
+            nodes.push_back({neighbours[slot], node.document, node.hops + 1, weights[slot]});
+        }
+    }
+    return nodes;
+}
+
+std::string Similarity_Server::handleRequest(const std::string& line) {
+    const int n = networkSynthesizer.getNumDocuments();
+
+    auto answer = [&](const json& request) -> json {
+        if (!request.is_object()) {
+            return failure("request must be an object");
+        }
+        const std::string op = request.value("op", "");
+        const int document = request.value("document", -1);
+        const bool needsDocument = op == "neighbourhood" || op == "community" || op == "statement" ||
+                                   (op == "similar" && !request.contains("topics") && !request.contains("documents"));
+        if (needsDocument && (document < 0 || document >= n)) {
+            return failure("document out of range");
+        }
+
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        json response;
+        if (op == "similar") {
+            // Several documents are scored in one pass over the matrix
+            const int k = std::clamp(request.value("k", 10), 0, MAX_RESULTS);
+            std::vector<Similarity_Query> queries(1);
+            if (request.contains("documents")) {
+                const auto documents = request["documents"].get<std::vector<int>>();
+                queries.resize(documents.size());
+                for (size_t q = 0; q < documents.size(); ++q) {
+                    if (documents[q] < 0 || documents[q] >= n) {
+                        return failure("document out of range");
+                    }
+                    queries[q].document = documents[q];
+                }
+            } else if (request.contains("topics")) {
+                queries[0].topics = request["topics"].get<std::vector<double>>();
+                if (static_cast<int>(queries[0].topics.size()) != networkSynthesizer.getNumTopics()) {
+                    return failure("topics must have " + std::to_string(networkSynthesizer.getNumTopics()) + " values");
+                }
+            } else {
+                queries[0].document = document;
+            }
+
+            const bool withText = request.value("text", false);
+            auto toJson = [&](const std::vector<Similar_Document>& nearest) {
+                json results = json::array();
+                for (const auto& match : nearest) {
+                    json result = describe(statements, match.document);
+                    result["distance"] = match.distance;
+                    if (withText) {
+                        result["comment"] = statements.getComment(match.document);
+                    }
+                    results.push_back(std::move(result));
+                }
+                return results;
+            };
+            const auto nearest = networkSynthesizer.findNearestDocuments(queries, k, parseFilter(request));
+            if (request.contains("documents")) {
+                json results = json::array();
+                for (const auto& matches : nearest) {
+                    results.push_back(toJson(matches));
+                }
+                response["results"] = std::move(results);
+            } else {
+                response["results"] = toJson(nearest.front());
+            }
+        } else if (op == "neighbourhood") {
+            const int depth = std::max(0, request.value("depth", 1));
+            const int limit = std::clamp(request.value("limit", 100), 1, MAX_RESULTS);
+            json nodes = json::array();
+            for (const auto& node : findNeighbourhood(document, depth, limit)) {
+                json entry = describe(statements, node.document);
+                entry["hops"] = node.hops;
+                if (node.parent >= 0) {
+                    entry["parent"] = node.parent;
+                    entry["weight"] = node.weight;
+                }
+                nodes.push_back(std::move(entry));
+            }
+            response["nodes"] = std::move(nodes);
+        } else if (op == "community") {
+            if (community[document] < 0) {
+                return failure(communitiesFile.empty() ? "no communities loaded" : "document has no community");
+            }
+            const auto& group = members[community[document]];
+            const int limit = std::clamp(request.value("limit", 100), 0, MAX_RESULTS);
+            response["community"] = community[document];
+            response["size"] = group.size();
+            response["members"] = std::vector<int>(group.begin(), group.begin() + std::min<size_t>(limit, group.size()));
+        } else if (op == "statement") {
+            response = describe(statements, document);
+            response["comment"] = statements.getComment(document);
+            response["source"] = statements.getSource(document);
+            response["factchecker"] = statements.getFactchecker(document);
+            response["factcheck_date"] = statements.getFactcheckDate(document);
+            if (community[document] >= 0) {
+                response["community"] = community[document];
+            }
+        } else if (op == "info") {
+            response["documents"] = n;
+            response["topics"] = networkSynthesizer.getNumTopics();
+            response["mst_edges"] = networkSynthesizer.getMST().size();
+            response["communities"] = members.size();
+            response["threads"] = pool.getNumThreads();
+        } else if (op == "load_communities") {
+            lock.unlock();
+            if (!loadCommunities(request.value("file", ""))) {
+                return failure("could not load communities");
+            }
+            response["ok"] = true;
+        } else if (op == "shutdown") {
+            running = false;
+            response["ok"] = true;
+        } else {
+            return failure("unknown op '" + op + "'");
+        }
+        return response;
+    };
+
+    auto answerSafely = [&](const json& request) -> json {
+        json response;
+        try {
+            response = answer(request);
+        } catch (const json::exception& error) {
+            response = failure(error.what());
+        }
+        if (request.is_object() && request.contains("id")) {
+            response["id"] = request["id"];
+        }
+        return response;
+    };
+
+    json request = json::parse(line, nullptr, false);
+    if (request.is_discarded()) {
+        return failure("malformed JSON").dump();
+    }
+    if (!request.is_object() || !request.contains("batch")) {
+        return answerSafely(request).dump();
+    }
+    if (!request["batch"].is_array()) {
+        return failure("batch must be an array").dump();
+    }
+
+    // The requests of a batch are answered in parallel, each into its own slot
+    const json& batch = request["batch"];
+    std::vector<json> results(batch.size());
+    pool.parallelFor(0, batch.size(), [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            results[i] = answerSafely(batch[i]);
+        }
+    }, 1);
+    json response = {{"results", std::move(results)}};
+    if (request.contains("id")) {
+        response["id"] = request["id"];
+    }
+    return response.dump();
+}
+
+#ifndef _WIN32
+
+bool Similarity_Server::serve(const std::string& socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path " << socketPath << " is too long." << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listener, 64) < 0) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        listener = -1;
+        return false;
+    }
+
+    running = true;
+    std::cout << "Serving " << networkSynthesizer.getNumDocuments() << " statements on " << socketPath << std::endl;
+    while (running) {
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (running && errno != EINTR) {
+                std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            }
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            clients.push_back(client);
+        }
+        std::thread(&Similarity_Server::serveClient, this, client).detach();
+    }
+
+    // Wake the connection threads blocked in recv() and wait for them to finish
+    std::unique_lock<std::mutex> lock(connectionsMutex);
+    for (int client : clients) {
+        ::shutdown(client, SHUT_RDWR);
+    }
+    disconnected.wait(lock, [this]() { return clients.empty(); });
+    lock.unlock();
+
+    ::close(listener);
+    listener = -1;
+    ::unlink(socketPath.c_str());
+    std::cout << "Server stopped." << std::endl;
+    return true;
+}
+
+void Similarity_Server::stop() {
+    running = false;
+    if (listener >= 0) {
+        ::shutdown(listener, SHUT_RDWR);
+    }
+}
+
+void Similarity_Server::serveClient(int client) {
+    std::string pending;
+    std::vector<char> buffer(1 << 16);
+    bool open = true;
+    while (open && running) {
+        const ssize_t count = ::recv(client, buffer.data(), buffer.size(), 0);
+        if (count <= 0) {
+            break;
+        }
+        pending.append(buffer.data(), static_cast<size_t>(count));
+
+        // Answer every complete line received so far
+        size_t start = 0;
+        for (size_t newline; (newline = pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+            const std::string line = pending.substr(start, newline - start);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            if (!sendAll(client, handleRequest(line) + "\n")) {
+                open = false;
+                break;
+            }
+        }
+        pending.erase(0, start);
+    }
+    if (!running) {
+        stop();
+    }
+
+    // Deregistered before closing, so that serve() never shuts down the number once it is reused
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        clients.erase(std::find(clients.begin(), clients.end(), client));
+        disconnected.notify_all();
+    }
+    ::close(client);
+}
+
+#else
+
+bool Similarity_Server::serve(const std::string& socketPath) {
+    std::cerr << "Error: Server mode needs Unix domain sockets, unavailable for " << socketPath << " on this platform." << std::endl;
+    return false;
+}
+
+void Similarity_Server::stop() {
+    running = false;
+}
+
+void Similarity_Server::serveClient(int) {
+}
+
+#endif
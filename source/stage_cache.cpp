@@ -0,0 +1,179 @@
+#include "stage_cache.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t fnv1a(const char* data, size_t size, uint64_t hash) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    std::string toHex(uint64_t hash) {
+        std::ostringstream out;
+        out << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return out.str();
+    }
+}
+
+// --- Fingerprint ---
+
+Fingerprint& Fingerprint::add(const std::string& name, const std::string& value) {
+    parameters.emplace_back(name, value);
+    return *this;
+}
+
+Fingerprint& Fingerprint::add(const std::string& name, double value) {
+    std::ostringstream out;
+    out << std::setprecision(17) << value;
+    return add(name, out.str());
+}
+
+std::string Fingerprint::value() const {
+    uint64_t hash = FNV_OFFSET;
+    for (const auto& [name, value] : parameters) {
+        hash = fnv1a(name.c_str(), name.size() + 1, hash);
+        hash = fnv1a(value.c_str(), value.size() + 1, hash);
+    }
+    return toHex(hash);
+}
+
+const std::vector<std::pair<std::string, std::string>>& Fingerprint::getParameters() const {
+    return parameters;
+}
+
+// --- Stage_Cache ---
+
+Stage_Cache::Stage_Cache(const std::string& directory, bool enabled) : directory(directory), enabled(enabled) {
+}
+
+bool Stage_Cache::isValid(const std::string& stage, const Fingerprint& fingerprint) const {
+    if (!enabled) {
+        return false;
+    }
+    std::ifstream manifest(manifestPath(stage));
+    if (!manifest.is_open()) {
+        return false;
+    }
+
+    std::string storedFingerprint;
+    std::map<std::string, std::string> storedParameters;
+    std::vector<std::pair<uintmax_t, std::pair<std::string, std::string>>> outputs;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "fingerprint") {
+            fields >> storedFingerprint;
+        } else if (kind == "param") {
+            std::string name, value;
+            fields >> name;
+            fields.get();
+            std::getline(fields, value);
+            storedParameters[name] = value;
+        } else if (kind == "output") {
+            uintmax_t size = 0;
+            std::string hash, path;
+            fields >> size >> hash;
+            fields.get();
+            std::getline(fields, path);
+            outputs.push_back({size, {hash, path}});
+        }
+    }
+
+    if (storedFingerprint != fingerprint.value()) {
+        for (const auto& [name, value] : fingerprint.getParameters()) {
+            auto it = storedParameters.find(name);
+            if (it == storedParameters.end() || it->second != value) {
+                std::cout << "Cache: " << stage << " is stale (" << name << " changed).\n";
+                return false;
+            }
+        }
+        std::cout << "Cache: " << stage << " is stale.\n";
+        return false;
+    }
+
+    for (const auto& [size, output] : outputs) {
+        const auto& [hash, path] = output;
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) != size || error || hashFile(path) != hash) {
+            std::cout << "Cache: " << stage << " is stale (" << path << " is missing or modified).\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Stage_Cache::record(const std::string& stage, const Fingerprint& fingerprint, const std::vector<std::string>& outputs) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Written aside and renamed, so an interrupted run never leaves a manifest for partial outputs
+    const std::string path = manifestPath(stage);
+    const std::string partial = path + ".part";
+    {
+        std::ofstream manifest(partial);
+        if (!manifest.is_open()) {
+            std::cerr << "Error: Could not open file " << partial << " for writing." << std::endl;
+            return false;
+        }
+        manifest << "stage " << stage << "\n";
+        manifest << "fingerprint " << fingerprint.value() << "\n";
+        for (const auto& [name, value] : fingerprint.getParameters()) {
+            manifest << "param " << name << " " << value << "\n";
+        }
+        for (const auto& output : outputs) {
+            const uintmax_t size = std::filesystem::file_size(output, error);
+            if (error) {
+                std::cerr << "Error: Stage " << stage << " did not produce " << output << "." << std::endl;
+                manifest.close();
+                std::filesystem::remove(partial, error);
+                return false;
+            }
+            manifest << "output " << size << " " << hashFile(output) << " " << output << "\n";
+        }
+    }
+    std::filesystem::rename(partial, path, error);
+    return !error;
+}
+
+void Stage_Cache::invalidate(const std::string& stage) const {
+    std::error_code error;
+    std::filesystem::remove(manifestPath(stage), error);
+}
+
+const std::string& Stage_Cache::getDirectory() const {
+    return directory;
+}
+
+std::string Stage_Cache::hashFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return "";
+    }
+    std::vector<char> buffer(size_t(1) << 20);
+    uint64_t hash = FNV_OFFSET;
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+    return toHex(hash);
+}
+
+std::string Stage_Cache::hashString(const std::string& data) {
+    return toHex(fnv1a(data.data(), data.size(), FNV_OFFSET));
+}
+
+std::string Stage_Cache::manifestPath(const std::string& stage) const {
+    return directory + "/" + stage + ".manifest";
+}
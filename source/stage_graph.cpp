@@ -0,0 +1,78 @@
+#include "stage_graph.h"
+#include <exception>
+#include <iostream>
+
+int Stage_Graph::addStage(const std::string& name, Stage_Function body, const std::vector<int>& dependencies) {
+    const int id = static_cast<int>(stages.size());
+    Stage stage;
+    stage.name = name;
+    stage.body = std::move(body);
+    stage.numDependencies = dependencies.size();
+    stages.push_back(std::move(stage));
+    for (int dependency : dependencies) {
+        stages[dependency].dependents.push_back(id);
+    }
+    return id;
+}
+
+bool Stage_Graph::run(Thread_Pool& pool) {
+    std::vector<int> roots;
+    for (size_t id = 0; id < stages.size(); ++id) {
+        stages[id].remaining = stages[id].numDependencies;
+        stages[id].blocked = false;
+        stages[id].state = State::PENDING;
+        if (stages[id].remaining == 0) {
+            roots.push_back(static_cast<int>(id));
+        }
+    }
+
+    Task_Group group(pool);
+    for (int id : roots) {
+        group.run([this, id, &group]() { runStage(id, group); });
+    }
+    group.wait();
+
+    bool ok = true;
+    for (const auto& stage : stages) {
+        if (stage.state == State::SKIPPED) {
+            std::cerr << "Error: Stage " << stage.name << " skipped because a dependency failed." << std::endl;
+        }
+        ok = ok && stage.state == State::SUCCEEDED;
+    }
+    return ok;
+}
+
+void Stage_Graph::runStage(int id, Task_Group& group) {
+    bool ok = false;
+    try {
+        ok = stages[id].body();
+    } catch (const std::exception& error) {
+        std::cerr << "Error: Stage " << stages[id].name << " failed: " << error.what() << std::endl;
+    }
+    if (!ok) {
+        std::cerr << "Error: Stage " << stages[id].name << " failed." << std::endl;
+    }
+    finishStage(id, ok ? State::SUCCEEDED : State::FAILED, group);
+}
+
+void Stage_Graph::finishStage(int id, State state, Task_Group& group) {
+    std::vector<int> ready, skipped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stages[id].state = state;
+        for (int dependent : stages[id].dependents) {
+            Stage& stage = stages[dependent];
+            stage.blocked = stage.blocked || state != State::SUCCEEDED;
+            if (--stage.remaining == 0) {
+                (stage.blocked ? skipped : ready).push_back(dependent);
+            }
+        }
+    }
+
+    for (int dependent : ready) {
+        group.run([this, dependent, &group]() { runStage(dependent, group); });
+    }
+    for (int dependent : skipped) {
+        finishStage(dependent, State::SKIPPED, group);
+    }
+}
@@ -19,6 +19,9 @@ Statement::Statement(std::string comment, Verdict verdict, std::string date, std
     : comment(std::move(comment)), verdict(verdict), originator(std::move(originator)), source(std::move(source)), factchecker(std::move(factchecker)), factcheckDate(std::move(factcheckDate)), id(0) {
     // Initialize `std::tm` structures to zero
     this->date = {};
+    if (date.empty()) {
+        return; // Unknown date, e.g. a group without dated statements
+    }
     std::istringstream dateStream(date);
     dateStream >> std::get_time(&this->date, "%m/%d/%Y");
 
@@ -27,11 +30,26 @@ Statement::Statement(std::string comment, Verdict verdict, std::string date, std
     }
 }
 
+/**
+ * @brief Converts a verdict to its PolitiFact name.
+ */
+const char* verdictToString(Verdict verdict) {
+    switch (verdict) {
+        case Verdict::TRUE: return "true";
+        case Verdict::MOSTLY_TRUE: return "mostly-true";
+        case Verdict::HALF_TRUE: return "half-true";
+        case Verdict::MOSTLY_FALSE: return "mostly-false";
+        case Verdict::FALSE: return "false";
+        case Verdict::PANTS_FIRE: return "pants-fire";
+        default: return "unknown";
+    }
+}
+
 /**
  * @brief Retrieves the comment of the statement.
  * @return The comment as a string.
  */
-std::string Statement::getComment() const {
+const std::string& Statement::getComment() const {
     return comment;
 }
 
@@ -55,7 +73,7 @@ std::tm Statement::getDate() const {
  * @brief Retrieves the originator of the statement.
  * @return The originator as a string.
  */
-std::string Statement::getOriginator() const {
+const std::string& Statement::getOriginator() const {
     return originator;
 }
 
@@ -63,7 +81,7 @@ std::string Statement::getOriginator() const {
  * @brief Retrieves the source of the statement.
  * @return The source as a string.
  */
-std::string Statement::getSource() const {
+const std::string& Statement::getSource() const {
     return source;
 }
 
@@ -71,7 +89,7 @@ std::string Statement::getSource() const {
  * @brief Retrieves the name of the factchecker.
  * @return The factchecker name as a string.
  */
-std::string Statement::getFactchecker() const {
+const std::string& Statement::getFactchecker() const {
     return factchecker;
 }
 
@@ -79,6 +97,6 @@ std::string Statement::getFactchecker() const {
  * @brief Retrieves the fact-checking date of the statement.
  * @return The fact-checking date as a string.
  */
-std::string Statement::getFactcheckDate() const {
+const std::string& Statement::getFactcheckDate() const {
     return factcheckDate;
 }
@@ -32,6 +32,14 @@ void Statements::addTopics(int id, const std::vector<double>& topics) {
     }
 }
 
+/**
+ * @brief Looks up a statement by ID.
+ */
+const Statement* Statements::findStatement(int id) const {
+    auto it = entries.find(id);
+    return it != entries.end() ? &it->second : nullptr;
+}
+
 /**
  * @brief Retrieves the comment of a statement by ID.
  */
@@ -45,18 +53,7 @@ std::string Statements::getComment(int id) const {
  */
 std::string Statements::getVerdict(int id) const {
     auto it = entries.find(id);
-    if (it != entries.end()) {
-        switch (it->second.getVerdict()) {
-            case Verdict::TRUE: return "true";
-            case Verdict::MOSTLY_TRUE: return "mostly-true";
-            case Verdict::HALF_TRUE: return "half-true";
-            case Verdict::MOSTLY_FALSE: return "mostly-false";
-            case Verdict::FALSE: return "false";
-            case Verdict::PANTS_FIRE: return "pants-fire";
-            default: return "unknown";
-        }
-    }
-    return "unknown";
+    return it != entries.end() ? verdictToString(it->second.getVerdict()) : "unknown";
 }
 
 /**
@@ -75,6 +72,14 @@ std::string Statements::getOriginator(int id) const {
     return it != entries.end() ? it->second.getOriginator() : "";
 }
 
+/**
+ * @brief Retrieves the date of a statement by ID.
+ */
+std::tm Statements::getDate(int id) const {
+    auto it = entries.find(id);
+    return it != entries.end() ? it->second.getDate() : std::tm{};
+}
+
 /**
  * @brief Retrieves the source of a statement by ID.
  */
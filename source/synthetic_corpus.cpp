@@ -0,0 +1,326 @@
+#include "synthetic_corpus.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    // Streams of independent random sequences derived from the seed
+    constexpr uint64_t DOCUMENT_STREAM = 0;
+    constexpr uint64_t TOPIC_STREAM = 1;
+    constexpr uint64_t TEXT_STREAM = 2;
+
+    const char* const VERDICTS[] = {"true", "mostly-true", "half-true", "mostly-false", "false", "pants-fire"};
+    const double VERDICT_WEIGHTS[] = {0.10, 0.15, 0.17, 0.18, 0.28, 0.12};
+    const char* const SOURCES[] = {"speech", "television", "news", "social_media", "blog", "statement", "advertisement", "other"};
+
+    // Draws a Dirichlet(concentration) vector, normalised; a vector that underflows to zero gets one spike
+    void drawDirichlet(std::mt19937_64& rng, double concentration, std::vector<double>& out) {
+        std::gamma_distribution<double> gamma(concentration, 1.0);
+        double sum = 0.0;
+        for (double& value : out) {
+            value = gamma(rng);
+            sum += value;
+        }
+        if (sum > 0.0) {
+            for (double& value : out) {
+                value /= sum;
+            }
+        } else {
+            std::fill(out.begin(), out.end(), 0.0);
+            out[std::uniform_int_distribution<size_t>(0, out.size() - 1)(rng)] = 1.0;
+        }
+    }
+
+    // Index of the first cumulative weight above u * total
+    size_t sampleCumulative(const std::vector<double>& cumulative, double u) {
+        auto it = std::upper_bound(cumulative.begin(), cumulative.end(), u * cumulative.back());
+        return std::min(static_cast<size_t>(it - cumulative.begin()), cumulative.size() - 1);
+    }
+
+    // "m/d/yyyy" of a day counted from 1970-01-01
+    std::string formatDate(long days) {
+        days += 719468;
+        const long era = (days >= 0 ? days : days - 146096) / 146097;
+        const long dayOfEra = days - era * 146097;
+        const long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const long shiftedMonth = (5 * dayOfYear + 2) / 153;
+        const long day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+        const long month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+        const long year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+        return std::to_string(month) + "/" + std::to_string(day) + "/" + std::to_string(year);
+    }
+}
+
+Synthetic_Corpus::Synthetic_Corpus(const Synthetic_Config& config, Thread_Pool& pool) : config(config), pool(pool) {
+    const int numTopics = std::max(1, config.numTopics);
+    const int vocabularySize = std::max(1, config.vocabularySize);
+    this->config.numTopics = numTopics;
+    this->config.vocabularySize = vocabularySize;
+
+    documents.assign(std::max(0, config.numDocuments), std::vector<double>(numTopics));
+    pool.parallelFor(0, documents.size(), [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            std::mt19937_64 rng(streamSeed(DOCUMENT_STREAM, i));
+            drawDirichlet(rng, config.alpha, documents[i]);
+        }
+    });
+
+    topicWords.assign(numTopics, std::vector<int>(vocabularySize));
+    topicProbs.assign(numTopics, std::vector<double>(vocabularySize));
+    pool.parallelFor(0, static_cast<size_t>(numTopics), [&](size_t start, size_t end) {
+        std::vector<double> probs(vocabularySize);
+        for (size_t t = start; t < end; ++t) {
+            std::mt19937_64 rng(streamSeed(TOPIC_STREAM, t));
+            drawDirichlet(rng, config.beta, probs);
+
+            std::vector<int>& words = topicWords[t];
+            std::iota(words.begin(), words.end(), 0);
+            std::sort(words.begin(), words.end(), [&probs](int a, int b) {
+                return probs[a] != probs[b] ? probs[a] > probs[b] : a < b;
+            });
+            for (int rank = 0; rank < vocabularySize; ++rank) {
+                topicProbs[t][rank] = probs[words[rank]];
+            }
+        }
+    }, 1);
+}
+
+const Synthetic_Config& Synthetic_Corpus::getConfig() const {
+    return config;
+}
+
+const std::vector<std::vector<double>>& Synthetic_Corpus::getDocuments() const {
+    return documents;
+}
+
+std::vector<double> Synthetic_Corpus::getWordTopicProbabilities(size_t numWords) const {
+    std::vector<double> probabilities(config.numTopics * numWords, 0.0);
+    for (int t = 0; t < config.numTopics; ++t) {
+        for (size_t rank = 0; rank < numWords && rank < topicProbs[t].size(); ++rank) {
+            probabilities[t * numWords + rank] = topicProbs[t][rank];
+        }
+    }
+    return probabilities;
+}
+
+void Synthetic_Corpus::fillStatements(Statements& statements) const {
+    const std::vector<Record> records = generateRecords();
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        const int id = static_cast<int>(i);
+        statements.addStatement(id, r.comment, r.verdict, r.date, r.originator, r.source, r.factchecker, r.factcheckDate);
+        statements.addTopics(id, documents[i]);
+    }
+}
+
+bool Synthetic_Corpus::writeJson(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+
+    // Streamed record by record; strings go through the JSON encoder for escaping
+    auto quote = [](const std::string& value) { return json(value).dump(); };
+    const std::vector<Record> records = generateRecords();
+    file << "{\n  \"statements\": [";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        file << (i == 0 ? "\n" : ",\n") << "    {"
+             << "\"verdict\": " << quote(r.verdict)
+             << ", \"statement_originator\": " << quote(r.originator)
+             << ", \"statement\": " << quote(r.comment)
+             << ", \"statement_date\": " << quote(r.date)
+             << ", \"statement_source\": " << quote(r.source)
+             << ", \"factchecker\": " << quote(r.factchecker)
+             << ", \"factcheck_date\": " << quote(r.factcheckDate)
+             << ", \"factcheck_analysis_link\": " << quote("https://example.org/factchecks/" + std::to_string(i))
+             << "}";
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+}
+
+std::vector<Synthetic_Corpus::Record> Synthetic_Corpus::generateRecords() const {
+    const size_t numDocuments = documents.size();
+
+    // Statement text follows the generative process of LDA: a topic per word, then a word of that topic
+    std::vector<std::vector<double>> wordCumulative(config.numTopics);
+    for (int t = 0; t < config.numTopics; ++t) {
+        wordCumulative[t].resize(topicProbs[t].size());
+        std::partial_sum(topicProbs[t].begin(), topicProbs[t].end(), wordCumulative[t].begin());
+    }
+
+    const long firstDay = 13514;                 // 1/1/2007
+    const long lastDay = 19722;                  // 12/31/2023
+    const int numOriginators = std::max(1, static_cast<int>(numDocuments / 20));
+    const int numFactcheckers = std::max(1, std::min(200, static_cast<int>(numDocuments / 500) + 10));
+
+    std::vector<Record> records(numDocuments);
+    pool.parallelFor(0, numDocuments, [&](size_t start, size_t end) {
+        std::vector<double> topicCumulative(config.numTopics);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::discrete_distribution<int> verdict(std::begin(VERDICT_WEIGHTS), std::end(VERDICT_WEIGHTS));
+        for (size_t i = start; i < end; ++i) {
+            std::mt19937_64 rng(streamSeed(TEXT_STREAM, i));
+            std::partial_sum(documents[i].begin(), documents[i].end(), topicCumulative.begin());
+            Record& record = records[i];
+
+            for (int w = 0; w < config.wordsPerDocument; ++w) {
+                const size_t topic = sampleCumulative(topicCumulative, unit(rng));
+                const size_t rank = sampleCumulative(wordCumulative[topic], unit(rng));
+                if (w > 0) {
+                    record.comment += ' ';
+                }
+                record.comment += word(topicWords[topic][rank]);
+            }
+
+            // Speakers are heavy-tailed: a few originators make most statements
+            record.verdict = VERDICTS[verdict(rng)];
+            record.originator = "Originator " + std::to_string(static_cast<int>(std::pow(unit(rng), 3.0) * numOriginators));
+            record.source = SOURCES[static_cast<size_t>(unit(rng) * std::size(SOURCES)) % std::size(SOURCES)];
+            record.factchecker = "Factchecker " + std::to_string(static_cast<int>(unit(rng) * numFactcheckers) % numFactcheckers);
+            const long day = firstDay + static_cast<long>(unit(rng) * (lastDay - firstDay));
+            record.date = formatDate(day);
+            record.factcheckDate = formatDate(day + 1 + static_cast<long>(unit(rng) * 14));
+        }
+    });
+    return records;
+}
+
+bool Synthetic_Corpus::writeComposition(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+
+    // Same layout as Mallet's --output-doc-topics: id, source label, one proportion per topic
+    file.precision(6);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        file << i << "\tdoc" << i;
+        for (double p : documents[i]) {
+            file << '\t' << p;
+        }
+        file << '\n';
+    }
+    return file.good();
+}
+
+bool Synthetic_Corpus::writeDiagnostics(const std::string& filename, size_t numWords) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+
+    const int numTopics = config.numTopics;
+    const size_t numDocuments = documents.size();
+    numWords = std::min(numWords, static_cast<size_t>(config.vocabularySize));
+
+    // Per-topic document statistics
+    std::vector<double> tokens(numTopics, 0.0), entropy(numTopics, 0.0);
+    std::vector<int> rankOneDocs(numTopics, 0), allocated(numTopics, 0);
+    for (size_t i = 0; i < numDocuments; ++i) {
+        const auto& row = documents[i];
+        const int top = static_cast<int>(std::max_element(row.begin(), row.end()) - row.begin());
+        ++rankOneDocs[top];
+        for (int t = 0; t < numTopics; ++t) {
+            tokens[t] += row[t] * config.wordsPerDocument;
+            allocated[t] += row[t] * config.wordsPerDocument >= 1.0 ? 1 : 0;
+        }
+    }
+    for (size_t i = 0; i < numDocuments; ++i) {
+        for (int t = 0; t < numTopics; ++t) {
+            const double share = tokens[t] > 0 ? documents[i][t] * config.wordsPerDocument / tokens[t] : 0.0;
+            if (share > 0) {
+                entropy[t] -= share * std::log(share);
+            }
+        }
+    }
+
+    // Corpus-wide word distribution and the total weight of each word over topics
+    std::vector<double> corpus(config.vocabularySize, 0.0), wordMass(config.vocabularySize, 0.0);
+    const double totalTokens = std::accumulate(tokens.begin(), tokens.end(), 0.0);
+    for (int t = 0; t < numTopics; ++t) {
+        for (size_t rank = 0; rank < topicProbs[t].size(); ++rank) {
+            const int w = topicWords[t][rank];
+            corpus[w] += totalTokens > 0 ? tokens[t] / totalTokens * topicProbs[t][rank] : 0.0;
+            wordMass[w] += topicProbs[t][rank];
+        }
+    }
+
+    file.precision(6);
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<model>\n";
+    for (int t = 0; t < numTopics; ++t) {
+        const auto& probs = topicProbs[t];
+        double sumSquares = 0.0, uniformDist = 0.0, corpusDist = 0.0, wordLength = 0.0, exclusivity = 0.0;
+        for (size_t rank = 0; rank < probs.size(); ++rank) {
+            const double p = probs[rank];
+            const int w = topicWords[t][rank];
+            sumSquares += p * p;
+            if (p > 0) {
+                uniformDist += p * std::log(p * config.vocabularySize);
+                corpusDist += corpus[w] > 0 ? p * std::log(p / corpus[w]) : 0.0;
+            }
+        }
+        for (size_t rank = 0; rank < numWords; ++rank) {
+            const int w = topicWords[t][rank];
+            wordLength += word(w).size();
+            exclusivity += wordMass[w] > 0 ? probs[rank] / wordMass[w] : 0.0;
+        }
+        if (numWords > 0) {
+            wordLength /= numWords;
+            exclusivity /= numWords;
+        }
+
+        // Coherence and token-doc-diff need word co-occurrences and are not simulated
+        file << "<topic id=\"" << t << "\" tokens=\"" << tokens[t] << "\" document_entropy=\"" << entropy[t]
+             << "\" word-length=\"" << wordLength << "\" coherence=\"0\" uniform_dist=\"" << uniformDist
+             << "\" corpus_dist=\"" << corpusDist << "\" eff_num_words=\"" << (sumSquares > 0 ? 1.0 / sumSquares : 0.0)
+             << "\" token-doc-diff=\"0\" rank_1_docs=\"" << (numDocuments ? double(rankOneDocs[t]) / numDocuments : 0.0)
+             << "\" allocation_ratio=\"" << (numDocuments ? double(allocated[t]) / numDocuments : 0.0)
+             << "\" allocation_count=\"" << allocated[t] << "\" exclusivity=\"" << exclusivity << "\">\n";
+
+        double cumulative = 0.0;
+        for (size_t rank = 0; rank < numWords; ++rank) {
+            cumulative += probs[rank];
+            file << "<word rank=\"" << rank + 1 << "\" count=\"" << std::lround(probs[rank] * tokens[t])
+                 << "\" prob=\"" << probs[rank] << "\" cumulative=\"" << cumulative << "\">" << word(topicWords[t][rank])
+                 << "</word>\n";
+        }
+        file << "</topic>\n";
+    }
+    file << "</model>\n";
+    return file.good();
+}
+
+uint64_t Synthetic_Corpus::streamSeed(uint64_t stream, uint64_t index) const {
+    // SplitMix64 finaliser over (seed, stream, index)
+    uint64_t z = config.seed + 0x9E3779B97F4A7C15ULL * (stream * 0x100000001B3ULL + index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+std::string Synthetic_Corpus::word(int id) {
+    // Pronounceable, distinct spellings: base-20 digits over consonant-vowel syllables, at least
+    // two syllables so no word collides with a stop word
+    static const char* const syllables[] = {"ba", "de", "fi", "go", "ku", "la", "me", "ni", "po", "ru",
+                                            "sa", "te", "vi", "wo", "zu", "ka", "le", "mi", "no", "pu"};
+    std::string spelling;
+    id += 20;
+    do {
+        spelling += syllables[id % 20];
+        id /= 20;
+    } while (id > 0);
+    return spelling;
+}
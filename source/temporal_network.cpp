@@ -0,0 +1,344 @@
+#include "temporal_network.h"
+#include "instrumentation.h"
+#include "tree_analytics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <fmt/format.h>
+
+namespace {
+
+// Days since 1970-01-01 of a proleptic Gregorian date, and back (Hinnant's algorithms)
+int daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void civilFromDays(int days, int& year, int& month, int& day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const int dayOfEra = days - era * 146097;
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int shifted = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+    month = shifted < 10 ? shifted + 3 : shifted - 9;
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+}
+
+Temporal_Network::Temporal_Network(const Statements& statements, int numTopics, Thread_Pool& pool)
+    : numTopics(numTopics), pool(pool) {
+    std::vector<int> dated;
+    std::vector<int> dayOf(std::max(0, statements.getSize()));
+    for (int i = 0; i < statements.getSize(); ++i) {
+        const Statement* statement = statements.findStatement(i);
+        if (!statement) {
+            continue;
+        }
+        const std::tm date = statement->getDate();
+        if (date.tm_mday == 0) { // Left zeroed when the date could not be parsed
+            continue;
+        }
+        dayOf[i] = daysFromCivil(date.tm_year + 1900, date.tm_mon + 1, date.tm_mday);
+        dated.push_back(i);
+    }
+    std::stable_sort(dated.begin(), dated.end(), [&](int a, int b) { return dayOf[a] < dayOf[b]; });
+
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    order = dated;
+    rows.assign(order.size() * rowSize, 0.0);
+    days.resize(order.size());
+    verdicts.resize(order.size());
+    for (size_t r = 0; r < order.size(); ++r) {
+        const Statement* statement = statements.findStatement(order[r]);
+        days[r] = dayOf[order[r]];
+        verdicts[r] = static_cast<int>(statement->getVerdict());
+        const std::vector<double> topics = statements.getTopics(order[r]);
+        double sum = 0.0;
+        for (size_t t = 0; t < rowSize && t < topics.size(); ++t) {
+            sum += topics[t] * topics[t];
+        }
+        if (sum > 0) {
+            const double scale = 1.0 / std::sqrt(sum);
+            for (size_t t = 0; t < rowSize && t < topics.size(); ++t) {
+                rows[r * rowSize + t] = topics[t] * scale;
+            }
+        }
+    }
+}
+
+double Temporal_Network::distance(size_t a, size_t b) const {
+    const size_t rowSize = static_cast<size_t>(numTopics);
+    const double* x = rows.data() + a * rowSize;
+    const double* y = rows.data() + b * rowSize;
+    double dot = 0.0;
+    for (size_t t = 0; t < rowSize; ++t) {
+        dot += x[t] * y[t];
+    }
+    return 1.0 - dot;
+}
+
+template <typename Distance>
+void Temporal_Network::buildWindow(Temporal_Window& window, size_t begin, size_t end, Distance&& distanceOf) const {
+    const size_t size = end - begin;
+    window.documents.assign(order.begin() + begin, order.begin() + end);
+    window.verdictAssortativity = std::numeric_limits<double>::quiet_NaN();
+    if (size < 2) {
+        return;
+    }
+
+    // Dense Prim: the window is a complete graph. Candidates carry document IDs and are compared
+    // with compareByWeight(), so ties resolve as in the pipeline's MST
+    std::vector<Edge> best(size, Edge(0, 0, std::numeric_limits<double>::infinity(), 0));
+    std::vector<int> parent(size, -1);
+    std::vector<char> inTree(size, 0);
+    std::vector<Edge> local;
+    local.reserve(size - 1);
+    size_t current = 0;
+    inTree[0] = 1;
+    for (size_t step = 1; step < size; ++step) {
+        size_t next = size;
+        const int a = order[begin + current];
+        for (size_t v = 0; v < size; ++v) {
+            if (inTree[v]) {
+                continue;
+            }
+            const int b = order[begin + v];
+            const Edge candidate(std::min(a, b), std::max(a, b), distanceOf(current, v), 0);
+            if (compareByWeight(candidate, best[v])) {
+                best[v] = candidate;
+                parent[v] = static_cast<int>(current);
+            }
+            if (next == size || compareByWeight(best[v], best[next])) {
+                next = v;
+            }
+        }
+        inTree[next] = 1;
+        local.emplace_back(parent[next], static_cast<int>(next), best[next].getWeight(), static_cast<int>(local.size()));
+        current = next;
+    }
+
+    window.mst.clear();
+    window.mst.reserve(local.size());
+    for (const auto& edge : local) {
+        const int a = order[begin + edge.getNode1()];
+        const int b = order[begin + edge.getNode2()];
+        window.mst.emplace_back(std::min(a, b), std::max(a, b), edge.getWeight(), 0);
+        window.mstWeight += edge.getWeight();
+        window.maxEdge = std::max(window.maxEdge, edge.getWeight());
+    }
+    std::sort(window.mst.begin(), window.mst.end(), compareByWeight);
+    for (size_t i = 0; i < window.mst.size(); ++i) {
+        const Edge& edge = window.mst[i];
+        window.mst[i] = Edge(edge.getNode1(), edge.getNode2(), edge.getWeight(), static_cast<int>(i));
+    }
+
+    const Tree_Analytics analytics(static_cast<int>(size), local);
+    int first = -1, second = -1;
+    window.diameter = analytics.diameter(first, second);
+    window.verdictAssortativity = analytics.assortativity(
+        std::vector<int>(verdicts.begin() + begin, verdicts.begin() + end));
+}
+
+std::vector<Temporal_Window> Temporal_Network::run(const Temporal_Config& config) {
+    Scoped_Timer timer("temporal_windows");
+    computedPairs = 0;
+    reusedPairs = 0;
+    const size_t n = order.size();
+    if (n == 0 || config.width < 1 || config.stride < 1) {
+        return {};
+    }
+
+    auto unitOf = [&](int day) {
+        if (config.unit == Time_Unit::DAY) {
+            return static_cast<long long>(day);
+        }
+        int year, month, dayOfMonth;
+        civilFromDays(day, year, month, dayOfMonth);
+        return static_cast<long long>(year) * 12 + (month - 1);
+    };
+    auto dateOf = [&](long long unit) {
+        int year, month, day = 1;
+        if (config.unit == Time_Unit::DAY) {
+            civilFromDays(static_cast<int>(unit), year, month, day);
+        } else {
+            const long long y = unit >= 0 ? unit / 12 : (unit - 11) / 12;
+            year = static_cast<int>(y);
+            month = static_cast<int>(unit - y * 12) + 1;
+        }
+        return fmt::format("{:04}-{:02}-{:02}", year, month, day);
+    };
+
+    // Each window is the range of rows whose unit falls in [start, start + width)
+    std::vector<long long> units(n);
+    for (size_t r = 0; r < n; ++r) {
+        units[r] = unitOf(days[r]);
+    }
+    const long long first = units.front();
+    const size_t numWindows = static_cast<size_t>((units.back() - first) / config.stride) + 1;
+    std::vector<Temporal_Window> windows(numWindows);
+    std::vector<std::pair<size_t, size_t>> ranges(numWindows);
+    size_t widest = 0;
+    for (size_t k = 0; k < numWindows; ++k) {
+        const long long start = first + static_cast<long long>(k) * config.stride;
+        const long long end = start + config.width;
+        ranges[k].first = static_cast<size_t>(std::lower_bound(units.begin(), units.end(), start) - units.begin());
+        ranges[k].second = static_cast<size_t>(std::lower_bound(units.begin(), units.end(), end) - units.begin());
+        windows[k].start = dateOf(start);
+        windows[k].end = dateOf(end);
+        widest = std::max(widest, ranges[k].second - ranges[k].first);
+        const size_t overlap = k == 0 ? 0 : static_cast<size_t>(std::max<long long>(0,
+            static_cast<long long>(std::min(ranges[k].second, ranges[k - 1].second)) -
+            static_cast<long long>(std::max(ranges[k].first, ranges[k - 1].first))));
+        windows[k].newDocuments = static_cast<int>(ranges[k].second - ranges[k].first - overlap);
+    }
+
+    // Runs of consecutive windows in parallel, as many as the budget allows for the widest matrix
+    const size_t widestBytes = std::max<size_t>(1, widest * widest * sizeof(double));
+    const size_t numRuns = std::max<size_t>(1, std::min({numWindows, static_cast<size_t>(pool.getNumThreads()),
+                                                          config.memoryBudgetBytes / widestBytes}));
+    const size_t runBytes = config.memoryBudgetBytes / numRuns;
+    std::vector<size_t> computed(numRuns, 0), reused(numRuns, 0);
+    pool.parallelFor(0, numRuns, [&](size_t runBegin, size_t runEnd) {
+        for (size_t run = runBegin; run < runEnd; ++run) {
+            const size_t windowBegin = run * numWindows / numRuns;
+            const size_t windowEnd = (run + 1) * numWindows / numRuns;
+            auto fits = [&](size_t size) { return size * size * sizeof(double) <= runBytes; };
+
+            // Row r of the current window has slot r % capacity, unique within any window
+            size_t capacity = 0;
+            for (size_t k = windowBegin; k < windowEnd; ++k) {
+                const size_t size = ranges[k].second - ranges[k].first;
+                if (fits(size)) {
+                    capacity = std::max(capacity, size);
+                }
+            }
+            std::vector<double> matrix(capacity * capacity);
+            size_t cachedEnd = 0;
+            bool cached = false;
+            for (size_t k = windowBegin; k < windowEnd; ++k) {
+                const auto [begin, end] = ranges[k];
+                const size_t size = end - begin;
+                if (!fits(size)) {
+                    buildWindow(windows[k], begin, end, [&](size_t i, size_t j) { return distance(begin + i, begin + j); });
+                    computed[run] += size * (size - 1) / 2;
+                    cached = false;
+                    continue;
+                }
+
+                // Rows before `fresh` stayed from the previous window with all their distances
+                const size_t fresh = cached ? std::max(begin, cachedEnd) : begin;
+                const size_t kept = fresh - begin, added = end - fresh;
+                reused[run] += kept * (kept - 1) / 2;
+                pool.parallelFor(fresh, end, [&](size_t rowBegin, size_t rowEnd) {
+                    for (size_t p = rowBegin; p < rowEnd; ++p) {
+                        const size_t slot = p % capacity;
+                        for (size_t q = begin; q < p; ++q) {
+                            const double d = distance(p, q);
+                            matrix[slot * capacity + q % capacity] = d;
+                            matrix[(q % capacity) * capacity + slot] = d;
+                        }
+                    }
+                }, std::max<size_t>(1, added / (4 * static_cast<size_t>(pool.getNumThreads()))));
+                computed[run] += added * kept + added * (added - 1) / 2;
+                cached = true;
+                cachedEnd = end;
+                buildWindow(windows[k], begin, end, [&](size_t i, size_t j) {
+                    return matrix[((begin + i) % capacity) * capacity + (begin + j) % capacity];
+                });
+            }
+        }
+    }, 1);
+
+    computedPairs = std::accumulate(computed.begin(), computed.end(), size_t(0));
+    reusedPairs = std::accumulate(reused.begin(), reused.end(), size_t(0));
+    timer.addItems(numWindows);
+    std::cout << numWindows << " temporal windows built in " << numRuns << " runs (" << computedPairs
+              << " distances computed, " << reusedPairs << " reused)\n";
+    return windows;
+}
+
+size_t Temporal_Network::getComputedPairs() const {
+    return computedPairs;
+}
+
+size_t Temporal_Network::getReusedPairs() const {
+    return reusedPairs;
+}
+
+bool Temporal_Network::writeSeries(const std::string& filename, const std::vector<Temporal_Window>& windows) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    auto number = [](double value) { return std::isnan(value) ? std::string() : fmt::format("{:g}", value); };
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer),
+                   "window,start,end,documents,new_documents,mst_weight,mean_edge,max_edge,diameter,verdict_assortativity\n");
+    for (size_t k = 0; k < windows.size(); ++k) {
+        const Temporal_Window& window = windows[k];
+        const double meanEdge = window.mst.empty() ? 0.0 : window.mstWeight / static_cast<double>(window.mst.size());
+        fmt::format_to(std::back_inserter(buffer), "{},{},{},{},{},{:g},{:g},{:g},{:g},{}\n", k, window.start,
+                       window.end, window.documents.size(), window.newDocuments, window.mstWeight, meanEdge,
+                       window.maxEdge, window.diameter, number(window.verdictAssortativity));
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+bool Temporal_Network::writeEdges(const std::string& filename, const std::vector<Temporal_Window>& windows) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "window,source,target,weight\n");
+    for (size_t k = 0; k < windows.size(); ++k) {
+        for (const auto& edge : windows[k].mst) {
+            fmt::format_to(std::back_inserter(buffer), "{},{},{},{}\n", k, edge.getNode1(), edge.getNode2(), edge.getWeight());
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+bool Temporal_Network::parseConfig(const std::string& text, Temporal_Config& config) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    const std::string unit = text.substr(0, colon);
+    const std::string rest = text.substr(colon + 1);
+    const size_t second = rest.find(':');
+    try {
+        const int width = std::stoi(rest.substr(0, second));
+        const int stride = second == std::string::npos ? 1 : std::stoi(rest.substr(second + 1));
+        if (width < 1 || stride < 1) {
+            return false;
+        }
+        if (unit == "day") {
+            config.unit = Time_Unit::DAY;
+        } else if (unit == "month") {
+            config.unit = Time_Unit::MONTH;
+        } else {
+            return false;
+        }
+        config.width = width;
+        config.stride = stride;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
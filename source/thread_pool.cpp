@@ -0,0 +1,208 @@
+#include "thread_pool.h"
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace {
+    // Identifies the pool and deque of the current worker thread
+    thread_local const Thread_Pool* currentPool = nullptr;
+    thread_local unsigned int currentIndex = 0;
+}
+
+Thread_Pool::Thread_Pool(unsigned int numThreads, bool pinThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        queues.push_back(std::make_unique<Worker_Queue>());
+    }
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        threads.emplace_back(&Thread_Pool::workerLoop, this, i);
+        if (pinThreads) {
+            pinThread(threads.back(), i);
+        }
+    }
+}
+
+Thread_Pool::~Thread_Pool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+unsigned int Thread_Pool::getNumThreads() const {
+    return static_cast<unsigned int>(threads.size());
+}
+
+void Thread_Pool::submit(Task task) {
+    const unsigned int target = isWorkerThread() ? currentIndex : nextQueue++ % getNumThreads();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++pendingTasks;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    wakeUp.notify_one();
+}
+
+bool Thread_Pool::popTask(unsigned int index, Task& task) {
+    {
+        Worker_Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --pendingTasks;
+            return true;
+        }
+    }
+
+    const unsigned int numQueues = getNumThreads();
+    for (unsigned int offset = 1; offset < numQueues; ++offset) {
+        Worker_Queue& victim = *queues[(index + offset) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --pendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Thread_Pool::runPendingTask() {
+    if (!isWorkerThread()) {
+        return false;
+    }
+    Task task;
+    if (!popTask(currentIndex, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+bool Thread_Pool::isWorkerThread() const {
+    return currentPool == this;
+}
+
+void Thread_Pool::workerLoop(unsigned int index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        Task task;
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return stopping || pendingTasks > 0; });
+        if (stopping && pendingTasks == 0) {
+            return;
+        }
+    }
+}
+
+void Thread_Pool::pinThread(std::thread& thread, unsigned int index) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    CPU_SET(cpus[index % cpus.size()], &target);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(target), &target) != 0) {
+        std::cerr << "Warning: Could not pin worker " << index << " to a CPU." << std::endl;
+    }
+#elif defined(_WIN32)
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (index % (8 * sizeof(DWORD_PTR))));
+#else
+    (void)thread;
+    (void)index;
+#endif
+}
+
+Thread_Pool& Thread_Pool::defaultPool() {
+    static Thread_Pool pool;
+    return pool;
+}
+
+// --- Task_Group ---
+
+Task_Group::Task_Group(Thread_Pool& pool) : pool(pool) {
+}
+
+Task_Group::~Task_Group() {
+    try {
+        wait();
+    } catch (...) {
+        // Errors are only reported through an explicit wait()
+    }
+}
+
+void Task_Group::run(Thread_Pool::Task task) {
+    ++outstanding;
+    pool.submit([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--outstanding == 0) {
+            done.notify_all();
+        }
+    });
+}
+
+void Task_Group::wait() {
+    if (pool.isWorkerThread()) {
+        // Nested wait: keep the worker busy so the tasks we wait for cannot starve
+        while (outstanding > 0) {
+            if (!pool.runPendingTask()) {
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait_for(lock, std::chrono::milliseconds(1), [this]() { return outstanding == 0; });
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return outstanding == 0; });
+    if (error) {
+        std::exception_ptr raised = error;
+        error = nullptr;
+        std::rethrow_exception(raised);
+    }
+}
@@ -0,0 +1,454 @@
+#include "topic_backend.h"
+#include "synthetic_corpus.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t kTailLines = 20; // Lines of output kept for error reports
+
+    void keepLine(std::deque<std::string>& tail, std::string line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        tail.push_back(std::move(line));
+        if (tail.size() > kTailLines) {
+            tail.pop_front();
+        }
+    }
+
+    std::string joinLines(const std::deque<std::string>& tail) {
+        std::string text;
+        for (const auto& line : tail) {
+            text += line;
+            text += '\n';
+        }
+        return text;
+    }
+
+    // Mallet logs "<10> LL/token: -8.41234" every ten iterations ("<10>" alone without the likelihood)
+    bool parseProgress(const std::string& line, int& iteration, double& logLikelihood) {
+        const size_t open = line.find('<');
+        const size_t close = line.find('>', open);
+        if (open == std::string::npos || close == std::string::npos || close == open + 1) {
+            return false;
+        }
+        try {
+            size_t used = 0;
+            iteration = std::stoi(line.substr(open + 1, close - open - 1), &used);
+            if (used != close - open - 1) {
+                return false;
+            }
+            logLikelihood = std::numeric_limits<double>::quiet_NaN();
+            const size_t marker = line.find("LL/token:", close);
+            if (marker != std::string::npos) {
+                logLikelihood = std::stod(line.substr(marker + 9));
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    std::string formatNumber(double value) {
+        std::ostringstream text;
+        text << value;
+        return text.str();
+    }
+}
+
+// --- Topic_Backend ---
+
+Training_Result Topic_Backend::train(const Training_Job& job) {
+    return train(std::vector<Training_Job>{job}, 1).front();
+}
+
+void Topic_Backend::cancel() {
+    ++generation;
+}
+
+void Topic_Backend::setOptions(Backend_Options options) {
+    std::lock_guard<std::mutex> lock(optionsMutex);
+    this->options = std::move(options);
+}
+
+Backend_Options Topic_Backend::snapshot() const {
+    std::lock_guard<std::mutex> lock(optionsMutex);
+    return options;
+}
+
+std::unique_ptr<Topic_Backend> Topic_Backend::create(const std::string& name) {
+    if (name == "mallet") {
+        return std::make_unique<Mallet_Backend>();
+    }
+    if (name == "stub") {
+        return std::make_unique<Stub_Backend>();
+    }
+    return nullptr;
+}
+
+// --- Mallet_Backend ---
+
+Mallet_Backend::Mallet_Backend(std::string executable) : executable(std::move(executable)) {
+}
+
+std::string Mallet_Backend::name() const {
+    return "mallet";
+}
+
+bool Mallet_Backend::importCorpus(const std::string& corpusFile, const std::string& output) {
+    const std::vector<std::string> command = {executable, "import-file", "--input", corpusFile,
+                                              "--output", "./temp/" + output + ".mallet",
+                                              "--keep-sequence", "--remove-stopwords"};
+    const Training_Result result = runProcesses({command}, {0}, 1).front();
+    if (!result.ok) {
+        std::cerr << "Error: Mallet import failed with exit code " << result.exitCode << ".\n" << result.output << std::flush;
+    }
+    return result.ok;
+}
+
+std::vector<std::string> Mallet_Backend::trainArguments(const Training_Job& job) const {
+    const Lda_Config& config = job.config;
+    std::vector<std::string> arguments = {
+        executable, "train-topics",
+        "--input", "./temp/" + job.input + ".mallet",
+        "--num-topics", std::to_string(config.numTopics),
+        "--word-topic-counts-file", "./temp/" + job.output + "_word_topic.txt",
+        "--output-doc-topics", "./temp/" + job.output + "_composition.txt",
+        "--diagnostics-file", "./temp/" + job.output + "_diagnostics.xml",
+        "--optimize-interval", std::to_string(config.optimizeInterval),
+        "--optimize-burn-in", std::to_string(config.optimizeBurnIn),
+        "--num-iterations", std::to_string(config.iterations),
+        "--beta", formatNumber(config.beta),
+        "--alpha", formatNumber(config.alpha)};
+    if (config.seed != 0) {
+        arguments.push_back("--random-seed");
+        arguments.push_back(std::to_string(config.seed));
+    }
+    return arguments;
+}
+
+std::vector<Training_Result> Mallet_Backend::train(const std::vector<Training_Job>& jobs, int concurrency) {
+    std::vector<std::vector<std::string>> commands;
+    std::vector<int> iterations;
+    for (const auto& job : jobs) {
+        commands.push_back(trainArguments(job));
+        iterations.push_back(job.config.iterations);
+    }
+    return runProcesses(commands, iterations, concurrency);
+}
+
+#ifdef _WIN32
+
+// No posix_spawn: the commands run one at a time through the shell
+std::vector<Training_Result> Mallet_Backend::runProcesses(const std::vector<std::vector<std::string>>& commands,
+                                                          const std::vector<int>& iterations, int concurrency) {
+    (void)iterations;
+    (void)concurrency;
+    const unsigned startGeneration = generation;
+    std::vector<Training_Result> results(commands.size());
+    for (size_t c = 0; c < commands.size(); ++c) {
+        if (generation != startGeneration) {
+            results[c].cancelled = true;
+            continue;
+        }
+        std::string command;
+        for (const auto& argument : commands[c]) {
+            command += (command.empty() ? "\"" : " \"") + argument + "\"";
+        }
+        const auto start = Clock::now();
+        results[c].exitCode = std::system(("\"" + command + " > NUL 2>&1\"").c_str());
+        results[c].ok = results[c].exitCode == 0;
+        results[c].seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return results;
+}
+
+#else
+
+std::vector<Training_Result> Mallet_Backend::runProcesses(const std::vector<std::vector<std::string>>& commands,
+                                                          const std::vector<int>& iterations, int concurrency) {
+    struct Child {
+        size_t index;
+        pid_t pid;
+        int fd;                          // Read end of the output pipe, -1 once closed
+        std::string pending;             // Output after the last newline
+        std::deque<std::string> tail;    // Last lines
+        Clock::time_point start;
+        bool stopping = false;
+        Clock::time_point killAt;        // SIGKILL if still running by then
+    };
+    const Backend_Options run = snapshot();
+    const unsigned startGeneration = generation;
+    std::vector<Training_Result> results(commands.size());
+    std::vector<Child> running;
+    size_t next = 0;
+    concurrency = std::max(1, concurrency);
+
+    auto handleLine = [&](Child& child, std::string line) {
+        int iteration = 0;
+        double logLikelihood = 0.0;
+        if (parseProgress(line, iteration, logLikelihood)) {
+            Training_Result& result = results[child.index];
+            if (!std::isnan(logLikelihood)) {
+                result.logLikelihood = logLikelihood;
+            }
+            if (run.onProgress) {
+                run.onProgress({static_cast<int>(child.index), iteration, iterations[child.index], logLikelihood});
+            }
+        }
+        keepLine(child.tail, std::move(line));
+    };
+
+    // Reads what a child has written so far; `closing` also closes the pipe and flushes the last line
+    auto drain = [&](Child& child, bool closing) {
+        char buffer[4096];
+        while (child.fd >= 0) {
+            const ssize_t count = read(child.fd, buffer, sizeof(buffer));
+            if (count > 0) {
+                child.pending.append(buffer, static_cast<size_t>(count));
+                for (size_t newline; (newline = child.pending.find('\n')) != std::string::npos;) {
+                    handleLine(child, child.pending.substr(0, newline));
+                    child.pending.erase(0, newline + 1);
+                }
+                continue;
+            }
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && !closing) {
+                return;
+            }
+            close(child.fd);
+            child.fd = -1;
+        }
+        if (closing && !child.pending.empty()) {
+            handleLine(child, std::move(child.pending));
+            child.pending.clear();
+        }
+    };
+
+    // Each child gets its own process group, so that stopping it also stops the JVM the
+    // Mallet launcher script starts
+    auto spawn = [&](size_t index) {
+        const auto& command = commands[index];
+        int pipeFds[2];
+#ifdef __linux__
+        if (pipe2(pipeFds, O_CLOEXEC) != 0) {
+#else
+        if (pipe(pipeFds) != 0 || fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC) != 0 || fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC) != 0) {
+#endif
+            results[index].output = std::string("Could not create a pipe: ") + std::strerror(errno) + "\n";
+            return;
+        }
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, pipeFds[1], 1);
+        posix_spawn_file_actions_adddup2(&actions, pipeFds[1], 2);
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, 0);
+
+        std::vector<char*> argv;
+        for (const auto& argument : command) {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(nullptr);
+        pid_t pid = -1;
+        const int error = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        close(pipeFds[1]);
+        if (error != 0) {
+            close(pipeFds[0]);
+            results[index].output = "Could not start " + command.front() + ": " + std::strerror(error) + "\n";
+            return;
+        }
+        fcntl(pipeFds[0], F_SETFL, fcntl(pipeFds[0], F_GETFL) | O_NONBLOCK);
+        Child child;
+        child.index = index;
+        child.pid = pid;
+        child.fd = pipeFds[0];
+        child.start = Clock::now();
+        running.push_back(std::move(child));
+    };
+
+    while (next < commands.size() || !running.empty()) {
+        while (static_cast<int>(running.size()) < concurrency && next < commands.size()) {
+            if (generation != startGeneration) {
+                results[next++].cancelled = true;
+            } else {
+                spawn(next++);
+            }
+        }
+        if (running.empty()) {
+            continue;
+        }
+
+        // Wait for output, waking up regularly for deadlines and exits
+        std::vector<pollfd> fds;
+        for (const auto& child : running) {
+            if (child.fd >= 0) {
+                fds.push_back({child.fd, POLLIN, 0});
+            }
+        }
+        poll(fds.empty() ? nullptr : fds.data(), fds.size(), 100);
+
+        for (auto& child : running) {
+            drain(child, false);
+        }
+
+        const auto now = Clock::now();
+        for (auto it = running.begin(); it != running.end();) {
+            Child& child = *it;
+            Training_Result& result = results[child.index];
+            const bool cancelled = generation != startGeneration;
+            const bool expired = run.timeout.count() > 0 && now - child.start >= run.timeout;
+            if ((cancelled || expired) && !child.stopping) {
+                kill(-child.pid, SIGTERM);
+                child.stopping = true;
+                child.killAt = now + std::chrono::seconds(5);
+                result.cancelled = cancelled;
+                result.timedOut = !cancelled;
+            } else if (child.stopping && now >= child.killAt) {
+                kill(-child.pid, SIGKILL);
+            }
+
+            int status = 0;
+            if (waitpid(child.pid, &status, WNOHANG) != child.pid) {
+                ++it;
+                continue;
+            }
+            drain(child, true);
+            if (child.stopping) {
+                kill(-child.pid, SIGKILL); // Whatever of the group is left
+            }
+            result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            result.ok = !child.stopping && result.exitCode == 0;
+            result.seconds = std::chrono::duration<double>(now - child.start).count();
+            result.output = joinLines(child.tail);
+            it = running.erase(it);
+        }
+    }
+    return results;
+}
+
+#endif
+
+// --- Stub_Backend ---
+
+Stub_Backend::Stub_Backend(std::chrono::microseconds iterationDelay) : iterationDelay(iterationDelay) {
+}
+
+std::string Stub_Backend::name() const {
+    return "stub";
+}
+
+bool Stub_Backend::importCorpus(const std::string& corpusFile, const std::string& output) {
+    std::ifstream corpus(corpusFile);
+    if (!corpus.is_open()) {
+        std::cerr << "Error: Could not open corpus file " << corpusFile << "." << std::endl;
+        return false;
+    }
+    int lines = 0;
+    for (std::string line; std::getline(corpus, line);) {
+        ++lines;
+    }
+    const std::string filename = "./temp/" + output + ".mallet";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    file << "stub " << lines << "\n";
+    return static_cast<bool>(file);
+}
+
+std::vector<Training_Result> Stub_Backend::train(const std::vector<Training_Job>& jobs, int concurrency) {
+    const Backend_Options run = snapshot();
+    const unsigned startGeneration = generation;
+    std::vector<Training_Result> results(jobs.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t j = next++; j < jobs.size(); j = next++) {
+            results[j] = trainOne(jobs[j], static_cast<int>(j), startGeneration, run);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < std::min<int>(std::max(1, concurrency), static_cast<int>(jobs.size())); ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+Training_Result Stub_Backend::trainOne(const Training_Job& job, int index, unsigned startGeneration,
+                                       const Backend_Options& run) const {
+    Training_Result result;
+    const auto start = Clock::now();
+    std::ifstream input("./temp/" + job.input + ".mallet");
+    std::string tag;
+    int numDocuments = -1;
+    if (!(input >> tag >> numDocuments) || tag != "stub" || numDocuments < 0) {
+        result.output = "./temp/" + job.input + ".mallet is not a corpus imported by the stub backend\n";
+        return result;
+    }
+
+    const Lda_Config& config = job.config;
+    for (int iteration = 1; iteration <= config.iterations; ++iteration) {
+        if (iterationDelay.count() > 0) {
+            std::this_thread::sleep_for(iterationDelay);
+        }
+        result.cancelled = generation != startGeneration;
+        result.timedOut = !result.cancelled && run.timeout.count() > 0 && Clock::now() - start >= run.timeout;
+        if (result.cancelled || result.timedOut) {
+            result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return result;
+        }
+        if (iteration % 10 == 0) {
+            result.logLikelihood = -10.0 + 2.0 * (1.0 - std::exp(-iteration / 100.0));
+            if (run.onProgress) {
+                run.onProgress({index, iteration, config.iterations, result.logLikelihood});
+            }
+        }
+    }
+
+    Synthetic_Config corpusConfig;
+    corpusConfig.numDocuments = numDocuments;
+    corpusConfig.numTopics = config.numTopics;
+    corpusConfig.alpha = config.alpha / std::max(1, config.numTopics);
+    corpusConfig.beta = config.beta;
+    corpusConfig.seed = config.seed != 0 ? static_cast<uint64_t>(config.seed) : 42;
+    const Synthetic_Corpus corpus(corpusConfig);
+    const std::string prefix = "./temp/" + job.output;
+    result.ok = corpus.writeComposition(prefix + "_composition.txt") && corpus.writeDiagnostics(prefix + "_diagnostics.xml", 200) &&
+                static_cast<bool>(std::ofstream(prefix + "_word_topic.txt"));
+    result.exitCode = result.ok ? 0 : 1;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
@@ -1,6 +1,7 @@
 // Topic_generator.cpp
 #include "topic_generator.h"
 #include "perplexity_utils.h"
+#include "instrumentation.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
@@ -13,16 +14,25 @@
 using json = nlohmann::json;
 using namespace tinyxml2;
 
-Topic_generator::Topic_generator() : malletFile(""), rawData("") {
+Topic_generator::Topic_generator() : Topic_generator(Thread_Pool::defaultPool()) {
+}
+
+Topic_generator::Topic_generator(Thread_Pool& pool)
+    : malletFile(""), rawData(""), pool(pool), backend(std::make_unique<Mallet_Backend>()) {
     // Constructor initialization
 }
 
-void Topic_generator::importStoreData(Statements& statements) {
-    std::ifstream file("input/politifact_factcheck_data_cleaned.json");
+void Topic_generator::importStoreData(Statements& statements, const std::string& filename,
+                                      const std::function<void(int, const std::string&)>& onStatement) {
+    Scoped_Timer timer("import");
+    std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Error: Could not open JSON file." << std::endl;
+        std::cerr << "Error: Could not open JSON file " << filename << "." << std::endl;
         return;
     }
+    file.seekg(0, std::ios::end);
+    timer.addBytes(static_cast<uint64_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
 
     json data;
     file >> data;
@@ -37,8 +47,13 @@ void Topic_generator::importStoreData(Statements& statements) {
         std::string factchecker = item["factchecker"];
         std::string factcheckDate = item["factcheck_date"];
 
-        statements.addStatement(id++, comment, verdict, date, originator, source, factchecker, factcheckDate);
+        statements.addStatement(id, comment, verdict, date, originator, source, factchecker, factcheckDate);
+        if (onStatement) {
+            onStatement(id, comment);
+        }
+        ++id;
     }
+    timer.addItems(id);
 
     std::cout << "Data successfully imported and stored in Statements table." << std::endl;
 }
@@ -49,56 +64,88 @@ void Topic_generator::dataDateFilter(const std::string& input) {
     return;
 }
 
-void Topic_generator::buildMalletProfile(Statements& statements, const std::string& output) {
+bool Topic_generator::buildMalletProfile(Statements& statements, const std::string& output) {
     std::cout << "Building Mallet profile from Statements table..." << std::endl;
 
     const std::string tempInputFile = "./temp/statements_only.txt";
-    std::ofstream outFile(tempInputFile);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not create temporary input file." << std::endl;
-        return;
-    }
+    {
+        Scoped_Timer timer("corpus_write");
+        std::ofstream outFile(tempInputFile);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not create temporary input file." << std::endl;
+            return false;
+        }
 
-    for (int id = 0; id < statements.getSize(); ++id) {
-        outFile << statements.getComment(id) << std::endl;
+        for (int id = 0; id < statements.getSize(); ++id) {
+            outFile << statements.getComment(id) << std::endl;
+        }
+        timer.addItems(statements.getSize());
+        timer.addBytes(static_cast<uint64_t>(outFile.tellp()));
+        outFile.close();
     }
-    outFile.close();
     std::cout << "Statements written to " << tempInputFile << std::endl;
 
-    std::string command = "mallet import-file --input " + tempInputFile + 
-                            " --output ./temp/" + output + ".mallet" +
-                            " --keep-sequence --remove-stopwords";
-                            
+    return importMalletCorpus(tempInputFile, output);
+}
 
-    int ret_code = std::system(command.c_str());
-    if (ret_code != 0) {
-        std::cerr << "Error: Mallet process failed with exit code " << ret_code << std::endl;
-    } else {
-        std::cout << "Mallet profile built successfully." << std::endl;
+bool Topic_generator::importMalletCorpus(const std::string& corpusFile, const std::string& output) {
+    Scoped_Timer timer("mallet_import");
+    if (!backend->importCorpus(corpusFile, output)) {
+        return false;
     }
+    std::cout << "Mallet profile built successfully." << std::endl;
+    return true;
+}
+
+bool Topic_generator::generateTopics(const std::string& input, int numTopics, const std::string& output) {
+    Lda_Config config;
+    config.numTopics = numTopics;
+    return generateTopics(input, config, output);
 }
 
-void Topic_generator::generateTopics(const std::string& input, int numTopics, const std::string& output) {
+bool Topic_generator::generateTopics(const std::string& input, const Lda_Config& config, const std::string& output) {
+    Scoped_Timer timer("lda_training");
+    timer.addCounter("topics", config.numTopics);
     std::cout << "Generating topics..." << std::endl;
 
-    std::string command = "mallet train-topics --input ./temp/" + input + ".mallet" + 
-                " --num-topics " + std::to_string(numTopics) +
-                " --word-topic-counts-file ./temp/" + output + "_word_topic.txt" +
-                " --output-doc-topics ./temp/" + output + "_composition.txt" +
-                " --diagnostics-file ./temp/" + output + "_diagnostics.xml" +
-                " --optimize-interval 20 --optimize-burn-in 50 --num-iterations 1000" +
-                " --beta 0.05 --alpha 50"+
-                " > NUL 2>&1";
-
-    int ret_code = std::system(command.c_str());
-    if (ret_code != 0) {
-        std::cerr << "Error: Mallet process failed with exit code " << ret_code << std::endl;
-    } else {
-        std::cout << "Topics generated successfully." << std::endl;
+    const Training_Result result = generateTopicChains({{input, config, output}}, 1).front();
+    if (!result.ok) {
+        return false;
     }
+    std::cout << "Topics generated successfully." << std::endl;
+    return true;
+}
+
+std::vector<Training_Result> Topic_generator::generateTopicChains(const std::vector<Training_Job>& jobs, int concurrency) {
+    std::vector<Training_Result> results = backend->train(jobs, concurrency);
+    for (size_t j = 0; j < results.size(); ++j) {
+        const Training_Result& result = results[j];
+        if (result.ok) {
+            continue;
+        }
+        std::cerr << "Error: Training of " << jobs[j].output << " with the " << backend->name() << " backend ";
+        if (result.timedOut) {
+            std::cerr << "timed out after " << result.seconds << " s";
+        } else if (result.cancelled) {
+            std::cerr << "was cancelled";
+        } else {
+            std::cerr << "failed with exit code " << result.exitCode;
+        }
+        std::cerr << ".\n" << result.output << std::flush;
+    }
+    return results;
+}
+
+void Topic_generator::setBackend(std::unique_ptr<Topic_Backend> backend) {
+    this->backend = std::move(backend);
+}
+
+Topic_Backend& Topic_generator::getBackend() {
+    return *backend;
 }
 
 void Topic_generator::assignTopics(Statements& statements, int numOfTopics, const std::string& profile) {
+    Scoped_Timer timer("topic_assignment");
     int numDocs = 0;
     double* docTopicProbs = parseDocTopicProb(profile, numOfTopics, numDocs);
 
@@ -114,6 +161,7 @@ void Topic_generator::assignTopics(Statements& statements, int numOfTopics, cons
         }
         statements.addTopics(docID, topics);
     }
+    timer.addItems(numDocs);
 
     delete[] docTopicProbs;
 
@@ -126,19 +174,20 @@ void Topic_generator::assignTopics(Statements& statements, int numOfTopics, cons
  */
 #include <fstream> // Include for file handling
 
-void Topic_generator::perplexityPypelyne(int numTopics) {
+void Topic_generator::perplexityPypelyne(int numTopics, const std::string& profile) {
+    Scoped_Timer timer("perplexity");
     size_t numWordsToConsider = 200;
     int numDocs;
 
-    double* docTopicProbs = parseDocTopicProb("profile1", numTopics, numDocs);
-    double* wordTopicProbs = parseDiagnosticsForWordTopicProbs("profile1", numTopics, numWordsToConsider);
-    double* docProbs = calculateDocumentProbabilities(docTopicProbs, numDocs, numTopics, wordTopicProbs, numWordsToConsider);
-    int totalWordsInCorpus = totalNumberOfWords("profile1");
+    double* docTopicProbs = parseDocTopicProb(profile, numTopics, numDocs);
+    double* wordTopicProbs = parseDiagnosticsForWordTopicProbs(profile, numTopics, numWordsToConsider);
+    double* docProbs = calculateDocumentProbabilities(docTopicProbs, numDocs, numTopics, wordTopicProbs, numWordsToConsider, pool);
+    int totalWordsInCorpus = totalNumberOfWords(profile);
 
     double perplexity = calculatePerplexity(docProbs, numDocs, totalWordsInCorpus);
     std::cout << "Perplexity: " << perplexity << std::endl;
 
-    double* means = calculateMeans("profile1", numTopics);
+    double* means = calculateMeans(profile, numTopics);
 
     const char* metricNames[] = {
         "tokens", "document_entropy", "word_length", "coherence",
@@ -0,0 +1,244 @@
+#include "tree_analytics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+Tree_Analytics::Tree_Analytics(int numNodes, const std::vector<Edge>& edges)
+    : numNodes(std::max(0, numNodes)), offsets(this->numNodes + 1, 0), parent(this->numNodes, -1),
+      parentWeight(this->numNodes, 0.0), root(this->numNodes, -1), subtreeSize(this->numNodes, 1) {
+    // Adjacency (CSR)
+    for (const auto& edge : edges) {
+        ++offsets[edge.getNode1() + 1];
+        ++offsets[edge.getNode2() + 1];
+    }
+    for (int v = 0; v < this->numNodes; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    neighbours.resize(offsets[this->numNodes]);
+    weights.resize(offsets[this->numNodes]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto& edge : edges) {
+        const int a = edge.getNode1();
+        const int b = edge.getNode2();
+        neighbours[fill[a]] = b;
+        weights[fill[a]++] = edge.getWeight();
+        neighbours[fill[b]] = a;
+        weights[fill[b]++] = edge.getWeight();
+    }
+
+    // Iterative DFS preorder of every tree
+    order.reserve(this->numNodes);
+    std::vector<int> stack;
+    for (int start = 0; start < this->numNodes; ++start) {
+        if (root[start] >= 0) {
+            continue;
+        }
+        root[start] = start;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            const int u = stack.back();
+            stack.pop_back();
+            order.push_back(u);
+            for (int slot = offsets[u]; slot < offsets[u + 1]; ++slot) {
+                const int v = neighbours[slot];
+                if (root[v] < 0) {
+                    root[v] = start;
+                    parent[v] = u;
+                    parentWeight[v] = weights[slot];
+                    stack.push_back(v);
+                }
+            }
+        }
+    }
+
+    // Children come after their parent in preorder, so a reverse sweep accumulates subtree sizes
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (parent[*it] >= 0) {
+            subtreeSize[parent[*it]] += subtreeSize[*it];
+        }
+    }
+}
+
+std::vector<double> Tree_Analytics::degrees() const {
+    std::vector<double> degree(numNodes);
+    for (int v = 0; v < numNodes; ++v) {
+        degree[v] = offsets[v + 1] - offsets[v];
+    }
+    return degree;
+}
+
+std::vector<double> Tree_Analytics::betweenness() const {
+    std::vector<double> result(numNodes, 0.0);
+    for (int v = 0; v < numNodes; ++v) {
+        const double size = subtreeSize[root[v]];
+        double branches = 0.0;
+        for (int slot = offsets[v]; slot < offsets[v + 1]; ++slot) {
+            const int u = neighbours[slot];
+            const double branch = u == parent[v] ? size - subtreeSize[v] : subtreeSize[u];
+            branches += branch * branch;
+        }
+        result[v] = ((size - 1) * (size - 1) - branches) / 2;
+    }
+    return result;
+}
+
+std::vector<double> Tree_Analytics::closeness() const {
+    // Distance sum of each root: every edge is crossed by the nodes below it
+    std::vector<double> total(numNodes, 0.0);
+    for (int v : order) {
+        if (parent[v] >= 0) {
+            total[root[v]] += parentWeight[v] * subtreeSize[v];
+        }
+    }
+    // Rerooting in preorder: parents are final before their children
+    for (int v : order) {
+        if (parent[v] >= 0) {
+            total[v] = total[parent[v]] + parentWeight[v] * (subtreeSize[root[v]] - 2.0 * subtreeSize[v]);
+        }
+    }
+
+    std::vector<double> result(numNodes, 0.0);
+    for (int v = 0; v < numNodes; ++v) {
+        const int others = subtreeSize[root[v]] - 1;
+        result[v] = others > 0 && total[v] > 0 ? others / total[v] : 0.0;
+    }
+    return result;
+}
+
+int Tree_Analytics::distancesFrom(int source, std::vector<double>& distance) const {
+    int farthest = source;
+    distance[source] = 0.0;
+    std::vector<std::pair<int, int>> stack{{source, -1}}; // (node, node it was reached from)
+    while (!stack.empty()) {
+        const auto [u, from] = stack.back();
+        stack.pop_back();
+        if (distance[u] > distance[farthest] || (distance[u] == distance[farthest] && u < farthest)) {
+            farthest = u;
+        }
+        for (int slot = offsets[u]; slot < offsets[u + 1]; ++slot) {
+            if (neighbours[slot] != from) {
+                distance[neighbours[slot]] = distance[u] + weights[slot];
+                stack.emplace_back(neighbours[slot], u);
+            }
+        }
+    }
+    return farthest;
+}
+
+std::vector<double> Tree_Analytics::eccentricity() const {
+    std::vector<double> result(numNodes, 0.0), fromFirst(numNodes, 0.0), fromSecond(numNodes, 0.0);
+    for (int v : order) {
+        if (parent[v] >= 0) {
+            continue;
+        }
+        // The node farthest from any node is a diameter end, and the node farthest from it the other end
+        const int first = distancesFrom(v, fromFirst);
+        const int second = distancesFrom(first, fromFirst);
+        distancesFrom(second, fromSecond);
+    }
+    for (int v = 0; v < numNodes; ++v) {
+        result[v] = std::max(fromFirst[v], fromSecond[v]);
+    }
+    return result;
+}
+
+double Tree_Analytics::diameter(int& first, int& second) const {
+    std::vector<double> distance(numNodes, 0.0);
+    double longest = -1.0;
+    first = second = -1;
+    for (int v : order) {
+        if (parent[v] >= 0) {
+            continue;
+        }
+        const int a = distancesFrom(v, distance);
+        const int b = distancesFrom(a, distance);
+        if (distance[b] > longest) {
+            longest = distance[b];
+            first = std::min(a, b);
+            second = std::max(a, b);
+        }
+    }
+    return std::max(0.0, longest);
+}
+
+std::vector<size_t> Tree_Analytics::degreeHistogram() const {
+    std::vector<size_t> histogram;
+    for (int v = 0; v < numNodes; ++v) {
+        const size_t degree = static_cast<size_t>(offsets[v + 1] - offsets[v]);
+        if (degree >= histogram.size()) {
+            histogram.resize(degree + 1, 0);
+        }
+        ++histogram[degree];
+    }
+    return histogram;
+}
+
+int Tree_Analytics::getNumComponents() const {
+    return static_cast<int>(std::count(parent.begin(), parent.end(), -1));
+}
+
+double Tree_Analytics::assortativity(const std::vector<int>& labels) const {
+    // Symmetric mixing matrix: only its trace and marginals are needed
+    std::unordered_map<int, double> marginal;
+    double same = 0.0, total = 0.0;
+    for (int u = 0; u < numNodes; ++u) {
+        for (int slot = offsets[u]; slot < offsets[u + 1]; ++slot) {
+            const int v = neighbours[slot];
+            if (labels[u] < 0 || labels[v] < 0) {
+                continue;
+            }
+            total += 1.0;
+            same += labels[u] == labels[v] ? 1.0 : 0.0;
+            marginal[labels[u]] += 1.0;
+        }
+    }
+    if (total == 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double expected = 0.0;
+    for (const auto& [label, count] : marginal) {
+        expected += (count / total) * (count / total);
+    }
+    return expected < 1.0 ? (same / total - expected) / (1.0 - expected) : std::numeric_limits<double>::quiet_NaN();
+}
+
+bool Tree_Analytics::writeSummary(const std::string& filename, const Statements& statements) const {
+    std::vector<int> verdicts(numNodes, -1), originators(numNodes, -1);
+    std::unordered_map<std::string, int> originatorIds;
+    for (int v = 0; v < numNodes; ++v) {
+        const Statement* statement = statements.findStatement(v);
+        if (statement) {
+            verdicts[v] = static_cast<int>(statement->getVerdict());
+            originators[v] = originatorIds.emplace(statement->getOriginator(), static_cast<int>(originatorIds.size())).first->second;
+        }
+    }
+
+    int first = -1, second = -1;
+    const double length = diameter(first, second);
+    auto number = [](double value) { return std::isnan(value) ? json(nullptr) : json(value); };
+    json summary = {
+        {"nodes", numNodes},
+        {"edges", neighbours.size() / 2},
+        {"components", getNumComponents()},
+        {"diameter", {{"length", length}, {"first", first}, {"second", second}}},
+        {"degree_histogram", degreeHistogram()},
+        {"verdict_assortativity", number(assortativity(verdicts))},
+        {"originator_assortativity", number(assortativity(originators))},
+    };
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    file << summary.dump(2) << "\n";
+    std::cout << "Tree metrics written to " << filename << " (diameter " << length << ", verdict assortativity "
+              << summary["verdict_assortativity"] << ")\n";
+    return true;
+}
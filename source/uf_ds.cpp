@@ -1,8 +1,6 @@
 #include "uf_ds.h"
 
-UF_DS::UF_DS(int size) : size(size) {
-    parent = new int[size];
-    rank = new int[size];
+UF_DS::UF_DS(int size) : parent(size), rank(size), size(size) {
     for (int i = 0; i < size; ++i) {
         parent[i] = i;
         rank[i] = 0;
@@ -30,4 +28,16 @@ void UF_DS::unite(int u, int v) {
             rank[rootU]++;
         }
     }
-}
\ No newline at end of file
+}
+
+void UF_DS::extend(int count) {
+    for (int i = 0; i < count; ++i) {
+        parent.push_back(size + i);
+        rank.push_back(0);
+    }
+    size += count;
+}
+
+int UF_DS::getSize() const {
+    return size;
+}
@@ -1,28 +1,272 @@
-#include "topic_generator.h"
-#include "statements.h"
-#include "network_synthesizer.h"
+#include "pipeline_runner.h"
+#include "instrumentation.h"
+#include "similarity_server.h"
+#include "synthetic_corpus.h"
+#include <algorithm>
+#include <csignal>
+#include <cxxopts.hpp>
+#include <filesystem>
 #include <iostream>
 #include <string>
 
-auto main() -> int {
+namespace {
+    Similarity_Server* activeServer = nullptr;
 
-    // Create Topic_generator and Statements instances
-    Topic_generator topicGenerator;
-    Statements statements;
+    void stopServer(int) {
+        if (activeServer) {
+            activeServer->stop();
+        }
+    }
+}
+
+auto main(int argc, char** argv) -> int {
+    cxxopts::Options options("Factify", "Topic modelling and network analysis of fact-checked statements");
+
+    // clang-format off
+    options.add_options()
+        ("h,help", "Show help")
+        ("input", "PolitiFact-shaped JSON file of statements",
+            cxxopts::value<std::string>()->default_value("input/politifact_factcheck_data_cleaned.json"))
+        ("topics", "Number of topics", cxxopts::value<int>()->default_value("60"))
+        ("profile", "Prefix of the Mallet files in ./temp", cxxopts::value<std::string>()->default_value("profile1"))
+        ("skip-mallet", "Reuse the existing ./temp/<profile>_composition.txt and _diagnostics.xml")
+        ("alpha", "Sum of the Dirichlet prior over topics", cxxopts::value<double>()->default_value("50"))
+        ("beta", "Dirichlet prior over words", cxxopts::value<double>()->default_value("0.05"))
+        ("iterations", "LDA training iterations", cxxopts::value<int>()->default_value("1000"))
+        ("topic-backend", "Topic backend: mallet, or stub for a synthetic model without Mallet",
+            cxxopts::value<std::string>()->default_value("mallet"))
+        ("training-timeout", "Stop a Mallet process after this many seconds (0 = never)",
+            cxxopts::value<double>()->default_value("0"))
+        ("chains", "Train this many LDA chains concurrently and keep the most likely",
+            cxxopts::value<int>()->default_value("1"))
+        ("no-cache", "Rerun every stage even if its inputs are unchanged")
+        ("cache-dir", "Directory of the stage manifests and cached MSTs",
+            cxxopts::value<std::string>()->default_value("./temp/cache"))
+        ("generate", "Write a synthetic corpus of this many statements to --input and ./temp/<profile>_*, then exit",
+            cxxopts::value<int>())
+        ("vocabulary", "Vocabulary size of the synthetic corpus", cxxopts::value<int>()->default_value("5000"))
+        ("seed", "Seed of the synthetic corpus", cxxopts::value<uint64_t>()->default_value("42"))
+        ("memory-budget", "RAM budget for the network stage in MiB (0 = 80% of physical memory)",
+            cxxopts::value<size_t>()->default_value("0"))
+        ("cores", "Worker threads shared by every stage (0 = all cores)", cxxopts::value<unsigned int>()->default_value("0"))
+        ("pin-threads", "Pin each worker thread to its own core")
+        ("strategy", "MST strategy: auto, dense, prim, knn or ooc", cxxopts::value<std::string>()->default_value("auto"))
+        ("knn", "Neighbours per document for the knn strategy", cxxopts::value<int>()->default_value("16"))
+        ("require-edge-list", "Keep the sorted edge stream, not only the MST")
+        ("allow-approximate", "Let the planner pick the approximate knn strategy")
+        ("shards", "Compute the MST with this many worker processes (0 = in-process)",
+            cxxopts::value<int>()->default_value("0"))
+        ("shard-dir", "Directory shared by the coordinator and the workers",
+            cxxopts::value<std::string>()->default_value("./temp/shards"))
+        ("shard-launch", "Worker launch command with {exe}, {dir} and {worker} placeholders",
+            cxxopts::value<std::string>()->default_value(""))
+        ("verify-shards", "Check the sharded MST against the single-process MST")
+        ("shard-worker", "Run as a shard worker over the given directory", cxxopts::value<std::string>())
+        ("shard-id", "Index of this shard worker", cxxopts::value<int>()->default_value("0"))
+        ("metrics-json", "Write per-stage timings, throughput and peak memory to this JSON file",
+            cxxopts::value<std::string>())
+        ("trace", "Write a Chrome trace of the stages to this file", cxxopts::value<std::string>())
+        ("serve", "After the pipeline, answer similarity queries on this Unix socket until shut down",
+            cxxopts::value<std::string>())
+        ("communities", "CSV of node_id,community rows for --serve and --binary-graph", cxxopts::value<std::string>())
+        ("binary-graph", "Also write the graph as memory-mappable typed columns to this file", cxxopts::value<std::string>())
+        ("layout", "Add ForceAtlas2 x/y positions to the exports, with this many iterations", cxxopts::value<int>())
+        ("percolation", "Comma-separated distance thresholds of ./temp/percolation.csv (default: 101 steps)",
+            cxxopts::value<std::vector<double>>())
+        ("distance-stats", "Write all-pair distance quantiles and histograms, by verdict pair, to ./temp/distance_stats.json with this many bins",
+            cxxopts::value<int>())
+        ("filtered-graph", "Also export a planar filtered graph: tmfg or pmfg", cxxopts::value<std::string>())
+        ("binary-graph-edges", "Edges of --binary-graph: mst, knn:<k>, threshold:<distance>, tmfg or pmfg",
+            cxxopts::value<std::string>()->default_value("mst"))
+        ("clusters", "Cut the single-linkage dendrogram at distance:<threshold> or clusters:<count>",
+            cxxopts::value<std::string>())
+        ("consensus", "Also write the MST consensus of replicas: bootstrap:<count> (topic resampling) or lda:<count> (Mallet seeds)",
+            cxxopts::value<std::string>())
+        ("consensus-seed", "Seed of the first consensus replica", cxxopts::value<uint64_t>()->default_value("1"))
+        ("permutations", "Test verdict clustering on the MST against this many label permutations", cxxopts::value<int>())
+        ("permutation-seed", "Seed of the label permutations", cxxopts::value<uint64_t>()->default_value("1"))
+        ("group-by", "Also build the network of statement groups: originator, source or factchecker",
+            cxxopts::value<std::string>())
+        ("temporal", "Also build an MST per sliding date window: <day|month>:<width>[:<stride>]",
+            cxxopts::value<std::string>());
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    if (result.count("shard-worker")) {
+        return Shard_Coordinator::runWorker(result["shard-worker"].as<std::string>(), result["shard-id"].as<int>());
+    }
+
+    const std::string input = result["input"].as<std::string>();
+    const int numTopics = result["topics"].as<int>();
+    const std::string profile = result["profile"].as<std::string>();
+
+    if (result.count("generate")) {
+        Synthetic_Config corpusConfig;
+        corpusConfig.numDocuments = result["generate"].as<int>();
+        corpusConfig.numTopics = numTopics;
+        corpusConfig.vocabularySize = result["vocabulary"].as<int>();
+        corpusConfig.seed = result["seed"].as<uint64_t>();
+
+        std::cout << "Generating " << corpusConfig.numDocuments << " synthetic statements...\n";
+        const std::filesystem::path inputDirectory = std::filesystem::path(input).parent_path();
+        if (!inputDirectory.empty()) {
+            std::filesystem::create_directories(inputDirectory);
+        }
+        std::filesystem::create_directories("./temp");
+        Synthetic_Corpus corpus(corpusConfig);
+        bool ok = corpus.writeJson(input) && corpus.writeComposition("./temp/" + profile + "_composition.txt") &&
+                  corpus.writeDiagnostics("./temp/" + profile + "_diagnostics.xml", 200);
+        if (ok) {
+            std::cout << "Synthetic corpus written to " << input << " and ./temp/" << profile << "_*\n";
+        }
+        return ok ? 0 : 1;
+    }
+
+    if (result.count("metrics-json") || result.count("trace")) {
+        Instrumentation::instance().enable();
+    }
+
+    Pipeline_Config pipelineConfig;
+    pipelineConfig.input = input;
+    pipelineConfig.profile = profile;
+    pipelineConfig.lda.numTopics = numTopics;
+    pipelineConfig.lda.alpha = result["alpha"].as<double>();
+    pipelineConfig.lda.beta = result["beta"].as<double>();
+    pipelineConfig.lda.iterations = result["iterations"].as<int>();
+    pipelineConfig.skipMallet = result.count("skip-mallet") > 0;
+    pipelineConfig.topicBackend = result["topic-backend"].as<std::string>();
+    pipelineConfig.trainingTimeout = result["training-timeout"].as<double>();
+    pipelineConfig.chains = std::max(1, result["chains"].as<int>());
+    if (!Topic_Backend::create(pipelineConfig.topicBackend)) {
+        std::cerr << "Error: Unknown topic backend " << pipelineConfig.topicBackend << std::endl;
+        return 1;
+    }
+    pipelineConfig.useCache = result.count("no-cache") == 0;
+    pipelineConfig.cacheDirectory = result["cache-dir"].as<std::string>();
+
+    if (result.count("binary-graph")) {
+        pipelineConfig.binaryGraph = result["binary-graph"].as<std::string>();
+        if (!Network_Synthesizer::parseGraphExport(result["binary-graph-edges"].as<std::string>(), pipelineConfig.binaryGraphEdges)) {
+            std::cerr << "Error: Unknown edge set " << result["binary-graph-edges"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    if (result.count("layout")) {
+        pipelineConfig.computeLayout = true;
+        pipelineConfig.layout.iterations = result["layout"].as<int>();
+    }
+    if (result.count("percolation")) {
+        pipelineConfig.percolationThresholds = result["percolation"].as<std::vector<double>>();
+    }
+    if (result.count("permutations")) {
+        pipelineConfig.permutations = result["permutations"].as<int>();
+        pipelineConfig.permutationSeed = result["permutation-seed"].as<uint64_t>();
+    }
+    if (result.count("distance-stats")) {
+        pipelineConfig.computeDistanceStatistics = true;
+        pipelineConfig.distanceBins = result["distance-stats"].as<int>();
+    }
+    if (result.count("filtered-graph")) {
+        Graph_Export_Config filtered;
+        const std::string kind = result["filtered-graph"].as<std::string>();
+        if (!Network_Synthesizer::parseGraphExport(kind, filtered) ||
+            (filtered.kind != Graph_Kind::TMFG && filtered.kind != Graph_Kind::PMFG)) {
+            std::cerr << "Error: Unknown filtered graph " << kind << std::endl;
+            return 1;
+        }
+        pipelineConfig.buildFilteredGraph = true;
+        pipelineConfig.filteredGraph = filtered.kind;
+    }
+    if (result.count("clusters")) {
+        pipelineConfig.cutDendrogram = true;
+        if (!Dendrogram::parseCut(result["clusters"].as<std::string>(), pipelineConfig.clusterCut)) {
+            std::cerr << "Error: Unknown cut " << result["clusters"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    if (result.count("consensus")) {
+        pipelineConfig.buildConsensus = true;
+        if (!Mst_Consensus::parseConfig(result["consensus"].as<std::string>(), pipelineConfig.consensus)) {
+            std::cerr << "Error: Unknown consensus " << result["consensus"].as<std::string>() << std::endl;
+            return 1;
+        }
+        pipelineConfig.consensus.seed = result["consensus-seed"].as<uint64_t>();
+    }
+    if (result.count("group-by")) {
+        pipelineConfig.buildGroupNetwork = true;
+        if (!Group_Network::parseKey(result["group-by"].as<std::string>(), pipelineConfig.groupKey)) {
+            std::cerr << "Error: Unknown group key " << result["group-by"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    if (result.count("temporal")) {
+        pipelineConfig.buildTemporal = true;
+        if (!Temporal_Network::parseConfig(result["temporal"].as<std::string>(), pipelineConfig.temporal)) {
+            std::cerr << "Error: Unknown windows " << result["temporal"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    if (result.count("communities")) {
+        pipelineConfig.communitiesFile = result["communities"].as<std::string>();
+    }
+
+    Planner_Config& plannerConfig = pipelineConfig.planner;
+    plannerConfig.memoryBudgetBytes = result["memory-budget"].as<size_t>() << 20;
+    if (plannerConfig.memoryBudgetBytes > 0) {
+        pipelineConfig.temporal.memoryBudgetBytes = plannerConfig.memoryBudgetBytes;
+    }
+    plannerConfig.cores = result["cores"].as<unsigned int>();
+    plannerConfig.knnNeighbours = result["knn"].as<int>();
+    plannerConfig.requireEdgeList = result.count("require-edge-list") > 0;
+    plannerConfig.allowApproximate = result.count("allow-approximate") > 0;
+
+    const std::string strategy = result["strategy"].as<std::string>();
+    if (strategy != "auto") {
+        if (!Execution_Planner::parseStrategy(strategy, plannerConfig.forced)) {
+            std::cerr << "Error: Unknown strategy " << strategy << std::endl;
+            return 1;
+        }
+        plannerConfig.forceStrategy = true;
+    }
+
+    pipelineConfig.shards = result["shards"].as<int>();
+    pipelineConfig.shardConfig.workers = pipelineConfig.shards;
+    pipelineConfig.shardConfig.directory = result["shard-dir"].as<std::string>();
+    pipelineConfig.shardConfig.launchCommand = result["shard-launch"].as<std::string>();
+    pipelineConfig.shardConfig.executable = std::filesystem::absolute(argv[0]).string();
+    pipelineConfig.verifyShards = result.count("verify-shards") > 0;
+
+    // One thread pool for the whole pipeline
+    Thread_Pool pool(plannerConfig.cores, result.count("pin-threads") > 0);
+    plannerConfig.cores = pool.getNumThreads();
 
-    topicGenerator.importStoreData(statements);
-    topicGenerator.buildMalletProfile(statements, "profile1");
-    topicGenerator.generateTopics("profile1", 60, "profile1");
-    topicGenerator.perplexityPypelyne(60);
-    topicGenerator.assignTopics(statements, 60, "profile1");
+    Pipeline_Runner runner(pipelineConfig, pool);
+    const int status = runner.run();
 
-    Network_Synthesizer networkSynthesizer(statements, 60);
-    networkSynthesizer.calculateSimilarity();
-    networkSynthesizer.buildNetwork();
-    networkSynthesizer.findMST();
+    if (result.count("metrics-json")) {
+        Instrumentation::instance().writeReport(result["metrics-json"].as<std::string>());
+    }
+    if (result.count("trace")) {
+        Instrumentation::instance().writeChromeTrace(result["trace"].as<std::string>());
+    }
 
-    networkSynthesizer.exportMSTToGraphMLWithNodeData("./temp/mst_with_data.graphml", statements);
-    networkSynthesizer.exportMSTWithNodeData("./temp/mst_edges.csv", "./temp/node_data.csv", statements);
+    if (status != 0 || !result.count("serve")) {
+        return status;
+    }
 
-    return 0;
+    Similarity_Server server(runner.getStatements(), *runner.getNetworkSynthesizer(), pool);
+    if (result.count("communities") && !server.loadCommunities(result["communities"].as<std::string>())) {
+        return 1;
+    }
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    const bool served = server.serve(result["serve"].as<std::string>());
+    activeServer = nullptr;
+    return served ? 0 : 1;
 }
@@ -0,0 +1,70 @@
+#include <doctest/doctest.h>
+#include <dendrogram.h>
+#include <edge.h>
+#include <network_synthesizer.h>
+#include <synthetic_corpus.h>
+#include <vector>
+
+TEST_CASE("Linkage rows of a small tree") {
+    // Path 0 - 1 - 2 - 3 with 4 attached to 3, given out of weight order
+    const std::vector<Edge> mst{Edge(2, 3, 0.4, 0), Edge(0, 1, 0.1, 1), Edge(3, 4, 0.2, 2), Edge(1, 2, 0.3, 3)};
+    const Dendrogram dendrogram(5, mst);
+    const auto& linkage = dendrogram.getLinkage();
+    REQUIRE(linkage.size() == 4);
+
+    CHECK(linkage[0].first == 0);
+    CHECK(linkage[0].second == 1);
+    CHECK(linkage[0].size == 2);
+    CHECK(linkage[1].first == 3);
+    CHECK(linkage[1].second == 4);
+    CHECK(linkage[1].size == 2);
+    CHECK(linkage[2].first == 2);
+    CHECK(linkage[2].second == 5); // {0, 1}
+    CHECK(linkage[2].size == 3);
+    CHECK(linkage[3].first == 6);  // {3, 4}
+    CHECK(linkage[3].second == 7); // {0, 1, 2}
+    CHECK(linkage[3].size == 5);
+    CHECK(linkage[3].distance == doctest::Approx(0.4));
+}
+
+TEST_CASE("Linkage of a document MST is a valid SciPy hierarchy") {
+    Synthetic_Config config;
+    config.numDocuments = 120;
+    config.numTopics = 6;
+    Network_Synthesizer synthesizer(Synthetic_Corpus(config).getDocuments(), config.numTopics);
+    synthesizer.findMSTFusedPrim();
+
+    const int n = config.numDocuments;
+    const Dendrogram dendrogram(n, synthesizer.getMST());
+    const auto& linkage = dendrogram.getLinkage();
+    REQUIRE(linkage.size() == static_cast<size_t>(n - 1));
+
+    // Cluster n + i is formed by row i; each cluster is merged at most once
+    std::vector<int> sizes(static_cast<size_t>(2 * n - 1), 1);
+    std::vector<char> merged(sizes.size(), 0);
+    for (size_t i = 0; i < linkage.size(); ++i) {
+        const auto& row = linkage[i];
+        const int id = n + static_cast<int>(i);
+        CHECK(row.first < row.second);
+        CHECK(row.second < id);
+        CHECK_FALSE(merged[row.first]);
+        CHECK_FALSE(merged[row.second]);
+        merged[row.first] = merged[row.second] = 1;
+        sizes[id] = sizes[row.first] + sizes[row.second];
+        CHECK(row.size == sizes[id]);
+        if (i > 0) {
+            CHECK(row.distance >= linkage[i - 1].distance);
+            CHECK(row.size >= 2);
+        }
+    }
+    CHECK(linkage.back().size == n);
+}
+
+TEST_CASE("Linkage of a forest stops at its components") {
+    const std::vector<Edge> forest{Edge(0, 1, 0.2, 0), Edge(2, 3, 0.1, 1)};
+    const Dendrogram dendrogram(5, forest);
+    REQUIRE(dendrogram.getLinkage().size() == 2);
+    CHECK(dendrogram.getLinkage()[0].first == 2);
+    CHECK(dendrogram.getLinkage()[1].first == 0);
+    CHECK(dendrogram.cutToClusters(1) == std::vector<int>{0, 0, 1, 1, 2});
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+#include <distance_statistics.h>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    const int numValues = 200000;
+
+    // Every value of [0, numValues) exactly once, in a scrambled order
+    double scrambled(int i) {
+        return static_cast<double>((static_cast<int64_t>(i) * 7919) % numValues);
+    }
+
+    // Largest distance between q and the normalised rank of the sketch's q-quantile
+    double maxRankError(const Kll_Sketch& sketch) {
+        double error = 0.0;
+        for (int i = 0; i <= 100; ++i) {
+            const double q = i / 100.0;
+            error = std::fmax(error, std::fabs(sketch.quantile(q) / numValues - q));
+        }
+        return error;
+    }
+}
+
+TEST_CASE("KLL quantiles are exact below the sketch capacity") {
+    Kll_Sketch sketch;
+    CHECK(std::isnan(sketch.quantile(0.5)));
+    for (int i = 99; i >= 0; --i) {
+        sketch.add(i);
+    }
+    CHECK(sketch.getCount() == 100);
+    CHECK(sketch.quantile(0.0) == 0.0);
+    CHECK(sketch.quantile(0.5) == 49.0);
+    CHECK(sketch.quantile(1.0) == 99.0);
+}
+
+TEST_CASE("KLL rank error stays within the bound") {
+    Kll_Sketch sketch(200);
+    for (int i = 0; i < numValues; ++i) {
+        sketch.add(scrambled(i));
+    }
+    CHECK(sketch.getCount() == static_cast<uint64_t>(numValues));
+    // About 1.7 / k expected; leave room for an unlucky draw
+    CHECK(maxRankError(sketch) < 0.02);
+}
+
+TEST_CASE("Merged KLL sketches summarise the union") {
+    Kll_Sketch merged(200, 1);
+    Kll_Sketch other(200, 2);
+    for (int i = 0; i < numValues; ++i) {
+        (i % 3 == 0 ? merged : other).add(scrambled(i));
+    }
+    merged.merge(other);
+    merged.merge(Kll_Sketch());
+    CHECK(merged.getCount() == static_cast<uint64_t>(numValues));
+    CHECK(maxRankError(merged) < 0.02);
+}
+
+TEST_CASE("Merged distance summaries match one pass over every distance") {
+    Distance_Summary all(10);
+    Distance_Summary first(10);
+    Distance_Summary second(10);
+    for (int i = 0; i < 1000; ++i) {
+        const double distance = scrambled(i) / numValues;
+        all.add(distance);
+        (i < 300 ? first : second).add(distance);
+    }
+    first.merge(second);
+    CHECK(first.getCount() == all.getCount());
+    CHECK(first.getMean() == doctest::Approx(all.getMean()));
+    CHECK(first.getVariance() == doctest::Approx(all.getVariance()));
+    CHECK(first.getMin() == all.getMin());
+    CHECK(first.getMax() == all.getMax());
+    CHECK(first.getHistogram() == all.getHistogram());
+}
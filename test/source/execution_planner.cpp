@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <execution_planner.h>
+#include <cstddef>
+
+namespace {
+    Planner_Config budgetConfig(size_t memoryBudgetBytes) {
+        Planner_Config config;
+        config.memoryBudgetBytes = memoryBudgetBytes;
+        config.diskBudgetBytes = size_t(1) << 50;
+        config.cores = 4;
+        config.outOfCoreBlockBytes = size_t(1) << 20;
+        return config;
+    }
+
+    Strategy chosen(const Planner_Config& config, size_t numDocuments, int numTopics) {
+        return Execution_Planner(config).plan(numDocuments, numTopics).strategy;
+    }
+
+    size_t memoryOf(Strategy strategy, const Planner_Config& config, size_t numDocuments, int numTopics) {
+        return Execution_Planner(config).estimate(strategy, numDocuments, numTopics).memoryBytes;
+    }
+}
+
+TEST_CASE("Fused Prim is charged a best edge and a remaining index per document") {
+    const Planner_Config config = budgetConfig(0);
+    const int numTopics = 20;
+    const size_t matrixBytes = 1000 * (numTopics + 1) * sizeof(double) + 1000 * sizeof(Edge);
+    CHECK(memoryOf(Strategy::FUSED_PRIM, config, 1000, numTopics) ==
+          matrixBytes + 1000 * (sizeof(Edge) + sizeof(int)) + sizeof(int));
+
+    // Large inputs are scanned in 4 chunks per core
+    const size_t perDocument = memoryOf(Strategy::FUSED_PRIM, config, 5001, numTopics) -
+                               memoryOf(Strategy::FUSED_PRIM, config, 5000, numTopics);
+    CHECK(perDocument == (numTopics + 1) * sizeof(double) + 2 * sizeof(Edge) + sizeof(int));
+    Planner_Config moreCores = config;
+    moreCores.cores = 8;
+    CHECK(memoryOf(Strategy::FUSED_PRIM, moreCores, 5000, numTopics) -
+              memoryOf(Strategy::FUSED_PRIM, config, 5000, numTopics) == 16 * sizeof(int));
+}
+
+TEST_CASE("The planner picks each strategy exactly up to its estimate") {
+    for (size_t numDocuments : {size_t(1000), size_t(20000)}) {
+        const int numTopics = 20;
+        const Planner_Config probe = budgetConfig(0);
+        const size_t dense = memoryOf(Strategy::DENSE_MATRIX, probe, numDocuments, numTopics);
+        const size_t prim = memoryOf(Strategy::FUSED_PRIM, probe, numDocuments, numTopics);
+        const size_t knn = memoryOf(Strategy::KNN_GRAPH, probe, numDocuments, numTopics);
+        const size_t ooc = memoryOf(Strategy::OUT_OF_CORE, probe, numDocuments, numTopics);
+        REQUIRE(prim < dense);
+        REQUIRE(knn < dense);
+        REQUIRE(ooc < dense);
+
+        // Only the MST: dense while it fits, then fused Prim, which is also the fallback
+        CHECK(chosen(budgetConfig(dense), numDocuments, numTopics) == Strategy::DENSE_MATRIX);
+        CHECK(chosen(budgetConfig(dense - 1), numDocuments, numTopics) == Strategy::FUSED_PRIM);
+        CHECK(chosen(budgetConfig(prim), numDocuments, numTopics) == Strategy::FUSED_PRIM);
+        const Execution_Plan starved = Execution_Planner(budgetConfig(prim - 1)).plan(numDocuments, numTopics);
+        CHECK(starved.strategy == Strategy::FUSED_PRIM);
+        CHECK_FALSE(starved.estimates[static_cast<size_t>(Strategy::FUSED_PRIM)].fits);
+
+        // The edge stream is required: kNN when approximation is allowed, else out-of-core
+        Planner_Config edges = budgetConfig(knn);
+        edges.requireEdgeList = true;
+        edges.allowApproximate = true;
+        CHECK(chosen(edges, numDocuments, numTopics) == Strategy::KNN_GRAPH);
+        edges.memoryBudgetBytes = knn - 1;
+        CHECK(chosen(edges, numDocuments, numTopics) == (ooc <= knn - 1 ? Strategy::OUT_OF_CORE : Strategy::FUSED_PRIM));
+
+        edges.allowApproximate = false;
+        edges.memoryBudgetBytes = ooc;
+        CHECK(chosen(edges, numDocuments, numTopics) == Strategy::OUT_OF_CORE);
+        edges.memoryBudgetBytes = ooc - 1;
+        CHECK(chosen(edges, numDocuments, numTopics) == Strategy::FUSED_PRIM);
+
+        // Out-of-core also needs its runs to fit on disk
+        edges.memoryBudgetBytes = ooc;
+        edges.diskBudgetBytes = Execution_Planner(edges).estimate(Strategy::OUT_OF_CORE, numDocuments, numTopics).diskBytes - 1;
+        CHECK(chosen(edges, numDocuments, numTopics) == Strategy::FUSED_PRIM);
+    }
+}
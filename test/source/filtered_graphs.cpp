@@ -0,0 +1,110 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <network_synthesizer.h>
+#include <planarity.h>
+#include <thread_pool.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::vector<std::pair<int, int>> endpoints(const std::vector<Edge>& edges) {
+        std::vector<std::pair<int, int>> result;
+        for (const auto& edge : edges) {
+            result.emplace_back(edge.getNode1(), edge.getNode2());
+        }
+        return result;
+    }
+
+    // Simple graph: no loops and no pair twice
+    bool isSimple(const std::vector<Edge>& edges) {
+        const auto pairs = sortedPairs(edges);
+        return std::adjacent_find(pairs.begin(), pairs.end()) == pairs.end() &&
+               std::none_of(pairs.begin(), pairs.end(), [](const auto& pair) { return pair.first == pair.second; });
+    }
+
+    // Kruskal-like walk over every pair in weight order, testing the whole graph each time
+    std::vector<Edge> naivePMFG(Network_Synthesizer& synthesizer, int n) {
+        Graph_Export_Config everyPair;
+        everyPair.kind = Graph_Kind::THRESHOLD;
+        everyPair.maxDistance = 2.0;
+        std::vector<Edge> candidates = synthesizer.findGraph(everyPair);
+        std::sort(candidates.begin(), candidates.end(), compareByWeight);
+
+        Planarity_Tester tester;
+        std::vector<Edge> graph;
+        std::vector<std::pair<int, int>> kept;
+        for (const auto& edge : candidates) {
+            if (graph.size() == static_cast<size_t>(3 * n - 6)) {
+                break;
+            }
+            kept.emplace_back(edge.getNode1(), edge.getNode2());
+            if (tester.isPlanar(n, kept)) {
+                graph.push_back(edge);
+            } else {
+                kept.pop_back();
+            }
+        }
+        return graph;
+    }
+}
+
+TEST_CASE("TMFG is a planar triangulation of every document") {
+    const int n = 60;
+    Thread_Pool pool(4);
+    Network_Synthesizer synthesizer(makeDocuments(n, 8, 3), 8, pool);
+    const std::vector<Edge> graph = synthesizer.findTMFG();
+
+    CHECK(graph.size() == static_cast<size_t>(3 * n - 6));
+    CHECK(isSimple(graph));
+    CHECK(std::is_sorted(graph.begin(), graph.end(), compareByWeight));
+    std::set<int> nodes;
+    for (const auto& edge : graph) {
+        nodes.insert(edge.getNode1());
+        nodes.insert(edge.getNode2());
+    }
+    CHECK(nodes.size() == static_cast<size_t>(n));
+    CHECK(Planarity_Tester().isPlanar(n, endpoints(graph)));
+}
+
+TEST_CASE("PMFG is planar and equals the sequential construction") {
+    const int n = 50;
+    Thread_Pool pool(4);
+    Network_Synthesizer synthesizer(makeDocuments(n, 6, 5), 6, pool);
+    const std::vector<Edge> graph = synthesizer.findPMFG();
+
+    CHECK(graph.size() == static_cast<size_t>(3 * n - 6));
+    CHECK(isSimple(graph));
+    CHECK(Planarity_Tester().isPlanar(n, endpoints(graph)));
+
+    // Speculative batches accept exactly the edges of the one-at-a-time walk, in the same order
+    const std::vector<Edge> expected = naivePMFG(synthesizer, n);
+    REQUIRE(graph.size() == expected.size());
+    for (size_t i = 0; i < graph.size(); ++i) {
+        CHECK(std::minmax(graph[i].getNode1(), graph[i].getNode2()) ==
+              std::minmax(expected[i].getNode1(), expected[i].getNode2()));
+    }
+
+    // Every rejected pair would break planarity
+    const auto kept = sortedPairs(graph);
+    std::vector<std::pair<int, int>> withExtra = endpoints(graph);
+    for (int u = 0; u < 5; ++u) {
+        for (int v = u + 1; v < n; v += 7) {
+            if (!std::binary_search(kept.begin(), kept.end(), std::make_pair(u, v))) {
+                withExtra.emplace_back(u, v);
+                CHECK_FALSE(Planarity_Tester().isPlanar(n, withExtra));
+                withExtra.pop_back();
+            }
+        }
+    }
+}
+
+TEST_CASE("Filtered graphs of fewer than four documents keep every pair") {
+    for (int n : {2, 3}) {
+        Network_Synthesizer synthesizer(makeDocuments(n, 4, 9), 4);
+        CHECK(synthesizer.findPMFG().size() == static_cast<size_t>(n * (n - 1) / 2));
+        CHECK(synthesizer.findTMFG().size() == static_cast<size_t>(n * (n - 1) / 2));
+    }
+}
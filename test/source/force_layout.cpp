@@ -0,0 +1,110 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <force_layout.h>
+#include <thread_pool.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+    // A ring with chords, weights in [0, 0.82]
+    std::vector<Edge> makeGraph(int numNodes) {
+        std::vector<Edge> edges;
+        for (int v = 0; v < numNodes; ++v) {
+            edges.emplace_back(v, (v + 1) % numNodes, 0.1 * (v % 10) / 1.1, static_cast<int>(edges.size()));
+            if (v % 7 == 0) {
+                edges.emplace_back(v, (v * 5 + 3) % numNodes, 0.25, static_cast<int>(edges.size()));
+            }
+        }
+        return edges;
+    }
+}
+
+TEST_CASE("A seeded layout is finite and reproducible across thread counts") {
+    const int numNodes = 300;
+    const std::vector<Edge> edges = makeGraph(numNodes);
+    Layout_Config config;
+    config.iterations = 50;
+    config.seed = 42;
+
+    Thread_Pool single(1), several(4);
+    Force_Layout first(numNodes, edges, single), second(numNodes, edges, several);
+    first.run(config);
+    second.run(config);
+    REQUIRE(first.getX().size() == static_cast<size_t>(numNodes));
+    CHECK(first.getX() == second.getX());
+    CHECK(first.getY() == second.getY());
+    for (int v = 0; v < numNodes; ++v) {
+        CHECK(std::isfinite(first.getX()[v]));
+        CHECK(std::isfinite(first.getY()[v]));
+    }
+
+    second.run(config);
+    CHECK(first.getX() == second.getX());
+    config.seed = 43;
+    second.run(config);
+    CHECK(first.getX() != second.getX());
+
+    Force_Layout lone(1, {});
+    lone.run(config);
+    CHECK(lone.getX().size() == 1);
+}
+
+TEST_CASE("Barnes-Hut with theta 0 applies the exact pairwise forces") {
+    const int numNodes = 60;
+    const std::vector<Edge> edges = makeGraph(numNodes);
+    Layout_Config config;
+    config.theta = 0.0;
+    config.seed = 9;
+
+    // Positions before and after the first iteration
+    Force_Layout layout(numNodes, edges);
+    config.iterations = 0;
+    layout.run(config);
+    const std::vector<double> x0 = layout.getX(), y0 = layout.getY();
+    config.iterations = 1;
+    layout.run(config);
+    const std::vector<double>& x1 = layout.getX();
+    const std::vector<double>& y1 = layout.getY();
+
+    // Exact O(n^2) ForceAtlas2 forces at the initial positions
+    std::vector<double> mass(numNodes, 1.0), fx(numNodes, 0.0), fy(numNodes, 0.0);
+    for (const auto& edge : edges) {
+        mass[edge.getNode1()] += 1.0;
+        mass[edge.getNode2()] += 1.0;
+    }
+    for (int v = 0; v < numNodes; ++v) {
+        for (int u = 0; u < numNodes; ++u) {
+            const double dx = x0[v] - x0[u], dy = y0[v] - y0[u];
+            if (u != v) {
+                const double factor = config.scalingRatio * mass[v] * mass[u] / (dx * dx + dy * dy);
+                fx[v] += dx * factor;
+                fy[v] += dy * factor;
+            }
+        }
+        const double pull = config.scalingRatio * mass[v] * config.gravity / std::hypot(x0[v], y0[v]);
+        fx[v] -= x0[v] * pull;
+        fy[v] -= y0[v] * pull;
+    }
+    for (const auto& edge : edges) {
+        const int a = edge.getNode1(), b = edge.getNode2();
+        const double similarity = 1.0 - edge.getWeight();
+        fx[a] -= (x0[a] - x0[b]) * similarity;
+        fy[a] -= (y0[a] - y0[b]) * similarity;
+        fx[b] -= (x0[b] - x0[a]) * similarity;
+        fy[b] -= (y0[b] - y0[a]) * similarity;
+    }
+
+    // With no previous force, node v moves by F * s / (1 + sqrt(s * mass * |F|)) for one global
+    // speed s, which node 0 determines
+    auto step = [&](int v) { return std::hypot(x1[v] - x0[v], y1[v] - y0[v]) / std::hypot(fx[v], fy[v]); };
+    const double a = mass[0] * std::hypot(fx[0], fy[0]), f = step(0);
+    const double root = (f * std::sqrt(a) + std::sqrt(f * f * a + 4 * f)) / 2;
+    const double speed = root * root;
+    CHECK(speed > 0.0);
+    for (int v = 0; v < numNodes; ++v) {
+        const double factor = speed / (1.0 + std::sqrt(speed * mass[v] * std::hypot(fx[v], fy[v])));
+        CHECK(x1[v] - x0[v] == doctest::Approx(fx[v] * factor).epsilon(1e-9));
+        CHECK(y1[v] - y0[v] == doctest::Approx(fy[v] * factor).epsilon(1e-9));
+    }
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <filesystem>
+#include <fstream>
+#include <graph_writer.h>
+#include <sstream>
+#include <statements.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::string readFile(const std::string& filename) {
+        std::ifstream file(filename);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+}
+
+TEST_CASE("GraphML escapes the XML special characters of text fields") {
+    Statements statements;
+    statements.addStatement(0, "comment", "true", "01/02/2020", "Smith & \"Sons\"", "<tweet>", "O'Brien", "03/04/2020");
+    statements.addStatement(1, "comment", "false", "01/02/2020", "plain", "speech", "checker", "03/04/2020");
+    const std::vector<Edge> edges{Edge(0, 1, 0.25, 0)};
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "factify_test_escape.graphml").string();
+    REQUIRE(Graph_Writer().writeGraphML(filename, 2, edges, statements));
+    const std::string graph = readFile(filename);
+    std::filesystem::remove(filename);
+
+    CHECK(graph.find("<data key=\"originator\">Smith &amp; &quot;Sons&quot;</data>") != std::string::npos);
+    CHECK(graph.find("<data key=\"source\">&lt;tweet&gt;</data>") != std::string::npos);
+    CHECK(graph.find("<data key=\"factchecker\">O&apos;Brien</data>") != std::string::npos);
+    CHECK(graph.find("<data key=\"originator\">plain</data>") != std::string::npos);
+    CHECK(graph.find("<tweet>") == std::string::npos);
+    CHECK(graph.find("Smith & ") == std::string::npos);
+}
+
+namespace {
+    // Reader written from the layout in graph_writer.h and binary_graph.dox
+    struct Binary_Graph {
+        std::string bytes;
+        uint32_t version = 0;
+        uint64_t numNodes = 0, numEdges = 0;
+        struct Entry {
+            uint8_t type;
+            uint64_t offset, count;
+        };
+        std::vector<std::pair<std::string, Entry>> directory;
+
+        template <typename T>
+        T read(uint64_t offset) const {
+            REQUIRE(offset + sizeof(T) <= bytes.size());
+            T value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        explicit Binary_Graph(const std::string& filename) : bytes(readFile(filename)) {
+            REQUIRE(bytes.size() >= 64);
+            CHECK(bytes.compare(0, 8, "FCTGRAPH") == 0);
+            version = read<uint32_t>(8);
+            const uint32_t numColumns = read<uint32_t>(12);
+            numNodes = read<uint64_t>(16);
+            numEdges = read<uint64_t>(24);
+            CHECK(bytes.find_first_not_of('\0', 32) >= 64);
+            for (uint32_t c = 0; c < numColumns; ++c) {
+                const uint64_t entry = 64 * (1 + c);
+                const std::string field = bytes.substr(entry, 40);
+                const std::string name = field.substr(0, field.find('\0'));
+                CHECK(field.find_first_not_of('\0', name.size()) == std::string::npos);
+                CHECK(bytes.find_first_not_of('\0', entry + 41) >= entry + 48);
+                directory.emplace_back(name, Entry{read<uint8_t>(entry + 40), read<uint64_t>(entry + 48),
+                                                   read<uint64_t>(entry + 56)});
+            }
+        }
+
+        const Entry& entry(const std::string& name) const {
+            const auto it = std::find_if(directory.begin(), directory.end(),
+                                         [&name](const auto& column) { return column.first == name; });
+            REQUIRE(it != directory.end());
+            return it->second;
+        }
+
+        template <typename T>
+        std::vector<T> column(const std::string& name, uint8_t type) const {
+            const Entry& e = entry(name);
+            CHECK(e.type == type);
+            std::vector<T> values(e.count);
+            for (uint64_t i = 0; i < e.count; ++i) {
+                values[i] = read<T>(e.offset + i * sizeof(T));
+            }
+            return values;
+        }
+
+        // Strings of a dictionary-coded column, by node
+        std::vector<std::string> strings(const std::string& name) const {
+            const auto codes = column<int32_t>(name, 1);
+            const auto offsets = column<int64_t>(name + ".offsets", 4);
+            const auto data = column<uint8_t>(name + ".data", 3);
+            REQUIRE(!offsets.empty());
+            CHECK(offsets.front() == 0);
+            CHECK(offsets.back() == static_cast<int64_t>(data.size()));
+            std::vector<std::string> values;
+            for (int32_t code : codes) {
+                if (code < 0) {
+                    values.emplace_back();
+                    continue;
+                }
+                REQUIRE(code + 1 < static_cast<int32_t>(offsets.size()));
+                values.emplace_back(data.begin() + offsets[code], data.begin() + offsets[code + 1]);
+            }
+            return values;
+        }
+    };
+}
+
+TEST_CASE("Binary graphs round-trip through the documented layout") {
+    Statements statements;
+    statements.addStatement(0, "a", "true", "01/02/2020", "Smith", "speech", "checker", "01/02/2020");
+    statements.addStatement(1, "b", "pants-fire", "11/30/2019", "Jones", "tweet", "checker", "12/01/2019");
+    statements.addStatement(3, "c", "half-true", "07/04/2021", "Smith", "speech", "other", "07/05/2021");
+    const std::vector<Edge> edges{Edge(0, 1, 0.125, 0), Edge(1, 3, 0.5, 1), Edge(3, 2, 0.75, 2)};
+    const std::vector<int> communities{2, 0, 1};
+    const std::vector<Node_Attribute> attributes{{"degree", {1.0, 2.0, 1.0, 2.0}}, {"short", {7.5}}};
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "factify_test_graph.bin").string();
+    REQUIRE(Graph_Writer().writeBinary(filename, 4, edges, statements, communities, attributes));
+    const Binary_Graph graph(filename);
+    std::filesystem::remove(filename);
+
+    CHECK(graph.version == 1);
+    CHECK(graph.numNodes == 4);
+    CHECK(graph.numEdges == 3);
+    REQUIRE(graph.directory.size() == 17);
+
+    // Columns follow the directory in order, each on a 64-byte boundary and zero-padded to the next
+    const std::vector<uint64_t> elementSizes{4, 4, 8, 1, 4, 4, 4, 8, 1, 4, 8, 1, 4, 8, 1, 8, 8};
+    uint64_t expectedOffset = 64 * (1 + graph.directory.size());
+    for (size_t c = 0; c < graph.directory.size(); ++c) {
+        const auto& e = graph.directory[c].second;
+        CHECK(e.offset % 64 == 0);
+        CHECK(e.offset == expectedOffset);
+        const uint64_t end = e.offset + e.count * elementSizes[c];
+        const uint64_t padded = (end + 63) / 64 * 64;
+        CHECK(graph.bytes.find_first_not_of('\0', end) >= padded);
+        expectedOffset = padded;
+    }
+    CHECK(graph.bytes.size() == expectedOffset);
+
+    CHECK(graph.column<int32_t>("edge.source", 1) == std::vector<int32_t>{0, 1, 3});
+    CHECK(graph.column<int32_t>("edge.target", 1) == std::vector<int32_t>{1, 3, 2});
+    CHECK(graph.column<double>("edge.weight", 2) == std::vector<double>{0.125, 0.5, 0.75});
+    CHECK(graph.column<uint8_t>("node.verdict", 3) == std::vector<uint8_t>{0, 5, 255, 2});
+    CHECK(graph.column<int32_t>("node.community", 1) == std::vector<int32_t>{2, 0, 1, -1});
+    CHECK(graph.column<int32_t>("node.date", 1) == std::vector<int32_t>{20200102, 20191130, 0, 20210704});
+    CHECK(graph.strings("node.originator") == std::vector<std::string>{"Smith", "Jones", "", "Smith"});
+    CHECK(graph.column<int64_t>("node.originator.offsets", 4) == std::vector<int64_t>{0, 5, 10});
+    CHECK(graph.strings("node.source") == std::vector<std::string>{"speech", "tweet", "", "speech"});
+    CHECK(graph.strings("node.factchecker") == std::vector<std::string>{"checker", "checker", "", "other"});
+    CHECK(graph.column<int32_t>("node.factchecker", 1)[2] == -1);
+    CHECK(graph.column<double>("node.degree", 2) == std::vector<double>{1.0, 2.0, 1.0, 2.0});
+    CHECK(graph.column<double>("node.short", 2) == std::vector<double>{7.5, 0.0, 0.0, 0.0});
+}
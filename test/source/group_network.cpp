@@ -0,0 +1,101 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <group_network.h>
+#include <network_synthesizer.h>
+#include <statements.h>
+#include <thread_pool.h>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Three originators over three topics. Statements weigh their word count: "Smith" has
+    // 2 words on topic 0 and 1 word on topic 1, "Jones" only topic 2, "Lee" topic 0 plus a
+    // statement without topics that counts but carries no weight.
+    Statements makeStatements() {
+        Statements statements;
+        statements.addStatement(0, "two words", "true", "01/02/2020", "Smith", "speech", "checker", "01/03/2020");
+        statements.addStatement(1, "three more words", "pants-fire", "05/06/2019", "Jones", "tweet", "checker", "05/07/2019");
+        statements.addStatement(2, "one", "false", "03/04/2021", "Smith", "tweet", "other", "03/05/2021");
+        statements.addStatement(3, "a statement by Lee", "half-true", "07/08/2018", "Lee", "speech", "other", "07/09/2018");
+        statements.addStatement(4, "", "pants-fire", "09/10/2020", "Jones", "speech", "checker", "09/11/2020");
+        statements.addStatement(5, "untagged", "true", "12/31/2022", "Lee", "speech", "checker", "01/01/2023");
+        statements.addTopics(0, {1.0, 0.0, 0.0});
+        statements.addTopics(1, {0.0, 0.0, 1.0});
+        statements.addTopics(2, {0.0, 1.0, 0.0});
+        statements.addTopics(3, {1.0, 0.0, 0.0});
+        statements.addTopics(4, {0.0, 0.0, 1.0});
+        return statements;
+    }
+}
+
+TEST_CASE("Groups aggregate counts, verdicts, dates and word-weighted topics") {
+    const Statements statements = makeStatements();
+    Thread_Pool pool(2);
+    const Group_Network network(statements, 3, Group_Key::ORIGINATOR, pool);
+    const auto& groups = network.getGroups();
+    REQUIRE(groups.size() == 3);
+
+    CHECK(groups[0].name == "Smith");
+    CHECK(groups[0].statements == 2);
+    CHECK(groups[0].weight == 3.0);
+    CHECK(groups[0].topics[0] == doctest::Approx(2.0 / 3.0));
+    CHECK(groups[0].topics[1] == doctest::Approx(1.0 / 3.0));
+    CHECK(groups[0].topics[2] == 0.0);
+    CHECK(groups[0].verdicts[static_cast<size_t>(Verdict::TRUE)] == 1);
+    CHECK(groups[0].verdicts[static_cast<size_t>(Verdict::FALSE)] == 1);
+    CHECK(groups[0].latestDate == 20210304);
+
+    CHECK(groups[1].name == "Jones");
+    CHECK(groups[1].statements == 2);
+    CHECK(groups[1].weight == 4.0);
+    CHECK(groups[1].topics == std::vector<double>{0.0, 0.0, 1.0});
+    CHECK(groups[1].verdicts[static_cast<size_t>(Verdict::PANTS_FIRE)] == 2);
+
+    CHECK(groups[2].name == "Lee");
+    CHECK(groups[2].statements == 2);
+    CHECK(groups[2].weight == 4.0);
+    CHECK(groups[2].topics == std::vector<double>{1.0, 0.0, 0.0});
+    CHECK(groups[2].latestDate == 20221231);
+
+    // Group nodes: majority verdict with ties to the truer one, latest date, group name
+    const Statements nodes = network.toStatements();
+    CHECK(nodes.getSize() == 3);
+    CHECK(nodes.getVerdict(0) == "true");
+    CHECK(nodes.getVerdict(1) == "pants-fire");
+    CHECK(nodes.getOriginator(2) == "Lee");
+    CHECK(nodes.findStatement(0)->getDate().tm_year == 121);
+
+    const std::vector<Node_Attribute> attributes = network.getAttributes();
+    REQUIRE(attributes.size() == 1 + 6 + 3);
+    CHECK(attributes[0].name == "statements");
+    CHECK(attributes[0].values == std::vector<double>{2.0, 2.0, 2.0});
+    CHECK(attributes[6].name == "verdict_pants_fire");
+    CHECK(attributes[6].values == std::vector<double>{0.0, 2.0, 0.0});
+    CHECK(attributes[7].name == "topic_0");
+}
+
+TEST_CASE("The group MST joins groups by the distance of their mean topics") {
+    const Statements statements = makeStatements();
+    const Group_Network network(statements, 3, Group_Key::ORIGINATOR);
+    Network_Synthesizer synthesizer(network.getTopicMatrix(), 3);
+    synthesizer.findMSTFusedPrim();
+    const std::vector<Edge> mst = synthesizer.getMST();
+    REQUIRE(mst.size() == 2);
+
+    // Smith (2/3, 1/3, 0) and Lee (1, 0, 0) are at 1 - 2/sqrt(5); Jones is orthogonal to both
+    CHECK(sortedPairs(std::vector<Edge>{mst[0]}) == std::vector<std::pair<int, int>>{{0, 2}});
+    CHECK(mst[0].getWeight() == doctest::Approx(1.0 - 2.0 / std::sqrt(5.0)));
+    CHECK((mst[1].getNode1() == 1 || mst[1].getNode2() == 1));
+    CHECK(mst[1].getWeight() == doctest::Approx(1.0));
+
+    // Grouping by source puts statements 0, 3, 4 and 5 together
+    const Group_Network sources(statements, 3, Group_Key::SOURCE);
+    REQUIRE(sources.getGroups().size() == 2);
+    CHECK(sources.getGroups()[0].name == "speech");
+    CHECK(sources.getGroups()[0].statements == 4);
+    CHECK(sources.getGroups()[0].weight == 2.0 + 4.0 + 1.0);
+    CHECK(sources.toStatements().getSource(1) == "tweet");
+    CHECK(sources.toStatements().getOriginator(1).empty());
+}
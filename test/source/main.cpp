@@ -1,3 +1,20 @@
-#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_IMPLEMENT
 
+#include "test_fixtures.h"
 #include <doctest/doctest.h>
+#include <filesystem>
+#include <shard_coordinator.h>
+#include <string>
+
+std::string testExecutable;
+
+int main(int argc, char** argv) {
+    // The sharded MST tests start this binary as their local workers
+    if (argc == 5 && std::string(argv[1]) == "--shard-worker" && std::string(argv[3]) == "--shard-id") {
+        return Shard_Coordinator::runWorker(argv[2], std::stoi(argv[4]));
+    }
+    testExecutable = std::filesystem::absolute(argv[0]).string();
+
+    doctest::Context context(argc, argv);
+    return context.run();
+}
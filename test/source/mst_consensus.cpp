@@ -0,0 +1,111 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <execution_planner.h>
+#include <mst_consensus.h>
+#include <network_synthesizer.h>
+#include <thread_pool.h>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::vector<Edge> exactMST(const std::vector<std::vector<double>>& documents, int numTopics) {
+        Network_Synthesizer synthesizer(documents, numTopics);
+        synthesizer.findMSTFusedPrim();
+        return synthesizer.getMST();
+    }
+
+    Planner_Config budget() {
+        Planner_Config planner;
+        planner.memoryBudgetBytes = size_t(64) << 20;
+        planner.diskBudgetBytes = size_t(64) << 20;
+        planner.cores = 4;
+        return planner;
+    }
+}
+
+TEST_CASE("Identical replicas support every MST edge fully") {
+    const int numDocuments = 150, numTopics = 6, replicas = 7;
+    const auto documents = makeDocuments(numDocuments, numTopics, 23);
+    const std::vector<Edge> mst = exactMST(documents, numTopics);
+
+    Thread_Pool pool(4);
+    Mst_Consensus consensus(numDocuments, numTopics, pool);
+    REQUIRE(consensus.run(replicas, budget(), [&](int, std::vector<std::vector<double>>& replica) {
+        replica = documents;
+        return true;
+    }));
+    CHECK(consensus.getNumTrees() == replicas);
+
+    const std::vector<Consensus_Edge> edges = consensus.getEdges();
+    REQUIRE(edges.size() == mst.size());
+    std::map<std::pair<int, int>, double> weights;
+    for (const auto& edge : mst) {
+        weights[{std::min(edge.getNode1(), edge.getNode2()), std::max(edge.getNode1(), edge.getNode2())}] = edge.getWeight();
+    }
+    for (const auto& edge : edges) {
+        CHECK(edge.first < edge.second);
+        CHECK(edge.count == replicas);
+        CHECK(edge.support == 1.0);
+        REQUIRE(weights.count({edge.first, edge.second}) == 1);
+        CHECK(edge.meanWeight == doctest::Approx(weights[{edge.first, edge.second}]));
+    }
+}
+
+TEST_CASE("Disjoint replicas split the support") {
+    // Two edge-disjoint spanning trees of four documents
+    Mst_Consensus consensus(4, 2);
+    consensus.addTree({Edge(0, 1, 0.1, 0), Edge(2, 1, 0.2, 1), Edge(2, 3, 0.3, 2)});
+    consensus.addTree({Edge(0, 2, 0.4, 0), Edge(3, 1, 0.5, 1), Edge(0, 3, 0.6, 2)});
+    CHECK(consensus.getNumTrees() == 2);
+
+    const std::vector<Consensus_Edge> edges = consensus.getEdges();
+    REQUIRE(edges.size() == 6);
+    const std::vector<std::pair<int, int>> expected{{0, 1}, {1, 2}, {2, 3}, {0, 2}, {1, 3}, {0, 3}};
+    for (size_t e = 0; e < edges.size(); ++e) {
+        CHECK(std::make_pair(edges[e].first, edges[e].second) == expected[e]);
+        CHECK(edges[e].count == 1);
+        CHECK(edges[e].support == 0.5);
+        CHECK(edges[e].meanWeight == doctest::Approx(0.1 * static_cast<double>(e + 1)));
+    }
+}
+
+TEST_CASE("Support counts the replicas whose MST holds each edge") {
+    const int numDocuments = 80, numTopics = 5, replicas = 6;
+    const auto even = makeDocuments(numDocuments, numTopics, 3);
+    const auto odd = makeDocuments(numDocuments, numTopics, 4);
+    std::map<std::pair<int, int>, int> expected;
+    for (const auto& tree : {exactMST(even, numTopics), exactMST(odd, numTopics)}) {
+        for (const auto& pair : sortedPairs(tree)) {
+            expected[pair] += replicas / 2;
+        }
+    }
+
+    Thread_Pool pool(3);
+    Mst_Consensus consensus(numDocuments, numTopics, pool);
+    REQUIRE(consensus.run(replicas, budget(), [&](int replica, std::vector<std::vector<double>>& documents) {
+        documents = replica % 2 == 0 ? even : odd;
+        return true;
+    }));
+
+    const std::vector<Consensus_Edge> edges = consensus.getEdges();
+    REQUIRE(edges.size() == expected.size());
+    double totalSupport = 0.0;
+    for (size_t e = 0; e < edges.size(); ++e) {
+        CHECK(edges[e].count == expected[{edges[e].first, edges[e].second}]);
+        CHECK(edges[e].support == doctest::Approx(static_cast<double>(edges[e].count) / replicas));
+        if (e > 0) {
+            CHECK(edges[e].support <= edges[e - 1].support);
+        }
+        totalSupport += edges[e].support;
+    }
+    CHECK(totalSupport == doctest::Approx(numDocuments - 1));
+
+    // A failing replica fails the run
+    Mst_Consensus failing(numDocuments, numTopics, pool);
+    CHECK_FALSE(failing.run(replicas, budget(), [&](int replica, std::vector<std::vector<double>>& documents) {
+        documents = even;
+        return replica != 4;
+    }));
+}
@@ -0,0 +1,156 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <network_synthesizer.h>
+#include <statements.h>
+#include <thread_pool.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+    const int numTopics = 8;
+    const char* const verdicts[] = {"true", "false", "half-true"};
+
+    std::string dateOf(int i) {
+        return std::to_string(1 + i % 12) + "/" + std::to_string(1 + i % 28) + "/" + std::to_string(2018 + i / 12 % 3);
+    }
+
+    int dateKey(int i) {
+        return (2018 + i / 12 % 3) * 10000 + (1 + i % 12) * 100 + 1 + i % 28;
+    }
+
+    // Several blocks of the kernel, with documents 7, 8 and 9 repeating the row of document 6
+    struct Corpus {
+        std::vector<std::vector<double>> documents = makeDocuments(2500, numTopics, 17);
+        Statements statements;
+
+        Corpus() {
+            for (int i : {7, 8, 9}) {
+                documents[i] = documents[6];
+            }
+            for (int i = 0; i < static_cast<int>(documents.size()); ++i) {
+                statements.addStatement(i, "statement", verdicts[i % 3], dateOf(i), "Originator " + std::to_string(i % 4),
+                                        "speech", "checker", dateOf(i));
+                statements.addTopics(i, documents[i]);
+            }
+        }
+    };
+
+    double cosineDistance(const std::vector<double>& a, const std::vector<double>& b) {
+        double dot = 0.0, normA = 0.0, normB = 0.0;
+        for (size_t t = 0; t < a.size(); ++t) {
+            dot += a[t] * b[t];
+            normA += a[t] * a[t];
+            normB += b[t] * b[t];
+        }
+        return 1.0 - dot / std::sqrt(normA * normB);
+    }
+
+    // Every document scored, sorted by distance then index
+    std::vector<Similar_Document> bruteForce(const Corpus& corpus, const std::vector<double>& query, int exclude, int k,
+                                             const std::function<bool(int)>& keep = [](int) { return true; }) {
+        std::vector<Similar_Document> all;
+        for (int i = 0; i < static_cast<int>(corpus.documents.size()); ++i) {
+            if (i != exclude && keep(i)) {
+                all.push_back({i, cosineDistance(query, corpus.documents[i])});
+            }
+        }
+        std::sort(all.begin(), all.end(), [](const Similar_Document& a, const Similar_Document& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.document < b.document);
+        });
+        all.resize(std::min(all.size(), static_cast<size_t>(std::max(0, k))));
+        return all;
+    }
+
+    void checkSame(const std::vector<Similar_Document>& actual, const std::vector<Similar_Document>& expected) {
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            CHECK(actual[i].document == expected[i].document);
+            CHECK(actual[i].distance == doctest::Approx(expected[i].distance).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("Nearest documents match a brute-force scan") {
+    const Corpus corpus;
+    Thread_Pool pool(4);
+    Network_Synthesizer synthesizer(corpus.statements, numTopics, pool);
+    synthesizer.buildQueryIndex();
+
+    for (int document : {0, 1234, 2499}) {
+        checkSame(synthesizer.findNearestDocuments(document, 25), bruteForce(corpus, corpus.documents[document], document, 25));
+    }
+    const std::vector<double> topics{0.5, 0.1, 0.0, 0.0, 0.2, 0.1, 0.1, 0.0};
+    checkSame(synthesizer.findNearestDocuments(topics, 40), bruteForce(corpus, topics, -1, 40));
+
+    // A batch gives each query the result it gets alone; malformed queries get nothing
+    std::vector<Similarity_Query> queries(4);
+    queries[0].document = 42;
+    queries[1].topics = topics;
+    queries[2].document = 2000;
+    queries[3].topics = {1.0, 2.0};
+    const auto batch = synthesizer.findNearestDocuments(queries, 10);
+    REQUIRE(batch.size() == 4);
+    checkSame(batch[0], bruteForce(corpus, corpus.documents[42], 42, 10));
+    checkSame(batch[1], bruteForce(corpus, topics, -1, 10));
+    checkSame(batch[2], bruteForce(corpus, corpus.documents[2000], 2000, 10));
+    CHECK(batch[3].empty());
+}
+
+TEST_CASE("Nearest documents with k at least the number of documents") {
+    const Corpus corpus;
+    Network_Synthesizer synthesizer(corpus.statements, numTopics);
+    synthesizer.buildQueryIndex();
+
+    const auto everyOther = synthesizer.findNearestDocuments(3, 2500);
+    CHECK(everyOther.size() == 2499);
+    checkSame(everyOther, bruteForce(corpus, corpus.documents[3], 3, 2499));
+    CHECK(synthesizer.findNearestDocuments(corpus.documents[3], 10000).size() == 2500);
+    CHECK(synthesizer.findNearestDocuments(3, 0).empty());
+}
+
+TEST_CASE("Nearest documents at equal distance are ordered by index") {
+    const Corpus corpus;
+    Network_Synthesizer synthesizer(corpus.statements, numTopics, Thread_Pool::defaultPool());
+    synthesizer.buildQueryIndex();
+
+    const auto nearest = synthesizer.findNearestDocuments(8, 3);
+    REQUIRE(nearest.size() == 3);
+    CHECK(nearest[0].document == 6);
+    CHECK(nearest[1].document == 7);
+    CHECK(nearest[2].document == 9);
+    CHECK(nearest[0].distance == nearest[1].distance);
+    CHECK(nearest[1].distance == nearest[2].distance);
+
+    const auto fromTopics = synthesizer.findNearestDocuments(corpus.documents[6], 4);
+    REQUIRE(fromTopics.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(fromTopics[i].document == 6 + i);
+    }
+}
+
+TEST_CASE("Nearest documents honour the metadata filters") {
+    const Corpus corpus;
+    Thread_Pool pool(3);
+    Network_Synthesizer synthesizer(corpus.statements, numTopics, pool);
+    synthesizer.buildQueryIndex(corpus.statements);
+
+    Query_Filter byVerdict;
+    byVerdict.verdicts = {"false", "half-true"};
+    checkSame(synthesizer.findNearestDocuments(10, 30, byVerdict),
+              bruteForce(corpus, corpus.documents[10], 10, 30, [](int i) { return i % 3 != 0; }));
+
+    Query_Filter byOriginatorAndDate;
+    byOriginatorAndDate.originators = {"Originator 1"};
+    byOriginatorAndDate.dateFrom = "03/01/2019";
+    byOriginatorAndDate.dateTo = "06/30/2019";
+    const auto keep = [](int i) { return i % 4 == 1 && dateKey(i) >= 20190301 && dateKey(i) <= 20190630; };
+    checkSame(synthesizer.findNearestDocuments(10, 15, byOriginatorAndDate),
+              bruteForce(corpus, corpus.documents[10], 10, 15, keep));
+
+    Query_Filter nothing;
+    nothing.verdicts = {"pants-fire"};
+    CHECK(synthesizer.findNearestDocuments(10, 5, nothing).empty());
+}
@@ -0,0 +1,158 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <network.h>
+#include <network_synthesizer.h>
+#include <uf_ds.h>
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Random simple graph; weights on a coarse grid so that many edges tie
+    std::vector<Edge> randomGraph(int numNodes, int numEdges) {
+        std::set<std::pair<int, int>> used;
+        std::vector<Edge> edges;
+        uint64_t state = 99;
+        auto next = [&state](uint64_t bound) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<int>((state >> 33) % bound);
+        };
+        while (static_cast<int>(edges.size()) < numEdges) {
+            const int u = next(numNodes);
+            const int v = next(numNodes);
+            if (u != v && used.emplace(std::min(u, v), std::max(u, v)).second) {
+                edges.emplace_back(u, v, next(50) / 50.0, static_cast<int>(edges.size()));
+            }
+        }
+        return edges;
+    }
+
+    Percolation_Point recompute(int numNodes, const std::vector<Edge>& edges, double threshold) {
+        UF_DS uf(numNodes);
+        std::vector<int> degree(numNodes, 0);
+        for (const auto& edge : edges) {
+            if (edge.getWeight() <= threshold) {
+                uf.unite(edge.getNode1(), edge.getNode2());
+                ++degree[edge.getNode1()];
+                ++degree[edge.getNode2()];
+            }
+        }
+        std::vector<int> size(numNodes, 0);
+        for (int v = 0; v < numNodes; ++v) {
+            ++size[uf.find(v)];
+        }
+        Percolation_Point point{threshold, 0, 0, 0};
+        for (int v = 0; v < numNodes; ++v) {
+            point.components += size[v] > 0 ? 1 : 0;
+            point.giantSize = std::max(point.giantSize, size[v]);
+            point.singletons += degree[v] == 0 ? 1 : 0;
+        }
+        return point;
+    }
+
+    void checkSweep(const std::vector<Percolation_Point>& sweep, int numNodes, const std::vector<Edge>& edges,
+                    const std::vector<double>& thresholds) {
+        REQUIRE(sweep.size() == thresholds.size());
+        for (size_t i = 0; i < thresholds.size(); ++i) {
+            const Percolation_Point expected = recompute(numNodes, edges, thresholds[i]);
+            CHECK(sweep[i].threshold == thresholds[i]);
+            CHECK(sweep[i].components == expected.components);
+            CHECK(sweep[i].giantSize == expected.giantSize);
+            CHECK(sweep[i].singletons == expected.singletons);
+        }
+    }
+}
+
+TEST_CASE("Percolation sweep matches a union-find per threshold") {
+    const int numNodes = 200;
+    const std::vector<Edge> edges = randomGraph(numNodes, 320);
+    // Unsorted, with thresholds below, at and between the weights and above all of them
+    const std::vector<double> thresholds{0.5, -1.0, 0.0, 0.98, 0.2, 0.21, 0.7, 2.0, 0.5};
+    checkSweep(Network::sweepPercolation(numNodes, edges, thresholds), numNodes, edges, thresholds);
+
+    // The components only depend on the minimum spanning forest; singletons count every node
+    // without a kept edge of its own, so only they may differ
+    std::vector<Edge> sorted = edges;
+    std::sort(sorted.begin(), sorted.end(), compareByWeight);
+    UF_DS uf(numNodes);
+    std::vector<Edge> forest;
+    for (const auto& edge : sorted) {
+        if (uf.find(edge.getNode1()) != uf.find(edge.getNode2())) {
+            uf.unite(edge.getNode1(), edge.getNode2());
+            forest.push_back(edge);
+        }
+    }
+    const auto fromForest = Network::sweepPercolation(numNodes, forest, thresholds);
+    const auto fromGraph = Network::sweepPercolation(numNodes, sorted, thresholds);
+    for (size_t i = 0; i < thresholds.size(); ++i) {
+        CHECK(fromForest[i].components == fromGraph[i].components);
+        CHECK(fromForest[i].giantSize == fromGraph[i].giantSize);
+        CHECK(fromForest[i].singletons == fromGraph[i].singletons);
+    }
+}
+
+TEST_CASE("CSR conversion keeps every edge once per endpoint") {
+    const int numNodes = 60;
+    std::vector<Edge> edges;
+    for (const auto& edge : randomGraph(numNodes, 150)) {
+        edges.emplace_back(std::min(edge.getNode1(), edge.getNode2()), std::max(edge.getNode1(), edge.getNode2()),
+                           edge.getWeight(), edge.getId());
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return std::make_pair(a.getNode1(), a.getNode2()) < std::make_pair(b.getNode1(), b.getNode2());
+    });
+    const Sparse_Graph graph = Network::toSparseGraph(numNodes, edges);
+
+    REQUIRE(graph.getNumNodes() == numNodes);
+    CHECK(graph.getNumEdges() == edges.size());
+    REQUIRE(graph.offsets.size() == static_cast<size_t>(numNodes + 1));
+    CHECK(graph.offsets.front() == 0);
+    CHECK(graph.offsets.back() == 2 * edges.size());
+    CHECK(graph.weights.size() == graph.neighbours.size());
+
+    std::vector<std::set<std::pair<int, double>>> expected(numNodes);
+    for (const auto& edge : edges) {
+        expected[edge.getNode1()].emplace(edge.getNode2(), edge.getWeight());
+        expected[edge.getNode2()].emplace(edge.getNode1(), edge.getWeight());
+    }
+    size_t degreeSum = 0;
+    for (int v = 0; v < numNodes; ++v) {
+        std::set<std::pair<int, double>> actual;
+        for (size_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            actual.emplace(graph.neighbours[e], graph.weights[e]);
+        }
+        degreeSum += graph.offsets[v + 1] - graph.offsets[v];
+        CHECK(actual == expected[v]);
+        CHECK(std::is_sorted(graph.neighbours.begin() + static_cast<std::ptrdiff_t>(graph.offsets[v]),
+                             graph.neighbours.begin() + static_cast<std::ptrdiff_t>(graph.offsets[v + 1])));
+    }
+    CHECK(degreeSum == 2 * edges.size());
+}
+
+TEST_CASE("The epsilon-graph holds exactly the pairs within the distance") {
+    const int numDocuments = 120;
+    Network_Synthesizer synthesizer(makeDocuments(numDocuments, 6, 21), 6);
+    const double maxDistance = 0.25;
+    const Sparse_Graph graph = synthesizer.buildEpsilonGraph(maxDistance);
+
+    Graph_Export_Config threshold;
+    threshold.kind = Graph_Kind::THRESHOLD;
+    threshold.maxDistance = maxDistance;
+    const auto expected = sortedPairs(synthesizer.findGraph(threshold));
+    REQUIRE(graph.getNumNodes() == numDocuments);
+    CHECK(graph.getNumEdges() == expected.size());
+
+    std::vector<std::pair<int, int>> actual;
+    for (int v = 0; v < numDocuments; ++v) {
+        for (size_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            CHECK(graph.weights[e] <= maxDistance);
+            if (v < graph.neighbours[e]) {
+                actual.emplace_back(v, graph.neighbours[e]);
+            }
+        }
+    }
+    CHECK(actual == expected);
+}
@@ -0,0 +1,64 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <network_synthesizer.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace {
+    std::vector<std::tuple<int, int, double>> normalise(const std::vector<Edge>& edges) {
+        std::vector<std::tuple<int, int, double>> result;
+        for (const auto& edge : edges) {
+            result.emplace_back(std::min(edge.getNode1(), edge.getNode2()), std::max(edge.getNode1(), edge.getNode2()),
+                                edge.getWeight());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST_CASE("Appending documents gives the MST of a full recompute") {
+    const int numTopics = 8;
+    const auto documents = makeDocuments(240, numTopics, 11);
+
+    Network_Synthesizer full(documents, numTopics);
+    full.findMSTFusedPrim();
+
+    // Grow the tree in two batches, the first of a single document
+    Network_Synthesizer incremental(std::vector<std::vector<double>>(documents.begin(), documents.begin() + 180),
+                                    numTopics);
+    incremental.findMSTFusedPrim();
+    incremental.appendDocuments({documents[180]});
+    incremental.appendDocuments(std::vector<std::vector<double>>(documents.begin() + 181, documents.end()));
+    REQUIRE(incremental.getNumDocuments() == 240);
+
+    const auto expected = normalise(full.getMST());
+    const auto actual = normalise(incremental.getMST());
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        CHECK(std::get<0>(actual[i]) == std::get<0>(expected[i]));
+        CHECK(std::get<1>(actual[i]) == std::get<1>(expected[i]));
+        CHECK(std::get<2>(actual[i]) == doctest::Approx(std::get<2>(expected[i])).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("Appending to an empty tree builds it from scratch") {
+    const int numTopics = 5;
+    const auto documents = makeDocuments(60, numTopics, 11);
+
+    Network_Synthesizer full(documents, numTopics);
+    full.findMSTFusedPrim();
+
+    Network_Synthesizer incremental(std::vector<std::vector<double>>(documents.begin(), documents.begin() + 1), numTopics);
+    incremental.findMSTFusedPrim();
+    incremental.appendDocuments(std::vector<std::vector<double>>(documents.begin() + 1, documents.end()));
+
+    const auto expected = normalise(full.getMST());
+    const auto actual = normalise(incremental.getMST());
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        CHECK(std::get<0>(actual[i]) == std::get<0>(expected[i]));
+        CHECK(std::get<1>(actual[i]) == std::get<1>(expected[i]));
+    }
+}
@@ -0,0 +1,63 @@
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <permutation_test.h>
+#include <thread_pool.h>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+    // Ring of 300 nodes whose labels come in runs of ten, with every tenth node unlabelled
+    struct Ring {
+        int numNodes = 300;
+        std::vector<Edge> edges;
+        std::vector<uint8_t> labels;
+        std::vector<std::string> labelNames{"a", "b", "c"};
+
+        Ring() {
+            for (int node = 0; node < numNodes; ++node) {
+                edges.emplace_back(node, (node + 1) % numNodes, 0.5, node);
+                labels.push_back(static_cast<uint8_t>(node % 10 == 9 ? 3 : (node / 10) % 3));
+            }
+        }
+    };
+
+    std::vector<Permutation_Statistic> runWithThreads(unsigned int numThreads, uint64_t seed) {
+        const Ring ring;
+        Thread_Pool pool(numThreads);
+        return Permutation_Test(ring.numNodes, ring.edges, ring.labels, ring.labelNames, pool).run(500, seed);
+    }
+
+    bool sameValue(double a, double b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+}
+
+TEST_CASE("Permutation results for a seed do not depend on the number of threads") {
+    const auto serial = runWithThreads(1, 42);
+    const auto parallel = runWithThreads(4, 42);
+    REQUIRE(serial.size() == 5);
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        CHECK(parallel[i].name == serial[i].name);
+        CHECK(sameValue(parallel[i].observed, serial[i].observed));
+        CHECK(sameValue(parallel[i].nullMean, serial[i].nullMean));
+        CHECK(sameValue(parallel[i].nullStdDev, serial[i].nullStdDev));
+        CHECK(sameValue(parallel[i].zScore, serial[i].zScore));
+        CHECK(sameValue(parallel[i].pValue, serial[i].pValue));
+    }
+
+    const auto reseeded = runWithThreads(4, 43);
+    CHECK(reseeded[0].observed == serial[0].observed);
+    CHECK(reseeded[0].nullMean != serial[0].nullMean);
+}
+
+TEST_CASE("Clustered labels are significant") {
+    const auto statistics = runWithThreads(2, 7);
+    REQUIRE(statistics[0].name == "same_label_fraction");
+    CHECK(statistics[0].observed > statistics[0].nullMean);
+    CHECK(statistics[0].pValue == doctest::Approx(1.0 / 501.0));
+    CHECK(statistics[1].name == "modularity");
+    CHECK(statistics[1].zScore > 3.0);
+}
@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+#include <planarity.h>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::vector<std::pair<int, int>> completeGraph(int n) {
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u < n; ++u) {
+            for (int v = u + 1; v < n; ++v) {
+                edges.emplace_back(u, v);
+            }
+        }
+        return edges;
+    }
+
+    std::vector<std::pair<int, int>> completeBipartiteGraph(int a, int b) {
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u < a; ++u) {
+            for (int v = 0; v < b; ++v) {
+                edges.emplace_back(u, a + v);
+            }
+        }
+        return edges;
+    }
+}
+
+TEST_CASE("Planarity of the Kuratowski graphs and their neighbours") {
+    Planarity_Tester tester;
+    CHECK(tester.isPlanar(4, completeGraph(4)));
+    CHECK_FALSE(tester.isPlanar(5, completeGraph(5)));
+    CHECK_FALSE(tester.isPlanar(6, completeBipartiteGraph(3, 3)));
+
+    // Removing any edge makes either graph planar
+    auto k5 = completeGraph(5);
+    k5.pop_back();
+    CHECK(tester.isPlanar(5, k5));
+    auto k33 = completeBipartiteGraph(3, 3);
+    k33.erase(k33.begin() + 4);
+    CHECK(tester.isPlanar(6, k33));
+    CHECK(tester.isPlanar(5, completeBipartiteGraph(2, 3)));
+}
+
+TEST_CASE("Planarity of subdivisions and disconnected graphs") {
+    Planarity_Tester tester;
+
+    // K3,3 with every edge subdivided by a new node is still non-planar
+    std::vector<std::pair<int, int>> subdivided;
+    int next = 6;
+    for (const auto& edge : completeBipartiteGraph(3, 3)) {
+        subdivided.emplace_back(edge.first, next);
+        subdivided.emplace_back(next, edge.second);
+        ++next;
+    }
+    CHECK_FALSE(tester.isPlanar(next, subdivided));
+
+    // K5 next to a planar component, reusing the tester's buffers
+    auto edges = completeGraph(4);
+    for (const auto& edge : completeGraph(5)) {
+        edges.emplace_back(edge.first + 4, edge.second + 4);
+    }
+    CHECK_FALSE(tester.isPlanar(9, edges));
+    CHECK(tester.isPlanar(9, completeGraph(4)));
+    CHECK(tester.isPlanar(0, {}));
+}
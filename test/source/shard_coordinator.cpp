@@ -0,0 +1,70 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <network_synthesizer.h>
+#include <shard_coordinator.h>
+#include <uf_ds.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    void checkSameTree(const std::vector<Edge>& actual, const std::vector<Edge>& expected) {
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            CHECK(actual[i].getNode1() == expected[i].getNode1());
+            CHECK(actual[i].getNode2() == expected[i].getNode2());
+            CHECK(actual[i].getWeight() == expected[i].getWeight());
+        }
+    }
+}
+
+TEST_CASE("Tile forests merged by Kruskal give the single-process MST") {
+    const int numDocuments = 150;
+    const int blocks = 3;
+    Network_Synthesizer synthesizer(makeDocuments(numDocuments, 10), 10);
+    synthesizer.findMSTFusedPrim();
+    std::vector<Edge> expected = synthesizer.getMST();
+    std::sort(expected.begin(), expected.end(), compareByWeight);
+
+    std::vector<Edge> candidates;
+    for (int a = 0; a < blocks; ++a) {
+        for (int b = a; b < blocks; ++b) {
+            const auto rows = Shard_Coordinator::blockRange(a, blocks, numDocuments);
+            const auto columns = Shard_Coordinator::blockRange(b, blocks, numDocuments);
+            const auto forest = synthesizer.findTileSpanningForest(rows.first, rows.second, columns.first, columns.second);
+            // A diagonal tile spans its block; an off-diagonal one is bipartite and spans both
+            CHECK(forest.size() == static_cast<size_t>(a == b ? rows.second - rows.first - 1
+                                                              : rows.second - rows.first + columns.second - columns.first - 1));
+            candidates.insert(candidates.end(), forest.begin(), forest.end());
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), compareByWeight);
+    UF_DS uf(numDocuments);
+    std::vector<Edge> merged;
+    for (const auto& edge : candidates) {
+        if (uf.find(edge.getNode1()) != uf.find(edge.getNode2())) {
+            uf.unite(edge.getNode1(), edge.getNode2());
+            merged.push_back(edge);
+        }
+    }
+    checkSameTree(merged, expected);
+}
+
+TEST_CASE("Sharded MST with local workers equals the single-process MST") {
+    const Temp_Directory directory("shards");
+
+    Shard_Config config;
+    config.workers = 3;
+    config.blocks = 4;
+    config.directory = directory.path.string();
+    config.executable = testExecutable;
+
+    Network_Synthesizer synthesizer(makeDocuments(200, 12), 12);
+    synthesizer.findMSTFusedPrim();
+    std::vector<Edge> expected = synthesizer.getMST();
+    std::sort(expected.begin(), expected.end(), compareByWeight);
+
+    REQUIRE(synthesizer.findMSTSharded(config));
+    checkSameTree(synthesizer.getMST(), expected);
+}
@@ -0,0 +1,108 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <pipeline_runner.h>
+#include <sstream>
+#include <stage_cache.h>
+#include <string>
+#include <synthetic_corpus.h>
+#include <thread_pool.h>
+
+namespace {
+    std::string readFile(const std::string& filename) {
+        std::ifstream file(filename);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    bool writeCorpus(const std::string& filename, uint64_t seed) {
+        Synthetic_Config corpus;
+        corpus.numDocuments = 40;
+        corpus.numTopics = 4;
+        corpus.seed = seed;
+        return Synthetic_Corpus(corpus).writeJson(filename);
+    }
+
+    Pipeline_Config stubConfig() {
+        Pipeline_Config config;
+        config.input = "./corpus.json";
+        config.profile = "cache_test";
+        config.topicBackend = "stub";
+        config.lda.numTopics = 4;
+        config.lda.iterations = 20;
+        config.lda.seed = 1;
+        config.perplexityWords = 10;
+        return config;
+    }
+
+    // Manifest of a stage and when it was last written
+    struct Manifest {
+        std::string contents;
+        std::filesystem::file_time_type written;
+
+        explicit Manifest(const std::string& stage)
+            : contents(readFile("./temp/cache/cache_test_" + stage + ".manifest")),
+              written(std::filesystem::last_write_time("./temp/cache/cache_test_" + stage + ".manifest")) {
+        }
+    };
+}
+
+TEST_CASE("A stage is valid only while its fingerprint and outputs are unchanged") {
+    const Temp_Directory directory("stage_cache");
+    const Stage_Cache cache(directory.file("cache"));
+    const std::string output = directory.file("output.txt");
+    std::ofstream(output) << "model";
+
+    Fingerprint key;
+    key.add("input", "abc").add("seed", 1);
+    CHECK_FALSE(cache.isValid("stage", key));
+    REQUIRE(cache.record("stage", key, {output}));
+    CHECK(cache.isValid("stage", key));
+
+    Fingerprint reseeded;
+    reseeded.add("input", "abc").add("seed", 2);
+    CHECK_FALSE(cache.isValid("stage", reseeded));
+
+    std::ofstream(output) << "changed";
+    CHECK_FALSE(cache.isValid("stage", key));
+
+    REQUIRE(cache.record("stage", key, {output}));
+    cache.invalidate("stage");
+    CHECK_FALSE(cache.isValid("stage", key));
+    CHECK_FALSE(Stage_Cache(directory.file("cache"), false).isValid("stage", key));
+}
+
+TEST_CASE("Changing a fingerprinted input reruns the stage instead of reusing it") {
+    const Temp_Directory directory("pipeline_cache");
+    const Working_Directory workingDirectory(directory.path);
+    REQUIRE(writeCorpus("./corpus.json", 1));
+    Thread_Pool pool(2);
+
+    Pipeline_Config config = stubConfig();
+    REQUIRE(Pipeline_Runner(config, pool).run() == 0);
+    const Manifest firstImport("mallet_import");
+    const Manifest firstTraining("lda_training");
+
+    // Unchanged inputs are served from the cache
+    REQUIRE(Pipeline_Runner(config, pool).run() == 0);
+    CHECK(Manifest("mallet_import").written == firstImport.written);
+    CHECK(Manifest("lda_training").written == firstTraining.written);
+
+    // A new seed retrains on the same import
+    config.lda.seed = 2;
+    REQUIRE(Pipeline_Runner(config, pool).run() == 0);
+    CHECK(Manifest("mallet_import").written == firstImport.written);
+    const Manifest reseeded("lda_training");
+    CHECK(reseeded.contents != firstTraining.contents);
+    CHECK(reseeded.contents.find("param seed 2\n") != std::string::npos);
+
+    // A new input file reimports and retrains
+    REQUIRE(writeCorpus("./corpus.json", 2));
+    REQUIRE(Pipeline_Runner(config, pool).run() == 0);
+    const Manifest reimported("mallet_import");
+    CHECK(reimported.contents != firstImport.contents);
+    CHECK(reimported.contents.find("param input " + Stage_Cache::hashFile("./corpus.json") + "\n") != std::string::npos);
+    CHECK(Manifest("lda_training").contents != reseeded.contents);
+}
@@ -0,0 +1,93 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <network_synthesizer.h>
+#include <statements.h>
+#include <temporal_network.h>
+#include <thread_pool.h>
+#include <string>
+#include <vector>
+
+namespace {
+    const int numTopics = 6;
+
+    // 2019: 30 documents in January and February, 1 in March, none in April, 25 in May and June
+    // and a single one in August, added out of date order
+    struct Dated_Corpus {
+        std::vector<std::vector<double>> documents;
+        Statements statements;
+
+        Dated_Corpus() {
+            std::vector<std::string> dates;
+            for (int i = 0; i < 30; ++i) {
+                dates.push_back(std::to_string(1 + i % 2) + "/" + std::to_string(1 + i % 28) + "/2019");
+            }
+            dates.push_back("03/15/2019");
+            for (int i = 0; i < 25; ++i) {
+                dates.push_back(std::to_string(5 + i % 2) + "/" + std::to_string(28 - i % 28) + "/2019");
+            }
+            dates.push_back("08/02/2019");
+            documents = makeDocuments(static_cast<int>(dates.size()), numTopics, 31);
+            for (int i = static_cast<int>(dates.size()) - 1; i >= 0; --i) {
+                statements.addStatement(i, "statement", "true", dates[i], "Originator", "speech", "checker", dates[i]);
+                statements.addTopics(i, documents[i]);
+            }
+        }
+    };
+
+    // MST of the window's documents from scratch, in document IDs
+    std::vector<Edge> scratchMST(const Dated_Corpus& corpus, const std::vector<int>& documents) {
+        std::vector<std::vector<double>> rows;
+        for (int document : documents) {
+            rows.push_back(corpus.documents[document]);
+        }
+        Network_Synthesizer synthesizer(rows, numTopics);
+        synthesizer.findMSTFusedPrim();
+        std::vector<Edge> mst;
+        for (const auto& edge : synthesizer.getMST()) {
+            mst.emplace_back(documents[edge.getNode1()], documents[edge.getNode2()], edge.getWeight(), edge.getId());
+        }
+        return mst;
+    }
+}
+
+TEST_CASE("Window MSTs with distance reuse equal MSTs recomputed per window") {
+    const Dated_Corpus corpus;
+    Thread_Pool pool(3);
+    Temporal_Network temporal(corpus.statements, numTopics, pool);
+
+    Temporal_Config config;
+    config.unit = Time_Unit::MONTH;
+    config.width = 2;
+    config.stride = 1;
+    const std::vector<Temporal_Window> windows = temporal.run(config);
+    CHECK(temporal.getReusedPairs() > 0);
+
+    // Jan-Feb through Aug-Sep
+    REQUIRE(windows.size() == 8);
+    const std::vector<size_t> sizes{30, 16, 1, 13, 25, 12, 1, 1};
+    for (size_t w = 0; w < windows.size(); ++w) {
+        const Temporal_Window& window = windows[w];
+        CHECK(window.documents.size() == sizes[w]);
+        const std::vector<Edge> expected = window.documents.size() > 1 ? scratchMST(corpus, window.documents)
+                                                                         : std::vector<Edge>();
+        CHECK(window.mst.size() == (window.documents.size() > 1 ? window.documents.size() - 1 : 0));
+        CHECK(sortedPairs(window.mst) == sortedPairs(expected));
+        double weight = 0.0;
+        for (const auto& edge : expected) {
+            weight += edge.getWeight();
+        }
+        CHECK(window.mstWeight == doctest::Approx(weight));
+    }
+    CHECK(windows[2].start == "2019-03-01");
+    CHECK(windows[2].mstWeight == 0.0);
+
+    // Without a distance cache every pair is computed on the fly, with the same trees
+    Temporal_Config uncached = config;
+    uncached.memoryBudgetBytes = 0;
+    const std::vector<Temporal_Window> onTheFly = temporal.run(uncached);
+    CHECK(temporal.getReusedPairs() == 0);
+    REQUIRE(onTheFly.size() == windows.size());
+    for (size_t w = 0; w < windows.size(); ++w) {
+        CHECK(sortedPairs(onTheFly[w].mst) == sortedPairs(windows[w].mst));
+    }
+}
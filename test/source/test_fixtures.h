@@ -0,0 +1,111 @@
+#ifndef TEST_FIXTURES_H
+#define TEST_FIXTURES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Absolute path of the test binary, which also runs as a shard worker (see main.cpp).
+ */
+extern std::string testExecutable;
+
+/**
+ * @brief Seeded topic proportions: skewed random rows, each summing to 1.
+ * @param numDocuments Number of rows.
+ * @param numTopics Number of columns.
+ * @param seed Seed; equal seeds give identical rows.
+ */
+inline std::vector<std::vector<double>> makeDocuments(int numDocuments, int numTopics, uint64_t seed = 1) {
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    auto next = [&state]() {
+        // splitmix64
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<double>((z ^ (z >> 31)) >> 11) / 9007199254740992.0;
+    };
+
+    std::vector<std::vector<double>> documents(static_cast<size_t>(numDocuments));
+    for (auto& row : documents) {
+        row.resize(static_cast<size_t>(numTopics));
+        double sum = 0.0;
+        for (double& p : row) {
+            const double u = next();
+            p = u * u * u * u + 1e-3;
+            sum += p;
+        }
+        for (double& p : row) {
+            p /= sum;
+        }
+    }
+    return documents;
+}
+
+/**
+ * @brief Node pairs of edges as (smaller, larger), sorted, to compare edge sets.
+ */
+template <typename EdgeRange>
+std::vector<std::pair<int, int>> sortedPairs(const EdgeRange& edges) {
+    std::vector<std::pair<int, int>> pairs;
+    for (const auto& edge : edges) {
+        pairs.emplace_back(std::min(edge.getNode1(), edge.getNode2()), std::max(edge.getNode1(), edge.getNode2()));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+/**
+ * @brief Empty directory under the system temporary directory, removed with its contents on destruction.
+ */
+class Temp_Directory {
+public:
+    explicit Temp_Directory(const std::string& name)
+        : path(std::filesystem::temp_directory_path() / ("factify_test_" + name)) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    ~Temp_Directory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    Temp_Directory(const Temp_Directory&) = delete;
+    Temp_Directory& operator=(const Temp_Directory&) = delete;
+
+    /**
+     * @brief Path of a file inside the directory.
+     */
+    std::string file(const std::string& name) const {
+        return (path / name).string();
+    }
+
+    const std::filesystem::path path; ///< The directory.
+};
+
+/**
+ * @brief Makes a directory the working directory until destruction, for code writing to ./temp.
+ */
+class Working_Directory {
+public:
+    explicit Working_Directory(const std::filesystem::path& directory) : previous(std::filesystem::current_path()) {
+        std::filesystem::current_path(directory);
+    }
+
+    ~Working_Directory() {
+        std::error_code error;
+        std::filesystem::current_path(previous, error);
+    }
+
+    Working_Directory(const Working_Directory&) = delete;
+    Working_Directory& operator=(const Working_Directory&) = delete;
+
+private:
+    std::filesystem::path previous; ///< Working directory to restore.
+};
+
+#endif // TEST_FIXTURES_H
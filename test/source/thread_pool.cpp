@@ -0,0 +1,139 @@
+#include <doctest/doctest.h>
+#include <thread_pool.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // Runs parallelFor over [begin, end) and counts how often each index is visited
+    std::vector<int> visits(Thread_Pool& pool, size_t begin, size_t end, size_t grain) {
+        std::vector<std::atomic<int>> counts(end + 8);
+        pool.parallelFor(begin, end, [&counts](size_t b0, size_t b1) {
+            for (size_t i = b0; i < b1; ++i) {
+                counts[i].fetch_add(1);
+            }
+        }, grain);
+        std::vector<int> result;
+        for (const auto& count : counts) {
+            result.push_back(count.load());
+        }
+        return result;
+    }
+}
+
+TEST_CASE("parallelFor visits every index exactly once") {
+    Thread_Pool pool(4);
+    for (size_t grain : {size_t(0), size_t(1), size_t(7), size_t(13), size_t(999), size_t(5000)}) {
+        const std::vector<int> counts = visits(pool, 3, 1003, grain);
+        for (size_t i = 0; i < counts.size(); ++i) {
+            CHECK(counts[i] == (i >= 3 && i < 1003 ? 1 : 0));
+        }
+    }
+    CHECK(visits(pool, 5, 5, 0) == std::vector<int>(13, 0));
+}
+
+TEST_CASE("Nested parallelFor inside tasks does not deadlock") {
+    for (unsigned int threads : {1u, 2u, 4u}) {
+        Thread_Pool pool(threads);
+        std::atomic<int64_t> sum{0};
+        pool.parallelFor(0, 16, [&](size_t b0, size_t b1) {
+            for (size_t outer = b0; outer < b1; ++outer) {
+                pool.parallelFor(0, 100, [&](size_t i0, size_t i1) {
+                    for (size_t i = i0; i < i1; ++i) {
+                        sum += static_cast<int64_t>(i);
+                    }
+                }, 3);
+            }
+        }, 1);
+        CHECK(sum.load() == 16 * 4950);
+
+        // Tasks that wait on their own groups, three levels deep
+        std::atomic<int> leaves{0};
+        Task_Group group(pool);
+        for (int a = 0; a < 4; ++a) {
+            group.run([&]() {
+                Task_Group inner(pool);
+                for (int b = 0; b < 4; ++b) {
+                    inner.run([&]() {
+                        pool.parallelFor(0, 8, [&](size_t i0, size_t i1) { leaves += static_cast<int>(i1 - i0); }, 1);
+                    });
+                }
+                inner.wait();
+            });
+        }
+        group.wait();
+        CHECK(leaves.load() == 4 * 4 * 8);
+    }
+}
+
+TEST_CASE("Task_Group rethrows the first exception in wait") {
+    Thread_Pool pool(4);
+    std::atomic<int> finished{0};
+    Task_Group group(pool);
+    for (int i = 0; i < 20; ++i) {
+        group.run([i, &finished]() {
+            if (i == 7) {
+                throw std::runtime_error("task 7");
+            }
+            ++finished;
+        });
+    }
+    CHECK_THROWS_AS(group.wait(), std::runtime_error);
+    CHECK(finished.load() == 19);
+
+    // The group is reusable and parallelFor propagates exceptions as well
+    group.run([&finished]() { ++finished; });
+    CHECK_NOTHROW(group.wait());
+    CHECK(finished.load() == 20);
+    CHECK_THROWS_AS(pool.parallelFor(0, 100, [](size_t b0, size_t) {
+        if (b0 == 50) {
+            throw std::logic_error("chunk 50");
+        }
+    }, 10), std::logic_error);
+}
+
+TEST_CASE("A single-thread pool runs everything on its one worker") {
+    Thread_Pool pool(1);
+    CHECK(pool.getNumThreads() == 1);
+    CHECK_FALSE(pool.isWorkerThread());
+    CHECK_FALSE(pool.runPendingTask());
+
+    std::atomic<int> onWorker{0};
+    Task_Group group(pool);
+    for (int i = 0; i < 10; ++i) {
+        group.run([&]() { onWorker += pool.isWorkerThread() ? 1 : 0; });
+    }
+    group.wait();
+    CHECK(onWorker.load() == 10);
+
+    const std::vector<int> counts = visits(pool, 0, 100, 9);
+    CHECK(std::count(counts.begin(), counts.begin() + 100, 1) == 100);
+
+    std::vector<uint32_t> values(20000);
+    uint32_t state = 12345;
+    for (auto& value : values) {
+        state = state * 1664525u + 1013904223u;
+        value = state;
+    }
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    pool.parallelSort(values.begin(), values.end(), std::less<uint32_t>());
+    CHECK(values == expected);
+}
+
+TEST_CASE("parallelSort on several workers matches std::sort") {
+    Thread_Pool pool(4);
+    std::vector<uint32_t> values(50000);
+    uint32_t state = 7;
+    for (auto& value : values) {
+        state = state * 1664525u + 1013904223u;
+        value = state % 1000; // Many equal keys
+    }
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    pool.parallelSort(values.begin(), values.end(), std::less<uint32_t>());
+    CHECK(values == expected);
+}
@@ -0,0 +1,160 @@
+#include "test_fixtures.h"
+#include <doctest/doctest.h>
+#include <topic_backend.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string readFile(const std::string& filename) {
+        std::ifstream file(filename);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    Training_Job makeJob(const std::string& output, int seed, int iterations) {
+        Training_Job job;
+        job.input = "corpus";
+        job.output = output;
+        job.config.numTopics = 5;
+        job.config.iterations = iterations;
+        job.config.seed = seed;
+        return job;
+    }
+
+    // Executable shell script standing in for the Mallet launcher
+    std::string writeScript(const Temp_Directory& directory, const std::string& name, const std::string& body) {
+        const std::string filename = directory.file(name);
+        std::ofstream(filename) << "#!/bin/sh\n" << body;
+        std::filesystem::permissions(filename, std::filesystem::perms::owner_all);
+        return filename;
+    }
+}
+
+TEST_CASE("The stub backend trains seeded chains and reports their progress") {
+    const Temp_Directory directory("stub_backend");
+    const Working_Directory working(directory.path);
+    std::filesystem::create_directories("./temp");
+    std::ofstream("./corpus.txt") << "first statement\nsecond statement\nthird statement\n";
+
+    Stub_Backend backend;
+    REQUIRE(backend.importCorpus("./corpus.txt", "corpus"));
+    CHECK(readFile("./temp/corpus.mallet") == "stub 3\n");
+
+    std::atomic<int> reports{0};
+    Backend_Options options;
+    options.onProgress = [&reports](const Training_Progress& progress) {
+        CHECK(progress.iterations == 50);
+        CHECK(progress.iteration % 10 == 0);
+        ++reports;
+    };
+    backend.setOptions(options);
+    const std::vector<Training_Result> results =
+        backend.train({makeJob("a", 1, 50), makeJob("b", 2, 50), makeJob("c", 1, 50)}, 2);
+    REQUIRE(results.size() == 3);
+    for (const auto& result : results) {
+        CHECK(result.ok);
+        CHECK(result.exitCode == 0);
+        CHECK_FALSE(result.timedOut);
+        CHECK(std::isfinite(result.logLikelihood));
+    }
+    CHECK(reports == 3 * 5);
+    CHECK(std::filesystem::exists("./temp/a_diagnostics.xml"));
+    CHECK(std::filesystem::exists("./temp/a_word_topic.txt"));
+    const std::string composition = readFile("./temp/a_composition.txt");
+    CHECK(std::count(composition.begin(), composition.end(), '\n') == 3);
+    CHECK(composition == readFile("./temp/c_composition.txt"));
+    CHECK(composition != readFile("./temp/b_composition.txt"));
+
+    Training_Job missing = makeJob("d", 1, 10);
+    missing.input = "missing";
+    const Training_Result failed = backend.train(missing);
+    CHECK_FALSE(failed.ok);
+    CHECK(failed.output.find("missing.mallet") != std::string::npos);
+}
+
+TEST_CASE("The stub backend stops chains at their deadline") {
+    const Temp_Directory directory("stub_deadline");
+    const Working_Directory working(directory.path);
+    std::filesystem::create_directories("./temp");
+    std::ofstream("./temp/corpus.mallet") << "stub 3\n";
+
+    Stub_Backend backend(std::chrono::milliseconds(2));
+    Backend_Options options;
+    options.timeout = std::chrono::milliseconds(30);
+    backend.setOptions(options);
+    const Training_Result result = backend.train(makeJob("slow", 1, 100000));
+    CHECK(result.timedOut);
+    CHECK_FALSE(result.ok);
+    CHECK(result.seconds < 10.0);
+    CHECK_FALSE(std::filesystem::exists("./temp/slow_composition.txt"));
+}
+
+#ifndef _WIN32
+
+TEST_CASE("Mallet processes past their deadline are stopped and reported") {
+    const Temp_Directory directory("mallet_deadline");
+    const std::string sleeper = writeScript(directory, "sleeper.sh", "echo '<10> LL/token: -9.5'\nsleep 30\necho done\n");
+
+    Mallet_Backend backend(sleeper);
+    std::atomic<int> reports{0};
+    Backend_Options options;
+    options.timeout = std::chrono::milliseconds(300);
+    options.onProgress = [&reports](const Training_Progress& progress) {
+        CHECK(progress.job == 0);
+        CHECK(progress.iteration == 10);
+        CHECK(progress.iterations == 1000);
+        CHECK(progress.logLikelihood == -9.5);
+        ++reports;
+    };
+    backend.setOptions(options);
+
+    const auto start = std::chrono::steady_clock::now();
+    const Training_Result result = backend.train(makeJob("sleep", 1, 1000));
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(result.timedOut);
+    CHECK_FALSE(result.cancelled);
+    CHECK_FALSE(result.ok);
+    CHECK(result.exitCode == -1);
+    CHECK(result.logLikelihood == -9.5);
+    CHECK(reports == 1);
+    CHECK(result.output.find("LL/token") != std::string::npos);
+    CHECK(result.output.find("done") == std::string::npos);
+    CHECK(result.seconds >= 0.3);
+    CHECK(seconds < 5.0);
+}
+
+TEST_CASE("Mallet exit codes and output are reported") {
+    const Temp_Directory directory("mallet_exit");
+    const std::string failing = writeScript(directory, "failing.sh", "echo \"$1\"\nexit 3\n");
+    const std::string passing = writeScript(directory, "passing.sh", "exit 0\n");
+
+    Mallet_Backend failingBackend(failing);
+    const Training_Result failed = failingBackend.train(makeJob("exit", 1, 10));
+    CHECK_FALSE(failed.ok);
+    CHECK_FALSE(failed.timedOut);
+    CHECK(failed.exitCode == 3);
+    CHECK(failed.output == "train-topics\n");
+
+    Mallet_Backend passingBackend(passing);
+    const std::vector<Training_Result> passed =
+        passingBackend.train({makeJob("a", 1, 10), makeJob("b", 2, 10), makeJob("c", 3, 10)}, 2);
+    for (const auto& result : passed) {
+        CHECK(result.ok);
+        CHECK(result.exitCode == 0);
+    }
+
+    Mallet_Backend absent(directory.file("absent"));
+    const Training_Result notStarted = absent.train(makeJob("absent", 1, 10));
+    CHECK_FALSE(notStarted.ok);
+    CHECK(notStarted.output.find("Could not start") != std::string::npos);
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include <doctest/doctest.h>
+#include <edge.h>
+#include <tree_analytics.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace {
+    // Path 0 - 1 - 2 - 3 - 4 with a star around 5 hanging off 2, an isolated node 9 and a pair 10 - 11
+    const int numNodes = 12;
+    const std::vector<Edge> forest{
+        Edge(3, 4, 1.5, 0), Edge(0, 1, 1.0, 1), Edge(5, 6, 0.25, 2), Edge(2, 5, 1.0, 3), Edge(1, 2, 2.0, 4),
+        Edge(8, 5, 1.0, 5), Edge(10, 11, 0.5, 6), Edge(2, 3, 0.5, 7), Edge(5, 7, 0.75, 8)};
+
+    struct All_Pairs {
+        std::vector<std::vector<double>> distance; ///< -1 between components.
+        std::vector<std::vector<int>> parent;      ///< Parent of each node in the BFS from a source.
+
+        All_Pairs() : distance(numNodes, std::vector<double>(numNodes, -1.0)), parent(numNodes, std::vector<int>(numNodes, -1)) {
+            std::vector<std::vector<std::pair<int, double>>> adjacency(numNodes);
+            for (const auto& edge : forest) {
+                adjacency[edge.getNode1()].emplace_back(edge.getNode2(), edge.getWeight());
+                adjacency[edge.getNode2()].emplace_back(edge.getNode1(), edge.getWeight());
+            }
+            for (int source = 0; source < numNodes; ++source) {
+                std::queue<int> queue;
+                distance[source][source] = 0.0;
+                queue.push(source);
+                while (!queue.empty()) {
+                    const int u = queue.front();
+                    queue.pop();
+                    for (const auto& [v, w] : adjacency[u]) {
+                        if (distance[source][v] < 0) {
+                            distance[source][v] = distance[source][u] + w;
+                            parent[source][v] = u;
+                            queue.push(v);
+                        }
+                    }
+                }
+            }
+        }
+    };
+}
+
+TEST_CASE("Tree metrics match all-pairs traversals") {
+    const All_Pairs pairs;
+    const Tree_Analytics analytics(numNodes, forest);
+    const std::vector<double> betweenness = analytics.betweenness();
+    const std::vector<double> closeness = analytics.closeness();
+    const std::vector<double> eccentricity = analytics.eccentricity();
+    REQUIRE(betweenness.size() == static_cast<size_t>(numNodes));
+    REQUIRE(closeness.size() == static_cast<size_t>(numNodes));
+    REQUIRE(eccentricity.size() == static_cast<size_t>(numNodes));
+
+    // Betweenness: pairs whose unique path has the node strictly inside
+    std::vector<double> through(numNodes, 0.0);
+    for (int s = 0; s < numNodes; ++s) {
+        for (int t = s + 1; t < numNodes; ++t) {
+            if (pairs.distance[s][t] < 0) {
+                continue;
+            }
+            for (int v = pairs.parent[s][t]; v != s; v = pairs.parent[s][v]) {
+                through[v] += 1.0;
+            }
+        }
+    }
+
+    double longest = 0.0;
+    for (int v = 0; v < numNodes; ++v) {
+        int reachable = 0;
+        double sum = 0.0, farthest = 0.0;
+        for (int u = 0; u < numNodes; ++u) {
+            if (u != v && pairs.distance[v][u] >= 0) {
+                ++reachable;
+                sum += pairs.distance[v][u];
+                farthest = std::max(farthest, pairs.distance[v][u]);
+            }
+        }
+        longest = std::max(longest, farthest);
+        CHECK(betweenness[v] == doctest::Approx(through[v]));
+        CHECK(closeness[v] == doctest::Approx(reachable > 0 ? reachable / sum : 0.0));
+        CHECK(eccentricity[v] == doctest::Approx(farthest));
+    }
+
+    // Hand-checked values: node 2 separates branches of 2, 2 and 4 nodes in a tree of 9
+    CHECK(betweenness[2] == doctest::Approx(20.0));
+    CHECK(betweenness[5] == doctest::Approx(18.0));
+    CHECK(betweenness[9] == 0.0);
+    CHECK(eccentricity[0] == doctest::Approx(5.0));
+
+    int first = -1, second = -1;
+    CHECK(analytics.diameter(first, second) == doctest::Approx(longest));
+    CHECK(pairs.distance[first][second] == doctest::Approx(longest));
+    CHECK(analytics.getNumComponents() == 3);
+    CHECK(analytics.degrees() == std::vector<double>{1, 2, 3, 2, 1, 4, 1, 1, 1, 0, 1, 1});
+}